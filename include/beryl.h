@@ -123,6 +123,16 @@ class ExportAPI Beryl
 	
 	void Loop();
 
+        /* 
+         * Calculates how long the mainloop may await for socket events.
+         * 
+         * @return:
+ 	 *
+         *         · int	: Milliseconds, or 0 if there is pending work.
+         */    
+
+	int GetWait();
+
 	/* Checks if the test office should be run. */
 
 	void CheckOffice();
@@ -0,0 +1,119 @@
+/*
+ * BerylDB - A lightweight database.
+ * http://www.beryldb.com
+ *
+ * Copyright (C) 2021 - Carlos F. Ferry <cferry@beryldb.com>
+ *
+ * This file is part of BerylDB. BerylDB is free software: you can
+ * redistribute it and/or modify it under the terms of the BSD License
+ * version 3.
+ *
+ * More information about our licensing can be found at https://docs.beryl.dev
+ */
+
+#pragma once
+
+#include <atomic>
+
+#include "socketstream.h"
+#include "brldb/query.h"
+
+/*
+ * Finished queries, pushed by data threads and collected by the mainloop.
+ *
+ * Queries are kept in a bounded ring: every slot carries a sequence that
+ * tells whether it is free to write or ready to read, so threads only
+ * compete on an atomic counter (based on Dmitry Vyukov's bounded queue).
+ * The mainloop is woken up through a descriptor (an eventfd, or a pipe
+ * where not available), which is only written to once until the ring is
+ * drained.
+ */
+
+class ExportAPI CompletionQueue : public EventHandler
+{
+  private:
+
+        struct Slot
+        {
+                std::atomic<size_t> sequence;
+
+                std::shared_ptr<QueryBase> query;
+        };
+
+        /* Slots of the ring, COMPLETION_SLOTS long. */
+
+        std::unique_ptr<Slot[]> slots;
+
+        /* Position of next slot to write. */
+
+        std::atomic<size_t> tail;
+
+        /* Position of next slot to read. Only used by the mainloop. */
+
+        size_t head;
+
+        /* Whether the mainloop has been woken up since last Drain(). */
+
+        std::atomic<bool> signaled;
+
+        /* Write end of the pipe (same as fd when using eventfd). */
+
+        int wakefd;
+
+        /* Wakes up the mainloop. */
+
+        void Wake();
+
+  public:
+
+        /* Constructor. */
+
+        CompletionQueue();
+
+        /* Destructor. */
+
+        ~CompletionQueue();
+
+        /* Creates wake up descriptors and adds them to the SocketPool. */
+
+        void Open();
+
+        /* Removes wake up descriptors. */
+
+        void Close();
+
+        /*
+         * Adds a finished query. Called by data threads.
+         *
+         * @parameters:
+	 *
+	 *         · QueryBase	: Query finished.
+         */
+
+        void Push(const std::shared_ptr<QueryBase>& query);
+
+        /*
+         * Removes next finished query. Called by the mainloop.
+         *
+         * @parameters:
+	 *
+	 *         · QueryBase	: Query removed.
+	 *
+         * @return:
+ 	 *
+         *         · True: A query was found.
+         */
+
+        bool Pop(std::shared_ptr<QueryBase>& query);
+
+        /* Allows threads to wake up the mainloop again. Called before popping. */
+
+        void Drain()
+        {
+                this->signaled.exchange(false);
+        }
+
+        /* Clears the wake up descriptor. */
+
+        void OnPendingRead();
+};
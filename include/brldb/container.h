@@ -0,0 +1,84 @@
+/*
+ * BerylDB - A lightweight database.
+ * http://www.beryldb.com
+ *
+ * Copyright (C) 2021 - Carlos F. Ferry <cferry@beryldb.com>
+ *
+ * This file is part of BerylDB. BerylDB is free software: you can
+ * redistribute it and/or modify it under the terms of the BSD License
+ * version 3.
+ *
+ * More information about our licensing can be found at https://docs.beryl.dev
+ */
+
+#pragma once
+
+/*
+ * Only static functions.
+ *
+ * Containers (lists, maps and multimaps) keep a registry entry, plus one
+ * entry per item in an item family (ItemRegs). Item keys start with the
+ * 8 byte id of their container.
+ */
+
+class ExportAPI Container
+{
+    public:
+
+        /*
+         * Encodes a number as 8 big endian bytes, so that encoded numbers
+         * sort as numbers do.
+         *
+         * @parameters:
+	 *
+	 *         · uint64_t	: Number to encode.
+	 *
+         * @return:
+ 	 *
+         *         · string	: Encoded number.
+         */
+
+        static std::string Encode(uint64_t number);
+
+        /*
+         * Reads container id from an item key.
+         *
+         * @parameters:
+	 *
+	 *         · Slice	: Item key.
+	 *
+         * @return:
+ 	 *
+         *         · uint64_t	: Container id, or 0 if key is invalid.
+         */
+
+        static uint64_t GetId(const rocksdb::Slice& key);
+
+        /*
+         * Removes all items of a container.
+         *
+         * @parameters:
+	 *
+	 *         · Database	: Database holding items.
+	 *         · string	: Item type.
+	 *         · uint64_t	: Container id.
+	 *         · WriteBatch	: Batch to append to.
+         */
+
+        static void Erase(std::shared_ptr<Database> database, const std::string& type, uint64_t id, rocksdb::WriteBatch& batch);
+
+        /*
+         * Copies all items of a container, keeping their keys.
+         *
+         * @parameters:
+	 *
+	 *         · Database	: Source database.
+	 *         · Database	: Target database.
+	 *         · string	: Item type.
+	 *         · uint64_t	: Source container.
+	 *         · uint64_t	: Target container.
+	 *         · WriteBatch	: Batch to append to, written to target.
+         */
+
+        static void Copy(std::shared_ptr<Database> source, std::shared_ptr<Database> target, const std::string& type, uint64_t from, uint64_t to, rocksdb::WriteBatch& batch);
+};
@@ -18,6 +18,11 @@
 #include <rocksdb/c.h>
 #include <rocksdb/options.h>
 #include <rocksdb/env.h>
+#include <rocksdb/slice_transform.h>
+#include <rocksdb/cache.h>
+#include <rocksdb/table.h>
+#include <rocksdb/write_buffer_manager.h>
+#include <rocksdb/utilities/write_batch_with_index.h>
 
 class ExportAPI Database
 {
@@ -40,6 +45,13 @@ class ExportAPI Database
         /* Options this DB is working with */
         
         rocksdb::Options options;
+
+        /* 
+         * Column families, sorted as TypeRegs after the default one, 
+         * followed by ItemRegs.
+         */
+
+        std::vector<rocksdb::ColumnFamilyHandle*> handles;
         
         /* Opening/Closure status. */
         
@@ -56,6 +68,118 @@ class ExportAPI Database
         /* Path to a database. */
        
         std::string path;
+
+        /* Storage format this database is using. */
+
+        BRLD_FORMAT format;
+
+        /* Last container id handed out by NewContainer(). */
+
+        std::atomic<uint64_t> containers;
+
+        /* 
+         * Reads the format marker of an opened database. Databases lacking
+         * a marker are either brand new (compact) or created before 
+         * compact format existed (legacy).
+         * 
+         * @return:
+ 	 *
+         *         · BRLD_FORMAT  : Format detected.
+         */    
+
+        BRLD_FORMAT DetectFormat();
+
+        /* 
+         * Rewrites a legacy database using the compact format. Entries are
+         * copied into a temporary database, which replaces the original one
+         * only after all entries have been written.
+         * 
+         * @return:
+ 	 *
+         *         · True: Database migrated.
+         */    
+
+        bool Migrate();
+
+        /* 
+         * Splits lists stored as a single value into one entry per item.
+         * 
+         * @return:
+ 	 *
+         *         · True: Lists migrated.
+         */    
+
+        bool MigrateLists();
+
+        /* 
+         * Splits maps and multimaps stored as a single value into one entry
+         * per field.
+         * 
+         * @return:
+ 	 *
+         *         · True: Maps migrated.
+         */    
+
+        bool MigrateMaps();
+
+        /* 
+         * Indexes geo entries created before the spatial index existed.
+         * 
+         * @return:
+ 	 *
+         *         · True: Geo entries indexed.
+         */    
+
+        bool MigrateGeos();
+
+        /* 
+         * Stores geo entries, kept as longitude:latitude text, as packed positions.
+         * 
+         * @return:
+ 	 *
+         *         · True: Geo entries packed.
+         */    
+
+        bool MigratePositions();
+
+        /* Finds the highest container id in use. */
+
+        void LoadContainers();
+
+        /* 
+         * Opens a database, along with a column family for every type.
+         * 
+         * @parameters:
+	 *
+	 *         · string	: Path to open.
+	 *         · DB		: Opened database.
+	 *         · vector	: Column family handles.
+	 * 
+         * @return:
+ 	 *
+         *         · Status     : Opening status.
+         */    
+
+        rocksdb::Status OpenFamilies(const std::string& dbpath, rocksdb::DB** dbptr, std::vector<rocksdb::ColumnFamilyHandle*>& list);
+
+        /* Releases column family handles. */
+
+        void CloseFamilies(rocksdb::DB* target, std::vector<rocksdb::ColumnFamilyHandle*>& list);
+
+        /* 
+         * Returns the batch gathering writes to this database, while the
+         * calling thread has a transaction open (see Begin()).
+         * 
+         * @parameters:
+	 *
+	 *         · bool	: Create batch if this database has none yet.
+	 * 
+         * @return:
+ 	 *
+         *         · WriteBatchWithIndex : Batch, or NULL if none.
+         */    
+
+        rocksdb::WriteBatchWithIndex* Gathered(bool create);
      
     public:
 
@@ -95,6 +219,149 @@ class ExportAPI Database
              return this->path;
         }
          
+        /* 
+         * Returns the column family a type is stored in.
+         * 
+         * @parameters:
+	 *
+	 *         · string	: Type (INT_KEY, INT_MAP, etc).
+	 * 
+         * @return:
+ 	 *
+         *         · ColumnFamilyHandle : Family handle.
+         */    
+
+        rocksdb::ColumnFamilyHandle* GetHandle(const std::string& type);
+
+        /* 
+         * Returns the column family of an entry, as formatted by
+         * QueryBase::SetDest().
+         * 
+         * @parameters:
+	 *
+	 *         · string	: Entry (key:select:type).
+	 * 
+         * @return:
+ 	 *
+         *         · ColumnFamilyHandle : Family handle.
+         */    
+
+        rocksdb::ColumnFamilyHandle* Route(const std::string& key);
+
+        /* 
+         * Creates an iterator over all entries of a given type.
+         * Caller owns returned iterator.
+         * 
+         * @parameters:
+	 *
+	 *         · string	: Type to iterate.
+	 * 
+         * @return:
+ 	 *
+         *         · Iterator	: New iterator.
+         */    
+
+        rocksdb::Iterator* NewIterator(const std::string& type);
+
+        /* 
+         * Reads a single entry. Entries written by an open transaction
+         * are read before being committed.
+         * 
+         * @parameters:
+	 *
+	 *         · ColumnFamilyHandle	: Family to read from.
+	 *         · string		: Entry to read.
+	 *         · string		: Value read.
+	 * 
+         * @return:
+ 	 *
+         *         · Status	: RocksDB status.
+         */    
+
+        rocksdb::Status Get(rocksdb::ColumnFamilyHandle* handle, const std::string& key, std::string* value);
+
+        /* Reads a single entry, pinning its value rather than copying it. */
+
+        rocksdb::Status Get(rocksdb::ColumnFamilyHandle* handle, const std::string& key, rocksdb::PinnableSlice* value);
+
+        /* Reads several entries of a family at once, as DB::MultiGet does. */
+
+        void MultiGet(rocksdb::ColumnFamilyHandle* handle, size_t total, const rocksdb::Slice* keys, rocksdb::PinnableSlice* values, rocksdb::Status* statuses, bool sorted);
+
+        /* 
+         * Writes a batch. Queries write through here, so that keys being
+         * watched are told about changes (see WatchTable). While a 
+         * transaction is open, batches are gathered instead.
+         * 
+         * @parameters:
+	 *
+	 *         · WriteBatch	: Batch to write.
+	 * 
+         * @return:
+ 	 *
+         *         · Status	: RocksDB status.
+         */    
+
+        rocksdb::Status Write(rocksdb::WriteBatch& batch);
+
+        /* Writes a single entry. */
+
+        rocksdb::Status Put(rocksdb::ColumnFamilyHandle* handle, const std::string& key, const std::string& value);
+
+        /* Removes a single entry. */
+
+        rocksdb::Status Delete(rocksdb::ColumnFamilyHandle* handle, const std::string& key);
+
+        /* 
+         * Opens a transaction on the calling thread. Until Commit() or
+         * Discard(), writes to any database are gathered in a batch per 
+         * database, which reads and iterators of that thread see.
+         */
+
+        static void Begin();
+
+        /* 
+         * Writes gathered batches, one write per database. Caches of a
+         * database whose batch could not be written are cleared, as
+         * they may hold entries that were never committed.
+         * 
+         * @return:
+ 	 *
+         *         · True: All batches written.
+         */    
+
+        static bool Commit();
+
+        /* Drops gathered batches, clearing caches of their databases. */
+
+        static void Discard();
+
+        /* Checks whether the calling thread has a transaction open. */
+
+        static bool Gathering();
+
+        /* 
+         * Allocates an id for a new container (ie, a list). Items of a 
+         * container are stored under its id, so renaming a container 
+         * does not require moving its items.
+         * 
+         * @return:
+ 	 *
+         *         · uint64_t	: New container id.
+         */    
+
+        uint64_t NewContainer()
+        {
+             return ++this->containers;
+        }
+
+        /* Returns current storage format. */
+
+        BRLD_FORMAT GetFormat()
+        {
+             return this->format;
+        }
+
         /* Returns database name. */
         
         std::string GetName()
@@ -14,57 +14,91 @@
 #pragma once
 
 #include <thread>
-#include <queue>
 #include <mutex>
 #include <atomic>
 #include <condition_variable>
 
 #include "brldb/query.h"
 
-enum THR_CMD
-{
-        PROC_EXIT_THREAD = 1,	/* Request to exit thread */
-        PROC_SIGNAL 	 = 2,   /* Request to process a QueryBase signal */
-};
-
-struct ThreadMsg
-{
-        THR_CMD id;
-        std::shared_ptr<QueryBase> msg;
-
-        ThreadMsg(THR_CMD identifier, std::shared_ptr<QueryBase> message) : msg(message)
-        { 
-             id = identifier; 
-        }
-};
+/*
+ * Runs queries posted by the mainloop.
+ *
+ * Queries are handed over through a bounded ring, DATATHREAD_SLOTS long.
+ * The mainloop is the only writer and this thread the only reader, so
+ * each end advances its own counter and no lock is taken. An idle thread
+ * checks its ring <dbconf:spin> times before sleeping, and the mainloop
+ * only signals threads that are actually asleep.
+ */
 
 class DataThread
 {   
     private:
 
-        /* Keeps this thread safe. */
-        
-        std::mutex m_mutex;
-        
         std::unique_ptr<std::thread> handler;
         
-        /* Queue item to attach. */
-        
-        std::queue<std::shared_ptr<ThreadMsg>> queue;
-        
-        /* Conditional variable for thread. */
-        
-        std::condition_variable m_cv;
+        /* Queries posted, DATATHREAD_SLOTS long. */
         
+        std::unique_ptr<std::shared_ptr<QueryBase>[]> slots;
+
+        /* Position of next slot to write. Only advanced by the mainloop. */
+
+        std::atomic<size_t> tail;
+
         /* Keeps track of busy status */
       
         std::atomic<bool> busy;
+
+        /* Whether this thread is asleep, or about to be. */
+
+        std::atomic<bool> sleeping;
+
+        /* Set by Exit(). Thread exits once its ring is empty. */
+
+        std::atomic<bool> exiting;
+
+        /* Position of next slot to read. Only advanced by this thread. */
+
+        std::atomic<size_t> head;
+
+        /* Used to sleep while there is nothing to run. */
+        
+        std::mutex m_mutex;
+        
+        std::condition_variable m_cv;
+
+        /* Position of this thread, used to pick a core when pinning. */
+
+        unsigned int index;
+
+        /* 
+         * Waits for a query to be posted.
+         *
+         * @return:
+ 	 *
+         *         · True: A query is ready. False: Thread should exit.
+         */    
+
+        bool Wait();
+
+        /* Wakes up this thread, if sleeping. */
+
+        void Wake();
+
+        /* Binds this thread to a core. */
+
+        void Pin();
         
     public:
     
-        /* Thread constructor. */
+        /* 
+         * Thread constructor.
+         * 
+         * @parameters:
+	 *
+	 *         · int	: Position of this thread.
+         */    
         
-        DataThread();
+        DataThread(unsigned int position);
 
         void SetStatus(bool flag);
 
@@ -80,6 +114,19 @@ class DataThread
          */    
          
         bool IsBusy();
+
+        /* 
+         * Checks whether the ring of this thread is full.
+         *
+         * @return:
+ 	 *
+         *         · True: No more queries may be posted for now.
+         */    
+
+        bool Full()
+        {
+                return (this->tail.load(std::memory_order_relaxed) - this->head.load(std::memory_order_acquire) >= DATATHREAD_SLOTS);
+        }
     
         /* A mainloop for a datathread. */
         
@@ -95,7 +142,7 @@ class DataThread
 
         std::thread::id Create();
 
-        /* Exists thread */
+        /* Exits thread, once all queries posted are run. */
         
         void Exit();
         
@@ -104,16 +151,20 @@ class DataThread
         ~DataThread();
 
         /* 
-         * Adds a new query to the thread manager.
+         * Adds a new query to the thread manager. Called by the mainloop.
          * 
          * @parameters:
 	 *
 	 *         · QueryBase   : Thread to process.
+         *
+         * @return:
+ 	 *
+         *         · True: Query queued. False: Database not available, or ring full.
          */            
         
-        void Post(const std::shared_ptr<QueryBase> query);
+        bool Post(const std::shared_ptr<QueryBase>& query);
 
-        /* Removes all items in this->queue */
+        /* Removes all queries not run yet. */
         
         void Clear();
-};
\ No newline at end of file
+};
@@ -14,9 +14,12 @@
 #pragma once
 
 #include <mutex>
+#include <set>
+#include <shared_mutex>
 
 #include "query.h"
 #include "brldb/datathread.h"
+#include "brldb/completion.h"
 
 /* Thread vector. */
        
@@ -28,9 +31,17 @@ class ExportAPI DataFlush : public safecast<DataFlush>
 
    private:
 
-        /* Mute used to add notifications. */
+        /* Serializes results processed by data threads (see AttachGlobal). */
 
         static std::mutex mute;
+
+        /* Users with queries awaiting to be dispatched. */
+
+        static std::set<User*> awaiting;
+
+        /* Users with results awaiting to be delivered. */
+
+        static std::set<User*> notified;
         
         /* Determines whether DataFlush should be delivering pendings. */
         
@@ -39,12 +50,40 @@ class ExportAPI DataFlush : public safecast<DataFlush>
         /* Vector containing all threads. */
 
         DataThreadVector threadslist;
+
+        /* Results of finished queries, awaiting to be delivered. */
+
+        CompletionQueue completed;
+
+        /* 
+         * Checks whether a query can be dispatched. Queries on different keys
+         * may run on different threads, so an exclusive query is dispatched
+         * only once earlier queries of its user are done, and queries that
+         * follow it wait until it is done.
+         *
+         * @return:
+ 	 *
+         *         · True: Query can be dispatched.
+         */
+
+        static bool Ready(User* user, const std::shared_ptr<QueryBase>& signal);
+
+        /* Returns thread running a query, or NULL if there are no threads. */
+
+        static DataThread* Target(const std::shared_ptr<QueryBase>& signal);
+
+        /* Checks whether the thread of a query can take it now. */
+
+        static bool Accepts(const std::shared_ptr<QueryBase>& signal);
   
    public:
 
-        /* Mutexes for queries */
+        /* 
+         * Queries run holding a shared lock, so queries on different keys
+         * run at once. Exclusive queries (see QueryBase::Exclusive) run alone.
+         */
         
-        static std::mutex query_mute;
+        static std::shared_timed_mutex query_mute;
    
         /* Flush processor */
         
@@ -195,9 +234,25 @@ class ExportAPI DataFlush : public safecast<DataFlush>
          * @parameters:
 	 *
 	 *         · QueryBase	: Signal to process.
+	 *
+         * @return:
+ 	 *
+         *         · True: Query removed from pending. False: Its thread is full.
          */             
          
-         static void Process(User* user, const std::shared_ptr<QueryBase> signal);
+         static bool Process(User* user, const std::shared_ptr<QueryBase> signal);
+
+        /* 
+         * Adds a query to the pending list of an user. Queries expecting
+         * a result are given a sequence, so results are delivered in order.
+         *
+         * @parameters:
+	 *
+	 *         · User	: User sending this query.
+	 *         · QueryBase	: Query to add.
+         */             
+
+         static void Queue(User* user, std::shared_ptr<QueryBase> signal);
         
          /* Pauses this->running */
         
@@ -228,7 +283,8 @@ class ExportAPI DataFlush : public safecast<DataFlush>
          static void AttachGlobal(const std::shared_ptr<QueryBase> result);
          
         /* 
-         * Adds a new notification to the notification vector.
+         * Adds a new notification to the completion queue. This function
+         * is called from data threads.
          * 
          * @parameters:
 	 *
@@ -237,13 +293,87 @@ class ExportAPI DataFlush : public safecast<DataFlush>
          
          static void AttachResult(const std::shared_ptr<QueryBase> result);
 
+        /* 
+         * Delivers results of an user, in the same order its queries
+         * were dispatched.
+         * 
+         * @parameters:
+	 *
+	 *         · User	: User to deliver results to.
+         */    
+
+         static void FlushResults(User* user);
+
+        /* 
+         * Sends the result of a query to its user, whether it succeeded or not.
+         * 
+         * @parameters:
+	 *
+	 *         · User	: User to reply to.
+	 *         · QueryBase	: Finished query.
+         */    
+
+         static void Reply(User* user, const std::shared_ptr<QueryBase>& signal);
+
+        /* 
+         * Runs a query on a data thread, telling watched keys about its
+         * writes. Caller must hold query_mute.
+         * 
+         * @parameters:
+	 *
+	 *         · QueryBase	: Query to run.
+         */    
+
+         static void Execute(QueryBase* request);
+
+         /* Called by Database on every write made by current thread. */
+
+         static void Written();
+
+         /* 
+          * Called by queries after a successful write whose keys they have
+          * touched themselves (see QueryBase::Touch), so that this write
+          * does not bump the epoch of all watched keys.
+          */
+
+         static void Touched();
+
+        /* 
+         * Removes an user from dispatching lists. Called when
+         * an user is destroyed.
+         * 
+         * @parameters:
+	 *
+	 *         · User	: User to remove.
+         */    
+
+         static void Forget(User* user);
+
          /* Called in the mainloop, used to dispatch notifications and pending queries. */
         
          static void Process();
 
+         /* Opens the completion queue. Called before threads are created. */
+
+         void Open()
+         {
+                this->completed.Open();
+         }
+
          /* Close all threads */
         
          void CloseThreads();     
+
+        /* 
+         * Checks whether there are queries that can be dispatched right away,
+         * in which case the mainloop should not sleep.
+	 * 
+         * @return:
+ 	 *
+         *         · True: Queries awaiting dispatch.
+         */            
+
+         static bool Pending();
         
          /* Returns vector of threads. */
         
@@ -17,6 +17,9 @@
 #include "brldb/expires.h"
 #include "brldb/futures.h"
 #include "brldb/database.h"
+#include "brldb/hotcache.h"
+#include "brldb/zset_index.h"
+#include "brldb/watches.h"
 #include "group.h"
 
 class ExportAPI DBManager : public safecast<DBManager>
@@ -197,6 +200,18 @@ class ExportAPI StoreManager
     private:
 
         rocksdb::Env* env = NULL;
+
+        /* Block cache shared by all databases, as set in <dbtuning>. */
+
+        std::shared_ptr<rocksdb::Cache> cache;
+
+        /* Table factory using the shared cache and bloom filters. */
+
+        std::shared_ptr<rocksdb::TableFactory> tables;
+
+        /* Memtable budget shared by all databases. */
+
+        std::shared_ptr<rocksdb::WriteBufferManager> buffers;
     
         /* Default database to use */
         
@@ -235,8 +250,20 @@ class ExportAPI StoreManager
         /* Flusher class */
         
         DataFlush Flusher; 
+
+        /* In-memory cache of hot keys. */
+
+        HotCache Hot;
+
+        /* Rank indexes of sorted sets. */
+
+        ZSetCache ZSets;
+
+        /* Versions of watched keys. */
+
+        WatchTable Watches;
         
-        /* Opens threads. */
+        /* Sizes in-memory caches, as set in <dbtuning>, and opens threads. */
 
         void OpenAll();
 
@@ -299,4 +326,36 @@ class ExportAPI StoreManager
               return this->env;
         }
 
+        /* 
+         * Applies <dbtuning> to the options of a database. Shared cache,
+         * table factory and write buffer manager are created the first
+         * time this function is called.
+         * 
+         * @parameters:
+	 *
+	 *         · Options	: Options to tune.
+         */            
+
+        void Tune(rocksdb::Options& options);
+
+        /* 
+         * Returns shared block cache.
+         * 
+         * @return:
+ 	 *
+         *         · Cache	: Shared cache, NULL if disabled.
+         */            
+
+        const std::shared_ptr<rocksdb::Cache>& GetCache()
+        {
+              return this->cache;
+        }
+
+        /* Returns shared write buffer manager, NULL if no budget is set. */
+
+        const std::shared_ptr<rocksdb::WriteBufferManager>& GetBuffers()
+        {
+              return this->buffers;
+        }
+
 };
\ No newline at end of file
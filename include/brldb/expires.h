@@ -15,6 +15,8 @@
 
 #include <mutex>
 
+#include "brldb/schedule.h"
+
 class ExpireEntry
 {
     public:
@@ -51,10 +53,20 @@ class ExpireEntry
         }
 };
 
-typedef std::multimap<time_t, ExpireEntry> ExpireMap;
+typedef ScheduleIndex<ExpireEntry>::Timeline ExpireMap;
 
 class ExportAPI ExpireManager : public safecast<ExpireManager>
 {
+    private:
+
+        /* Seconds the oldest pending expire is overdue, as of last flush. */
+
+        time_t lag;
+
+        /* Expires removed since startup. */
+
+        uint64_t expired;
+
     public:
         
         /* Expires have mutex, as these are called inside db threads. */
@@ -65,12 +77,14 @@ class ExportAPI ExpireManager : public safecast<ExpireManager>
         
         ExpireManager();
 
-        /* Expires map */
+        /* Expires, sorted by schedule and indexed by key. */
         
-        ExpireMap ExpireList;
+        ScheduleIndex<ExpireEntry> ExpireList;
         
         /* 
-         * Flushes all pending expires.
+         * Flushes pending expires. Expired keys are removed in batches,
+         * one per database, up to <ttls:batch> keys per call. Keys left
+         * behind are removed in following calls.
          *
          * @parameters:
          *
@@ -92,7 +106,7 @@ class ExportAPI ExpireManager : public safecast<ExpireManager>
          *         · int: Time at which this timer will run.
          */            
          
-        signed int Add(std::shared_ptr<Database> database, signed int schedule, const std::string& key, unsigned int select, bool epoch = false);
+        signed int Add(const std::shared_ptr<Database>& database, signed int schedule, const std::string& key, unsigned int select, bool epoch = false);
 
         /* 
          * Returns triggering time of a timer.
@@ -103,7 +117,7 @@ class ExportAPI ExpireManager : public safecast<ExpireManager>
          *         · int: time_t to expiring time.
          */          
            
-        static signed int GetTIME(std::shared_ptr<Database> database, const std::string& key, unsigned int select);
+        static signed int GetTIME(const std::shared_ptr<Database>& database, const std::string& key, unsigned int select);
 
         /* 
          * Deletes an entry from expires.
@@ -113,7 +127,7 @@ class ExportAPI ExpireManager : public safecast<ExpireManager>
          *         · True: Entry has been deleted. False: Not found.
          */            
          
-        static bool Delete(std::shared_ptr<Database> database, const std::string& key, unsigned int select);
+        static bool Delete(const std::shared_ptr<Database>& database, const std::string& key, unsigned int select);
 
         /* 
          * Finds an expire.
@@ -123,7 +137,7 @@ class ExportAPI ExpireManager : public safecast<ExpireManager>
          *         · ExpireEntry: An static object to ExpireEntry.
          */    
                  
-        ExpireEntry Find(std::shared_ptr<Database> database, const std::string& key, unsigned int select);
+        ExpireEntry Find(const std::shared_ptr<Database>& database, const std::string& key, unsigned int select);
         
         /* 
          * Gets all expires.
@@ -134,7 +148,7 @@ class ExportAPI ExpireManager : public safecast<ExpireManager>
          *                      static object of a ExpireEntry.
          */          
            
-        ExpireMap& GetExpires();        
+        const ExpireMap& GetExpires();        
 
         /* 
          * Time to live.
@@ -144,7 +158,7 @@ class ExportAPI ExpireManager : public safecast<ExpireManager>
          *         · Same as ExpireManager::GetTIME();
          */    
          
-        signed int GetTTL(std::shared_ptr<Database> database, const std::string& key, unsigned int select);
+        signed int GetTTL(const std::shared_ptr<Database>& database, const std::string& key, unsigned int select);
         
         /* Clears everything inside ExpireList. */
         
@@ -179,7 +193,33 @@ class ExportAPI ExpireManager : public safecast<ExpireManager>
                  
         unsigned int CountAll()
         {
-            return this->ExpireList.size();
+            return this->ExpireList.Count();
+        }
+
+        /* 
+         * Expire lag.
+	 * 
+         * @return:
+ 	 *
+         *         · time_t: Seconds the oldest pending expire is overdue.
+         */    
+
+        time_t GetLag()
+        {
+            return this->lag;
+        }
+
+        /* 
+         * Counts expired keys.
+	 * 
+         * @return:
+ 	 *
+         *         · uint64_t: Expires removed since startup.
+         */    
+
+        uint64_t GetExpired()
+        {
+            return this->expired;
         }
         
         /* 
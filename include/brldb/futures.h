@@ -15,6 +15,8 @@
 
 #include <mutex>
 
+#include "brldb/schedule.h"
+
 class FutureEntry
 {
   public:
@@ -38,7 +40,7 @@ class FutureEntry
         }
 };
 
-typedef std::multimap<time_t, FutureEntry> FutureMap;
+typedef ScheduleIndex<FutureEntry>::Timeline FutureMap;
 
 class ExportAPI FutureManager : public safecast<FutureManager>
 {
@@ -50,9 +52,9 @@ class ExportAPI FutureManager : public safecast<FutureManager>
 
         FutureManager();
         
-        /* Future list. */
+        /* Futures, sorted by schedule and indexed by key. */
 
-        FutureMap FutureList;
+        ScheduleIndex<FutureEntry> FutureList;
 
         /* 
          * Flushes all pending futures. 
@@ -140,7 +142,7 @@ class ExportAPI FutureManager : public safecast<FutureManager>
          *         · FutureMap: Map of futures.
          */                
          
-        FutureMap& GetFutures();        
+        const FutureMap& GetFutures();        
 
         /* 
          * Counts all items in FutureList.
@@ -151,7 +153,7 @@ class ExportAPI FutureManager : public safecast<FutureManager>
          
         unsigned int CountAll()
         {
-            return this->FutureList.size();
+            return this->FutureList.Count();
         }
 
         unsigned int Count(std::shared_ptr<Database> database, unsigned int select);
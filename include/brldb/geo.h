@@ -29,7 +29,7 @@
  *         · double: Calculation.
  */ 
 
-double deg2rad(double deg) 
+inline double deg2rad(double deg) 
 {
        return (deg * M_PI / 180);
 }
@@ -46,7 +46,7 @@ double deg2rad(double deg)
  *         · double: Calculation.
  */ 
 
-double rad2deg(double rad) 
+inline double rad2deg(double rad) 
 {
        return (rad * 180 / M_PI);
 }
@@ -65,7 +65,7 @@ double rad2deg(double rad)
  *         · double: Calculation.
  */ 
 
-double CalculateDistance(double lat1d, double lon1d, double lat2d, double lon2d) 
+inline double CalculateDistance(double lat1d, double lon1d, double lat2d, double lon2d) 
 {
        double lat1r, lon1r, lat2r, lon2r, u, v;
        lat1r = deg2rad(lat1d);
@@ -0,0 +1,165 @@
+/*
+ * BerylDB - A lightweight database.
+ * http://www.beryldb.com
+ *
+ * Copyright (C) 2021 - Carlos F. Ferry <cferry@beryldb.com>
+ *
+ * This file is part of BerylDB. BerylDB is free software: you can
+ * redistribute it and/or modify it under the terms of the BSD License
+ * version 3.
+ *
+ * More information about our licensing can be found at https://docs.beryl.dev
+ */
+
+#pragma once
+
+struct GeoMatch
+{
+        std::string key;
+
+        double latitude;
+
+        double longitude;
+
+        /* Distance to the center of a search, in kilometers. */
+
+        double distance;
+};
+
+typedef std::vector<GeoMatch> GeoMatches;
+
+/*
+ * Spatial index of geo entries. Geo entries are stored as a packed position
+ * (see Position), and indexed in the INT_GEO_ITEM family, under their
+ * select, as:
+ *
+ *         · select + geohash + key	: Latitude and longitude.
+ *
+ * Geohashes are 52 bits long, interleaving 26 bits of longitude and 26 bits
+ * of latitude, so that any cell of the grid, at any precision, is a single
+ * range of keys. Searches seek only the few cells covering their area.
+ *
+ * Index entries may outlive their entry (ie, keys expiring), so every match
+ * is checked against its registry before being returned, and stale entries
+ * are removed on the way.
+ *
+ * Only static functions.
+ */
+
+class ExportAPI GeoIndex
+{
+  private:
+
+        typedef std::pair<uint64_t, uint64_t> HashRange;
+
+        /* Appends ranges of cells covering a box that does not cross the antimeridian. */
+
+        static void Cover(double minlat, double maxlat, double minlon, double maxlon, std::vector<HashRange>& ranges);
+
+        /*
+         * Reads all entries found within a box.
+         *
+         * @parameters:
+	 *
+	 *         · Database	: Database to look into.
+	 *         · int	: Select.
+	 *         · double	: Lowest latitude.
+	 *         · double	: Highest latitude.
+	 *         · double	: Lowest longitude (may be lower than -180).
+	 *         · double	: Highest longitude (may be higher than 180).
+	 *         · GeoMatches	: Entries found, not verified yet.
+         */
+
+        static void Scan(std::shared_ptr<Database> database, unsigned int select, double minlat, double maxlat, double minlon, double maxlon, GeoMatches& found);
+
+        /* Removes matches whose registry no longer exists, or has moved. */
+
+        static void Verify(std::shared_ptr<Database> database, unsigned int select, GeoMatches& found);
+
+  public:
+
+        /* Encodes a position as a 52 bit geohash. */
+
+        static uint64_t Hash(double latitude, double longitude);
+
+        /* Returns index key of an entry. */
+
+        static std::string Entry(unsigned int select, const std::string& key, double latitude, double longitude);
+
+        /* Packs a position into 16 bytes. Used by both registry and index values. */
+
+        static std::string Position(double latitude, double longitude);
+
+        /*
+         * Parses a geo value, as stored in its registry.
+         *
+         * @return:
+ 	 *
+         *         · True: Valid value.
+         */
+
+        static bool Parse(const std::string& value, double& latitude, double& longitude);
+
+        /* Parses a geo value stored as text (longitude:latitude), before BRLD_FORMAT_POSITIONS. */
+
+        static bool ParseLegacy(const std::string& value, double& latitude, double& longitude);
+
+        /* Adds an entry to a batch. */
+
+        static void Add(std::shared_ptr<Database> database, rocksdb::WriteBatch& batch, unsigned int select, const std::string& key, double latitude, double longitude);
+
+        /* Removes an entry, given its registry value. */
+
+        static void Remove(std::shared_ptr<Database> database, rocksdb::WriteBatch& batch, unsigned int select, const std::string& key, const std::string& value);
+
+        /* Removes all entries of a select. */
+
+        static void Erase(std::shared_ptr<Database> database, unsigned int select, rocksdb::WriteBatch& batch);
+
+        /*
+         * Indexes an entry, given its registry value.
+         *
+         * @return:
+ 	 *
+         *         · True: Entry indexed.
+         */
+
+        static bool Index(std::shared_ptr<Database> database, unsigned int select, const std::string& key, const std::string& value);
+
+        /* Drops an entry, given its registry value. */
+
+        static void Drop(std::shared_ptr<Database> database, unsigned int select, const std::string& key, const std::string& value);
+
+        /* Distance between two positions, in kilometers. */
+
+        static double Distance(double lat1, double lon1, double lat2, double lon2);
+
+        /*
+         * Finds entries within a distance.
+         *
+         * @parameters:
+	 *
+	 *         · Database	: Database to look into.
+	 *         · int	: Select.
+	 *         · double	: Latitude of center.
+	 *         · double	: Longitude of center.
+	 *         · double	: Radius, in kilometers.
+	 *         · GeoMatches	: Entries found, closest first.
+         */
+
+        static void Radius(std::shared_ptr<Database> database, unsigned int select, double latitude, double longitude, double radius, GeoMatches& found);
+
+        /* Finds entries within a box. Boxes with minlon > maxlon cross the antimeridian. */
+
+        static void Box(std::shared_ptr<Database> database, unsigned int select, double minlat, double minlon, double maxlat, double maxlon, GeoMatches& found);
+
+        /*
+         * Finds closest entries to a position.
+         *
+         * @parameters:
+	 *
+	 *         · size_t	: Max. entries to find.
+         */
+
+        static void Nearest(std::shared_ptr<Database> database, unsigned int select, double latitude, double longitude, size_t count, GeoMatches& found);
+};
@@ -0,0 +1,183 @@
+/*
+ * BerylDB - A lightweight database.
+ * http://www.beryldb.com
+ *
+ * Copyright (C) 2021 - Carlos F. Ferry <cferry@beryldb.com>
+ *
+ * This file is part of BerylDB. BerylDB is free software: you can
+ * redistribute it and/or modify it under the terms of the BSD License
+ * version 3.
+ *
+ * More information about our licensing can be found at https://docs.beryl.dev
+ */
+
+#pragma once
+
+#include <atomic>
+#include <mutex>
+
+/* Shards of the hot cache, each one with its own lock. */
+
+const unsigned int HOT_SHARDS = 16;
+
+/* Values larger than this are never cached. */
+
+const size_t HOT_MAX_VALUE = 64 * 1024;
+
+/*
+ * In-memory cache of hot keys, kept in front of RocksDB.
+ *
+ * Entries are keyed by database and registry entry (key, select and type),
+ * and evicted using CLOCK. New entries are only admitted if they have been
+ * accessed more often than the entry they would evict, which is tracked by
+ * an aging count-min sketch (TinyLFU), so scans do not flush hot keys.
+ *
+ * Entries are invalidated by every write path in QueryBase; data threads
+ * handle a given key in order, so no stale value can be cached.
+ */
+
+class ExportAPI HotCache : public safecast<HotCache>
+{
+  private:
+
+        struct Entry
+        {
+                std::string key;
+
+                std::string value;
+
+                /* Set when accessed, cleared as the clock hand passes. */
+
+                bool referenced;
+        };
+
+        struct Shard
+        {
+                std::mutex lock;
+
+                /* Maps keys to their position in slots. */
+
+                std::unordered_map<std::string, size_t> index;
+
+                /* Clock ring. */
+
+                std::vector<Entry> slots;
+
+                /* Positions in slots left free by invalidations. */
+
+                std::vector<size_t> unused;
+
+                size_t hand;
+
+                /* Frequency sketch, 4 rows of 4 bit counters. */
+
+                std::vector<unsigned char> sketch;
+
+                /* Accesses since last aging. */
+
+                size_t accesses;
+        };
+
+        std::unique_ptr<Shard[]> shards;
+
+        /* Maximum entries per shard. */
+
+        size_t capacity;
+
+        std::atomic<bool> enabled;
+
+        std::atomic<uint64_t> hits;
+
+        std::atomic<uint64_t> misses;
+
+        std::atomic<uint64_t> rejected;
+
+        /* Builds the key of an entry. */
+
+        static std::string Build(const std::shared_ptr<Database>& database, const std::string& dest);
+
+        Shard& Find(const std::string& entry, size_t& hash);
+
+        /* Counts an access to a key, halving all counters from time to time. */
+
+        void Record(Shard& shard, size_t hash);
+
+        unsigned int Frequency(const Shard& shard, size_t hash) const;
+
+        void Remove(Shard& shard, std::unordered_map<std::string, size_t>::iterator it);
+
+  public:
+
+        /* Constructor. */
+
+        HotCache();
+
+        /*
+         * Sets up the cache. Entries already cached are dropped.
+         *
+         * @parameters:
+	 *
+	 *         · size_t	: Maximum entries. 0 disables the cache.
+         */
+
+        void Configure(size_t entries);
+
+        bool Enabled() const
+        {
+                return this->enabled.load(std::memory_order_relaxed);
+        }
+
+        /*
+         * Looks up a registry entry.
+         *
+         * @parameters:
+	 *
+	 *         · Database	: Database the entry belongs to.
+	 *         · string	: Registry entry.
+	 *         · string	: Cached value, if not NULL.
+	 *
+         * @return:
+ 	 *
+         *         · True: Entry is cached.
+         */
+
+        bool Fetch(const std::shared_ptr<Database>& database, const std::string& dest, std::string* value);
+
+        /* Caches a value just read from a database. */
+
+        void Add(const std::shared_ptr<Database>& database, const std::string& dest, const std::string& value);
+
+        /* Removes an entry, called whenever it is written or deleted. */
+
+        void Invalidate(const std::shared_ptr<Database>& database, const std::string& dest);
+
+        /* Removes all entries of a database. */
+
+        void Clear(const std::string& dbname);
+
+        /* Counts cached entries. */
+
+        size_t Count();
+
+        size_t GetCapacity() const
+        {
+                return this->capacity * HOT_SHARDS;
+        }
+
+        uint64_t GetHits() const
+        {
+                return this->hits;
+        }
+
+        uint64_t GetMisses() const
+        {
+                return this->misses;
+        }
+
+        /* Entries not admitted, as they were less popular than evicted ones. */
+
+        uint64_t GetRejected() const
+        {
+                return this->rejected;
+        }
+};
@@ -13,6 +13,8 @@
 
 #pragma once
 
+#include <rocksdb/iterator.h>
+
 class ExportAPI LoopIterator
 {
     public:
@@ -22,3 +24,57 @@ class ExportAPI LoopIterator
         LoopIterator();
 };
 
+/* 
+ * Limits an iterator to the entries that may match a glob pattern.
+ * The literal prefix of a pattern (everything before '*' or '?') is 
+ * expanded into its case variants, and every variant is visited as a 
+ * bounded range, in key order. Entries must still be matched against 
+ * the full pattern.
+ */
+
+class ExportAPI PrefixRange
+{
+    private:
+
+        /* Encoded prefixes to visit, sorted. */
+
+        std::vector<std::string> prefixes;
+
+        /* Prefix currently being visited. */
+
+        unsigned int current;
+
+        /* Moves to the first non-empty range, starting at this->current. */
+
+        void Skip(rocksdb::Iterator* it);
+
+    public:
+
+        /* 
+         * Constructor.
+         *
+         * @parameters:
+	 *
+	 *         · string	: Glob pattern.
+         */
+
+        PrefixRange(const std::string& pattern);
+
+        /* Positions iterator at first matching range. */
+
+        void Seek(rocksdb::Iterator* it);
+
+        /* 
+         * Checks whether iterator is within a range.
+         *
+         * @return:
+ 	 *
+         *         · True: Iterator may be used.
+         */
+
+        bool Valid(rocksdb::Iterator* it);
+
+        /* Advances iterator, jumping to next range if needed. */
+
+        void Next(rocksdb::Iterator* it);
+};
@@ -0,0 +1,230 @@
+/*
+ * BerylDB - A lightweight database.
+ * http://www.beryldb.com
+ *
+ * Copyright (C) 2021 - Carlos F. Ferry <cferry@beryldb.com>
+ *
+ * This file is part of BerylDB. BerylDB is free software: you can
+ * redistribute it and/or modify it under the terms of the BSD License
+ * version 3.
+ *
+ * More information about our licensing can be found at https://docs.beryl.dev
+ */
+
+#pragma once
+
+#include "brldb/list_handler.h"
+
+/*
+ * Lists are stored as a small registry entry (id:head:tail), plus one
+ * entry per item in the INT_LIST_ITEM family. Items are keyed by the
+ * list id and their sequence number (see Container), so pushing, popping
+ * and reading either end of a list only touches a single item.
+ */
+
+class ExportAPI ListStore
+{
+  private:
+
+        std::shared_ptr<Database> database;
+
+        /* Registry entry of this list (key:select:INT_LIST). */
+
+        std::string dest;
+
+        /* Container id. */
+
+        uint64_t id;
+
+        /* Sequence of first item. */
+
+        uint64_t head;
+
+        /* Sequence after last item. */
+
+        uint64_t tail;
+
+        /*
+         * Writes registry entry, or removes it if this list is empty.
+         *
+         * @parameters:
+	 *
+	 *         · WriteBatch	: Batch to append to.
+         *
+         * @return:
+ 	 *
+         *         · True: Batch written.
+         */
+
+        bool Commit(rocksdb::WriteBatch& batch);
+
+  public:
+
+        /*
+         * Constructor.
+         *
+         * @parameters:
+	 *
+	 *         · Database	: Database holding this list.
+	 *         · string	: Registry entry.
+         */
+
+        ListStore(std::shared_ptr<Database> db, const std::string& regdest);
+
+        /*
+         * Loads a registry value.
+         *
+         * @parameters:
+	 *
+	 *         · string	: Registry value, as read from dest.
+	 *
+         * @return:
+ 	 *
+         *         · True: Valid registry.
+         */
+
+        bool Load(const std::string& registry);
+
+        /* Initializes an empty list, using a new container id. */
+
+        void Create();
+
+        /*
+         * Counts items in list.
+         *
+         * @return:
+ 	 *
+         *         · uint	: List size.
+         */
+
+        unsigned int Count()
+        {
+                return this->tail - this->head;
+        }
+
+        /*
+         * Adds an item to the end of the list.
+         *
+         * @parameters:
+	 *
+	 *         · string	: Item to add.
+	 *
+         * @return:
+ 	 *
+         *         · True: Item added.
+         */
+
+        bool Push(const std::string& item);
+
+        /*
+         * Removes first or last item.
+         *
+         * @parameters:
+	 *
+	 *         · bool	: Pop from front.
+	 *         · string	: Removed item.
+	 *
+         * @return:
+ 	 *
+         *         · True: Item removed.
+         */
+
+        bool Pop(bool front, std::string& item);
+
+        /*
+         * Reads an item by position.
+         *
+         * @parameters:
+	 *
+	 *         · uint	: Position, starting at 0.
+	 *         · string	: Item found.
+	 *
+         * @return:
+ 	 *
+         *         · True: Item found.
+         */
+
+        bool At(unsigned int pos, std::string& item);
+
+        /*
+         * Reads all items.
+         *
+         * @return:
+ 	 *
+         *         · ListHandler	: Handler with all items, in order.
+         */
+
+        std::shared_ptr<ListHandler> Fetch();
+
+        /*
+         * Replaces all items. An empty handler removes this list.
+         *
+         * @parameters:
+	 *
+	 *         · ListHandler	: New items.
+	 *
+         * @return:
+ 	 *
+         *         · True: List written.
+         */
+
+        bool Replace(std::shared_ptr<ListHandler> handler);
+
+        /*
+         * Keeps first items in list, removing the rest.
+         *
+         * @parameters:
+	 *
+	 *         · uint	: Items to keep.
+	 *
+         * @return:
+ 	 *
+         *         · True: List written.
+         */
+
+        bool Truncate(unsigned int size);
+
+        /*
+         * Removes all items, along with the registry entry.
+         *
+         * @return:
+ 	 *
+         *         · True: List removed.
+         */
+
+        bool Erase();
+
+        /*
+         * Copies all items into a new list.
+         *
+         * @parameters:
+	 *
+	 *         · Database	: Target database.
+	 *         · string	: Target registry entry.
+	 *
+         * @return:
+ 	 *
+         *         · True: List copied.
+         */
+
+        bool CopyTo(std::shared_ptr<Database> target, const std::string& newdest);
+
+        /*
+         * Formats the key of an item.
+         *
+         * @parameters:
+	 *
+	 *         · uint64_t	: Container id.
+	 *         · uint64_t	: Item sequence.
+	 *
+         * @return:
+ 	 *
+         *         · string	: Fixed size key, sorted as sequences.
+         */
+
+        static std::string ItemKey(uint64_t container, uint64_t seq);
+
+        /* Formats a registry value. */
+
+        static std::string Registry(uint64_t container, uint64_t first, uint64_t last);
+};
@@ -0,0 +1,278 @@
+/*
+ * BerylDB - A lightweight database.
+ * http://www.beryldb.com
+ *
+ * Copyright (C) 2021 - Carlos F. Ferry <cferry@beryldb.com>
+ *
+ * This file is part of BerylDB. BerylDB is free software: you can
+ * redistribute it and/or modify it under the terms of the BSD License
+ * version 3.
+ *
+ * More information about our licensing can be found at https://docs.beryl.dev
+ */
+
+#pragma once
+
+#include "brldb/map_handler.h"
+#include "brldb/multimap_handler.h"
+
+/*
+ * Maps and multimaps are stored as a registry entry (id:count:next), plus
+ * one entry per field in an item family (see Container).
+ *
+ * Map items are keyed as id + field. Multimap items are keyed as
+ * id + field + ':' + sequence, as a field may hold many values. Fields
+ * are encoded with to_bin(), so ':' only appears as a separator.
+ */
+
+class ExportAPI MapStore
+{
+  private:
+
+        std::shared_ptr<Database> database;
+
+        /* Registry entry of this map (key:select:type). */
+
+        std::string dest;
+
+        /* Item type, either INT_MAP_ITEM or INT_MMAP_ITEM. */
+
+        std::string type;
+
+        /* Whether this is a multimap. */
+
+        bool multi;
+
+        /* Container id. */
+
+        uint64_t id;
+
+        /* Items stored. */
+
+        uint64_t count;
+
+        /* Sequence of next value added (multimaps only). */
+
+        uint64_t next;
+
+        /* Upper bound of current iteration. */
+
+        std::string bound;
+
+        /*
+         * Writes registry entry, or removes it if this map is empty.
+         *
+         * @parameters:
+	 *
+	 *         · WriteBatch	: Batch to append to.
+         *
+         * @return:
+ 	 *
+         *         · True: Batch written.
+         */
+
+        bool Commit(rocksdb::WriteBatch& batch);
+
+        /* Returns the key of a map field, or the key prefix of a multimap field. */
+
+        std::string FieldKey(const std::string& field);
+
+  public:
+
+        /*
+         * Constructor.
+         *
+         * @parameters:
+	 *
+	 *         · Database	: Database holding this map.
+	 *         · string	: Registry entry.
+	 *         · bool	: Multimap.
+         */
+
+        MapStore(std::shared_ptr<Database> db, const std::string& regdest, bool is_multi = false);
+
+        /*
+         * Loads a registry value.
+         *
+         * @parameters:
+	 *
+	 *         · string	: Registry value, as read from dest.
+	 *
+         * @return:
+ 	 *
+         *         · True: Valid registry.
+         */
+
+        bool Load(const std::string& registry);
+
+        /* Initializes an empty map, using a new container id. */
+
+        void Create();
+
+        /*
+         * Counts items in map.
+         *
+         * @return:
+ 	 *
+         *         · uint	: Items stored.
+         */
+
+        unsigned int Count()
+        {
+                return this->count;
+        }
+
+        /*
+         * Sets a field. Maps replace previous value, while multimaps add
+         * a new value to the field.
+         *
+         * @parameters:
+	 *
+	 *         · string	: Field.
+	 *         · string	: Value.
+	 *
+         * @return:
+ 	 *
+         *         · True: Field written.
+         */
+
+        bool Set(const std::string& field, const std::string& value);
+
+        /*
+         * Reads a field. Multimaps return first value of a field.
+         *
+         * @parameters:
+	 *
+	 *         · string	: Field.
+	 *         · string	: Value found.
+	 *
+         * @return:
+ 	 *
+         *         · True: Field found.
+         */
+
+        bool Get(const std::string& field, std::string& value);
+
+        /*
+         * Checks whether a field exists.
+         *
+         * @parameters:
+	 *
+	 *         · string	: Field.
+	 *
+         * @return:
+ 	 *
+         *         · True: Field found.
+         */
+
+        bool Exists(const std::string& field);
+
+        /*
+         * Removes a field, along with all its values.
+         *
+         * @parameters:
+	 *
+	 *         · string	: Field.
+	 *
+         * @return:
+ 	 *
+         *         · uint	: Items removed.
+         */
+
+        unsigned int Remove(const std::string& field);
+
+        /* Returns a new iterator over items. Caller owns it. */
+
+        rocksdb::Iterator* NewIterator();
+
+        /*
+         * Positions an iterator at first item.
+         *
+         * @parameters:
+	 *
+	 *         · Iterator	: Iterator to use.
+	 *         · string	: Only visit values of this field (multimaps).
+         */
+
+        void Seek(rocksdb::Iterator* it, const std::string& field = "");
+
+        /*
+         * Checks whether an iterator points to an item.
+         *
+         * @return:
+ 	 *
+         *         · True: Iterator is within this map.
+         */
+
+        bool Valid(rocksdb::Iterator* it);
+
+        /* Returns the field an iterator points to. */
+
+        std::string Field(rocksdb::Iterator* it);
+
+        /*
+         * Reads all items.
+         *
+         * @return:
+ 	 *
+         *         · MapHandler	: Handler with all items.
+         */
+
+        std::shared_ptr<MapHandler> FetchMap();
+
+        /*
+         * Reads all items of a multimap.
+         *
+         * @return:
+ 	 *
+         *         · MultiMapHandler	: Handler with all items.
+         */
+
+        std::shared_ptr<MultiMapHandler> FetchMulti();
+
+        /*
+         * Removes all items, along with the registry entry.
+         *
+         * @return:
+ 	 *
+         *         · True: Map removed.
+         */
+
+        bool Erase();
+
+        /*
+         * Copies all items into a new map.
+         *
+         * @parameters:
+	 *
+	 *         · Database	: Target database.
+	 *         · string	: Target registry entry.
+	 *
+         * @return:
+ 	 *
+         *         · True: Map copied.
+         */
+
+        bool CopyTo(std::shared_ptr<Database> target, const std::string& newdest);
+
+        /* Formats a registry value. */
+
+        static std::string Registry(uint64_t container, uint64_t items, uint64_t seq);
+
+        /*
+         * Formats the key of an item.
+         *
+         * @parameters:
+	 *
+	 *         · bool	: Multimap.
+	 *         · uint64_t	: Container id.
+	 *         · string	: Field.
+	 *         · uint64_t	: Value sequence (multimaps only).
+	 *
+         * @return:
+ 	 *
+         *         · string	: Item key.
+         */
+
+        static std::string ItemKey(bool is_multi, uint64_t container, const std::string& field, uint64_t seq = 0);
+};
@@ -0,0 +1,120 @@
+/*
+ * BerylDB - A lightweight database.
+ * http://www.beryldb.com
+ *
+ * Copyright (C) 2021 - Carlos F. Ferry <cferry@beryldb.com>
+ *
+ * This file is part of BerylDB. BerylDB is free software: you can
+ * redistribute it and/or modify it under the terms of the BSD License
+ * version 3.
+ *
+ * More information about our licensing can be found at https://docs.beryl.dev
+ */
+
+#pragma once
+
+enum VECTOR_TYPE
+{
+       VECTOR_TYPE_STRING	=	0,
+       VECTOR_TYPE_INT		=	1,
+       VECTOR_TYPE_DOUBLE	=	2
+};
+
+enum VECTOR_AGGREGATE
+{
+       VECTOR_AGGREGATE_SUM	=	1,
+       VECTOR_AGGREGATE_AVG	=	2,
+       VECTOR_AGGREGATE_HIGH	=	3,
+       VECTOR_AGGREGATE_LOW	=	4
+};
+
+/*
+ * Numeric vectors are stored as a header followed by a packed array of
+ * 64 bit little-endian items (int64 or double). The header is made of
+ * BIN_ESCAPE and a type char, a sequence to_bin() never produces, so
+ * packed vectors can be told apart from regular ones.
+ *
+ * Aggregates run directly over the stored value, using AVX2 or SSE2
+ * when available.
+ */
+
+class ExportAPI PackedVector
+{
+  public:
+
+        /*
+         * Finds the type of a stored vector.
+         *
+         * @parameters:
+	 *
+	 *         · string	: Stored value.
+	 *
+         * @return:
+ 	 *
+         *         · VECTOR_TYPE	: VECTOR_TYPE_STRING if not packed.
+         */
+
+        static VECTOR_TYPE GetType(const std::string& load);
+
+        /* Returns header of a packed vector. */
+
+        static std::string Header(VECTOR_TYPE type);
+
+        /*
+         * Appends an item to a packed vector.
+         *
+         * @parameters:
+	 *
+	 *         · VECTOR_TYPE	: Type of vector.
+	 *         · string		: Item to append.
+	 *         · string		: Packed vector.
+	 *
+         * @return:
+ 	 *
+         *         · True: Item is a valid number for given type.
+         */
+
+        static bool Pack(VECTOR_TYPE type, const std::string& item, std::string& packed);
+
+        /*
+         * Unpacks all items of a stored vector.
+         *
+         * @return:
+ 	 *
+         *         · StringVector	: Items, formatted as strings.
+         */
+
+        static StringVector Unpack(const std::string& load);
+
+        /*
+         * Checks whether an item can be stored in a vector of given type.
+         *
+         * @return:
+ 	 *
+         *         · True: Valid item.
+         */
+
+        static bool Valid(VECTOR_TYPE type, const std::string& item);
+
+        /*
+         * Formats a number so it can be parsed back without losing precision.
+         */
+
+        static std::string Format(double value);
+
+        /*
+         * Aggregates all items of a packed vector.
+         *
+         * @parameters:
+	 *
+	 *         · string		: Stored value.
+	 *         · VECTOR_AGGREGATE	: Aggregate to calculate.
+	 *         · string		: Result.
+	 *
+         * @return:
+ 	 *
+         *         · True: Value is a non-empty packed vector.
+         */
+
+        static bool Aggregate(const std::string& load, VECTOR_AGGREGATE aggregate, std::string& result);
+};
@@ -15,7 +15,10 @@
 
 #include "dbnumeric.h"
 #include "brldb/database.h"
+#include "brldb/iterators.h"
 #include "cstruct.h"
+#include "brldb/query_pool.h"
+#include "brldb/watches.h"
 
 enum STR_FUNCTION
 {
@@ -87,7 +90,13 @@ class ExportAPI QueryBase
 
         bool key_required;
 
+        /* Value loaded while looking up the type of key. */
+
         RocksData mapped;
+
+        /* Last value read by Get(), when not loaded already. */
+
+        RocksData fetched;
         
     public:
     
@@ -113,6 +122,10 @@ class ExportAPI QueryBase
         unsigned int subresult;
         
         bool partial;
+
+        /* Position among queries dispatched by user (0 if unordered). */
+
+        uint64_t sequence;
         
         std::string hesh;
             
@@ -122,34 +135,20 @@ class ExportAPI QueryBase
         
         std::string value;
        
-        std::string length;
-        
         signed int offset;
         
         signed int limit;
         
-        DualMMap mlist;
-        
         unsigned int select_query;
 
         unsigned int id;
 
-        /* Only first element */
-        
-        bool onlyfirst;
-        
         /* q_ stands for query */
         
         std::string response;
         
-        bool all;
-
         StringVector VecData;
         
-        std::multimap<std::string, std::string>  mmap;
-        
-        std::map<std::string, unsigned int> nmap;
-        
         std::shared_ptr<Database> database;
 
         std::shared_ptr<Database> transf_db;
@@ -157,6 +156,10 @@ class ExportAPI QueryBase
         std::vector<std::string> list;
 
         User* user;
+
+        /* Whether values are replied to without quotes (see User::IsDelimited). */
+
+        bool delimited;
         
         OP_TYPE operation;
         
@@ -186,8 +189,8 @@ class ExportAPI QueryBase
         }
         
         QueryBase() :  finished(false), key_required(false), flags(QUERY_FLAGS_NONE), access(DBL_NONE),  
-                        subresult(0), partial(false), offset(0), limit(0), user(NULL), 
-                        operation(OP_NONE), counter(0), data(0), size(0.0)
+                        subresult(0), partial(false), sequence(0), offset(0), limit(0), user(NULL), 
+                        delimited(false), operation(OP_NONE), counter(0), data(0), size(0.0)
         {
               
         }
@@ -196,6 +199,17 @@ class ExportAPI QueryBase
         
         bool CheckKey();
 
+        /* 
+         * Checks whether this query may touch other keys than its own
+         * (or none at all), in which case it can not run alongside others.
+         * 
+         * @return:
+ 	 *
+         *         · True: Query must run alone.
+         */    
+
+        bool Exclusive();
+
         void DelFuture();
         
         void DelExpire();	
@@ -210,6 +224,50 @@ class ExportAPI QueryBase
          
         signed int IsExpiring();
 
+        /* 
+         * Removes a key whose expire already passed, but has not been
+         * flushed yet.
+         * 
+         * @parameters:
+	 *
+	 *         · uint	: Select of key.
+	 *         · string	: Key to check.
+	 * 
+         * @return:
+ 	 *
+         *         · True: Key was expired and has been removed.
+         */    
+
+        bool ExpireLazy(unsigned int select, const std::string& regkey);
+
+        /* 
+         * Touches a key written to by this query, if it is being watched.
+         * Queries writing to keys other than their own touch each of them,
+         * and then call DataFlush::Touched().
+         * 
+         * @parameters:
+	 *
+	 *         · uint	: Select of key.
+	 *         · string	: Key written to.
+         */    
+
+        void Touch(unsigned int select, const std::string& regkey);
+
+        /* 
+         * Formats a value to reply with. Values are quoted, unless 
+         * these are delimited by the serializer of the requesting user.
+         * 
+         * @parameters:
+	 *
+	 *         · string	: Value to reply with.
+	 * 
+         * @return:
+ 	 *
+         *         · string	: Value, formatted.
+         */    
+
+        std::string Quote(const std::string& reply) const;
+
         /* 
          * Writes and adds an expire to the database.
          * 
@@ -236,7 +294,35 @@ class ExportAPI QueryBase
         
         int CheckDest(unsigned int select, const std::string& regkey,  const std::string& ltype, std::shared_ptr<Database> db = NULL);
 
-        RocksData Get(const std::string& where);
+        /* 
+         * Reads an entry, unless it was loaded while checking its type.
+         * 
+         * @parameters:
+	 *
+	 *         · string	: Entry to read.
+	 * 
+         * @return:
+ 	 *
+         *         · RocksData	: Value read, valid until next call.
+         */    
+
+        const RocksData& Get(const std::string& where);
+
+        /* 
+         * Reads keys of a given type with a single MultiGet. Lookups are sorted
+         * beforehand, so RocksDB does not need to sort them again.
+         * 
+         * @parameters:
+	 *
+	 *         · string	: Type of keys, which are read from list.
+	 *         · vector	: Values found (may be NULL).
+	 * 
+         * @return:
+ 	 *
+         *         · vector	: Whether each key in list was found.
+         */    
+
+        std::vector<bool> MultiRead(const std::string& regtype, std::vector<std::string>* values = NULL);
         
         /* 
          * Writes an entry to the database.
@@ -251,6 +337,19 @@ class ExportAPI QueryBase
         
         void Delete(const std::string& wdest);
         
+        /* 
+         * Offers a result of another query, sent while this one is running.
+         * 
+         * @return:
+ 	 *
+         *         · True: Result kept, to be delivered by this query.
+         */    
+
+        virtual bool Collect(const std::shared_ptr<QueryBase>& result)
+        {
+              return false;
+        }
+
         virtual void Run() = 0;
         
         virtual void Process() = 0;
@@ -408,6 +507,8 @@ class ExportAPI del_query : public routed_query
         
         void Lists();
 
+        void ZSets();
+
         void Vectors();
 
         void Run();
@@ -434,6 +535,8 @@ class ExportAPI transfer_query : public routed_query
 
         void Lists();
 
+        void ZSets();
+
         void Vectors();
 
         void Run();
@@ -487,6 +590,8 @@ class ExportAPI clone_query : public routed_query
 
         void Lists();
 
+        void ZSets();
+
         void Vectors();
 
         void Run();
@@ -514,6 +619,8 @@ class ExportAPI copy_query : public routed_query
 
         void Lists();
 
+        void ZSets();
+
         void Vectors();
 
         void Run();
@@ -596,6 +703,10 @@ class ExportAPI glist_query  : public QueryBase
 {
     public:
 
+        /* Keys found, by type. */
+
+        std::map<std::string, unsigned int> nmap;
+
         glist_query() 
         {
                 this->type = QUERY_TYPE_SKIP;
@@ -610,6 +721,10 @@ class ExportAPI list_query  : public QueryBase
 {
     public:
 
+        /* Keys found, by type. */
+
+        std::map<std::string, unsigned int> nmap;
+
         list_query() 
         {
                 this->type = QUERY_TYPE_SKIP;
@@ -620,6 +735,69 @@ class ExportAPI list_query  : public QueryBase
         void Process();
 };
 
+/* 
+ * Runs queries queued by MRUN, one after another and with no other query
+ * running meanwhile. Nothing is run if a watched key has changed. Writes
+ * are gathered, visible to later queries of the transaction, and committed
+ * once all queries ran, in a single write per database.
+ */
+
+class ExportAPI transaction_query  : public QueryBase
+{
+    public:
+
+        /* Queries queued by commands within this transaction, in order. */
+
+        std::vector<std::shared_ptr<QueryBase>> queries;
+
+        /* 
+         * Results to deliver, partial ones included, in order. Each one is
+         * kept along with the position of its query in queries.
+         */
+
+        std::vector<std::pair<size_t, std::shared_ptr<QueryBase>>> results;
+
+        /* 
+         * Replies written directly by commands while these were replayed,
+         * along with the number of queries queued before each one.
+         */
+
+        std::vector<std::pair<size_t, ProtocolTrigger::SerializedMessage>> replies;
+
+        /* Position of query being run. */
+
+        size_t position;
+
+        /* Keys watched by user, released once checked. */
+
+        WatchMap watching;
+
+        /* Watch epoch when first key was watched. */
+
+        uint64_t epoch;
+
+        /* Whether a watched key changed, so nothing was run. */
+
+        bool aborted;
+
+        /* Whether gathered writes could not be committed, so none applied. */
+
+        bool failed;
+
+        transaction_query() : position(0), epoch(0), aborted(false), failed(false)
+        {
+                this->type = QUERY_TYPE_SKIP;
+        }
+
+        ~transaction_query();
+
+        bool Collect(const std::shared_ptr<QueryBase>& result);
+
+        void Run();
+
+        void Process();
+};
+
 class ExportAPI test_dump_query  : public QueryBase
 {
     public:
@@ -918,6 +1096,25 @@ class ExportAPI geoaddnx_query  : public QueryBase
         void Process();
 };
 
+class ExportAPI geomadd_query  : public QueryBase
+{
+    public:
+
+        /* Latitude and longitude of every key in list. */
+
+        std::vector<std::pair<double, double>> positions;
+
+        geomadd_query() 
+        {
+                this->type = QUERY_TYPE_SKIP;
+                this->base_request = INT_GEO;
+        }
+
+        void Run();
+
+        void Process();
+};
+
 class ExportAPI alpha_query  : public QueryBase
 {
     public:
@@ -1555,6 +1752,21 @@ class ExportAPI vavg_query  : public QueryBase
         void Process();
 };
 
+class ExportAPI vtype_query  : public QueryBase
+{
+    public:
+
+        vtype_query() 
+        {
+                this->type = QUERY_TYPE_READ;
+                this->base_request = INT_VECTOR;
+        }
+
+        void Run();
+
+        void Process();
+};
+
 class ExportAPI vreverse_query  : public QueryBase
 {
     public:
@@ -1782,6 +1994,56 @@ class ExportAPI get_query  : public QueryBase
         void Process();
 };
 
+/* 
+ * Multi-key queries: keys are kept in list (and values in VecData for
+ * msetkeys). These queries touch many keys, so they run alone.
+ */
+
+class ExportAPI mgetkeys_query  : public QueryBase
+{
+    public:
+
+        mgetkeys_query() 
+        {
+                this->type = QUERY_TYPE_SKIP;
+                this->base_request = INT_KEY;
+        }
+
+        void Run();
+
+        void Process();
+};
+
+class ExportAPI msetkeys_query  : public QueryBase
+{
+    public:
+
+        msetkeys_query() 
+        {
+                this->type = QUERY_TYPE_SKIP;
+                this->base_request = INT_KEY;
+        }
+
+        void Run();
+
+        void Process();
+};
+
+class ExportAPI mdelkeys_query  : public QueryBase
+{
+    public:
+
+        mdelkeys_query() 
+        {
+                this->type = QUERY_TYPE_SKIP;
+                this->base_request = INT_KEY;
+        }
+
+        void Run();
+
+        void Process();
+};
+
 class ExportAPI getexp_query  : public QueryBase
 {
     public:
@@ -1888,6 +2150,73 @@ class ExportAPI geodistance_query : public QueryBase
         void Process();
 };
 
+/* Spatial searches, answered by GeoIndex. */
+
+class ExportAPI gradius_query : public QueryBase
+{
+    public:
+
+        double latitude;
+
+        double longitude;
+
+        /* Kilometers. */
+
+        double radius;
+
+        gradius_query() : latitude(0), longitude(0), radius(0)
+        {
+                this->type = QUERY_TYPE_SKIP;
+                this->base_request = INT_GEO;
+        }
+
+        void Run();
+
+        void Process();
+};
+
+class ExportAPI gbox_query : public QueryBase
+{
+    public:
+
+        double minlat;
+
+        double minlon;
+
+        double maxlat;
+
+        double maxlon;
+
+        gbox_query() : minlat(0), minlon(0), maxlat(0), maxlon(0)
+        {
+                this->type = QUERY_TYPE_SKIP;
+                this->base_request = INT_GEO;
+        }
+
+        void Run();
+
+        void Process();
+};
+
+class ExportAPI gnearest_query : public QueryBase
+{
+    public:
+
+        double latitude;
+
+        double longitude;
+
+        gnearest_query() : latitude(0), longitude(0)
+        {
+                this->type = QUERY_TYPE_SKIP;
+                this->base_request = INT_GEO;
+        }
+
+        void Run();
+
+        void Process();
+};
+
 class ExportAPI future_list_query  : public QueryBase
 {
     public:
@@ -2006,6 +2335,38 @@ class ExportAPI expireat_query  : public QueryBase
         void Process();
 };
 
+/* Key removed by expire_batch_query. */
+
+struct ExpiredKey
+{
+        /* Schedule of expire, as stored. */
+
+        time_t schedule;
+
+        unsigned int select;
+
+        std::string key;
+};
+
+class ExportAPI expire_batch_query  : public QueryBase
+{
+    public:
+
+        /* Expired keys, all within this query's database. */
+
+        std::vector<ExpiredKey> expired;
+
+        expire_batch_query() 
+        {
+                this->type = QUERY_TYPE_SKIP;
+                this->Required(false);
+        }
+
+        void Run();
+
+        void Process();
+};
+
 class ExportAPI future_exec_query  : public QueryBase
 {
     public:
@@ -2071,6 +2432,10 @@ class ExportAPI mgetall_query  : public QueryBase
 {
     public:
 
+        /* Items found, along with their values. */
+
+        DualMMap mmap;
+
         mgetall_query() 
         {
                 this->type = QUERY_TYPE_READ;
@@ -2101,6 +2466,10 @@ class ExportAPI hgetall_query  : public QueryBase
 {
     public:
 
+        /* Fields found, along with their values. */
+
+        DualMMap mmap;
+
         hgetall_query() 
         {
                 this->type = QUERY_TYPE_READ;
@@ -2191,6 +2560,10 @@ class ExportAPI search_query  : public QueryBase
 {
     public:
 
+        /* Keys found, along with their values. */
+
+        DualMMap mmap;
+
         search_query() 
         {
                 this->type = QUERY_TYPE_SKIP;
@@ -2322,3 +2695,128 @@ class ExportAPI ismatch_query  : public QueryBase
 
         void Process();
 };
+
+/* 
+ * Sorted sets. Members are kept in value (or hesh when a score is given
+ * too), see ZSetStore.
+ */
+
+class ExportAPI zadd_query  : public QueryBase
+{
+    public:
+
+        zadd_query() 
+        {
+                this->type = QUERY_TYPE_WRITE;
+                this->base_request = INT_ZSET;
+        }
+
+        void Run();
+
+        void Process();
+};
+
+class ExportAPI zrem_query  : public QueryBase
+{
+    public:
+
+        zrem_query() 
+        {
+                this->type = QUERY_TYPE_READ;
+                this->base_request = INT_ZSET;
+        }
+
+        void Run();
+
+        void Process();
+};
+
+class ExportAPI zscore_query  : public QueryBase
+{
+    public:
+
+        zscore_query() 
+        {
+                this->type = QUERY_TYPE_READ;
+                this->base_request = INT_ZSET;
+        }
+
+        void Run();
+
+        void Process();
+};
+
+class ExportAPI zcount_query  : public QueryBase
+{
+    public:
+
+        zcount_query() 
+        {
+                this->type = QUERY_TYPE_READ;
+                this->base_request = INT_ZSET;
+        }
+
+        void Run();
+
+        void Process();
+};
+
+class ExportAPI zrank_query  : public QueryBase
+{
+    public:
+
+        zrank_query() 
+        {
+                this->type = QUERY_TYPE_READ;
+                this->base_request = INT_ZSET;
+        }
+
+        void Run();
+
+        void Process();
+};
+
+class ExportAPI zrange_query  : public QueryBase
+{
+    public:
+
+        zrange_query() 
+        {
+                this->type = QUERY_TYPE_READ;
+                this->base_request = INT_ZSET;
+        }
+
+        void Run();
+
+        void Process();
+};
+
+class ExportAPI zrangebyscore_query  : public QueryBase
+{
+    public:
+
+        zrangebyscore_query() 
+        {
+                this->type = QUERY_TYPE_READ;
+                this->base_request = INT_ZSET;
+        }
+
+        void Run();
+
+        void Process();
+};
+
+class ExportAPI zpopmin_query  : public QueryBase
+{
+    public:
+
+        zpopmin_query() 
+        {
+                this->type = QUERY_TYPE_READ;
+                this->base_request = INT_ZSET;
+        }
+
+        void Run();
+
+        void Process();
+};
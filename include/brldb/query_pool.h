@@ -0,0 +1,116 @@
+/*
+ * BerylDB - A lightweight database.
+ * http://www.beryldb.com
+ *
+ * Copyright (C) 2021 - Carlos F. Ferry <cferry@beryldb.com>
+ *
+ * This file is part of BerylDB. BerylDB is free software: you can
+ * redistribute it and/or modify it under the terms of the BSD License
+ * version 3.
+ *
+ * More information about our licensing can be found at https://docs.beryl.dev
+ */
+
+#pragma once
+
+/*
+ * Recycles memory of finished queries, so that dispatching a query does
+ * not go through malloc and free.
+ *
+ * Blocks are kept by size, in classes QUERY_POOL_ALIGN bytes apart. Freed
+ * blocks are pushed onto a shared list of their class, which may be done
+ * from any thread. A thread allocating takes the whole shared list at once
+ * into a list of its own, so blocks are never popped from the shared list
+ * one by one, and no locks are needed. Blocks larger than QUERY_POOL_SIZE
+ * are not pooled.
+ *
+ * Only static functions.
+ */
+
+class ExportAPI QueryPool
+{
+  public:
+
+        /* 
+         * Allocates a block.
+         * 
+         * @parameters:
+	 *
+	 *         · size_t	: Bytes needed.
+	 * 
+         * @return:
+ 	 *
+         *         · void*	: Block allocated.
+         */    
+
+        static void* Allocate(size_t size);
+
+        /* 
+         * Returns a block to the pool, or frees it if its class is full.
+         * 
+         * @parameters:
+	 *
+	 *         · void*	: Block, as returned by Allocate().
+	 *         · size_t	: Bytes requested when it was allocated.
+         */    
+
+        static void Release(void* block, size_t size);
+
+        /* Blocks kept by the pool, waiting to be reused. */
+
+        static size_t Pooled();
+
+        /* Creates a query, along with its control block, using a pooled block. */
+
+        template <typename T>
+        static std::shared_ptr<T> Make();
+};
+
+/* Allocator used by std::allocate_shared, backed by QueryPool. */
+
+template <typename T>
+class QueryAllocator
+{
+  public:
+
+        typedef T value_type;
+
+        QueryAllocator()
+        {
+
+        }
+
+        template <typename U>
+        QueryAllocator(const QueryAllocator<U>&)
+        {
+
+        }
+
+        T* allocate(size_t count)
+        {
+                return static_cast<T*>(QueryPool::Allocate(count * sizeof(T)));
+        }
+
+        void deallocate(T* block, size_t count)
+        {
+                QueryPool::Release(block, count * sizeof(T));
+        }
+
+        template <typename U>
+        bool operator==(const QueryAllocator<U>&) const
+        {
+                return true;
+        }
+
+        template <typename U>
+        bool operator!=(const QueryAllocator<U>&) const
+        {
+                return false;
+        }
+};
+
+template <typename T>
+std::shared_ptr<T> QueryPool::Make()
+{
+        return std::allocate_shared<T>(QueryAllocator<T>());
+}
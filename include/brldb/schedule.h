@@ -0,0 +1,190 @@
+/*
+ * BerylDB - A lightweight database.
+ * http://www.beryldb.com
+ *
+ * Copyright (C) 2021 - Carlos F. Ferry <cferry@beryldb.com>
+ *
+ * This file is part of BerylDB. BerylDB is free software: you can
+ * redistribute it and/or modify it under the terms of the BSD License
+ * version 3.
+ *
+ * More information about our licensing can be found at https://docs.beryl.dev
+ */
+
+#pragma once
+
+#include <map>
+#include <atomic>
+#include <functional>
+
+/* Counters of keys, used by ScheduleIndex::MayHave(). */
+
+const unsigned int SCHEDULE_MARKS = 4096;
+
+/*
+ * Timed entries (expires and futures), sorted by schedule and indexed by
+ * database, select and key. Entries are expected to provide schedule,
+ * database, select and key members.
+ *
+ * Lookups and removals by key run in constant time, while insertions
+ * run in O(log n). Callers are in charge of locking, except for MayHave(),
+ * which lets hot paths skip both the lock and the lookup for keys that
+ * have no entry.
+ */
+
+template <typename Entry>
+class ScheduleIndex
+{
+  public:
+
+        typedef std::multimap<time_t, Entry> Timeline;
+
+  private:
+
+        /* Entries, sorted by schedule. */
+
+        Timeline timeline;
+
+        /* Position of every entry in timeline. */
+
+        STR1::unordered_map<std::string, typename Timeline::iterator> index;
+
+        /* Entries counted by hash of their key, readable without locking. */
+
+        std::atomic<unsigned int> marks[SCHEDULE_MARKS];
+
+        void Mark(const std::string& key, int delta)
+        {
+                this->marks[std::hash<std::string>()(key) % SCHEDULE_MARKS].fetch_add(delta, std::memory_order_relaxed);
+        }
+
+  public:
+
+        ScheduleIndex()
+        {
+                for (unsigned int i = 0; i < SCHEDULE_MARKS; i++)
+                {
+                        this->marks[i].store(0, std::memory_order_relaxed);
+                }
+        }
+
+        /*
+         * Formats an index key.
+         *
+         * @parameters:
+	 *
+	 *         · Database	: Database of entry.
+	 *         · string	: Key of entry.
+	 *         · uint	: Select of entry.
+	 *
+         * @return:
+ 	 *
+         *         · string	: Index key.
+         */
+
+        static std::string Lookup(const std::shared_ptr<Database>& database, const std::string& key, unsigned int select)
+        {
+                return database->GetName() + ":" + convto_string(select) + ":" + key;
+        }
+
+        /* Adds an entry, replacing any entry with the same key. */
+
+        void Add(const Entry& entry)
+        {
+                this->Remove(entry.database, entry.key, entry.select);
+                this->index[Lookup(entry.database, entry.key, entry.select)] = this->timeline.insert(std::make_pair(entry.schedule, entry));
+                this->Mark(entry.key, 1);
+        }
+
+        /*
+         * Checks, without locking, whether a key may have an entry in any
+         * database or select. False positives are possible, as keys share
+         * counters, but a key with an entry is never missed.
+         */
+
+        bool MayHave(const std::string& key) const
+        {
+                return (this->marks[std::hash<std::string>()(key) % SCHEDULE_MARKS].load(std::memory_order_relaxed) != 0);
+        }
+
+        /*
+         * Finds an entry.
+         *
+         * @return:
+ 	 *
+         *         · Entry	: Entry found, or NULL.
+         */
+
+        Entry* Find(const std::shared_ptr<Database>& database, const std::string& key, unsigned int select)
+        {
+                typename STR1::unordered_map<std::string, typename Timeline::iterator>::iterator it = this->index.find(Lookup(database, key, select));
+
+                if (it == this->index.end())
+                {
+                        return NULL;
+                }
+
+                return &it->second->second;
+        }
+
+        /*
+         * Removes an entry.
+         *
+         * @return:
+ 	 *
+         *         · True: Entry removed. False: Not found.
+         */
+
+        bool Remove(const std::shared_ptr<Database>& database, const std::string& key, unsigned int select)
+        {
+                typename STR1::unordered_map<std::string, typename Timeline::iterator>::iterator it = this->index.find(Lookup(database, key, select));
+
+                if (it == this->index.end())
+                {
+                        return false;
+                }
+
+                this->Mark(key, -1);
+                this->timeline.erase(it->second);
+                this->index.erase(it);
+                return true;
+        }
+
+        /*
+         * Removes an entry while walking the timeline.
+         *
+         * @return:
+ 	 *
+         *         · iterator	: Entry following the removed one.
+         */
+
+        typename Timeline::iterator Erase(typename Timeline::const_iterator it)
+        {
+                this->index.erase(Lookup(it->second.database, it->second.key, it->second.select));
+                this->Mark(it->second.key, -1);
+                return this->timeline.erase(it);
+        }
+
+        /* Entries, sorted by schedule. */
+
+        const Timeline& GetTimeline()
+        {
+                return this->timeline;
+        }
+
+        unsigned int Count()
+        {
+                return this->timeline.size();
+        }
+
+        void Clear()
+        {
+                this->timeline.clear();
+                this->index.clear();
+
+                for (unsigned int i = 0; i < SCHEDULE_MARKS; i++)
+                {
+                        this->marks[i].store(0, std::memory_order_relaxed);
+                }
+        }
+};
@@ -14,7 +14,9 @@
 #pragma once
 
 #include <algorithm>
-#include <vector>  
+#include <vector>
+
+#include "brldb/packed_vector.h"  
 
 class ExportAPI VectorHandler
 {
@@ -22,6 +24,10 @@ class ExportAPI VectorHandler
     
         StringVector mhandler;
 
+        /* Items are stored packed, unless VECTOR_TYPE_STRING. */
+
+        VECTOR_TYPE numeric;
+
         HANDLER_MSG LastMsg;
      
   public:
@@ -55,6 +61,25 @@ class ExportAPI VectorHandler
          
         bool IsNumeric();
 
+        /* 
+         * Changes the way items are stored.
+         * 
+         * @parameters:
+	 *
+	 *         · VECTOR_TYPE: New type.
+	 * 
+         * @return:
+ 	 *
+         *         · True: All items are valid for given type.
+         */    
+
+        bool SetType(VECTOR_TYPE type);
+
+        VECTOR_TYPE GetType()
+        {
+                return this->numeric;
+        }
+
         double GetHigh();
         
         double GetLow();
@@ -140,7 +165,7 @@ class ExportAPI VectorHandler
         void Resize(unsigned int size)
         {
                this->LastMsg = HANDLER_MSG_OK;
-               this->mhandler.resize(size);
+               this->mhandler.resize(size, this->numeric == VECTOR_TYPE_STRING ? "" : "0");
         }
 
         /* 
@@ -157,13 +182,9 @@ class ExportAPI VectorHandler
          
         std::vector<std::string> Find(const std::string& key);
 
-        /* Sors vector */
+        /* Sorts vector. Numeric vectors are sorted by value. */
         
-        void Sort()
-        {
-               this->LastMsg = HANDLER_MSG_OK;
-               std::sort(this->mhandler.begin(), this->mhandler.end());
-        }
+        void Sort();
         
         std::string Front();
         
@@ -0,0 +1,129 @@
+/*
+ * BerylDB - A lightweight database.
+ * http://www.beryldb.com
+ *
+ * Copyright (C) 2021 - Carlos F. Ferry <cferry@beryldb.com>
+ *
+ * This file is part of BerylDB. BerylDB is free software: you can
+ * redistribute it and/or modify it under the terms of the BSD License
+ * version 3.
+ *
+ * More information about our licensing can be found at https://docs.beryl.dev
+ */
+
+#pragma once
+
+#include <atomic>
+#include <mutex>
+
+/* Watched keys, along with their version when watched. */
+
+typedef std::map<std::string, uint64_t> WatchMap;
+
+/*
+ * Versions of keys being watched (see WATCH).
+ *
+ * Only watched keys are tracked. Data threads bump the version of a key
+ * once a query writes to it, and bump a global epoch after queries that
+ * may write to keys they do not know of (see DataFlush::Touched). A transaction whose
+ * watched keys changed is aborted; changes are never missed, though a
+ * few may be reported that did not happen.
+ */
+
+class ExportAPI WatchTable : public safecast<WatchTable>
+{
+  private:
+
+        struct Entry
+        {
+                uint64_t version;
+
+                /* Users (or transactions) watching this key. */
+
+                unsigned int watchers;
+        };
+
+        std::mutex lock;
+
+        std::unordered_map<std::string, Entry> entries;
+
+        /* Same as entries.size(), read without locking. */
+
+        std::atomic<size_t> watched;
+
+        std::atomic<uint64_t> epoch;
+
+  public:
+
+        /* Constructor. */
+
+        WatchTable();
+
+        /* 
+         * Builds the id of a key.
+         * 
+         * @parameters:
+	 *
+	 *         · Database	: Database of key.
+	 *         · uint	: Select of key.
+	 *         · string	: Key.
+	 * 
+         * @return:
+ 	 *
+         *         · string	: Id of key.
+         */    
+
+        static std::string Build(const std::shared_ptr<Database>& database, unsigned int select, const std::string& key);
+
+        /* Whether any key is being watched. */
+
+        bool Active() const
+        {
+                return (this->watched.load(std::memory_order_relaxed) > 0);
+        }
+
+        uint64_t GetEpoch() const
+        {
+                return this->epoch.load();
+        }
+
+        /* 
+         * Starts watching a key.
+         * 
+         * @return:
+ 	 *
+         *         · uint64_t	: Current version of key.
+         */    
+
+        uint64_t Watch(const std::string& id);
+
+        /* Stops watching keys. */
+
+        void Unwatch(const WatchMap& keys);
+
+        /* 
+         * Checks whether watched keys have changed.
+         * 
+         * @parameters:
+	 *
+	 *         · WatchMap	: Keys, along with their version when watched.
+	 *         · uint64_t	: Epoch when first key was watched.
+	 * 
+         * @return:
+ 	 *
+         *         · True: A key may have changed.
+         */    
+
+        bool Changed(const WatchMap& keys, uint64_t since);
+
+        /* Called after a key has been written to. */
+
+        void Touch(const std::string& id);
+
+        /* Called after a query that may have written to any key. */
+
+        void TouchAll()
+        {
+                this->epoch++;
+        }
+};
@@ -0,0 +1,203 @@
+/*
+ * BerylDB - A lightweight database.
+ * http://www.beryldb.com
+ *
+ * Copyright (C) 2021 - Carlos F. Ferry <cferry@beryldb.com>
+ *
+ * This file is part of BerylDB. BerylDB is free software: you can
+ * redistribute it and/or modify it under the terms of the BSD License
+ * version 3.
+ *
+ * More information about our licensing can be found at https://docs.beryl.dev
+ */
+
+#pragma once
+
+#include <list>
+#include <mutex>
+
+typedef std::pair<std::string, double> ZSetItem;
+
+typedef std::vector<ZSetItem> ZSetItems;
+
+/*
+ * Order-statistics index of a sorted set: a skiplist in which every link
+ * knows how many items it skips, so that ranks can be found, and items
+ * visited by rank, in O(log n).
+ *
+ * Items are sorted by score, and then by member, as they are sorted on
+ * disk (see ZSetStore).
+ */
+
+class ExportAPI ZSetIndex
+{
+  private:
+
+        struct Node;
+
+        struct Link
+        {
+                Node* node;
+
+                /* Items skipped by following this link. */
+
+                size_t span;
+        };
+
+        struct Node
+        {
+                std::string member;
+
+                double score;
+
+                std::vector<Link> next;
+        };
+
+        Node* head;
+
+        /* Levels in use. */
+
+        unsigned int level;
+
+        size_t length;
+
+        static bool Before(const Node* node, double score, const std::string& member);
+
+        static unsigned int RandomLevel();
+
+  public:
+
+        /* Constructor. */
+
+        ZSetIndex();
+
+        /* Destructor. */
+
+        ~ZSetIndex();
+
+        /* Adds an item. Item must not be already indexed. */
+
+        void Insert(double score, const std::string& member);
+
+        /*
+         * Removes an item.
+         *
+         * @return:
+ 	 *
+         *         · True: Item was indexed.
+         */
+
+        bool Erase(double score, const std::string& member);
+
+        /*
+         * Finds the rank of an item.
+         *
+         * @return:
+ 	 *
+         *         · signed long	: Zero based rank, or -1 if not found.
+         */
+
+        signed long Rank(double score, const std::string& member) const;
+
+        /*
+         * Reads items by rank.
+         *
+         * @parameters:
+	 *
+	 *         · size_t		: Zero based rank of first item.
+	 *         · size_t		: Items to read.
+	 *         · ZSetItems	: Items found.
+         */
+
+        void Range(size_t start, size_t count, ZSetItems& items) const;
+
+        size_t Count() const
+        {
+                return this->length;
+        }
+};
+
+/*
+ * Keeps indexes of recently ranked sorted sets. Indexes are keyed by
+ * database and container id, as ids are never reused, and are dropped
+ * in LRU order when too many items are indexed.
+ *
+ * An index is only used by the data thread handling its key.
+ */
+
+class ExportAPI ZSetCache : public safecast<ZSetCache>
+{
+  private:
+
+        struct Entry
+        {
+                std::string name;
+
+                std::shared_ptr<ZSetIndex> index;
+
+                /* Items this entry accounts for. */
+
+                size_t counted;
+        };
+
+        std::mutex lock;
+
+        /* Most recently used entries first. */
+
+        std::list<Entry> entries;
+
+        std::unordered_map<std::string, std::list<Entry>::iterator> lookup;
+
+        /* Max. items indexed. 0 disables indexes. */
+
+        size_t budget;
+
+        size_t used;
+
+        static std::string Build(const std::shared_ptr<Database>& database, uint64_t id);
+
+        /* Drops least recently used entries until budget is met. */
+
+        void Trim();
+
+  public:
+
+        /* Constructor. */
+
+        ZSetCache();
+
+        /*
+         * Sets up the cache. Indexes already built are dropped.
+         *
+         * @parameters:
+	 *
+	 *         · size_t	: Maximum items indexed.
+         */
+
+        void Configure(size_t items);
+
+        bool Enabled() const
+        {
+                return this->budget != 0;
+        }
+
+        /* Returns index of a sorted set, or NULL if not indexed. */
+
+        std::shared_ptr<ZSetIndex> Find(const std::shared_ptr<Database>& database, uint64_t id);
+
+        /* Keeps a new index. Indexes larger than the budget are not kept. */
+
+        void Add(const std::shared_ptr<Database>& database, uint64_t id, const std::shared_ptr<ZSetIndex>& index);
+
+        /* Drops index of a sorted set. */
+
+        void Drop(const std::shared_ptr<Database>& database, uint64_t id);
+
+        /* Drops all indexes of a database. */
+
+        void Clear(const std::string& dbname);
+
+        /* Counts indexed sets. */
+
+        size_t Count();
+};
@@ -0,0 +1,240 @@
+/*
+ * BerylDB - A lightweight database.
+ * http://www.beryldb.com
+ *
+ * Copyright (C) 2021 - Carlos F. Ferry <cferry@beryldb.com>
+ *
+ * This file is part of BerylDB. BerylDB is free software: you can
+ * redistribute it and/or modify it under the terms of the BSD License
+ * version 3.
+ *
+ * More information about our licensing can be found at https://docs.beryl.dev
+ */
+
+#pragma once
+
+#include "brldb/zset_index.h"
+
+/*
+ * Sorted sets are stored as a registry entry (id:count), plus two entries
+ * per member in the INT_ZSET_ITEM family (see Container):
+ *
+ *         · id + 'm' + member			: Score of member.
+ *         · id + 's' + score + member		: Empty, sorted by score.
+ *
+ * Scores are encoded so that they sort as numbers do, thus score ranges
+ * and lowest members are found with a single seek. Ranks are found using
+ * a ZSetIndex, built on first use and kept in Kernel->Store->ZSets.
+ */
+
+class ExportAPI ZSetStore
+{
+  private:
+
+        std::shared_ptr<Database> database;
+
+        /* Registry entry of this set (key:select:INT_ZSET). */
+
+        std::string dest;
+
+        /* Container id. */
+
+        uint64_t id;
+
+        /* Members stored. */
+
+        uint64_t count;
+
+        /*
+         * Writes registry entry, or removes it if this set is empty.
+         *
+         * @parameters:
+	 *
+	 *         · WriteBatch	: Batch to append to.
+         *
+         * @return:
+ 	 *
+         *         · True: Batch written.
+         */
+
+        bool Commit(rocksdb::WriteBatch& batch);
+
+        /* Returns key of a member entry. */
+
+        std::string MemberKey(const std::string& member);
+
+        /* Returns key of a score entry. */
+
+        std::string ScoreKey(double score, const std::string& member);
+
+        /* Returns index of this set, building it if needed. NULL if indexes are disabled. */
+
+        std::shared_ptr<ZSetIndex> GetIndex();
+
+  public:
+
+        /*
+         * Constructor.
+         *
+         * @parameters:
+	 *
+	 *         · Database	: Database holding this set.
+	 *         · string	: Registry entry.
+         */
+
+        ZSetStore(std::shared_ptr<Database> db, const std::string& regdest);
+
+        /*
+         * Loads a registry value.
+         *
+         * @parameters:
+	 *
+	 *         · string	: Registry value, as read from dest.
+	 *
+         * @return:
+ 	 *
+         *         · True: Valid registry.
+         */
+
+        bool Load(const std::string& registry);
+
+        /* Initializes an empty set, using a new container id. */
+
+        void Create();
+
+        unsigned int Count()
+        {
+                return this->count;
+        }
+
+        /*
+         * Adds a member, or updates its score.
+         *
+         * @parameters:
+	 *
+	 *         · string	: Member.
+	 *         · double	: Score.
+	 *
+         * @return:
+ 	 *
+         *         · int	: 1 if added, 0 if updated, -1 on failure.
+         */
+
+        int Add(const std::string& member, double score);
+
+        /*
+         * Finds score of a member.
+         *
+         * @return:
+ 	 *
+         *         · True: Member found.
+         */
+
+        bool Score(const std::string& member, double& score);
+
+        /*
+         * Removes a member.
+         *
+         * @return:
+ 	 *
+         *         · True: Member removed.
+         */
+
+        bool Remove(const std::string& member);
+
+        /*
+         * Removes member with lowest score.
+         *
+         * @parameters:
+	 *
+	 *         · ZSetItem	: Member removed, along with its score.
+	 *
+         * @return:
+ 	 *
+         *         · True: Member removed.
+         */
+
+        bool PopMin(ZSetItem& item);
+
+        /*
+         * Finds rank of a member.
+         *
+         * @return:
+ 	 *
+         *         · signed long	: Zero based rank, or -1 if not found.
+         */
+
+        signed long Rank(const std::string& member);
+
+        /*
+         * Reads members by rank. Negative ranks count from the end.
+         *
+         * @parameters:
+	 *
+	 *         · long	: First rank.
+	 *         · long	: Last rank, included.
+	 *         · ZSetItems	: Members found.
+         */
+
+        void Range(signed long start, signed long stop, ZSetItems& items);
+
+        /*
+         * Reads members within a score range.
+         *
+         * @parameters:
+	 *
+	 *         · double	: Lowest score.
+	 *         · double	: Highest score, included.
+	 *         · ZSetItems	: Members found.
+	 *         · size_t	: Max. members to read.
+         */
+
+        void RangeByScore(double min, double max, ZSetItems& items, size_t limit);
+
+        /*
+         * Removes all members, along with the registry entry.
+         *
+         * @return:
+ 	 *
+         *         · True: Set removed.
+         */
+
+        bool Erase();
+
+        /*
+         * Copies all members into a new set.
+         *
+         * @parameters:
+	 *
+	 *         · Database	: Target database.
+	 *         · string	: Target registry entry.
+	 *
+         * @return:
+ 	 *
+         *         · True: Set copied.
+         */
+
+        bool CopyTo(std::shared_ptr<Database> target, const std::string& newdest);
+
+        /* Encodes a score, so that encoded scores sort as numbers do. */
+
+        static std::string EncodeScore(double score);
+
+        /* Decodes an encoded score. */
+
+        static double DecodeScore(const char* data);
+
+        /*
+         * Parses a score, or a score range limit (-inf and +inf are allowed).
+         *
+         * @return:
+ 	 *
+         *         · True: Valid score.
+         */
+
+        static bool ParseScore(const std::string& text, double& score);
+
+        /* Formats a score so it can be parsed back without losing precision. */
+
+        static std::string FormatScore(double score);
+};
@@ -89,7 +89,41 @@ class ExportAPI StreamSocket : public EventHandler
 	{
   	  public:
 		
-		typedef std::string Element;
+		/* 
+		 * Data to send. Messages sent to many users (see Channel::Write)
+		 * are shared by all their queues, rather than copied.
+		 */
+
+		class Element
+		{
+		  private:
+
+			std::string owned;
+
+			std::shared_ptr<const std::string> shared;
+
+			/* Bytes already sent. */
+
+			size_t offset;
+
+		  public:
+
+			Element(const std::string& newdata) : owned(newdata), offset(0) { }
+
+			Element(std::string&& newdata) : owned(std::move(newdata)), offset(0) { }
+
+			Element(const std::shared_ptr<const std::string>& newdata) : shared(newdata), offset(0) { }
+
+			const char* data() const { return (shared ? shared->data() : owned.data()) + offset; }
+
+			size_t length() const { return (shared ? shared->length() : owned.length()) - offset; }
+
+			size_t size() const { return length(); }
+
+			/* Skips bytes already sent. */
+
+			void consume(size_t n) { offset += n; }
+		};
 
 		
 		typedef std::deque<Element> Container;
@@ -125,10 +159,10 @@ class ExportAPI StreamSocket : public EventHandler
 		}
 
 		
-		void erase_front(Element::size_type n)
+		void erase_front(size_t n)
 		{
 			nbytes -= n;
-			data.front().erase(0, n);
+			data.front().consume(n);
 		}
 
 		
@@ -146,6 +180,20 @@ class ExportAPI StreamSocket : public EventHandler
 		}
 
 		
+		void push_back(Element&& newdata)
+		{
+			nbytes += newdata.length();
+			data.push_back(std::move(newdata));
+		}
+
+		
+		void push_back(std::string&& newdata)
+		{
+			nbytes += newdata.length();
+			data.push_back(Element(std::move(newdata)));
+		}
+
+		
 		void clear()
 		{
 			data.clear();
@@ -209,6 +257,18 @@ class ExportAPI StreamSocket : public EventHandler
 	
 	std::string recvq;
 
+	/* Bytes at the front of recvq already consumed. Removed once per read, not once per line. */
+
+	std::string::size_type recvpos;
+
+	/* Marks bytes of recvq as consumed. */
+
+	void Consume(std::string::size_type count);
+
+	/* Removes consumed bytes from recvq. */
+
+	void Compact();
+
 	
 	void swap_internal(StreamSocket& other);
 
@@ -219,6 +279,7 @@ class ExportAPI StreamSocket : public EventHandler
 		: closeonempty(false)
 		, closing(false)
 		, ioattach(NULL)
+		, recvpos(0)
 		, type(sstype)
 	{
 	
@@ -259,6 +320,12 @@ class ExportAPI StreamSocket : public EventHandler
 
 	
 	void AppendBuffer(const std::string& data);
+
+	void AppendBuffer(std::string&& data);
+
+	/* Queues data shared with other sockets, without copying it. */
+
+	void AppendBuffer(const std::shared_ptr<const std::string>& data);
 	
 	bool find_next_line(std::string& line, char delim = '\n');
 	
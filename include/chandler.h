@@ -124,6 +124,15 @@ class ExportAPI CommandModel : public ServiceProvider
 		
 		}
 
+		/* Takes parameters parsed, as these may be large. */
+
+		Params(std::vector<std::string>&& paramsref, ProtocolTrigger::TagMap&& tagsref)
+			: std::vector<std::string>(std::move(paramsref))
+			, tags(std::move(tagsref))
+		{
+		
+		}
+
 		
 		template<typename Iterator> Params(Iterator first, Iterator last) : std::vector<std::string>(first, last)
 		{
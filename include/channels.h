@@ -63,6 +63,14 @@ class ExportAPI Channel : public Expandable
 	
 	SubscriptionMap subscribedlist;
 
+	/* 
+	 * Subscriptions of local users, kept flat so that messages are
+	 * written to large channels without walking subscribedlist.
+	 * Each subscription keeps its own position, so removals are O(1).
+	 */
+
+	std::vector<Subscription*> locals;
+
 	/* Channel constructor. */
 	
 	Channel(const std::string &name, time_t current);
@@ -225,7 +225,7 @@ class ProtocolTrigger::Message : public ProtocolTrigger::MessageSource
 	typedef std::vector<Param> ParamList;
 
  private:
-	typedef std::vector<std::pair<SerializedData, SerializedMessage> > SerializedList;
+	typedef std::vector<std::pair<SerializedData, SharedMessage> > SerializedList;
 
 	ParamList params;
 	TagMap tags;
@@ -311,7 +311,7 @@ class ProtocolTrigger::Message : public ProtocolTrigger::MessageSource
 	}
 
 	
-	const SerializedMessage& GetSerialized(const SerializedData& serializeinfo) const;
+	const SharedMessage& GetSerialized(const SerializedData& serializeinfo) const;
 
 	
 	void ClearParams()
@@ -503,13 +503,41 @@ class ExportAPI ProtocolTrigger::Serializer : public DataProvider
 	bool HandleTag(LocalUser* user, const std::string& tagname, std::string& tagvalue, TagMap& tags) const;
 
 	
-	const SerializedMessage& SerializeForUser(LocalUser* user, Message& msg);
+	const SharedMessage& SerializeForUser(LocalUser* user, Message& msg);
 
 	
 	virtual std::string Serialize(const Message& msg, const TagSelection& tagwl) const = 0;
 
 	
 	virtual bool Parse(LocalUser* user, const std::string& line, ParseOutput& parseoutput) = 0;
+
+	/* Whether input is read with Extract(), rather than line by line. */
+
+	virtual bool IsFramed() const
+	{
+		return false;
+	}
+
+	/* 
+	 * Extracts next command from input, for serializers whose input 
+	 * is not split in lines.
+	 *
+	 * @parameters:
+	 *
+	 *         · string	: Input received.
+	 *         · size_t	: Offset of first byte not consumed yet.
+	 *         · FrameState	: Progress of the command, kept by the caller between reads.
+	 *         · ParseOutput	: Command found, if any.
+	 *
+	 * @return:
+	 *
+	 *         · long	: Bytes consumed, 0 if more input is needed, or -1 if input is malformed.
+	 */
+
+	virtual long Extract(LocalUser* user, const std::string& input, std::string::size_type pos, FrameState& frame, ParseOutput& parseoutput)
+	{
+		return -1;
+	}
 };
 
 inline ProtocolTrigger::MessageProvider::MessageProvider(MessageDataProvider* prov, const std::string& val, void* data)
@@ -23,7 +23,7 @@ struct PendingCMD
         
         /* Constructor, sets variables. */
         
-        PendingCMD(LocalUser* usr, const CommandModel::Params cmd_paramsarams, const std::string& cmd) : user(usr), cmd_params(cmd_paramsarams), command(cmd)
+        PendingCMD(LocalUser* usr, CommandModel::Params&& cmd_paramsarams, const std::string& cmd) : user(usr), cmd_params(std::move(cmd_paramsarams)), command(cmd)
         {
         
         }
@@ -44,7 +44,7 @@ class ExportAPI CommandQueue : public safecast<CommandQueue>
 	 *
 	 *         · user: User that is requesting this new command.
 	 *         · command: Command requested.
-	 *         · cmd_params: Command's parameters.
+	 *         · cmd_params: Command's parameters, moved into the queue.
          */          
 
         void Add(LocalUser* user, const std::string& command, CommandModel::Params& cmd_params);
@@ -52,13 +52,28 @@ class ExportAPI CommandQueue : public safecast<CommandQueue>
         /* 
          * Runs pending commands. 
          * This function is called from mainloop and runs constantly.
+         *
+         * @return:
+ 	 *
+         *         · True: Commands were run, so the mainloop should not sleep.
          */    
 	
-	void Flush();
+	bool Flush();
 
         /* Resets pending flushes. */
         
         void Reset();
+
+        /* 
+         * Runs commands queued since MULTI. Their queries are captured into
+         * a single transaction query, run as a whole (see MRUN).
+         *
+         * @parameters:
+	 *
+	 *         · user: User running MRUN.
+         */    
+
+        void Transaction(LocalUser* user);
 };
 
 class ExportAPI CommandHandler : public safecast<CommandHandler>
@@ -96,6 +111,10 @@ class ExportAPI CommandHandler : public safecast<CommandHandler>
 
 	 void ProcessBuffer(LocalUser* user, const std::string& buffer);
 
+	 /* Queues a command parsed by a serializer. Commands left empty are ignored. */
+
+	 void ProcessOutput(LocalUser* user, ProtocolTrigger::ParseOutput& parseoutput);
+
         /* 
          * Adds a command to the command handler.
          * 
@@ -76,11 +76,56 @@ struct DBOptions
         unsigned int datathread;
         
         unsigned int yieldusec;
+
+        unsigned int depth;
+
+        /* Times an idle data thread checks for queries before sleeping. */
+
+        unsigned int spin;
+
+        /* Whether data threads are bound to a core each. */
+
+        bool pinthreads;
         
         bool createim;
         
         bool pipeline;
         
+        bool migrate;
+
+        /* Shared block cache, in MB. 0 disables it. */
+
+        unsigned int cachesize;
+
+        /* Block cache type: lru or hyperclock. */
+
+        std::string cachetype;
+
+        /* Bloom filter bits per key. 0 disables filters. */
+
+        unsigned int bloombits;
+
+        /* Whether filters include whole keys, besides prefixes. */
+
+        bool wholekey;
+
+        /* Compression used on upper levels, and on the bottommost one. */
+
+        std::string compression;
+
+        std::string bottommost;
+
+        /* Memtable budget shared by all databases, in MB. 0 means unlimited. */
+
+        unsigned int writebuffer;
+
+        /* Entries kept in the hot key cache. 0 disables it. */
+
+        unsigned int hotkeys;
+
+        /* Sorted set members kept in rank indexes. 0 disables them. */
+
+        unsigned int zsetitems;
 };
 
 /* Stores user-cmd line arguments. */
@@ -170,6 +215,14 @@ class ExportAPI Configuration
 	std::atomic<bool> KeepExpires;
 	
 	std::atomic<bool> KeepFutures;
+
+	/* Maximum keys expired on every flush. */
+
+	unsigned int ExpireBatch;
+
+	/* Whether overdue keys are removed when read. */
+
+	bool LazyExpire;
 	
 	bool WildcardIPv6;
 
@@ -197,6 +250,14 @@ class ExportAPI Configuration
 	
 	unsigned int MaxClients;
 
+	/* Max amount of commands run per client on every loop. */
+	
+	unsigned int Pipeline;
+
+	/* Threads verifying passwords (see AuthPool). */
+	
+	unsigned int AuthThreads;
+
 	
         bool RawLog;
 
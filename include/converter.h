@@ -17,34 +17,96 @@
 #include <sstream>
 
 /* 
- * Converts binary to string.
+ * Storage formats. BRLD_FORMAT_LEGACY expands every byte into eight
+ * '0'/'1' characters, while BRLD_FORMAT_COMPACT keeps bytes as they are
+ * and only escapes the separators used by our keys and values.
+ * BRLD_FORMAT_FAMILIES uses compact encoding, storing every type in
+ * its own column family. BRLD_FORMAT_LISTS stores list items as 
+ * individual entries, and BRLD_FORMAT_MAPS does the same for map and
+ * multimap fields. BRLD_FORMAT_GEOS adds a spatial index of geo entries,
+ * and BRLD_FORMAT_POSITIONS stores geo entries as two packed doubles.
+ */
+
+enum BRLD_FORMAT
+{
+       BRLD_FORMAT_NONE         =       0,
+       BRLD_FORMAT_LEGACY       =       1,
+       BRLD_FORMAT_COMPACT      =       2,
+       BRLD_FORMAT_FAMILIES     =       3,
+       BRLD_FORMAT_LISTS        =       4,
+       BRLD_FORMAT_MAPS         =       5,
+       BRLD_FORMAT_GEOS         =       6,
+       BRLD_FORMAT_POSITIONS    =       7,
+       BRLD_FORMAT_CURRENT      =       BRLD_FORMAT_POSITIONS
+};
+
+/* Escape byte used by the compact format. */
+
+const char BIN_ESCAPE = '\x1b';
+
+/* 
+ * Decodes an entry stored in compact format, appending it to a given
+ * string. Useful to build large replies without extra copies.
  * 
  * @parameters:
  *
- *         · string: Binary data.
+ *         · char	: Encoded data.
+ *         · size_t	: Length of data.
+ *         · string	: Output to append to.
+ */ 
+
+inline void to_string(const char* data, std::size_t size, std::string& output)
+{
+         output.reserve(output.size() + size);
+
+         for (std::size_t i = 0; i < size; ++i)
+         {
+              const char c = data[i];
+
+              if (c != BIN_ESCAPE || i + 1 == size)
+              {
+                   output += c;
+                   continue;
+              }
+
+              switch (data[++i])
+              {
+                   case '1':
+                        output += ':';
+                   break;
+
+                   case '2':
+                        output += '/';
+                   break;
+
+                   default:
+                        output += BIN_ESCAPE;
+              }
+         }
+}
+
+/* 
+ * Decodes an entry stored in compact format.
+ * 
+ * @parameters:
+ *
+ *         · string: Encoded data.
  * 
  * @return:
  *
- *         · string: ASCII text.
+ *         · string: Original data.
  */ 
 
 inline std::string to_string(const std::string& data)
 {
-         std::stringstream sstream(data);
          std::string output;
-         std::bitset<8> bits;
-
-         while (sstream >> bits)
-         {
-              char c = char(bits.to_ulong());
-              output += c;
-         }
-
+         to_string(data.data(), data.size(), output);
          return output;
 }
 
 /* 
- * Converts a string to binary.
+ * Encodes a string using the compact format. Separators (':' and '/')
+ * are escaped, so encoded entries can be joined together safely.
  * 
  * @parameters:
  *
@@ -52,21 +114,76 @@ inline std::string to_string(const std::string& data)
  * 
  * @return:
  *
- *         · string: Binary data.
+ *         · string: Encoded data.
  */ 
  
 inline std::string to_bin(const std::string& data)
 {
         std::string result;
+        result.reserve(data.size());
 
         for (std::size_t i = 0; i < data.size(); ++i)
         {
-              result.append(std::bitset<8>(data[i]).to_string());  
+              const char c = data[i];
+
+              switch (c)
+              {
+                   case BIN_ESCAPE:
+                        result += BIN_ESCAPE;
+                        result += '0';
+                   break;
+
+                   case ':':
+                        result += BIN_ESCAPE;
+                        result += '1';
+                   break;
+
+                   case '/':
+                        result += BIN_ESCAPE;
+                        result += '2';
+                   break;
+
+                   default:
+                        result += c;
+              }
         }
 
         return result;
 }
 
+/* 
+ * Converts legacy binary data (eight '0'/'1' characters per byte) 
+ * to a string. Only used while migrating old databases.
+ * 
+ * @parameters:
+ *
+ *         · string: Binary data.
+ * 
+ * @return:
+ *
+ *         · string: ASCII text.
+ */ 
+
+inline std::string legacy_to_string(const std::string& data)
+{
+         std::string output;
+         output.reserve(data.size() / 8);
+
+         for (std::size_t i = 0; i + 8 <= data.size(); i += 8)
+         {
+              unsigned char c = 0;
+
+              for (std::size_t j = 0; j < 8; ++j)
+              {
+                    c = (c << 1) | (data[i + j] == '1');
+              }
+
+              output += (char)c;
+         }
+
+         return output;
+}
+
 /* Checks whether a string has quotes (start and end) */
 
 inline bool is_correct(const std::string& str)
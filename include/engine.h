@@ -492,9 +492,10 @@ class ExportAPI Dispatcher : public safecast<Dispatcher>
          *         · string    : Title that a given returning title has.
          *         · string    : Subtitle to utilize.
          *         · QueryBase : Original query. 
+         *         · DualMMap  : Items to flush.
          */  
          
-        static void MMapFlush(bool comillas, const std::string& title, const std::string& subtitle, QueryBase* query);
+        static void MMapFlush(bool comillas, const std::string& title, const std::string& subtitle, QueryBase* query, const DualMMap& items);
         
         /* 
          * This function is used when creating a string that cotains repeated 
@@ -99,6 +99,7 @@ class ExportAPI User : public Expandable
     
    friend class DataFlush;
    friend class LocalUser;
+   friend class AuthPool;
    
    private:
    
@@ -118,9 +119,28 @@ class ExportAPI User : public Expandable
         
         static std::mutex db_mute;
         
-        /* Whether this user is busy. */
+        /* Queries dispatched to data threads, whose results are not yet delivered. */
         
-        bool Locked;
+        unsigned int inflight;
+
+        /* Sequence given to next query. */
+
+        uint64_t issued;
+
+        /* Sequence of next result to deliver. */
+
+        uint64_t delivered;
+
+        /* 
+         * Sequence of last exclusive query queued (see QueryBase::Exclusive).
+         * Commands that follow it wait until its result is delivered.
+         */
+
+        uint64_t barrier;
+
+        /* Whether results are being delivered to this user. */
+
+        bool delivering;
 
 	std::string cached_user_real_host;
 	
@@ -146,9 +166,21 @@ class ExportAPI User : public Expandable
 	
 	bool Multi;
 	
-	/* Wether this user is currently flushing his multi queue. */
+	/* Transaction being built by MRUN, capturing queries queued meanwhile. */
+	
+	std::shared_ptr<transaction_query> Transaction;
+	
+	/* Keys watched by this user (see WATCH). */
+	
+	WatchMap Watching;
+	
+	/* Watch epoch when first key was watched. */
 	
-	bool MultiRunning;
+	uint64_t WatchEpoch;
+	
+	/* Releases all watched keys. */
+	
+	void Unwatch();
 	
 	class for_each_neighbor_handler
 	{
@@ -203,25 +235,46 @@ class ExportAPI User : public Expandable
 	bool IsQuitting();
 	
         /* 
-         * Locks this user, so we can later recognized it
-         * as being busy.
-         *
-         * @parameters:
-	 *
-	 *         · flag: Either true or false.
+         * Checks whether this user has any query running.
+	 * 
+         * @return:
+ 	 *
+         *         · True: User is busy.
          */    	
          
-	void SetLock(bool flag);
+	bool IsLocked();
 
         /* 
-         * Checks whether this user has any pending query.
+         * Counts queries sent by this user, whose results are not yet delivered.
 	 * 
          * @return:
  	 *
-         *         · True: User is busy.
+         *         · uint	: Queries awaiting results.
          */    	
-         
-	bool IsLocked();
+
+	unsigned int Outstanding()
+	{
+		return this->issued - this->delivered;
+	}
+
+        /* Checks whether an exclusive query of this user is yet to be delivered. */
+
+	bool AwaitingExclusive()
+	{
+		return (this->barrier >= this->delivered);
+	}
+
+        /* 
+         * Checks whether values sent by this user are delimited by its serializer
+         * (see ProtocolTrigger::Serializer::IsFramed). Such values are taken
+         * as they are, without quotes, and replied to in the same way.
+	 * 
+         * @return:
+ 	 *
+         *         · True: Values are framed.
+         */    	
+
+	bool IsDelimited();
 	
 	/* Unique id */
 	
@@ -524,15 +577,24 @@ class ExportAPI User : public Expandable
 	void SendProtocol(const Numeric::Numeric& numeric);
 
 	template <typename T1>
-	void SendProtocol(unsigned int numeric, T1 p1)
+	void SendProtocol(unsigned int numeric, const T1& p1)
 	{
 		Numeric::Numeric n(numeric);
 		n.push(p1);
 		SendProtocol(n);
 	}
 
+	/* Large replies can be moved, instead of copied. */
+
+	void SendProtocol(unsigned int numeric, std::string&& p1)
+	{
+		Numeric::Numeric n(numeric);
+		n.push(std::move(p1));
+		SendProtocol(n);
+	}
+
 	template <typename T1, typename T2>
-	void SendProtocol(unsigned int numeric, T1 p1, T2 p2)
+	void SendProtocol(unsigned int numeric, const T1& p1, const T2& p2)
 	{
 		Numeric::Numeric n(numeric);
 		n.push(p1);
@@ -541,7 +603,7 @@ class ExportAPI User : public Expandable
 	}
 
 	template <typename T1, typename T2, typename T3>
-	void SendProtocol(unsigned int numeric, T1 p1, T2 p2, T3 p3)
+	void SendProtocol(unsigned int numeric, const T1& p1, const T2& p2, const T3& p3)
 	{
 		Numeric::Numeric n(numeric);
 		n.push(p1);
@@ -551,7 +613,7 @@ class ExportAPI User : public Expandable
 	}
 
 	template <typename T1, typename T2, typename T3, typename T4>
-	void SendProtocol(unsigned int numeric, T1 p1, T2 p2, T3 p3, T4 p4)
+	void SendProtocol(unsigned int numeric, const T1& p1, const T2& p2, const T3& p3, const T4& p4)
 	{
 		Numeric::Numeric n(numeric);
 		n.push(p1);
@@ -562,7 +624,7 @@ class ExportAPI User : public Expandable
 	}
 
 	template <typename T1, typename T2, typename T3, typename T4, typename T5>
-	void SendProtocol(unsigned int numeric, T1 p1, T2 p2, T3 p3, T4 p4, T5 p5)
+	void SendProtocol(unsigned int numeric, const T1& p1, const T2& p2, const T3& p3, const T4& p4, const T5& p5)
 	{
 		Numeric::Numeric n(numeric);
 		n.push(p1);
@@ -592,7 +654,8 @@ class ExportAPI User : public Expandable
 
 
         /* 
-         * Sets a login to be used for a given user.
+         * Sets a login to be used for a given user. Its password must be
+         * verified first (see CommandLogin).
          * 
          * @parameters:
 	 *
@@ -621,8 +684,27 @@ class ExportAPI InstanceStream : public StreamSocket
 {
  private:
 
+	 /* Bytes after recvpos known not to hold a full line. */
+
 	 size_t checked_until;
 
+	 /* Framed command being received, parsed up to the input read so far. */
+
+	 ProtocolTrigger::FrameState frame;
+
+	 /* 
+	  * Read commands from input, line by line or using a framed serializer
+	  * (see Serializer::Extract).
+	  *
+	  * @return:
+	  *
+	  *         · True: Serializer was changed, so input left must be read again.
+	  */
+
+	 bool StreamLines();
+
+	 bool StreamFrames();
+
  public:
 
 	LocalUser* const user;
@@ -645,10 +727,25 @@ class ExportAPI LocalUser : public User, public brld::node_list_node<LocalUser>
 {
  
   friend class CommandQueue;
+  friend class DataFlush;
+  friend class transaction_query;
   
   private:
   
 	void Write(const ProtocolTrigger::SerializedMessage& serialized);
+
+	void Write(const ProtocolTrigger::SharedMessage& serialized);
+
+        /* 
+         * Output written while earlier queries are running, along with
+         * the sequence of the last query that must be delivered before it.
+         */
+
+        std::deque<std::pair<uint64_t, ProtocolTrigger::SerializedMessage>> held;
+
+        /* Writes held output whose preceding queries were delivered. */
+
+        void Release();
 	
 	void Send(ProtocolTrigger::Event& protoev, ProtocolTrigger::MessageList& msglist);
 	
@@ -755,6 +852,19 @@ class ExportAPI LocalUser : public User, public brld::node_list_node<LocalUser>
 	{
 		return this->PendingMulti;
 	}
+
+        /* 
+         * Checks whether commands received are waiting to run, or awaiting results.
+         * 
+         * @return:
+ 	 *
+         *         · True: User is busy.
+         */    
+
+	bool Busy()
+	{
+		return (this->Multi || !this->PendingList.empty() || this->Outstanding());
+	}
 };
 
 class RemoteUser : public User
@@ -13,6 +13,10 @@
 
 #pragma once
 
+#include <list>
+#include <thread>
+#include <condition_variable>
+
 #include "stats.h"
 
 class ExportAPI Session : public safecast<Session>
@@ -162,39 +166,136 @@ class ExportAPI SessionManager : public safecast<SessionManager>
 };
 
 /* 
- * This class manages an user's cache by storing login and password. 
- * This class contains several functions related to user sessions, such as
- * cache removal and adding.
+ * Threads verifying passwords, so that hashing (ie, bcrypt) does not block
+ * the mainloop. Requests are queries: their Run() is called from one of
+ * these threads, and their result is delivered as any other query, in
+ * order, by calling Process() from the mainloop.
+ */
+
+class ExportAPI AuthPool
+{
+    private:
+
+        std::vector<std::thread> threads;
+
+        /* Requests not yet taken by a thread. */
+
+        std::deque<std::shared_ptr<QueryBase>> requests;
+
+        std::mutex lock;
+
+        std::condition_variable wake;
+
+        bool exiting;
+
+        /* Runs requests until Stop() is called. */
+
+        void Process();
+
+    public:
+
+        /* Constructor. */
+
+        AuthPool();
+
+        /* Destructor, stops all threads. */
+
+        ~AuthPool();
+
+        /* 
+         * Creates threads.
+         * 
+         * @parameters:
+	 *
+	 *         · count: Threads to create.
+         */            
+
+        void Start(unsigned int count);
+
+        /* Stops all threads. Requests not yet run are discarded. */
+
+        void Stop();
+
+        /* 
+         * Adds a request. Called from the mainloop.
+         * 
+         * @parameters:
+	 *
+	 *         · user: User awaiting this request.
+	 *         · query: Request to run.
+         */            
+
+        void Submit(User* user, std::shared_ptr<QueryBase> query);
+
+        /* Counts requests not yet taken by a thread. */
+
+        size_t Pending();
+};
+
+/* 
+ * This class manages an user's cache of verified credentials. Passwords
+ * are never kept: logins are mapped to a keyed digest of the last
+ * password that was verified, so that next logins skip bcrypt.
+ *
+ * The cache is bounded (LOGIN_CACHE_SIZE), least recently used logins
+ * being removed first, and entries expire after LOGIN_CACHE_TTL seconds.
  */
  
 class ExportAPI LoginCache 
 {
     private:
-    
+
+        struct Entry
+        {
+                std::string login;
+
+                uint64_t digest;
+
+                time_t added;
+        };
+
+        /* Entries, most recently used first. */
+
+        typedef std::list<Entry> EntryList;
+
         /* logins umap tracks of all users loggin in. */
         
-        typedef std::unordered_map<std::string, std::string> LoginMap;
+        typedef std::unordered_map<std::string, EntryList::iterator> LoginMap;
         
+        EntryList entries;
+
         /* Cached logins. */
         
         LoginMap logins;
-        
-        /* Removes last element from cache. */
 
-        bool RemoveLastCache();
+        /* Random key used by Digest(). */
+
+        uint64_t key[2];
+
+        /* Bumped whenever credentials are removed. */
+
+        uint64_t generation;
+
+        /* Returns keyed digest of a login and its password. */
+
+        uint64_t Digest(const std::string& user, const std::string& pass);
 
     public: 
     
         /* Session handler. */
 
         SessionManager Sessions;
+
+        /* Password verification threads. */
+
+        AuthPool Workers;
         
-        /* Constructor, does nothing. */
+        /* Constructor, generates digest key. */
 
         LoginCache();
         
         /* 
-         * Adds a user pass key to the cache.
+         * Adds a verified user pass to the cache.
          * 
          * @parameters:
 	 *
@@ -205,16 +306,15 @@ class ExportAPI LoginCache
         void Add(const std::string& user, const std::string& pass);
 
         /* 
-         * Checks whether a given user is in the cache.
+         * Checks whether a given user pass has been verified before.
          * 
          * @return:
          *
-         *      ·  1: User pass matches.
-         *      · -1: User found, but pass does not match.
-         *      ·  0: User not found.  
+         *      · True: User pass matches.
+         *      · False: Not found, or pass does not match. Pass must be verified.
          */            
          
-        signed int InCache(const std::string& user, const std::string& pass);
+        bool InCache(const std::string& user, const std::string& pass);
 
         /* 
          * Checks if an user is in cache.
@@ -238,6 +338,16 @@ class ExportAPI LoginCache
                 return this->logins.size();
         }
         
+        /* 
+         * Returns current generation. Verifications started in an older
+         * generation may have checked credentials that were removed since.
+         */
+
+        uint64_t GetGeneration()
+        {
+                return this->generation;
+        }
+
         /* 
          * Removes a given user from the cache list. 
          *
@@ -248,4 +358,3 @@ class ExportAPI LoginCache
         
         void Remove(const std::string& login);
 };
-
@@ -15,6 +15,7 @@
 
 #include "beryl.h"
 #include "engine.h"
+#include "extras.h"
 
 /* 
  * Checks whether a given number is valid and, positive.
@@ -85,6 +86,13 @@ inline bool CheckValid(User* user, const std::string& number)
 
 inline bool CheckFormat(User* user, const std::string& value, bool notify = true)
 {
+        /* Framed values are delimited by their length, so any value is valid. */
+
+        if (user->IsDelimited())
+        {
+             return true;
+        }
+
         if (value.size() == 0)
         {
             if (notify)
@@ -118,6 +126,30 @@ inline bool CheckFormat(User* user, const std::string& value, bool notify = true
         return false;
 }
 
+/* 
+ * Removes quote marks from a value sent by an user, unless its values
+ * are delimited (see User::IsDelimited).
+ * 
+ * @parameters:
+ *
+ *         · user: User that sent this value.
+ *         · value: Value to unquote.
+ *
+ * @return:
+ *
+ *         · string: Value, without quote marks.
+ */
+
+inline std::string stripe(User* user, const std::string& value)
+{
+        if (user->IsDelimited())
+        {
+             return value;
+        }
+
+        return stripe(value);
+}
+
 /* 
  * Checks whether a given key is valid.
  * 
@@ -13,6 +13,8 @@
 
 #pragma once
 
+class HashProvider;
+
 class ExportAPI UserHelper
 {
     public:
@@ -80,7 +82,22 @@ class ExportAPI UserHelper
 
         static bool DeleteFlags(const std::string& user);
 
-        static bool CheckPass(const std::string& user, const std::string& key);
+        /* 
+         * Verifies a password. This function is slow (see HashProvider) and
+         * is called from AuthPool threads, thus it does not use LoginCache.
+         *
+         * @parameters:
+	 *
+	 *         · provider: Hash provider, found from the mainloop.
+	 *         · user: Login to verify.
+	 *         · key: Password provided.
+	 * 
+         * @return:
+ 	 *
+         *         · True: Login is enabled and password matches.
+         */    
+
+        static bool CheckPass(HashProvider* provider, const std::string& user, const std::string& key);
 
         static std::string CheckFlags(const std::string& user);
 
@@ -25,42 +25,68 @@ enum MONITOR_LEVEL
       MONITOR_DEFAULT  =  20    /* Shows not-found commands plus everything on Default */
 };
 
-typedef std::multimap<User*, MONITOR_LEVEL> MonitorMap;
+/* Monitoring settings of a given user. */
 
-/* Temporary command to deliver to monitors. */
+struct MonitorEntry
+{
+       MONITOR_LEVEL level;
+
+       /* Only 1 out of rate matching commands is delivered. */
+
+       unsigned int rate;
+
+       /* Commands to deliver, in uppercase. Empty if all are delivered. */
+
+       std::set<std::string> filter;
+
+       /* Matching commands seen, used for sampling. */
+
+       uint64_t seen;
+
+       /* Unique id, as users may be removed before their events are flushed. */
+
+       uint64_t id;
+
+       /* Commands this monitor wanted, dropped since last flush. */
+
+       uint64_t dropped;
+
+       MonitorEntry(MONITOR_LEVEL lvl = MONITOR_DEFAULT, unsigned int samplerate = 1) : level(lvl), rate(samplerate), seen(0), id(0), dropped(0)
+       {
+
+       }
+};
+
+typedef std::map<User*, MonitorEntry> MonitorMap;
+
+/* Command to deliver to monitors, kept in a slot of MonitorHandler's ring. */
 
 struct CMDBuffer
 {
-     friend class MonitorHandler;
-     
-     private:
-    
        /* Original author of this command */
        
        std::string instance;
        
-       /* Original command */
+       /* Command and its parameters, formatted once for all monitors. */
        
-       std::string command;
+       std::string line;
 
-       /* Monitoring level. */
-       
-       MONITOR_LEVEL level;
+       /* Monitors this command is delivered to, along with their ids. */
 
-       /* Command that is being monitored */
-       
-       CommandModel::Params params;
-     
-     public:
-       
-       /* Constructor, define data */
-       
-       CMDBuffer(const std::string& dest, const std::string& cmd, MONITOR_LEVEL lvl, const CommandModel::Params& parameters) : instance(dest), command(cmd), level(lvl), params(parameters)
-       {
-       
-       }
+       std::vector<std::pair<User*, uint64_t>> targets;
 };
 
+/* 
+ * Monitors receive commands run by other users. Commands are pushed into
+ * a bounded ring (MONITOR_SLOTS), which is entirely flushed on every
+ * mainloop pass. Commands pushed while the ring is full are dropped and
+ * counted for the monitors that wanted them, so monitoring never grows
+ * memory nor lags behind. Slots are
+ * reused, so their strings keep their capacity.
+ *
+ * Commands are only pushed and flushed by the mainloop.
+ */
+
 class ExportAPI MonitorHandler 
 {
    private:
@@ -69,9 +95,31 @@ class ExportAPI MonitorHandler
         
         MonitorMap MonitorList;
         
-        /* Pending buffer */
+        /* Ring of pending commands. */
         
-        std::deque<CMDBuffer> buffer;
+        std::unique_ptr<CMDBuffer[]> slots;
+
+        /* Position of next slot to write. */
+
+        size_t tail;
+
+        /* Position of next slot to flush. */
+
+        size_t head;
+
+        /* Commands wanted by any monitor, dropped since last flush and since startup. */
+
+        uint64_t dropped;
+
+        uint64_t total_dropped;
+
+        /* Id given to next monitor. */
+
+        uint64_t next_id;
+
+        /* Whether a monitor may receive a given command. Updates its sampling counter. */
+
+        static bool Wants(MonitorEntry& entry, MONITOR_LEVEL level, const std::string& cmd);
         
    public:
    
@@ -102,7 +150,7 @@ class ExportAPI MonitorHandler
          * @parameters:
 	 *
 	 *         · User	   : User that will receive monitoring events.
-	 *         · MONITOR_LEVEL : May be Default or Debug.
+	 *         · MonitorEntry  : Level (Default or Debug), sampling rate and filter.
 	 * 
          * @return:
  	 *
@@ -112,7 +160,7 @@ class ExportAPI MonitorHandler
          *              · false    : Unable to add user.
          */    
                  
-        bool Add(User* user, MONITOR_LEVEL level);
+        bool Add(User* user, const MonitorEntry& entry);
 
         /* 
          * Removes an user from the monitor map.
@@ -143,6 +191,20 @@ class ExportAPI MonitorHandler
                  
         void Flush();
 
+        /* Checks whether there are commands left to flush. */
+
+        bool Pending()
+        {
+                return (this->head != this->tail);
+        }
+
+        /* Counts commands dropped since startup, as the ring was full. */
+
+        uint64_t GetDropped()
+        {
+                return this->total_dropped;
+        }
+
         /* 
          * Returns a MonitorMap containing all monitoring users.
          * 
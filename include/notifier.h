@@ -141,6 +141,13 @@ class ExportAPI Notifier
 
          void Flush();
 
+         /* Checks whether there are events left to flush. */
+
+         bool Pending()
+         {
+                return !this->events.empty();
+         }
+
         /* 
          * Resets NotifyList and pending events.
          * 
@@ -43,6 +43,12 @@ class Numeric::Numeric
 		return *this;
 	}
 
+	Numeric& push(std::string&& x)
+	{
+		params.push_back(std::move(x));
+		return *this;
+	}
+
 	void SetServer(Server* server) 
 	{ 
 		sourceserver = server; 
@@ -30,6 +30,11 @@ class ExportAPI ReducerHandler  : public safecast<ReducerHandler>
 	}
 	
 	void Apply();
+
+	bool Pending() 
+	{ 
+		return !this->list.empty(); 
+	}
 };
 
 class ExportAPI PromiseAction : public Discarder
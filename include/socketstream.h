@@ -188,7 +188,7 @@ class ExportAPI SocketPool
 	
 	static EventHandler* GetReference(int fd);
 
-	static int Events();
+	static int Events(int timeout);
 
 	
 	static void Writes();
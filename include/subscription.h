@@ -36,9 +36,13 @@ class ExportAPI Subscription : public Expandable, public brld::node_list_node<Su
 	
 	Channel* const chan;
 
+	/* Position in chan->locals, only meaningful for local users. */
+
+	size_t local;
+
 	/* Constructor. */
 		
-	Subscription(User* usr, Channel* cptr) : from_connect(false), user(usr), chan(cptr) 
+	Subscription(User* usr, Channel* cptr) : from_connect(false), user(usr), chan(cptr), local(0)
 	{
 	
 	}
@@ -26,11 +26,16 @@ namespace ProtocolTrigger
 	class MessageTagEvent;
 	class MessageDataProvider;
 	class Serializer;
+	struct ParseOutput;
 
 	typedef std::vector<Message*> MessageList;
 	typedef std::vector<std::string> ParamList;
 	typedef std::string SerializedMessage;
 
+	/* Serialized message, shared by all users it is sent to. */
+
+	typedef std::shared_ptr<const SerializedMessage> SharedMessage;
+
 	struct MessageProvider
 	{
 		MessageDataProvider* tagprov;
@@ -41,6 +46,49 @@ namespace ProtocolTrigger
 
 	
 	typedef brld::flat_map<std::string, MessageProvider, std::greater<std::string> > TagMap;
+
+	/* 
+	 * Progress of a framed command being received (see Serializer::Extract),
+	 * kept between reads so that input already parsed is not parsed again.
+	 * Offsets are relative to the start of the command.
+	 */
+
+	struct FrameState
+	{
+		/* Arguments expected, 0 until known. */
+
+		uint64_t count;
+
+		/* Bytes parsed, up to the next header to read. */
+
+		size_t parsed;
+
+		/* Offset and length of every argument parsed. */
+
+		std::vector<std::pair<size_t, size_t> > args;
+
+		FrameState() : count(0), parsed(0)
+		{
+
+		}
+
+		void Reset()
+		{
+			this->count = 0;
+			this->parsed = 0;
+
+			/* Large commands do not keep their memory once parsed. */
+
+			if (this->args.capacity() > 1024)
+			{
+				std::vector<std::pair<size_t, size_t> >().swap(this->args);
+			}
+			else
+			{
+				this->args.clear();
+			}
+		}
+	};
 }
 
 /* A vector of users */
@@ -23,6 +23,42 @@ const unsigned int MAX_DATABASES	=	5;
 
 const unsigned int ITER_LIMIT 		= 	50;
 
+/* Entries written per batch when migrating a database. */
+
+const unsigned int MIGRATE_BATCH 	= 	10000;
+
+/* Results that data threads may queue before the mainloop collects them. Must be a power of two. */
+
+const unsigned int COMPLETION_SLOTS 	= 	8192;
+
+/* Queries that may be posted to a data thread before it runs them. Must be a power of two. */
+
+const unsigned int DATATHREAD_SLOTS 	= 	4096;
+
+/* Largest query block kept by QueryPool, and spacing between its size classes. */
+
+const unsigned int QUERY_POOL_SIZE 	= 	4096;
+
+const unsigned int QUERY_POOL_ALIGN 	= 	64;
+
+/* Blocks QueryPool keeps, per size class. */
+
+const unsigned int QUERY_POOL_BLOCKS 	= 	1024;
+
+/* Commands kept for monitors until next flush. Must be a power of two. */
+
+const unsigned int MONITOR_SLOTS 	= 	4096;
+
+/* Max. verified logins kept by LoginCache, and seconds they are kept for. */
+
+const unsigned int LOGIN_CACHE_SIZE 	= 	1024;
+
+const unsigned int LOGIN_CACHE_TTL 	= 	3600;
+
+/* Max. ranges visited when scanning keys by a literal prefix. */
+
+const unsigned int MAX_PREFIX_RANGES 	= 	64;
+
 /* Registry types. */
 
 const std::vector<std::string> TypeRegs = 
@@ -33,10 +69,22 @@ const std::vector<std::string> TypeRegs =
     INT_MAP, 
     INT_MMAP, 
     INT_VECTOR, 
+    INT_ZSET, 
     INT_EXPIRE, 
     INT_FUTURE 
 };
 
+/* Item types. These are not registries, as items belong to a registry. */
+
+const std::vector<std::string> ItemRegs = 
+{ 
+    INT_LIST_ITEM, 
+    INT_MAP_ITEM, 
+    INT_MMAP_ITEM, 
+    INT_ZSET_ITEM, 
+    INT_GEO_ITEM 
+};
+
 /* Core database */
 
 const std::string CORE_DB		=	"core";
@@ -53,6 +101,16 @@ const std::string DEFAULT_EMERALD 	= 	"emerald";
 
 const unsigned int INPUT_LIMIT 		= 	65530;
 
+/* 
+ * Max. length of a command, and max. arguments of it, read by the bulk serializer.
+ * Commands are buffered until complete, thus the bulk serializer is only
+ * available to logged users.
+ */
+
+const unsigned long BULK_LIMIT 		= 	536870912;
+
+const unsigned long BULK_ARGS 		= 	1048576;
+
 /* Time to wait before starting accepting requests. */
 
 const int PRELOOP_WAIT 			= 	1000000;
@@ -127,3 +185,7 @@ const std::string BRANCH 		= 	"BerylDB-@VERSION_MAJOR@";
 
 %define CLOCK_GETTIME_OK
 
+/* Whether eventfd() is available, used to wake up the mainloop. */
+
+%define HAS_EVENTFD
+
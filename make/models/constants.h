@@ -121,6 +121,10 @@ const std::string PROCESS_ALREADY 	= 	"ALREADY_USING";
 
 const std::string DATABASE_BUSY 	= 	"DATABASE_BUSY";
 
+/* Commands sent earlier are still running. */
+
+const std::string COMMANDS_PENDING 	= 	"COMMANDS_PENDING";
+
 /* Entry is defined. */
 
 const std::string ENTRY_DEFINED 	= 	"ENTRY_DEFINED";
@@ -181,6 +185,10 @@ const std::string PROCESS_NULL 		= 	"NULL";
 
 const std::string PROCESS_OK 		= 	"OK";
 
+/* Transaction not run, as a watched key changed. */
+
+const std::string MULTI_ABORTED 	= 	"ABORTED";
+
 /* > 0 */
 
 const std::string MUST_BE_GREAT_ZERO   = 	"GREATER_THAN_ZERO";
@@ -256,6 +264,27 @@ const std::string INT_MMAP 		= 	"5";
 
 const std::string INT_VECTOR 		= 	"6";
 
+/* Sorted sets. */
+
+const std::string INT_ZSET 		= 	"10";
+
+/* 
+ * Container items, stored apart from their registry. Item types are 
+ * formed by '7', followed by the type of their registry.
+ */
+
+const std::string INT_MAP_ITEM 		= 	"72";
+
+const std::string INT_LIST_ITEM 	= 	"73";
+
+/* Spatial index of geo entries, keyed by select instead of container. */
+
+const std::string INT_GEO_ITEM 		= 	"74";
+
+const std::string INT_MMAP_ITEM 	= 	"75";
+
+const std::string INT_ZSET_ITEM 	= 	"710";
+
 /* Expires definition. */
 
 const std::string INT_EXPIRE 		= 	"8";
@@ -264,6 +293,14 @@ const std::string INT_EXPIRE 		= 	"8";
 
 const std::string INT_FUTURE 		=	 "9";
 
+/* Storage format registry. */
+
+const std::string INT_FORMAT 		=	 "0";
+
+/* Key holding the storage format of a database. */
+
+const std::string FORMAT_KEY 		=	 "format:0:" + INT_FORMAT;
+
 /* Default exiting msg */
 
 const std::string SERVER_EXITING 	= 	"SERVER_EXITING";
@@ -18,19 +18,23 @@
 #include "monitor.h"
 #include "engine.h"
 
-MonitorHandler::MonitorHandler()
+MonitorHandler::MonitorHandler() : slots(new CMDBuffer[MONITOR_SLOTS]), tail(0), head(0), dropped(0), total_dropped(0), next_id(1)
 {
 
 }
 
-bool MonitorHandler::Add(User* user, MONITOR_LEVEL level)
+bool MonitorHandler::Add(User* user, const MonitorEntry& entry)
 {
         if (!user || user->IsQuitting())
         {
             return false;
         }
 
-        this->MonitorList.insert(std::make_pair(user, level));
+        MonitorEntry& adding = this->MonitorList[user];
+        adding = entry;
+        adding.seen = 0;
+        adding.id = this->next_id++;
+        adding.dropped = 0;
         return true;
 }
 
@@ -51,6 +55,21 @@ void MonitorHandler::Remove(User* user)
         this->MonitorList.erase(user);
 }        
 
+bool MonitorHandler::Wants(MonitorEntry& entry, MONITOR_LEVEL level, const std::string& cmd)
+{
+        if (entry.level > level)
+        {
+             return false;
+        }
+
+        if (!entry.filter.empty() && entry.filter.find(cmd) == entry.filter.end())
+        {
+             return false;
+        }
+
+        return ((entry.seen++ % entry.rate) == 0);
+}
+
 void MonitorHandler::Push(const std::string& instance, const std::string& cmd, MONITOR_LEVEL level, const CommandModel::Params& params)
 {
         if (!this->MonitorList.size())
@@ -58,10 +77,72 @@ void MonitorHandler::Push(const std::string& instance, const std::string& cmd, M
              return;
         }
 
-        /* CMDBuffer, which is later inserted in a buffered list. */
-        
-        CMDBuffer adding(instance, cmd, level, params);
-        this->buffer.push_back(adding);
+        const size_t pos = this->tail;
+
+        /* Commands are filtered first, so drops are only counted for monitors that wanted them. */
+
+        const bool full = (pos - this->head >= MONITOR_SLOTS);
+        bool lost = false;
+
+        CMDBuffer& adding = this->slots[pos & (MONITOR_SLOTS - 1)];
+
+        if (!full)
+        {
+             adding.targets.clear();
+        }
+
+        for (MonitorMap::iterator i = this->MonitorList.begin(); i != this->MonitorList.end(); ++i)
+        {
+                User* const user = i->first;
+
+                if (!user || user->IsQuitting() || user->instance == instance)
+                {
+                     continue;
+                }
+
+                if (!Wants(i->second, level, cmd))
+                {
+                     continue;
+                }
+
+                if (full)
+                {
+                     i->second.dropped++;
+                     lost = true;
+                     continue;
+                }
+
+                adding.targets.push_back(std::make_pair(user, i->second.id));
+        }
+
+        if (full)
+        {
+             if (lost)
+             {
+                  this->dropped++;
+                  this->total_dropped++;
+             }
+
+             return;
+        }
+
+        /* Filtered out, or not sampled, by all monitors. */
+
+        if (adding.targets.empty())
+        {
+             return;
+        }
+
+        adding.instance.assign(instance);
+        adding.line.assign(cmd);
+
+        for (CommandModel::Params::const_iterator i = params.begin(); i != params.end(); ++i)
+        {
+                adding.line.push_back(' ');
+                adding.line.append(*i);
+        }
+
+        this->tail = pos + 1;
 }
 
 MonitorMap MonitorHandler::GetList(const std::string& arg)
@@ -84,19 +165,14 @@ MonitorMap MonitorHandler::GetList(const std::string& arg)
           monitor = MONITOR_DEBUG;
       }
       
-      MonitorMap all = this->MonitorList;
-      
-      for (MonitorMap::iterator uit = all.begin(); uit != all.end(); uit++)
+      for (MonitorMap::const_iterator uit = this->MonitorList.begin(); uit != this->MonitorList.end(); uit++)
       {
-               User* user = uit->first;
-               MONITOR_LEVEL level = uit->second;
-               
-               if (level != monitor)
+               if (uit->second.level != monitor)
                {
                      continue;
                }
                
-               list.insert(std::make_pair(user, level));
+               list.insert(*uit);
       }
       
       return list;
@@ -104,68 +180,67 @@ MonitorMap MonitorHandler::GetList(const std::string& arg)
 
 void MonitorHandler::Flush()
 {
-        if (!this->buffer.size())
+        size_t pos = this->head;
+        const size_t end = this->tail;
+
+        if (pos == end && !this->dropped)
         {
             return;
         }
 
-        if (!this->MonitorList.size())
+        /* Everything pending is delivered on every pass. */
+
+        for (; pos != end; pos++)
+        {
+                CMDBuffer& flushing = this->slots[pos & (MONITOR_SLOTS - 1)];
+
+                for (std::vector<std::pair<User*, uint64_t>>::const_iterator i = flushing.targets.begin(); i != flushing.targets.end(); ++i)
+                {
+                        MonitorMap::const_iterator it = this->MonitorList.find(i->first);
+
+                        /* Monitor removed, or replaced, since this command was pushed. */
+
+                        if (it == this->MonitorList.end() || it->second.id != i->second || i->first->IsQuitting())
+                        {
+                             continue;
+                        }
+
+                        Dispatcher::SmartDiv(i->first, BRLD_MONITOR, flushing.instance, flushing.line, ":");
+                }
+
+                this->head = pos + 1;
+        }
+
+        if (!this->dropped)
         {
-             this->buffer.clear();
              return;
         }
 
-        const MonitorMap& all = this->MonitorList;
-        
-        /* Process next item in buffer */
-        
-        CMDBuffer flushing    = this->buffer.front();
-               
-        for (MonitorMap::const_iterator i = all.begin(); i != all.end(); i++)
+        /* Monitors are told about gaps in their own stream. */
+
+        this->dropped = 0;
+
+        for (MonitorMap::iterator i = this->MonitorList.begin(); i != this->MonitorList.end(); ++i)
         {
-                      User* const user    = i->first;
-                      MONITOR_LEVEL level = i->second;
-                      
-                      if (!user || user->IsQuitting())
-                      {
-                           continue;
-                      }
-                      
-                      if (user->instance == flushing.instance)
-                      {
-                           continue;
-                      }
-                      
-                      if (level <= flushing.level)
-                      {
-                             std::ostringstream fullparams;
-                             
-                             unsigned int size = flushing.params.size();
-                             unsigned int counter = 0;
-                             
-                             for (std::string item: flushing.params) 
-                             {
-                                       fullparams << item;
-                                       counter++;
-                                       
-                                       if (size != counter)
-                                       {
-                                             fullparams << " ";    
-                                       }
-                             }
-    
-                             std::string sfinal(fullparams.str());
-                             Dispatcher::SmartDiv(user, BRLD_MONITOR, flushing.instance, Daemon::Format("%s %s", flushing.command.c_str(), sfinal.c_str()).c_str(), ":");
-                      }
-        }     
-               
-        this->buffer.pop_front();
+                if (!i->second.dropped)
+                {
+                     continue;
+                }
+
+                if (!i->first->IsQuitting())
+                {
+                     Dispatcher::SmartDiv(i->first, BRLD_MONITOR, Kernel->Config->ServerName, "DROPPED " + convto_string(i->second.dropped), ":");
+                }
+
+                i->second.dropped = 0;
+        }
 }
 
 void MonitorHandler::Reset()
 {
         this->MonitorList.clear();
-        this->buffer.clear();
+        this->head = this->tail;
+        this->dropped = 0;
 }
 
 Notifier::Notifier()
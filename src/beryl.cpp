@@ -222,6 +222,10 @@ void Beryl::Initialize()
 
 	this->Store->OpenAll();
 
+	/* Opens password verification threads. */
+
+	this->Logins->Workers.Start(this->Config->AuthThreads);
+
         /* Open all databases. */
 
         this->Store->DBM->OpenAll();
@@ -317,7 +321,7 @@ void Beryl::Loop()
 {
         /* Flushes pending commands. */
 
-        Kernel->Commander->Queue->Flush();
+        const bool ran = Kernel->Commander->Queue->Flush();
 
         /*
          * Our socket pool needs to actively await for data in active file descriptors.
@@ -327,7 +331,7 @@ void Beryl::Loop()
          */
 
         SocketPool::Writes();
-        SocketPool::Events();
+        SocketPool::Events(ran ? 0 : this->GetWait());
       
 	/* Removes all quitting clients. */
 	
@@ -350,6 +354,18 @@ void Beryl::Loop()
         this->Atomics->Run();
 }
 
+int Beryl::GetWait()
+{
+        if (DataFlush::Pending() || this->Monitor->Pending() || this->Notify->Pending() || this->Reducer->Pending())
+        {
+                return 0;
+        }
+
+        /* Finished queries wake us up, so we may sleep until timers are due. */
+
+        return 1000 - (this->TIME.tv_nsec / 1000000);
+}
+
 void Beryl::Timed(time_t current)
 {
  	/* We call all pending timers to be delivered. */
@@ -377,14 +393,6 @@ void Beryl::Timed(time_t current)
 
                    if ((current % 3600) == 0)
                    {
-			     /* 
-			      * Login cache should only be in memory for
-			      * an hour. There is no need to store ACL
-			      * data for weeks.
-			      */
-			     
-			     this->Logins->Reset();
-			     
 			     /* Runs every one hour. */
 			     
 			     NOTIFY_MODS(OnEveryHour, (current));
@@ -444,6 +452,7 @@ void Beryl::PrepareExit(int status, const std::string& quitmsg)
 	
 	/* Login cache will not be needed anymore. */
 	
+	this->Logins->Workers.Stop();
 	this->Logins->Reset();
 
 	/* 
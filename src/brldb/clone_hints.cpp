@@ -16,11 +16,14 @@
 #include "brldb/query.h"
 #include "brldb/dbnumeric.h"
 #include "brldb/expires.h"
+#include "brldb/list_store.h"
+#include "brldb/map_store.h"
+#include "brldb/zset_store.h"
+#include "brldb/geo_index.h"
 #include "helpers.h"
 
 void clone_query::Keys()
 {
-    RocksData result = this->Get(this->dest);
     const std::string& newdest = to_bin(this->key) + ":" + this->value + ":" + this->identified;
 
     this->ExpireBatch(newdest, this->value, this->key, convto_num<unsigned int>(this->value), this->id);
@@ -29,22 +32,102 @@ void clone_query::Keys()
 
 void clone_query::Lists()
 {
+    ListStore store(this->database, this->dest);
+    const RocksData& result = this->Get(this->dest);
 
+    if (!result.status.ok() || !store.Load(result.value))
+    {
+        access_set(DBL_NOT_FOUND);
+        return;
+    }
+
+    const std::string& newdest = to_bin(this->key) + ":" + this->value + ":" + this->identified;
+
+    if (!store.CopyTo(this->database, newdest))
+    {
+          access_set(DBL_UNABLE_WRITE);
+          return;
+    }
+
+    this->SetOK();
 }
 
 void clone_query::Multis()
 {
+    MapStore store(this->database, this->dest, true);
+    const RocksData& result = this->Get(this->dest);
+
+    if (!result.status.ok() || !store.Load(result.value))
+    {
+        access_set(DBL_NOT_FOUND);
+        return;
+    }
 
+    const std::string& newdest = to_bin(this->key) + ":" + this->value + ":" + this->identified;
+
+    if (!store.CopyTo(this->database, newdest))
+    {
+          access_set(DBL_UNABLE_WRITE);
+          return;
+    }
+
+    this->SetOK();
 }
 
 void clone_query::Geos()
 {
+    /* Copies are indexed under their own select. */
+
+    const RocksData& result = this->Get(this->dest);
 
+    if (result.status.ok())
+    {
+          GeoIndex::Index(this->database, convto_num<unsigned int>(this->value), this->key, result.value);
+    }
 }
 
 void clone_query::Maps()
 {
+    MapStore store(this->database, this->dest);
+    const RocksData& result = this->Get(this->dest);
+
+    if (!result.status.ok() || !store.Load(result.value))
+    {
+        access_set(DBL_NOT_FOUND);
+        return;
+    }
 
+    const std::string& newdest = to_bin(this->key) + ":" + this->value + ":" + this->identified;
+
+    if (!store.CopyTo(this->database, newdest))
+    {
+          access_set(DBL_UNABLE_WRITE);
+          return;
+    }
+
+    this->SetOK();
+}
+
+void clone_query::ZSets()
+{
+    ZSetStore store(this->database, this->dest);
+    const RocksData& result = this->Get(this->dest);
+
+    if (!result.status.ok() || !store.Load(result.value))
+    {
+        access_set(DBL_NOT_FOUND);
+        return;
+    }
+
+    const std::string& newdest = to_bin(this->key) + ":" + this->value + ":" + this->identified;
+
+    if (!store.CopyTo(this->database, newdest))
+    {
+          access_set(DBL_UNABLE_WRITE);
+          return;
+    }
+
+    this->SetOK();
 }
 
 void clone_query::Vectors()
@@ -67,11 +150,17 @@ void clone_query::Run()
     } 
     else if (this->identified == INT_MAP)
     {
+          /* Items are copied along with the registry. */
+
           this->Maps();
+          return;
     }
     else if (this->identified == INT_MMAP)
     {
+          /* Items are copied along with the registry. */
+
           this->Multis();
+          return;
     }
     else if (this->identified == INT_GEO)
     {
@@ -79,14 +168,24 @@ void clone_query::Run()
     }
     else if (this->identified == INT_LIST)
     {
+          /* Items are copied along with the registry. */
+
           this->Lists();
+          return;
+    }
+    else if (this->identified == INT_ZSET)
+    {
+          /* Members are copied along with the registry. */
+
+          this->ZSets();
+          return;
     }
     else if (this->identified == INT_VECTOR)
     {    
           this->Vectors();
     }   
 
-    RocksData result = this->Get(this->dest);
+    const RocksData& result = this->Get(this->dest);
     const std::string& newdest = to_bin(this->key) + ":" + this->value + ":" + this->identified;
     this->Write(newdest, result.value);
     this->SetOK();
@@ -0,0 +1,170 @@
+/*
+ * BerylDB - A lightweight database.
+ * http://www.beryldb.com
+ *
+ * Copyright (C) 2021 - Carlos F. Ferry <cferry@beryldb.com>
+ *
+ * This file is part of BerylDB. BerylDB is free software: you can
+ * redistribute it and/or modify it under the terms of the BSD License
+ * version 3.
+ *
+ * More information about our licensing can be found at https://docs.beryl.dev
+ */
+
+#include <thread>
+
+#include "beryl.h"
+#include "brldb/completion.h"
+
+#ifdef HAS_EVENTFD
+#include <sys/eventfd.h>
+#endif
+
+CompletionQueue::CompletionQueue() : slots(new Slot[COMPLETION_SLOTS]), tail(0), head(0), signaled(false), wakefd(-1)
+{
+        for (size_t i = 0; i < COMPLETION_SLOTS; i++)
+        {
+                this->slots[i].sequence = i;
+        }
+}
+
+CompletionQueue::~CompletionQueue()
+{
+        this->Close();
+}
+
+void CompletionQueue::Open()
+{
+        if (this->HasFileDesc())
+        {
+                return;
+        }
+
+#ifdef HAS_EVENTFD
+        this->fd = eventfd(0, EFD_NONBLOCK);
+        this->wakefd = this->fd;
+#else
+        int fds[2];
+
+        if (pipe(fds) == 0)
+        {
+                SocketPool::NonBlocking(fds[0]);
+                SocketPool::NonBlocking(fds[1]);
+
+                this->fd = fds[0];
+                this->wakefd = fds[1];
+        }
+#endif
+
+        if (!this->HasFileDesc() || !SocketPool::AddDescriptor(this, Q_REQ_POOL_READ | Q_NO_WRITE))
+        {
+                bprint(ERROR, "Unable to create completion queue: %s", strerror(errno));
+                exit(EXIT_CODE_SOCKETSTREAM);
+        }
+}
+
+void CompletionQueue::Close()
+{
+        if (!this->HasFileDesc())
+        {
+                return;
+        }
+
+        SocketPool::DeleteDescriptor(this);
+
+        if (this->wakefd != this->fd)
+        {
+                SocketPool::Close(this->wakefd);
+        }
+
+        SocketPool::Close(this->fd);
+
+        this->fd = -1;
+        this->wakefd = -1;
+}
+
+void CompletionQueue::Wake()
+{
+        if (this->signaled.exchange(true) || this->wakefd < 0)
+        {
+                return;
+        }
+
+#ifdef HAS_EVENTFD
+        eventfd_write(this->wakefd, 1);
+#else
+        char dummy = 0;
+        write(this->wakefd, &dummy, 1);
+#endif
+}
+
+void CompletionQueue::Push(const std::shared_ptr<QueryBase>& query)
+{
+        size_t pos = this->tail.load(std::memory_order_relaxed);
+        Slot* slot;
+
+        while (true)
+        {
+                slot = &this->slots[pos & (COMPLETION_SLOTS - 1)];
+
+                const size_t sequence = slot->sequence.load(std::memory_order_acquire);
+                const intptr_t diff = (intptr_t)sequence - (intptr_t)pos;
+
+                if (diff == 0)
+                {
+                        if (this->tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                        {
+                                break;
+                        }
+                }
+                else if (diff < 0)
+                {
+                        /* Ring is full: waits for the mainloop to collect results. */
+
+                        this->Wake();
+                        std::this_thread::yield();
+                        pos = this->tail.load(std::memory_order_relaxed);
+                }
+                else
+                {
+                        pos = this->tail.load(std::memory_order_relaxed);
+                }
+        }
+
+        slot->query = query;
+        slot->sequence.store(pos + 1, std::memory_order_release);
+
+        this->Wake();
+}
+
+bool CompletionQueue::Pop(std::shared_ptr<QueryBase>& query)
+{
+        Slot* slot = &this->slots[this->head & (COMPLETION_SLOTS - 1)];
+
+        if (slot->sequence.load(std::memory_order_acquire) != this->head + 1)
+        {
+                return false;
+        }
+
+        query = std::move(slot->query);
+        slot->query.reset();
+        slot->sequence.store(this->head + COMPLETION_SLOTS, std::memory_order_release);
+
+        this->head++;
+        return true;
+}
+
+void CompletionQueue::OnPendingRead()
+{
+#ifdef HAS_EVENTFD
+        eventfd_t value;
+        eventfd_read(this->fd, &value);
+#else
+        char buffer[64];
+
+        while (read(this->fd, buffer, sizeof(buffer)) > 0)
+        {
+
+        }
+#endif
+}
@@ -0,0 +1,68 @@
+/*
+ * BerylDB - A lightweight database.
+ * http://www.beryldb.com
+ *
+ * Copyright (C) 2021 - Carlos F. Ferry <cferry@beryldb.com>
+ *
+ * This file is part of BerylDB. BerylDB is free software: you can
+ * redistribute it and/or modify it under the terms of the BSD License
+ * version 3.
+ *
+ * More information about our licensing can be found at https://docs.beryl.dev
+ */
+
+#include "beryl.h"
+#include "brldb/database.h"
+#include "brldb/container.h"
+
+std::string Container::Encode(uint64_t number)
+{
+        std::string encoded(8, '\0');
+
+        for (unsigned int i = 0; i < 8; ++i)
+        {
+                encoded[7 - i] = static_cast<char>((number >> (i * 8)) & 0xFF);
+        }
+
+        return encoded;
+}
+
+uint64_t Container::GetId(const rocksdb::Slice& key)
+{
+        if (key.size() < 8)
+        {
+                return 0;
+        }
+
+        uint64_t id = 0;
+
+        for (unsigned int i = 0; i < 8; ++i)
+        {
+                id = (id << 8) | static_cast<unsigned char>(key[i]);
+        }
+
+        return id;
+}
+
+void Container::Erase(std::shared_ptr<Database> database, const std::string& type, uint64_t id, rocksdb::WriteBatch& batch)
+{
+        batch.DeleteRange(database->GetHandle(type), Encode(id), Encode(id + 1));
+}
+
+void Container::Copy(std::shared_ptr<Database> source, std::shared_ptr<Database> target, const std::string& type, uint64_t from, uint64_t to, rocksdb::WriteBatch& batch)
+{
+        const std::string& first = Encode(from);
+        const std::string& last = Encode(from + 1);
+        const std::string& prefix = Encode(to);
+
+        rocksdb::ColumnFamilyHandle* items = target->GetHandle(type);
+        std::unique_ptr<rocksdb::Iterator> it(source->NewIterator(type));
+
+        for (it->Seek(first); it->Valid() && it->key().compare(last) < 0; it->Next())
+        {
+                rocksdb::Slice suffix = it->key();
+                suffix.remove_prefix(8);
+
+                batch.Put(items, prefix + suffix.ToString(), it->value());
+        }
+}
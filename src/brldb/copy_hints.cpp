@@ -14,6 +14,10 @@
 #include "beryl.h"
 #include "helpers.h"
 #include "brldb/expires.h"
+#include "brldb/list_store.h"
+#include "brldb/map_store.h"
+#include "brldb/zset_store.h"
+#include "brldb/geo_index.h"
 
 void copy_query::Keys()
 {
@@ -27,22 +31,102 @@ void copy_query::Keys()
 
 void copy_query::Maps()
 {
+     MapStore store(this->database, this->dest);
+     const RocksData& result = this->Get(this->dest);
 
+     if (!result.status.ok() || !store.Load(result.value))
+     {
+          access_set(DBL_NOT_FOUND);
+          return;
+     }
+
+     const std::string& newdest = to_bin(this->value) + ":" + convto_string(this->select_query) + ":" + this->identified;
+
+     if (!store.CopyTo(this->database, newdest))
+     {
+          access_set(DBL_UNABLE_WRITE);
+          return;
+     }
+
+     this->SetOK();
 }
 
 void copy_query::Multis()
 {
+     MapStore store(this->database, this->dest, true);
+     const RocksData& result = this->Get(this->dest);
+
+     if (!result.status.ok() || !store.Load(result.value))
+     {
+          access_set(DBL_NOT_FOUND);
+          return;
+     }
+
+     const std::string& newdest = to_bin(this->value) + ":" + convto_string(this->select_query) + ":" + this->identified;
 
+     if (!store.CopyTo(this->database, newdest))
+     {
+          access_set(DBL_UNABLE_WRITE);
+          return;
+     }
+
+     this->SetOK();
 }
 
 void copy_query::Geos()
 {
+    /* Copies are indexed under their own name. */
 
+    const RocksData& result = this->Get(this->dest);
+
+    if (result.status.ok())
+    {
+          GeoIndex::Index(this->database, this->select_query, this->value, result.value);
+    }
 }
 
 void copy_query::Lists()
 {
+     ListStore store(this->database, this->dest);
+     const RocksData& result = this->Get(this->dest);
+
+     if (!result.status.ok() || !store.Load(result.value))
+     {
+          access_set(DBL_NOT_FOUND);
+          return;
+     }
+
+     const std::string& newdest = to_bin(this->value) + ":" + convto_string(this->select_query) + ":" + this->identified;
 
+     if (!store.CopyTo(this->database, newdest))
+     {
+          access_set(DBL_UNABLE_WRITE);
+          return;
+     }
+
+     this->SetOK();
+}
+
+void copy_query::ZSets()
+{
+     ZSetStore store(this->database, this->dest);
+     const RocksData& result = this->Get(this->dest);
+
+     if (!result.status.ok() || !store.Load(result.value))
+     {
+          access_set(DBL_NOT_FOUND);
+          return;
+     }
+
+     const std::string& newdest = to_bin(this->value) + ":" + convto_string(this->select_query) + ":" + this->identified;
+
+     if (!store.CopyTo(this->database, newdest))
+     {
+          access_set(DBL_UNABLE_WRITE);
+          return;
+     }
+
+     this->SetOK();
 }
 
 void copy_query::Vectors()
@@ -58,11 +142,17 @@ void copy_query::Run()
     } 
     else if (this->identified == INT_MAP)
     {
+          /* Items are copied along with the registry. */
+
           this->Maps();
+          return;
     }
     else if (this->identified == INT_MMAP)
     {
+          /* Items are copied along with the registry. */
+
           this->Multis();
+          return;
     }
     else if (this->identified == INT_GEO)
     {
@@ -70,14 +160,24 @@ void copy_query::Run()
     }
     else if (this->identified == INT_LIST)
     {
+          /* Items are copied along with the registry. */
+
           this->Lists();
+          return;
+    }
+    else if (this->identified == INT_ZSET)
+    {
+          /* Members are copied along with the registry. */
+
+          this->ZSets();
+          return;
     }
     else if (this->identified == INT_VECTOR)
     {    
           this->Vectors();
     }   
 
-    RocksData result = this->Get(this->dest);
+    const RocksData& result = this->Get(this->dest);
     const std::string& newdest = to_bin(this->value) + ":" + convto_string(convto_string(this->select_query)) + ":" + this->identified;
     this->Write(newdest, result.value);
 }
@@ -11,10 +11,18 @@
  * More information about our licensing can be found at https://docs.beryl.dev
  */
 
+#include <cstring>
+#include <algorithm>
+
 #include "beryl.h"
 #include "exit.h"
 #include "engine.h"
 #include "brldb/datathread.h"
+#include "brldb/database.h"
+#include "brldb/container.h"
+#include "brldb/list_store.h"
+#include "brldb/map_store.h"
+#include "brldb/geo_index.h"
 #include "managers/user.h"
 #include "managers/settings.h"
 
@@ -28,7 +36,7 @@ bool Database::IsClosing()
         return this->Closing;
 }
 
-Database::Database(const std::string& dbname, const std::string& dbpath) : created(Kernel->Now()), name(dbname), path(Kernel->Config->Paths->SetWDDB(dbpath))
+Database::Database(const std::string& dbname, const std::string& dbpath) : created(Kernel->Now()), name(dbname), path(Kernel->Config->Paths->SetWDDB(dbpath)), format(BRLD_FORMAT_NONE), containers(0)
 {
         this->SetClosing(false);
 }
@@ -43,6 +51,242 @@ UserDatabase::UserDatabase(const std::string& dbname, const std::string& dbpath)
 
 }
 
+namespace
+{
+        /* 
+         * Extracts the encoded key (everything before the first ':') from 
+         * an entry. All types of a given key share the same prefix, 
+         * allowing prefix bloom filters to discard lookups early.
+         */
+
+        class KeyPrefix : public rocksdb::SliceTransform
+        {
+             public:
+
+                const char* Name() const override
+                {
+                        return "beryl.KeyPrefix";
+                }
+
+                rocksdb::Slice Transform(const rocksdb::Slice& key) const override
+                {
+                        const char* found = static_cast<const char*>(memchr(key.data(), ':', key.size()));
+                        return rocksdb::Slice(key.data(), found - key.data());
+                }
+
+                bool InDomain(const rocksdb::Slice& key) const override
+                {
+                        return memchr(key.data(), ':', key.size()) != NULL;
+                }
+        };
+
+        /* 
+         * Finds the column family of a given type. Handles are sorted as 
+         * TypeRegs and then ItemRegs, with the default family at the front.
+         */
+
+        rocksdb::ColumnFamilyHandle* FindHandle(const std::vector<rocksdb::ColumnFamilyHandle*>& handles, const std::string& type)
+        {
+                for (unsigned int i = 0; i < TypeRegs.size(); ++i)
+                {
+                        if (TypeRegs[i] == type)
+                        {
+                                return handles[i + 1];
+                        }
+                }
+
+                for (unsigned int i = 0; i < ItemRegs.size(); ++i)
+                {
+                        if (ItemRegs[i] == type)
+                        {
+                                return handles[TypeRegs.size() + i + 1];
+                        }
+                }
+
+                return handles[0];
+        }
+
+        /* Finds the column family an entry (key:select:type[:database]) belongs to. */
+
+        rocksdb::ColumnFamilyHandle* RouteHandle(const std::vector<rocksdb::ColumnFamilyHandle*>& handles, const std::string& key)
+        {
+                const size_t first = key.find(':');
+                const size_t second = (first == std::string::npos ? first : key.find(':', first + 1));
+
+                if (second == std::string::npos)
+                {
+                        return handles[0];
+                }
+
+                const size_t end = key.find(':', second + 1);
+                return FindHandle(handles, key.substr(second + 1, end == std::string::npos ? end : end - second - 1));
+        }
+
+        /* 
+         * Transcodes a legacy value. Values are made of encoded items, 
+         * separated by ':' (lists, vectors, geos) and '/' (maps).
+         */
+
+        std::string MigrateValue(const std::string& value)
+        {
+                std::string result;
+                std::string item;
+
+                for (std::size_t i = 0; i <= value.size(); ++i)
+                {
+                        if (i == value.size() || value[i] == ':' || value[i] == '/')
+                        {
+                                result += to_bin(legacy_to_string(item));
+
+                                if (i < value.size())
+                                {
+                                        result += value[i];
+                                }
+
+                                item.clear();
+                                continue;
+                        }
+
+                        item += value[i];
+                }
+
+                return result;
+        }
+
+        /* Transcodes a legacy entry. */
+
+        void MigrateEntry(const std::string& rawmap, const std::string& rawvalue, std::string& newkey, std::string& newvalue)
+        {
+                /* Keys are formatted as key:select:type[:database]. */
+
+                const size_t found = rawmap.find_first_of(":");
+
+                if (found == std::string::npos)
+                {
+                        newkey = rawmap;
+                        newvalue = rawvalue;
+                        return;
+                }
+
+                newkey = to_bin(legacy_to_string(rawmap.substr(0, found))) + rawmap.substr(found);
+
+                engine::colon_node_stream stream(rawmap.substr(found + 1));
+                std::string select;
+                std::string type;
+                stream.items_extract(select);
+                stream.items_extract(type);
+
+                /* Expires and futures are stored as plain text. */
+
+                if (type == INT_EXPIRE || type == INT_FUTURE)
+                {
+                        newvalue = rawvalue;
+                }
+                else
+                {
+                        newvalue = MigrateValue(rawvalue);
+                }
+        }
+
+        /* Batches of the transaction open on this thread, one per database (see Database::Begin). */
+
+        typedef std::vector<std::pair<Database*, std::unique_ptr<rocksdb::WriteBatchWithIndex>>> GatheredBatches;
+
+        thread_local std::unique_ptr<GatheredBatches> gathering;
+
+        /* Copies a batch into the batch of an open transaction. */
+
+        class Gather : public rocksdb::WriteBatch::Handler
+        {
+             private:
+
+                rocksdb::DB* db;
+
+                rocksdb::WriteBatchWithIndex* target;
+
+                const std::vector<rocksdb::ColumnFamilyHandle*>& handles;
+
+                rocksdb::ColumnFamilyHandle* Family(uint32_t id) const
+                {
+                        for (std::vector<rocksdb::ColumnFamilyHandle*>::const_iterator i = this->handles.begin(); i != this->handles.end(); ++i)
+                        {
+                                if ((*i)->GetID() == id)
+                                {
+                                        return *i;
+                                }
+                        }
+
+                        return this->handles[0];
+                }
+
+             public:
+
+                Gather(rocksdb::DB* database, rocksdb::WriteBatchWithIndex* batch, const std::vector<rocksdb::ColumnFamilyHandle*>& list) : db(database), target(batch), handles(list)
+                {
+
+                }
+
+                rocksdb::Status PutCF(uint32_t id, const rocksdb::Slice& key, const rocksdb::Slice& value) override
+                {
+                        return this->target->Put(this->Family(id), key, value);
+                }
+
+                rocksdb::Status DeleteCF(uint32_t id, const rocksdb::Slice& key) override
+                {
+                        return this->target->Delete(this->Family(id), key);
+                }
+
+                rocksdb::Status SingleDeleteCF(uint32_t id, const rocksdb::Slice& key) override
+                {
+                        return this->target->Delete(this->Family(id), key);
+                }
+
+                rocksdb::Status MergeCF(uint32_t id, const rocksdb::Slice& key, const rocksdb::Slice& value) override
+                {
+                        return this->target->Merge(this->Family(id), key, value);
+                }
+
+                /* 
+                 * Indexed batches have no range deletions, so entries in range
+                 * are looked up (committed or not) and removed one by one.
+                 */
+
+                rocksdb::Status DeleteRangeCF(uint32_t id, const rocksdb::Slice& begin, const rocksdb::Slice& end) override
+                {
+                        rocksdb::ColumnFamilyHandle* handle = this->Family(id);
+
+                        rocksdb::ReadOptions read_options;
+                        read_options.total_order_seek = true;
+
+                        std::vector<std::string> found;
+
+                        {
+                                std::unique_ptr<rocksdb::Iterator> it(this->target->NewIteratorWithBase(handle, this->db->NewIterator(read_options, handle)));
+
+                                for (it->Seek(begin); it->Valid() && it->key().compare(end) < 0; it->Next())
+                                {
+                                        found.push_back(it->key().ToString());
+                                }
+                        }
+
+                        for (std::vector<std::string>::const_iterator i = found.begin(); i != found.end(); ++i)
+                        {
+                                this->target->Delete(handle, *i);
+                        }
+
+                        return rocksdb::Status::OK();
+                }
+        };
+
+        /* Clears caches of a database, which may hold entries never committed. */
+
+        void Forget(Database* database)
+        {
+                Kernel->Store->Hot->Clear(database->GetName());
+                Kernel->Store->ZSets->Clear(database->GetName());
+        }
+}
+
 void Database::Close()
 {
         if (!this->db)
@@ -53,9 +297,236 @@ void Database::Close()
         slog("DATABASE", LOG_DEFAULT, "Closing database: %s.", this->GetName().c_str());
         bprint(INFO, "Closing database: %s.", this->GetName().c_str());
 
+        this->CloseFamilies(this->db, this->handles);
         delete this->db;
 }
 
+rocksdb::ColumnFamilyHandle* Database::GetHandle(const std::string& type)
+{
+        return FindHandle(this->handles, type);
+}
+
+rocksdb::ColumnFamilyHandle* Database::Route(const std::string& key)
+{
+        return RouteHandle(this->handles, key);
+}
+
+rocksdb::Iterator* Database::NewIterator(const std::string& type)
+{
+        /* Scans may seek using partial keys, which requires total order. */
+
+        rocksdb::ReadOptions read_options;
+        read_options.total_order_seek = true;
+
+        rocksdb::ColumnFamilyHandle* handle = this->GetHandle(type);
+        rocksdb::WriteBatchWithIndex* gathered = this->Gathered(false);
+
+        if (!gathered)
+        {
+                return this->db->NewIterator(read_options, handle);
+        }
+
+        return gathered->NewIteratorWithBase(handle, this->db->NewIterator(read_options, handle));
+}
+
+rocksdb::Status Database::Get(rocksdb::ColumnFamilyHandle* handle, const std::string& key, std::string* value)
+{
+        rocksdb::WriteBatchWithIndex* gathered = this->Gathered(false);
+
+        if (!gathered)
+        {
+                return this->db->Get(rocksdb::ReadOptions(), handle, key, value);
+        }
+
+        return gathered->GetFromBatchAndDB(this->db, rocksdb::ReadOptions(), handle, key, value);
+}
+
+rocksdb::Status Database::Get(rocksdb::ColumnFamilyHandle* handle, const std::string& key, rocksdb::PinnableSlice* value)
+{
+        rocksdb::WriteBatchWithIndex* gathered = this->Gathered(false);
+
+        if (!gathered)
+        {
+                return this->db->Get(rocksdb::ReadOptions(), handle, key, value);
+        }
+
+        return gathered->GetFromBatchAndDB(this->db, rocksdb::ReadOptions(), handle, key, value);
+}
+
+void Database::MultiGet(rocksdb::ColumnFamilyHandle* handle, size_t total, const rocksdb::Slice* keys, rocksdb::PinnableSlice* values, rocksdb::Status* statuses, bool sorted)
+{
+        rocksdb::WriteBatchWithIndex* gathered = this->Gathered(false);
+
+        if (!gathered)
+        {
+                this->db->MultiGet(rocksdb::ReadOptions(), handle, total, keys, values, statuses, sorted);
+                return;
+        }
+
+        gathered->MultiGetFromBatchAndDB(this->db, rocksdb::ReadOptions(), handle, total, keys, values, statuses, sorted);
+}
+
+rocksdb::Status Database::Write(rocksdb::WriteBatch& batch)
+{
+        DataFlush::Written();
+
+        rocksdb::WriteBatchWithIndex* gathered = this->Gathered(true);
+
+        if (gathered)
+        {
+                Gather handler(this->db, gathered, this->handles);
+                return batch.Iterate(&handler);
+        }
+
+        return this->db->Write(rocksdb::WriteOptions(), &batch);
+}
+
+rocksdb::Status Database::Put(rocksdb::ColumnFamilyHandle* handle, const std::string& key, const std::string& value)
+{
+        DataFlush::Written();
+
+        rocksdb::WriteBatchWithIndex* gathered = this->Gathered(true);
+
+        if (gathered)
+        {
+                return gathered->Put(handle, key, value);
+        }
+
+        return this->db->Put(rocksdb::WriteOptions(), handle, key, value);
+}
+
+rocksdb::Status Database::Delete(rocksdb::ColumnFamilyHandle* handle, const std::string& key)
+{
+        DataFlush::Written();
+
+        rocksdb::WriteBatchWithIndex* gathered = this->Gathered(true);
+
+        if (gathered)
+        {
+                return gathered->Delete(handle, key);
+        }
+
+        return this->db->Delete(rocksdb::WriteOptions(), handle, key);
+}
+
+rocksdb::WriteBatchWithIndex* Database::Gathered(bool create)
+{
+        if (!gathering)
+        {
+                return NULL;
+        }
+
+        for (GatheredBatches::const_iterator i = gathering->begin(); i != gathering->end(); ++i)
+        {
+                if (i->first == this)
+                {
+                        return i->second.get();
+                }
+        }
+
+        if (!create)
+        {
+                return NULL;
+        }
+
+        /* Entries written twice are overwritten, so iterators see them once. */
+
+        gathering->push_back(std::make_pair(this, std::unique_ptr<rocksdb::WriteBatchWithIndex>(new rocksdb::WriteBatchWithIndex(rocksdb::BytewiseComparator(), 0, true))));
+        return gathering->back().second.get();
+}
+
+void Database::Begin()
+{
+        gathering.reset(new GatheredBatches());
+}
+
+bool Database::Commit()
+{
+        std::unique_ptr<GatheredBatches> batches(std::move(gathering));
+
+        if (!batches)
+        {
+                return true;
+        }
+
+        bool written = true;
+
+        for (GatheredBatches::const_iterator i = batches->begin(); i != batches->end(); ++i)
+        {
+                if (written && i->first->db->Write(rocksdb::WriteOptions(), i->second->GetWriteBatch()).ok())
+                {
+                        continue;
+                }
+
+                written = false;
+                Forget(i->first);
+        }
+
+        return written;
+}
+
+void Database::Discard()
+{
+        std::unique_ptr<GatheredBatches> batches(std::move(gathering));
+
+        if (!batches)
+        {
+                return;
+        }
+
+        for (GatheredBatches::const_iterator i = batches->begin(); i != batches->end(); ++i)
+        {
+                Forget(i->first);
+        }
+}
+
+bool Database::Gathering()
+{
+        return gathering.get() != NULL;
+}
+
+rocksdb::Status Database::OpenFamilies(const std::string& dbpath, rocksdb::DB** dbptr, std::vector<rocksdb::ColumnFamilyHandle*>& list)
+{
+        static std::shared_ptr<const rocksdb::SliceTransform> prefix = std::make_shared<KeyPrefix>();
+
+        rocksdb::ColumnFamilyOptions family(options);
+        family.prefix_extractor = prefix;
+        family.memtable_prefix_bloom_size_ratio = 0.02;
+
+        std::vector<rocksdb::ColumnFamilyDescriptor> descriptors;
+        descriptors.push_back(rocksdb::ColumnFamilyDescriptor(rocksdb::kDefaultColumnFamilyName, rocksdb::ColumnFamilyOptions(options)));
+
+        for (std::vector<std::string>::const_iterator iter = TypeRegs.begin(); iter != TypeRegs.end(); ++iter)
+        {
+                descriptors.push_back(rocksdb::ColumnFamilyDescriptor("type_" + *iter, family));
+        }
+
+        /* Items are keyed by an 8 byte container id, followed by their own key. */
+
+        static std::shared_ptr<const rocksdb::SliceTransform> container(rocksdb::NewFixedPrefixTransform(8));
+
+        rocksdb::ColumnFamilyOptions items(options);
+        items.prefix_extractor = container;
+        items.memtable_prefix_bloom_size_ratio = 0.02;
+
+        for (std::vector<std::string>::const_iterator iter = ItemRegs.begin(); iter != ItemRegs.end(); ++iter)
+        {
+                descriptors.push_back(rocksdb::ColumnFamilyDescriptor("items_" + *iter, items));
+        }
+
+        return rocksdb::DB::Open(rocksdb::DBOptions(options), dbpath, descriptors, &list, dbptr);
+}
+
+void Database::CloseFamilies(rocksdb::DB* target, std::vector<rocksdb::ColumnFamilyHandle*>& list)
+{
+        for (std::vector<rocksdb::ColumnFamilyHandle*>::iterator iter = list.begin(); iter != list.end(); ++iter)
+        {
+                target->DestroyColumnFamilyHandle(*iter);
+        }
+
+        list.clear();
+}
+
 bool Database::Open()
 {	
         this->db = NULL;
@@ -65,12 +536,15 @@ bool Database::Open()
 
         options.env 				= Kernel->Store->GetEnv();
         options.create_if_missing 		= Kernel->Config->DB.createim;
+        options.create_missing_column_families 	= true;
         options.keep_log_file_num 		= 1;
         options.write_thread_max_yield_usec 	= Kernel->Config->DB.yieldusec;
         options.enable_thread_tracking 		= true;
         options.enable_pipelined_write 		= Kernel->Config->DB.pipeline;
 
-        this->status 				= rocksdb::DB::Open(options, this->path, &this->db);
+        Kernel->Store->Tune(options);
+
+        this->status 				= this->OpenFamilies(this->path, &this->db, this->handles);
 
         slog("DATABASE", LOG_VERBOSE, "Database opened: %s", this->path.c_str());
 
@@ -85,9 +559,555 @@ bool Database::Open()
                 slog("DATABASE", LOG_DEFAULT, "Database opened: %s: %s", this->path.c_str(), this->status.ToString().c_str());
         }
 
+        this->format = this->DetectFormat();
+
+        if (this->format != BRLD_FORMAT_CURRENT)
+        {
+                if (!Kernel->Config->DB.migrate)
+                {
+                        bprint(ERROR, "Database %s uses an old format and migrations are disabled.", this->name.c_str());
+                        slog("DATABASE", LOG_DEFAULT, "Database %s uses an old format and migrations are disabled.", this->name.c_str());
+                        Kernel->Exit(EXIT_CODE_DATABASE, true, true);
+                }
+
+                /* Migrations are applied in order, one format at a time. */
+
+                if ((this->format < BRLD_FORMAT_FAMILIES && !this->Migrate()) || (this->format < BRLD_FORMAT_LISTS && !this->MigrateLists())
+                    || (this->format < BRLD_FORMAT_MAPS && !this->MigrateMaps()) || (this->format < BRLD_FORMAT_GEOS && !this->MigrateGeos())
+                    || (this->format < BRLD_FORMAT_POSITIONS && !this->MigratePositions()))
+                {
+                        bprint(ERROR, "Unable to migrate database: %s", this->name.c_str());
+                        slog("DATABASE", LOG_DEFAULT, "Unable to migrate database: %s", this->name.c_str());
+                        Kernel->Exit(EXIT_CODE_DATABASE, true, true);
+                }
+        }
+
+        this->LoadContainers();
+        return true;
+}
+
+BRLD_FORMAT Database::DetectFormat()
+{
+        std::string dbvalue;
+        rocksdb::Status fstatus = this->db->Get(rocksdb::ReadOptions(), FORMAT_KEY, &dbvalue);
+
+        if (fstatus.ok())
+        {
+                return static_cast<BRLD_FORMAT>(convto_num<unsigned int>(dbvalue));
+        }
+
+        /* No marker: an empty database is created using the current format. */
+
+        std::unique_ptr<rocksdb::Iterator> it(this->db->NewIterator(rocksdb::ReadOptions()));
+        it->SeekToFirst();
+
+        if (it->Valid())
+        {
+                return BRLD_FORMAT_LEGACY;
+        }
+
+        this->db->Put(rocksdb::WriteOptions(), FORMAT_KEY, convto_string(BRLD_FORMAT_CURRENT));
+        return BRLD_FORMAT_CURRENT;
+}
+
+bool Database::Migrate()
+{
+        const bool legacy = (this->format == BRLD_FORMAT_LEGACY);
+        const std::string temp_path = this->path + ".migrate";
+        
+        bprint(INFO, "Migrating database: %s.", this->name.c_str());
+        slog("DATABASE", LOG_DEFAULT, "Migrating database: %s.", this->name.c_str());
+
+        /* 
+         * Compact databases are moved into column families in place. Legacy 
+         * ones are transcoded into a temporary database first.
+         */
+
+        rocksdb::DB* target = this->db;
+        std::vector<rocksdb::ColumnFamilyHandle*> target_handles = this->handles;
+        rocksdb::Options d_options;
+        rocksdb::Status tstatus;
+
+        if (legacy)
+        {
+                /* Leftovers from an interrupted migration are discarded. */
+
+                rocksdb::DestroyDB(temp_path, d_options);
+                target_handles.clear();
+
+                tstatus = this->OpenFamilies(temp_path, &target, target_handles);
+
+                if (!tstatus.ok())
+                {
+                        return false;
+                }
+        }
+
+        unsigned int total_counter = 0;
+        rocksdb::WriteBatch batch;
+        std::unique_ptr<rocksdb::Iterator> it(this->db->NewIterator(rocksdb::ReadOptions()));
+
+        for (it->SeekToFirst(); it->Valid(); it->Next()) 
+        {
+                const std::string& rawmap = it->key().ToString();
+
+                if (rawmap == FORMAT_KEY)
+                {
+                        continue;
+                }
+
+                std::string newkey = rawmap;
+                std::string newvalue = it->value().ToString();
+
+                if (legacy)
+                {
+                        MigrateEntry(rawmap, it->value().ToString(), newkey, newvalue);
+                }
+                else
+                {
+                        batch.Delete(rawmap);
+                }
+
+                batch.Put(RouteHandle(target_handles, newkey), newkey, newvalue);
+
+                if (++total_counter % MIGRATE_BATCH == 0)
+                {
+                        tstatus = target->Write(rocksdb::WriteOptions(), &batch);
+                        batch.Clear();
+
+                        if (!tstatus.ok())
+                        {
+                                break;
+                        }
+                }
+        }
+
+        it.reset();
+
+        if (tstatus.ok())
+        {
+                batch.Put(FORMAT_KEY, convto_string(BRLD_FORMAT_FAMILIES));
+                tstatus = target->Write(rocksdb::WriteOptions(), &batch);
+        }
+
+        if (!legacy)
+        {
+                if (!tstatus.ok())
+                {
+                        return false;
+                }
+
+                this->format = BRLD_FORMAT_FAMILIES;
+
+                iprint((int)total_counter, "Entries migrated in %s.", this->name.c_str());
+                slog("DATABASE", LOG_DEFAULT, "Database migrated: %s (%u entries).", this->name.c_str(), total_counter);
+                return true;
+        }
+
+        this->CloseFamilies(target, target_handles);
+        delete target;
+
+        if (!tstatus.ok())
+        {
+                rocksdb::DestroyDB(temp_path, d_options);
+                return false;
+        }
+
+        /* Swaps migrated database with the original one. */
+
+        this->CloseFamilies(this->db, this->handles);
+        delete this->db;
+        this->db = NULL;
+
+        const std::string old_path = this->path + ".legacy";
+
+        if (std::rename(this->path.c_str(), old_path.c_str()) != 0)
+        {
+                return false;
+        }
+
+        if (std::rename(temp_path.c_str(), this->path.c_str()) != 0)
+        {
+                std::rename(old_path.c_str(), this->path.c_str());
+                return false;
+        }
+
+        this->status = this->OpenFamilies(this->path, &this->db, this->handles);
+
+        if (!this->status.ok())
+        {
+                return false;
+        }
+
+        FileSystem::RemoveDir(old_path.c_str());
+
+        this->format = BRLD_FORMAT_FAMILIES;
+
+        iprint((int)total_counter, "Entries migrated in %s.", this->name.c_str());
+        slog("DATABASE", LOG_DEFAULT, "Database migrated: %s (%u entries).", this->name.c_str(), total_counter);
+        return true;
+}
+
+bool Database::MigrateLists()
+{
+        bprint(INFO, "Migrating lists: %s.", this->name.c_str());
+        slog("DATABASE", LOG_DEFAULT, "Migrating lists: %s.", this->name.c_str());
+
+        unsigned int total_counter = 0;
+        uint64_t container = 0;
+
+        rocksdb::Status tstatus;
+        rocksdb::WriteBatch batch;
+        rocksdb::ColumnFamilyHandle* lists = this->GetHandle(INT_LIST);
+        rocksdb::ColumnFamilyHandle* items = this->GetHandle(INT_LIST_ITEM);
+
+        /* 
+         * Last list migrated is saved along every batch, so an interrupted
+         * migration resumes after it, instead of splitting a list twice.
+         */
+
+        const std::string progress = "lists:0:" + INT_FORMAT;
+        std::string last;
+
+        std::unique_ptr<rocksdb::Iterator> it(this->NewIterator(INT_LIST));
+
+        if (this->db->Get(rocksdb::ReadOptions(), progress, &last).ok())
+        {
+                container = convto_num<uint64_t>(last.substr(0, last.find(':')));
+                last = last.substr(last.find(':') + 1);
+                it->Seek(last);
+
+                if (it->Valid() && it->key() == last)
+                {
+                        it->Next();
+                }
+        }
+        else
+        {
+                it->SeekToFirst();
+        }
+
+        for (; it->Valid(); it->Next()) 
+        {
+                /* Lists were stored as item:item:item: */
+
+                engine::colon_node_stream stream(it->value().ToString());
+                std::string item;
+                uint64_t seq = 0;
+
+                container++;
+
+                while (stream.items_extract(item))
+                {
+                        batch.Put(items, ListStore::ItemKey(container, seq++), to_string(item));
+                }
+
+                batch.Put(lists, it->key(), ListStore::Registry(container, 0, seq));
+
+                if (++total_counter % MIGRATE_BATCH == 0)
+                {
+                        batch.Put(progress, convto_string(container) + ":" + it->key().ToString());
+                        tstatus = this->db->Write(rocksdb::WriteOptions(), &batch);
+                        batch.Clear();
+
+                        if (!tstatus.ok())
+                        {
+                                return false;
+                        }
+                }
+        }
+
+        it.reset();
+
+        batch.Delete(progress);
+        batch.Put(FORMAT_KEY, convto_string(BRLD_FORMAT_LISTS));
+        tstatus = this->db->Write(rocksdb::WriteOptions(), &batch);
+
+        if (!tstatus.ok())
+        {
+                return false;
+        }
+
+        this->format = BRLD_FORMAT_LISTS;
+
+        iprint((int)total_counter, "Lists migrated in %s.", this->name.c_str());
+        slog("DATABASE", LOG_DEFAULT, "Lists migrated: %s (%u lists).", this->name.c_str(), total_counter);
+        return true;
+}
+
+bool Database::MigrateMaps()
+{
+        bprint(INFO, "Migrating maps: %s.", this->name.c_str());
+        slog("DATABASE", LOG_DEFAULT, "Migrating maps: %s.", this->name.c_str());
+
+        /* Ids are handed out after those used by lists, or by a previous run. */
+
+        this->LoadContainers();
+
+        unsigned int total_counter = 0;
+
+        rocksdb::Status tstatus;
+        rocksdb::WriteBatch batch;
+
+        const std::vector<std::string> types = { INT_MAP, INT_MMAP };
+
+        for (std::vector<std::string>::const_iterator type = types.begin(); type != types.end(); ++type)
+        {
+                const bool multi = (*type == INT_MMAP);
+
+                rocksdb::ColumnFamilyHandle* maps = this->GetHandle(*type);
+                rocksdb::ColumnFamilyHandle* items = this->GetHandle(multi ? INT_MMAP_ITEM : INT_MAP_ITEM);
+
+                /* Last map migrated, kept per type. */
+
+                const std::string progress = "maps:" + *type + ":" + INT_FORMAT;
+                std::string last, done;
+
+                std::unique_ptr<rocksdb::Iterator> it(this->NewIterator(*type));
+
+                if (this->db->Get(rocksdb::ReadOptions(), progress, &last).ok())
+                {
+                        it->Seek(last);
+
+                        if (it->Valid() && it->key() == last)
+                        {
+                                it->Next();
+                        }
+                }
+                else
+                {
+                        it->SeekToFirst();
+                }
+
+                for (; it->Valid(); it->Next())
+                {
+                        /* Maps were stored as field/value:field/value: */
+
+                        const uint64_t container = this->NewContainer();
+                        uint64_t seq = 0;
+
+                        if (multi)
+                        {
+                                std::shared_ptr<MultiMapHandler> handler = MultiMapHandler::Create(it->value().ToString());
+                                MultiMap& all = handler->GetList();
+
+                                for (MultiMap::const_iterator i = all.begin(); i != all.end(); ++i)
+                                {
+                                        batch.Put(items, MapStore::ItemKey(true, container, i->first, seq++), i->second);
+                                }
+                        }
+                        else
+                        {
+                                std::shared_ptr<MapHandler> handler = MapHandler::Create(it->value().ToString());
+                                MapMap& all = handler->GetList();
+
+                                for (MapMap::const_iterator i = all.begin(); i != all.end(); ++i)
+                                {
+                                        batch.Put(items, MapStore::ItemKey(false, container, i->first), i->second);
+                                        seq++;
+                                }
+                        }
+
+                        if (!seq)
+                        {
+                                batch.Delete(maps, it->key());
+                        }
+                        else
+                        {
+                                batch.Put(maps, it->key(), MapStore::Registry(container, seq, seq));
+                        }
+
+                        done = it->key().ToString();
+
+                        if (++total_counter % MIGRATE_BATCH == 0)
+                        {
+                                batch.Put(progress, it->key());
+                                tstatus = this->db->Write(rocksdb::WriteOptions(), &batch);
+                                batch.Clear();
+
+                                if (!tstatus.ok())
+                                {
+                                        return false;
+                                }
+                        }
+                }
+
+                /* Pending maps of this type are written before moving on. */
+
+                if (!done.empty())
+                {
+                        batch.Put(progress, done);
+                        tstatus = this->db->Write(rocksdb::WriteOptions(), &batch);
+                        batch.Clear();
+
+                        if (!tstatus.ok())
+                        {
+                                return false;
+                        }
+                }
+        }
+
+        for (std::vector<std::string>::const_iterator type = types.begin(); type != types.end(); ++type)
+        {
+                batch.Delete("maps:" + *type + ":" + INT_FORMAT);
+        }
+
+        batch.Put(FORMAT_KEY, convto_string(BRLD_FORMAT_MAPS));
+        tstatus = this->db->Write(rocksdb::WriteOptions(), &batch);
+
+        if (!tstatus.ok())
+        {
+                return false;
+        }
+
+        this->format = BRLD_FORMAT_MAPS;
+
+        iprint((int)total_counter, "Maps migrated in %s.", this->name.c_str());
+        slog("DATABASE", LOG_DEFAULT, "Maps migrated: %s (%u maps).", this->name.c_str(), total_counter);
         return true;
 }
 
+bool Database::MigrateGeos()
+{
+        bprint(INFO, "Indexing geo entries: %s.", this->name.c_str());
+        slog("DATABASE", LOG_DEFAULT, "Indexing geo entries: %s.", this->name.c_str());
+
+        unsigned int total_counter = 0;
+
+        rocksdb::Status tstatus;
+        rocksdb::WriteBatch batch;
+
+        rocksdb::ColumnFamilyHandle* index = this->GetHandle(INT_GEO_ITEM);
+        std::unique_ptr<rocksdb::Iterator> it(this->NewIterator(INT_GEO));
+
+        /* Index entries are idempotent, so an interrupted run just starts over. */
+
+        for (it->SeekToFirst(); it->Valid(); it->Next())
+        {
+                const std::string& rawmap = it->key().ToString();
+
+                engine::colon_node_stream stream(rawmap);
+                std::string key, select;
+
+                if (!stream.items_extract(key) || !stream.items_extract(select))
+                {
+                        continue;
+                }
+
+                double latitude, longitude;
+
+                if (!GeoIndex::ParseLegacy(it->value().ToString(), latitude, longitude))
+                {
+                        continue;
+                }
+
+                batch.Put(index, GeoIndex::Entry(convto_num<unsigned int>(select), to_string(key), latitude, longitude), GeoIndex::Position(latitude, longitude));
+
+                if (++total_counter % MIGRATE_BATCH == 0)
+                {
+                        tstatus = this->db->Write(rocksdb::WriteOptions(), &batch);
+                        batch.Clear();
+
+                        if (!tstatus.ok())
+                        {
+                                return false;
+                        }
+                }
+        }
+
+        batch.Put(FORMAT_KEY, convto_string(BRLD_FORMAT_GEOS));
+        tstatus = this->db->Write(rocksdb::WriteOptions(), &batch);
+
+        if (!tstatus.ok())
+        {
+                return false;
+        }
+
+        this->format = BRLD_FORMAT_GEOS;
+
+        iprint((int)total_counter, "Geo entries indexed in %s.", this->name.c_str());
+        slog("DATABASE", LOG_DEFAULT, "Geo entries indexed: %s (%u entries).", this->name.c_str(), total_counter);
+        return true;
+}
+
+bool Database::MigratePositions()
+{
+        bprint(INFO, "Packing geo entries: %s.", this->name.c_str());
+        slog("DATABASE", LOG_DEFAULT, "Packing geo entries: %s.", this->name.c_str());
+
+        unsigned int total_counter = 0;
+
+        rocksdb::Status tstatus;
+        rocksdb::WriteBatch batch;
+
+        rocksdb::ColumnFamilyHandle* geos = this->GetHandle(INT_GEO);
+        std::unique_ptr<rocksdb::Iterator> it(this->NewIterator(INT_GEO));
+
+        /* Entries packed by an interrupted run are no longer text, and are skipped. */
+
+        for (it->SeekToFirst(); it->Valid(); it->Next())
+        {
+                double latitude, longitude;
+
+                if (!GeoIndex::ParseLegacy(it->value().ToString(), latitude, longitude))
+                {
+                        continue;
+                }
+
+                batch.Put(geos, it->key(), GeoIndex::Position(latitude, longitude));
+
+                if (++total_counter % MIGRATE_BATCH == 0)
+                {
+                        tstatus = this->db->Write(rocksdb::WriteOptions(), &batch);
+                        batch.Clear();
+
+                        if (!tstatus.ok())
+                        {
+                                return false;
+                        }
+                }
+        }
+
+        batch.Put(FORMAT_KEY, convto_string(BRLD_FORMAT_POSITIONS));
+        tstatus = this->db->Write(rocksdb::WriteOptions(), &batch);
+
+        if (!tstatus.ok())
+        {
+                return false;
+        }
+
+        this->format = BRLD_FORMAT_POSITIONS;
+
+        iprint((int)total_counter, "Geo entries packed in %s.", this->name.c_str());
+        slog("DATABASE", LOG_DEFAULT, "Geo entries packed: %s (%u entries).", this->name.c_str(), total_counter);
+        return true;
+}
+
+void Database::LoadContainers()
+{
+        uint64_t highest = 0;
+
+        for (std::vector<std::string>::const_iterator iter = ItemRegs.begin(); iter != ItemRegs.end(); ++iter)
+        {
+                /* Geo index is keyed by select, not by container. */
+
+                if (*iter == INT_GEO_ITEM)
+                {
+                        continue;
+                }
+
+                std::unique_ptr<rocksdb::Iterator> it(this->NewIterator(*iter));
+                it->SeekToLast();
+
+                if (it->Valid())
+                {
+                        highest = std::max(highest, Container::GetId(it->key()));
+                }
+        }
+
+        this->containers = highest;
+}
+
 bool Database::FlushDB()
 {
         if (!this->db)
@@ -106,6 +1126,8 @@ bool Database::FlushDB()
         
         Kernel->Store->Expires->DatabaseDestroy(this->GetName());
         Kernel->Store->Futures->DatabaseDestroy(this->GetName());
+        Kernel->Store->Hot->Clear(this->GetName());
+        Kernel->Store->ZSets->Clear(this->GetName());
         
         rocksdb::Options d_options;
         rocksdb::DestroyDB(this->path, d_options);
@@ -199,13 +1221,113 @@ StoreManager::~StoreManager()
        env = NULL;
 }
 
+namespace
+{
+        rocksdb::CompressionType GetCompression(const std::string& name)
+        {
+                if (stdhelpers::string::equalsci(name, "lz4"))
+                {
+                        return rocksdb::kLZ4Compression;
+                }
+
+                if (stdhelpers::string::equalsci(name, "zstd"))
+                {
+                        return rocksdb::kZSTD;
+                }
+
+                return rocksdb::kNoCompression;
+        }
+}
+
+void StoreManager::Tune(rocksdb::Options& options)
+{
+       const DBOptions& tuning = Kernel->Config->DB;
+
+       if (!this->tables)
+       {
+              const size_t capacity = (size_t)tuning.cachesize << 20;
+
+              rocksdb::BlockBasedTableOptions table;
+
+              if (!capacity)
+              {
+                     table.no_block_cache = true;
+              }
+              else if (stdhelpers::string::equalsci(tuning.cachetype, "hyperclock"))
+              {
+                     this->cache = rocksdb::HyperClockCacheOptions(capacity, 0).MakeSharedCache();
+              }
+              else
+              {
+                     rocksdb::LRUCacheOptions lru;
+                     lru.capacity = capacity;
+                     this->cache = lru.MakeSharedCache();
+              }
+
+              table.block_cache = this->cache;
+
+              /* 
+               * Index and filter blocks are charged to the shared cache, so memory
+               * stays bounded regardless of the number of databases opened.
+               */
+
+              table.cache_index_and_filter_blocks = (this->cache != NULL);
+              table.pin_l0_filter_and_index_blocks_in_cache = (this->cache != NULL);
+
+              if (tuning.bloombits)
+              {
+                     table.filter_policy.reset(rocksdb::NewBloomFilterPolicy(tuning.bloombits, false));
+                     table.whole_key_filtering = tuning.wholekey;
+                     table.optimize_filters_for_memory = true;
+              }
+
+              this->tables.reset(rocksdb::NewBlockBasedTableFactory(table));
+
+              if (tuning.writebuffer)
+              {
+                     this->buffers = std::make_shared<rocksdb::WriteBufferManager>((size_t)tuning.writebuffer << 20);
+              }
+
+              slog("DATABASE", LOG_VERBOSE, "Tuning: %u MB %s cache, %u bloom bits, %s/%s compression.", tuning.cachesize, tuning.cachetype.c_str(), tuning.bloombits, tuning.compression.c_str(), tuning.bottommost.c_str());
+       }
+
+       options.table_factory = this->tables;
+       options.write_buffer_manager = this->buffers;
+
+       if (tuning.bloombits && tuning.wholekey)
+       {
+              options.memtable_whole_key_filtering = true;
+       }
+
+       /* Two first levels are left uncompressed, as they are rewritten often. */
+
+       const rocksdb::CompressionType upper = GetCompression(tuning.compression);
+
+       options.compression_per_level.assign(options.num_levels, upper);
+
+       for (int level = 0; level < std::min(2, options.num_levels); level++)
+       {
+              options.compression_per_level[level] = rocksdb::kNoCompression;
+       }
+
+       options.compression = upper;
+       options.bottommost_compression = GetCompression(tuning.bottommost);
+}
+
 void StoreManager::OpenAll()
 {
        unsigned int counter = 0;
 
+       /* In-memory caches are sized before any thread may use them. */
+
+       this->Hot->Configure(Kernel->Config->DB.hotkeys);
+       this->ZSets->Configure(Kernel->Config->DB.zsetitems);
+
+       Kernel->Store->Flusher->Open();
+
        for (unsigned int i = 1; i <= Kernel->Config->DB.datathread; i++)
        {
-              DataThread* New = new DataThread();   
+              DataThread* New = new DataThread(i - 1);   
               New->Create();
               Kernel->Store->Flusher->threadslist.push_back(New);
               counter++;
@@ -230,6 +1352,9 @@ void StoreManager::Push(std::shared_ptr<QueryBase> request)
            return;
       }
 
-      user->pending.push_back(request);       
+      /* Serializer of an user does not change while its queries are pending. */
+
+      request->delimited = user->IsDelimited();
+      DataFlush::Queue(user, request);
 }
 
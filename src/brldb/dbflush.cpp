@@ -15,6 +15,10 @@
 #include "engine.h"
 #include "algo.h"
 
+#if defined(__linux__)
+#include <pthread.h>
+#endif
+
 namespace 
 {
       void CheckFlush(User* user, std::shared_ptr<QueryBase> signal)
@@ -87,10 +91,29 @@ namespace
       }
 }
 
-std::mutex DataFlush::query_mute;
+std::shared_timed_mutex DataFlush::query_mute;
 
 std::mutex DataFlush::mute;
 
+std::set<User*> DataFlush::awaiting;
+
+std::set<User*> DataFlush::notified;
+
+namespace
+{
+      /* Query being run by current thread. Partial results inherit its sequence. */
+
+      thread_local QueryBase* current = NULL;
+
+      /* Writes made by query being run by current thread. */
+
+      thread_local unsigned int written = 0;
+
+      /* Writes whose keys this query has touched itself. */
+
+      thread_local unsigned int touched = 0;
+}
+
 void DataFlush::Pause()
 {
       this->running = false;
@@ -113,13 +136,24 @@ DataFlush::DataFlush() : running(false)
 
 void DataFlush::AttachResult(const std::shared_ptr<QueryBase> signal)
 {
-            if (!signal)
+            if (!signal || signal->user == Kernel->Clients->Global)
             {
                  return;
             }
             
-            std::lock_guard<std::mutex> lg(DataFlush::mute);
-            signal->user->notifications.push_back(signal);
+            /* Partial results of queries within a transaction are delivered along with it. */
+
+            if (current && current != signal.get() && current->user == signal->user && current->Collect(signal))
+            {
+                 return;
+            }
+
+            if (!signal->sequence && current && current->user == signal->user)
+            {
+                 signal->sequence = current->sequence;
+            }
+
+            Kernel->Store->Flusher->completed.Push(signal);
 }
 
 void DataFlush::AttachGlobal(const std::shared_ptr<QueryBase> signal)
@@ -131,55 +165,170 @@ void DataFlush::AttachGlobal(const std::shared_ptr<QueryBase> signal)
 
             std::lock_guard<std::mutex> lg(DataFlush::mute);
             signal->Process();
-            signal->user->SetLock(false);
 }
 
-void DataFlush::GetResults()
+void DataFlush::FlushResults(User* user)
 {
-            const UserMap& users = Kernel->Clients->GetInstances();
-            
-            if (!users.size())
-            {
-                  return;
-            }
+            std::deque<std::shared_ptr<QueryBase>>& results = user->notifications;
 
-            DataFlush::mute.lock();
-            
-            for (UserMap::const_iterator i = users.begin(); i != users.end(); ++i)
+            for (std::deque<std::shared_ptr<QueryBase>>::iterator i = results.begin(); i != results.end(); )
             {
-                        User* const user = i->second;
+                        std::shared_ptr<QueryBase> signal = *i;
 
-                        if (user == NULL || user->IsQuitting() || !user->notifications.size())
+                        /* Results of later queries wait until previous ones are delivered. */
+
+                        if (signal->sequence > user->delivered)
                         {
+                              ++i;
                               continue;
                         }
-                        
-                        /* Nothing to iterate if user has no pending notifications. */
 
-                        if (user->notifications.size())
+                        i = results.erase(i);
+
+                        /* Left behind by ResetAll(). */
+
+                        if (signal->sequence && signal->sequence < user->delivered)
                         {
-                              std::shared_ptr<QueryBase> signal = user->notifications.front();
-                              
-                              /* Removes signal from queue. */
-                              
-                              user->notifications.pop_front();
-                              
-                              if (!signal->GetStatus())
-                              {
-                                    LocalUser* localuser = IS_LOCAL(user);
-                                    NOTIFY_MODS(OnQueryFailed, (signal->access, localuser, signal));
-                              }
-                              
-                              CheckFlush(user, signal);
-                              
-                              if (!signal->partial)
+                              continue;
+                        }
+
+                        if (!user->IsQuitting() && signal->access != DBL_INTERRUPT)
+                        {
+                              user->delivering = true;
+                              DataFlush::Reply(user, signal);
+                              user->delivering = false;
+                        }
+
+                        if (signal->sequence && !signal->partial)
+                        {
+                              user->delivered++;
+                              user->inflight--;
+
+                              /* Output of pipelined commands that followed this query. */
+
+                              LocalUser* const localuser = IS_LOCAL(user);
+
+                              if (localuser)
                               {
-                              user->SetLock(false);
+                                    localuser->Release();
                               }
+
+                              /* Results that arrived earlier may be next. */
+
+                              i = results.begin();
+                        }
+            }
+}
+
+void DataFlush::Reply(User* user, const std::shared_ptr<QueryBase>& signal)
+{
+            if (!signal->GetStatus())
+            {
+                  LocalUser* localuser = IS_LOCAL(user);
+                  NOTIFY_MODS(OnQueryFailed, (signal->access, localuser, signal));
+            }
+
+            CheckFlush(user, signal);
+}
+
+void DataFlush::Written()
+{
+            written++;
+}
+
+void DataFlush::Touched()
+{
+            touched++;
+}
+
+void DataFlush::Execute(QueryBase* request)
+{
+            written = touched = 0;
+            request->Prepare();
+
+            /* Only writes whose keys are yet to be touched are left. */
+
+            const bool pending = (written > touched);
+            written = touched = 0;
+
+            if (!pending)
+            {
+                  return;
+            }
+
+            if (Kernel->Store->Watches->Active())
+            {
+                  if (request->Exclusive() || !request->database)
+                  {
+                        Kernel->Store->Watches->TouchAll();
+                  }
+                  else
+                  {
+                        Kernel->Store->Watches->Touch(WatchTable::Build(request->database, request->select_query, request->key));
                   }
             }
-            
-            DataFlush::mute.unlock();
+}
+
+void DataFlush::Forget(User* user)
+{
+            DataFlush::awaiting.erase(user);
+            DataFlush::notified.erase(user);
+}
+
+bool DataFlush::Pending()
+{
+            /* Queries that cannot be dispatched yet are not worth spinning for. */
+
+            User* const global = Kernel->Clients->Global;
+
+            if (global->pending.size() && Accepts(global->pending.front()))
+            {
+                  return true;
+            }
+
+            for (std::set<User*>::const_iterator i = DataFlush::awaiting.begin(); i != DataFlush::awaiting.end(); ++i)
+            {
+                  User* const user = *i;
+
+                  if (user->pending.size() && user->inflight < Kernel->Config->DB.depth && Ready(user, user->pending.front()) && Accepts(user->pending.front()))
+                  {
+                        return true;
+                  }
+            }
+
+            return false;
+}
+
+void DataFlush::GetResults()
+{
+            CompletionQueue& completed = Kernel->Store->Flusher->completed;
+            std::shared_ptr<QueryBase> signal;
+
+            /* Results pushed from now on wake up the mainloop again. */
+
+            completed.Drain();
+
+            while (completed.Pop(signal))
+            {
+                        signal->user->notifications.push_back(signal);
+                        DataFlush::notified.insert(signal->user);
+            }
+
+            for (std::set<User*>::iterator i = DataFlush::notified.begin(); i != DataFlush::notified.end(); )
+            {
+                        User* const user = *i;
+
+                        DataFlush::FlushResults(user);
+
+                        if (user->notifications.empty())
+                        {
+                              i = DataFlush::notified.erase(i);
+                        }
+                        else
+                        {
+                              ++i;
+                        }
+            }
 }
 
 void DataFlush::Process()
@@ -195,36 +344,54 @@ void DataFlush::Process()
       DataFlush::GetPending();
 }
 
-void DataFlush::GetPending()
+bool DataFlush::Ready(User* user, const std::shared_ptr<QueryBase>& signal)
 {
-      /* Before processing user pendings, we must check global. */
-      
-      if (Kernel->Clients->Global->pending.size())
+      if (!signal || !signal->sequence)
       {
-               Process(Kernel->Clients->Global, Kernel->Clients->Global->pending.front());
-               return;
+            return true;
       }
 
-      const UserMap& users = Kernel->Clients->GetInstances();
-      
-      if (!users.size())
+      if (signal->Exclusive())
       {
-            return;
+            return !user->inflight;
       }
+
+      return (!user->AwaitingExclusive() || signal->sequence < user->barrier);
+}
+
+void DataFlush::GetPending()
+{
+      /* Global queries are not limited by depth, as they expect no results. */
       
-      for (UserMap::const_iterator i = users.begin(); i != users.end(); ++i)
+      User* const global = Kernel->Clients->Global;
+
+      while (global->pending.size() && Process(global, global->pending.front()))
       {
-               User* const user = i->second;
 
-               const unsigned int pending = user->pending.size();
+      }
+
+      for (std::set<User*>::iterator i = DataFlush::awaiting.begin(); i != DataFlush::awaiting.end(); )
+      {
+               User* const user = *i;
 
-               if ((user && !user->IsQuitting()) && (!pending || user->IsLocked()))
+               if (user->IsQuitting())
                {
-                    continue;
+                    user->pending.clear();
+               }
+
+               while (user->pending.size() && user->inflight < Kernel->Config->DB.depth && Ready(user, user->pending.front()) && Process(user, user->pending.front()))
+               {
+
+               }
+
+               if (user->pending.empty())
+               {
+                    i = DataFlush::awaiting.erase(i);
+               }
+               else
+               {
+                    ++i;
                }
-               
-               user->SetLock(true);
-               Process(user, user->pending.front());
       }
 }
 
@@ -238,57 +405,96 @@ bool DataThread::IsBusy()
       return this->busy;
 }
 
-void DataFlush::Process(User* user, std::shared_ptr<QueryBase> signal)
+DataThread* DataFlush::Target(const std::shared_ptr<QueryBase>& signal)
 {
-      if (!signal || !Kernel->Store->Flusher->Status())
+      const DataThreadVector& Threads = Kernel->Store->Flusher->GetThreads();
+
+      /* Queries on a given key are always run by the same thread. */
+
+      if (!signal || Threads.empty())
       {
-            return;
+            return NULL;
       }
 
-      const DataThreadVector& Threads = Kernel->Store->Flusher->GetThreads();
-      
-      /* Thread to use. */
-      
-      DataThread *ToUse = NULL;
-      
-      for (DataThreadVector::const_iterator i = Threads.begin(); i != Threads.end(); ++i)
+      return Threads[std::hash<std::string>()(signal->key) % Threads.size()];
+}
+
+bool DataFlush::Accepts(const std::shared_ptr<QueryBase>& signal)
+{
+      DataThread* const thread = Target(signal);
+      return (!thread || !thread->Full());
+}
+
+bool DataFlush::Process(User* user, std::shared_ptr<QueryBase> signal)
+{
+      DataThread* const thread = Target(signal);
+
+      /* Query is kept pending until its thread catches up. */
+
+      if (thread && thread->Full())
       {
-             DataThread* thread = *i;
-           
-             /* First, we attempt to find an unused thread. */
-           
-             if (!thread->IsBusy())
-             {
-                   /* No need to continue looking for a thread. */
-
-                   ToUse = thread;
-                   break; 
-             }
+            return false;
       }
-      
-      /* Checks whether we have assigned a thread. */
-      
-      if (!ToUse)
+
+      user->pending.pop_front();
+
+      if (!signal)
       {
-            /* We find a random thread to attach this signal into. */
-      
-            ToUse = *random_item(Threads.begin(), Threads.end());
+            return true;
       }
 
-      /* Unable to find any thread at all. */
-      
-      if (!ToUse)
+      if (signal->sequence)
+      {
+            user->inflight++;
+      }
+
+      if (thread && thread->Post(signal))
+      {
+            return true;
+      }
+
+      /* Unable to run this query. Its result is still delivered, in order. */
+
+      if (signal->sequence)
       {
-            user->SetLock(false);
-            user->pending.clear();
+            signal->access_set(DBL_STATUS_BROKEN);
+            user->notifications.push_back(signal);
+            DataFlush::notified.insert(user);
+      }
+
+      return true;
+}
+
+void DataFlush::Queue(User* user, std::shared_ptr<QueryBase> signal)
+{
+      /* Queries of commands run by MRUN are run by its transaction. */
+
+      if (user->Transaction)
+      {
+            user->Transaction->queries.push_back(signal);
             return;
       }
 
-      user->pending.pop_front();
+      user->pending.push_back(signal);
 
-      /* Let's start processing this signal. */
-      
-      ToUse->Post(signal);
+      if (user == Kernel->Clients->Global)
+      {
+            return;
+      }
+
+      /* Queries expecting a result are delivered in the same order they were sent. */
+
+      if (signal->flags != QUERY_FLAGS_QUIET && signal->flags != QUERY_FLAGS_GLOBAL)
+      {
+            signal->sequence = user->issued++;
+
+            if (signal->Exclusive())
+            {
+                  user->barrier = signal->sequence;
+            }
+      }
+
+      DataFlush::awaiting.insert(user);
 }
 
 void DataFlush::ResetAll()
@@ -311,22 +517,36 @@ void DataFlush::ResetAll()
       {           
               User* const user = i->second;
             
-              if (user == NULL || user->IsQuitting())
+              if (user == NULL)
               {
                      continue;
               }
 
               user->notifications.clear();
               user->pending.clear();
+
+              /* Results of queries still running are discarded once they arrive. */
+
+              user->delivered = user->issued;
+              user->inflight = 0;
+
+              LocalUser* const localuser = IS_LOCAL(user);
+
+              if (localuser)
+              {
+                    localuser->Release();
+              }
       }
 
+      DataFlush::awaiting.clear();
+      DataFlush::notified.clear();
       DataFlush::mute.unlock();
 
       Kernel->Store->Expires->Reset();
       Kernel->Store->Flusher->Resume();
 }
 
-DataThread::DataThread() : handler(nullptr), busy(false)
+DataThread::DataThread(unsigned int position) : handler(nullptr), slots(new std::shared_ptr<QueryBase>[DATATHREAD_SLOTS]), tail(0), busy(false), sleeping(false), exiting(false), head(0), index(position)
 {
 
 }
@@ -338,35 +558,42 @@ void DataThread::Exit()
              return;
       }  
 
-      std::shared_ptr<ThreadMsg> Input(new ThreadMsg(PROC_EXIT_THREAD, 0));
-      {
-             std::lock_guard<std::mutex> lock(m_mutex);
-             queue.push(Input);
-             m_cv.notify_one();
-      }
+      this->exiting.store(true);
+      this->Wake();
 
       handler->join();
       handler = NULL;
 }
 
-void DataThread::Post(const std::shared_ptr<QueryBase> query)
+void DataThread::Wake()
+{
+      /* Pairs with the check made by Wait() before sleeping. */
+
+      if (this->sleeping.load())
+      {
+             std::lock_guard<std::mutex> lock(this->m_mutex);
+             this->m_cv.notify_one();
+      }
+}
+
+bool DataThread::Post(const std::shared_ptr<QueryBase>& query)
 {	
       if (!handler)
       {
-            return;
+            return false;
       }
 
-      if (!query || !query->database || query->database->IsClosing())
+      if (!query->database || query->database->IsClosing() || this->Full())
       {
-            query->user->SendProtocol(ERR_INPUT, DB_NULL);
-            query->user->SetLock(false);
-            return;
+            return false;
       }
-           
-      std::shared_ptr<ThreadMsg> Input(new ThreadMsg(PROC_SIGNAL, query));
-      std::unique_lock<std::mutex> lk(m_mutex);
-      queue.push(Input);
-      m_cv.notify_one();
+
+      const size_t pos = this->tail.load(std::memory_order_relaxed);
+
+      this->slots[pos & (DATATHREAD_SLOTS - 1)] = query;
+      this->tail.store(pos + 1);
+      this->Wake();
+      return true;
 }
 
 std::thread::id DataThread::Create()
@@ -374,116 +601,146 @@ std::thread::id DataThread::Create()
       if (!handler)
       {
               handler = std::unique_ptr<std::thread>(new std::thread(&DataThread::Process, this)); 
+
+              if (Kernel->Config->DB.pinthreads)
+              {
+                      this->Pin();
+              }
       }
 
       return handler->get_id();
 }
 
-void DataThread::Process()
+void DataThread::Pin()
+{
+#if defined(__linux__)
+      const unsigned int cores = std::thread::hardware_concurrency();
+
+      if (cores < 2)
+      {
+            return;
+      }
+
+      /* First core is left to the mainloop. */
+
+      cpu_set_t set;
+      CPU_ZERO(&set);
+      CPU_SET(1 + (this->index % (cores - 1)), &set);
+
+      if (pthread_setaffinity_np(handler->native_handle(), sizeof(set), &set) != 0)
+      {
+            slog("DATABASE", LOG_DEFAULT, "Unable to pin thread %u.", this->index);
+      }
+#endif
+}
+
+bool DataThread::Wait()
 {
-      while (true)
+      const unsigned int spin = Kernel->Config->DB.spin;
+
+      for (unsigned int tries = 0; ; tries++)
       {
-              std::shared_ptr<ThreadMsg> signal;
+              const size_t pos = this->head.load(std::memory_order_relaxed);
+
+              if (pos != this->tail.load(std::memory_order_acquire))
               {
-                      std::unique_lock<std::mutex> lk(m_mutex);
+                    return true;
+              }
 
-                      while (queue.empty())
-                      {
-                            m_cv.wait(lk);
-                      }
+              /* Queries posted before Exit() are still run. */
 
-                      if (queue.empty())
-                      {
-                            continue;
-                      }
+              if (this->exiting.load())
+              {
+                    return (pos != this->tail.load());
+              }
 
-                      signal = queue.front();
+              if (tries < spin)
+              {
+                    continue;
               }
 
-              /* Indicates this thread is busy. */
+              std::unique_lock<std::mutex> lock(this->m_mutex);
 
-              this->SetStatus(true);
+              this->sleeping.store(true);
+
+              while (pos == this->tail.load() && !this->exiting.load())
+              {
+                    this->m_cv.wait(lock);
+              }
+
+              this->sleeping.store(false);
+              tries = 0;
+      }
+}
+
+void DataThread::Process()
+{
+      while (this->Wait())
+      {
+              /* Queries are kept in the ring while paused. */
 
               if (!Kernel->Store->Flusher->Status())
               {
-                    this->SetStatus(false);
+                    std::this_thread::yield();
                     continue;
               }
 
-              switch (signal->id)
+              /* Indicates this thread is busy. */
+
+              this->SetStatus(true);
+
+              const size_t pos = this->head.load(std::memory_order_relaxed);
+              std::shared_ptr<QueryBase> request = std::move(this->slots[pos & (DATATHREAD_SLOTS - 1)]);
+              this->head.store(pos + 1, std::memory_order_release);
+
+              /* Queries of quitting users are not run, though their results are still expected. */
+
+              if (request->user->IsQuitting())
               {
-                    case PROC_EXIT_THREAD:
-                    {
-                          DataFlush::query_mute.lock();
-                          this->Clear();
-                          DataFlush::query_mute.unlock();
-                          
-                          return;
-                    }
-                    
-                    case PROC_SIGNAL:
-                    {
-                          std::shared_ptr<QueryBase> request = signal->msg;
-                          
-                          /* Let's release the locked user. */
-
-                          if (!request->user && request->user->IsQuitting())
-                          {
-                               /* In case lock status gets locked. */
-                               
-                               if (request->user)
-                               {
-                                     request->user->SetLock(false);
-                               }
-                               
-                               queue.pop();
-                               
-                               signal.reset();
-                               signal = NULL;
-                               
-                               break;
-                          }
-                          
-                          queue.pop();
-                          
-                          DataFlush::query_mute.lock();
-                          
-                          if (request->access != DBL_INVALID_FORMAT)
-                          {
-                                 request->Prepare();
-                          }
-
-                          DataFlush::query_mute.unlock();
-            
-                          this->SetStatus(false);
-
-                          if (request->flags == QUERY_FLAGS_QUIET)
-                          {
-                                 break;
-                          }
-                          
-                          if (request->flags == QUERY_FLAGS_GLOBAL)
-                          {
-                                 DataFlush::AttachGlobal(request);
-                                 break;
-                          }
-
-                          if (request->access != DBL_INTERRUPT)
-                          {
-                                 /* Adds result to the pending notification list. */
-
-                                 DataFlush::AttachResult(request);
-                          }
-                        
-                          break;
-                    }
+                     request->access_set(DBL_INTERRUPT);
+              }
+              else if (request->access != DBL_INVALID_FORMAT)
+              {
+                     current = request.get();
+
+                     if (request->Exclusive())
+                     {
+                            std::unique_lock<std::shared_timed_mutex> lock(DataFlush::query_mute);
+                            DataFlush::Execute(request.get());
+                     }
+                     else
+                     {
+                            std::shared_lock<std::shared_timed_mutex> lock(DataFlush::query_mute);
+                            DataFlush::Execute(request.get());
+                     }
+
+                     current = NULL;
+              }
 
-                    default:
-                    {
-                           break;
-                    }
+              this->SetStatus(false);
+
+              if (request->flags == QUERY_FLAGS_QUIET)
+              {
+                     continue;
+              }
+              
+              if (request->flags == QUERY_FLAGS_GLOBAL)
+              {
+                     DataFlush::AttachGlobal(request);
+                     continue;
+              }
+
+              if (request->access != DBL_INTERRUPT || request->sequence)
+              {
+                     /* Adds result to the pending notification list. */
+
+                     DataFlush::AttachResult(request);
               }
       }
+
+      DataFlush::query_mute.lock();
+      this->Clear();
+      DataFlush::query_mute.unlock();
 }
 
 DataThread::~DataThread()
@@ -493,8 +750,14 @@ DataThread::~DataThread()
 
 void DataThread::Clear()
 {
-         std::queue<std::shared_ptr<ThreadMsg>> empty;
-         std::swap(this->queue, empty);
+         const size_t last = this->tail.load();
+
+         for (size_t pos = this->head.load(); pos != last; pos++)
+         {
+              this->slots[pos & (DATATHREAD_SLOTS - 1)].reset();
+         }
+
+         this->head.store(last);
          this->SetStatus(false);
 }
 
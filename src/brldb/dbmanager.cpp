@@ -67,6 +67,8 @@ bool DBManager::Delete(const std::string& name)
       }
       
       userdb->Close();
+      Kernel->Store->Hot->Clear(name);
+      Kernel->Store->ZSets->Clear(name);
       STHelper::Delete("databases", name);
       this->DBMap.erase(name);
       return true;
@@ -16,6 +16,10 @@
 #include "brldb/query.h"
 #include "brldb/dbnumeric.h"
 #include "brldb/expires.h"
+#include "brldb/list_store.h"
+#include "brldb/map_store.h"
+#include "brldb/zset_store.h"
+#include "brldb/geo_index.h"
 #include "helpers.h"
 
 void del_query::Keys()
@@ -24,10 +28,12 @@ void del_query::Keys()
 
        rocksdb::WriteBatch batch;
 
-       batch.Delete(this->dest);
-       batch.Delete(lookup);
+       batch.Delete(this->database->Route(this->dest), this->dest);
+       batch.Delete(this->database->Route(lookup), lookup);
        
-       rocksdb::Status stats = this->database->GetAddress()->Write(rocksdb::WriteOptions(), &batch);
+       rocksdb::Status stats = this->database->Write(batch);
+
+       Kernel->Store->Hot->Invalidate(this->database, this->dest);
 
        if (stats.ok())
        {
@@ -41,22 +47,58 @@ void del_query::Keys()
 
 void del_query::Lists()
 {
+       ListStore store(this->database, this->dest);
+       const RocksData& result = this->Get(this->dest);
 
+       if (result.status.ok() && store.Load(result.value))
+       {
+              store.Erase();
+       }
 }
 
 void del_query::Multis()
 {
+       MapStore store(this->database, this->dest, true);
+       const RocksData& result = this->Get(this->dest);
 
+       if (result.status.ok() && store.Load(result.value))
+       {
+              store.Erase();
+       }
 }
 
 void del_query::Maps()
 {
+       MapStore store(this->database, this->dest);
+       const RocksData& result = this->Get(this->dest);
+
+       if (result.status.ok() && store.Load(result.value))
+       {
+              store.Erase();
+       }
+}
+
+void del_query::ZSets()
+{
+       ZSetStore store(this->database, this->dest);
+       const RocksData& result = this->Get(this->dest);
 
+       if (result.status.ok() && store.Load(result.value))
+       {
+              store.Erase();
+       }
 }
 
 void del_query::Geos()
 {
+    /* Index entry goes along with the registry. */
+
+    const RocksData& result = this->Get(this->dest);
 
+    if (result.status.ok())
+    {
+          GeoIndex::Drop(this->database, this->select_query, this->key, result.value);
+    }
 }
 
 void del_query::Vectors()
@@ -93,6 +135,10 @@ void del_query::Run()
     {
          this->Lists();
     }
+    else if (this->identified == INT_ZSET)
+    {
+         this->ZSets();
+    }
     else if (this->identified == INT_VECTOR)
     {    
           this->Vectors();
@@ -14,6 +14,8 @@
 #include "beryl.h"
 #include "engine.h"
 #include "brldb/list_handler.h"
+#include "brldb/list_store.h"
+#include "brldb/map_store.h"
 #include "brldb/multimap_handler.h"
 #include "brldb/map_handler.h"
 #include "brldb/vector_handler.h"
@@ -26,7 +28,7 @@ void diff_query::Keys()
     std::string lookup  = to_bin(this->value) + ":" + convto_string(convto_string(this->select_query)) + ":" + this->identified;
     
     std::string dbvalue;
-    rocksdb::Status fstatus = this->database->GetAddress()->Get(rocksdb::ReadOptions(), lookup, &dbvalue);     
+    rocksdb::Status fstatus = this->database->Get(this->database->Route(lookup), lookup, &dbvalue);     
     
     if (!fstatus.ok())
     {
@@ -34,7 +36,7 @@ void diff_query::Keys()
           return;
     }
     
-    RocksData query_result = this->Get(this->dest);
+    const RocksData& query_result = this->Get(this->dest);
     
     if (query_result.value == dbvalue)
     {
@@ -49,22 +51,26 @@ void diff_query::Keys()
 
 void diff_query::Maps()
 {
-    RocksData query_result = this->Get(this->dest);
-
-    std::shared_ptr<MapHandler> handler1 = MapHandler::Create(query_result.value);
+    const RocksData& query_result = this->Get(this->dest);
+    
+    MapStore store1(this->database, this->dest);
+    store1.Load(query_result.value);
+    std::shared_ptr<MapHandler> handler1 = store1.FetchMap();
 
     std::string lookup  = to_bin(this->value) + ":" + convto_string(convto_string(this->select_query)) + ":" + this->identified;
 
     std::string dbvalue;
-    rocksdb::Status fstatus = this->database->GetAddress()->Get(rocksdb::ReadOptions(), lookup, &dbvalue);
+    rocksdb::Status fstatus = this->database->Get(this->database->Route(lookup), lookup, &dbvalue);
 
-    if (!fstatus.ok())
+    MapStore store2(this->database, lookup);
+
+    if (!fstatus.ok() || !store2.Load(dbvalue))
     {
           access_set(DBL_NOT_FOUND);
           return;
     }
 
-    std::shared_ptr<MapHandler> handler2 = MapHandler::Create(dbvalue);
+    std::shared_ptr<MapHandler> handler2 = store2.FetchMap();
 
     StringVector flist = DiffHandler::CompareMap(handler2->GetList(), handler1->GetList());
 
@@ -94,12 +100,11 @@ void diff_query::Maps()
                                     if (aux_counter % ITER_LIMIT == 0)
                                     {
                                                 tracker++;
-                                                std::shared_ptr<diff_query> request = std::make_shared<diff_query>();
+                                                std::shared_ptr<diff_query> request = QueryPool::Make<diff_query>();
                                                 request->user = this->user;
                                                 request->partial = true;
                                                 request->subresult = tracker;
-                                                request->VecData = result;
-                                                result.clear();
+                                                request->VecData.swap(result);
                                                 request->SetOK();
                                                 DataFlush::AttachResult(request);
                                       }
@@ -118,12 +123,11 @@ void diff_query::Maps()
                              if (aux_counter % ITER_LIMIT == 0)
                              {
                                         tracker++;
-                                        std::shared_ptr<diff_query> request = std::make_shared<diff_query>();
+                                        std::shared_ptr<diff_query> request = QueryPool::Make<diff_query>();
                                         request->user = this->user;
                                         request->partial = true;
                                         request->subresult = tracker;
-                                        request->VecData = result;
-                                        result.clear();
+                                        request->VecData.swap(result);
                                         request->SetOK();
                                         DataFlush::AttachResult(request);
                              }
@@ -135,28 +139,32 @@ void diff_query::Maps()
     this->subresult = ++tracker;
     this->partial = false;
     this->counter = aux_counter;
-    this->VecData = result;
+    this->VecData.swap(result);
     this->SetOK();
 }
 
 void diff_query::Multis()
 {
-    RocksData query_result = this->Get(this->dest);
-
-    std::shared_ptr<MultiMapHandler> handler1 = MultiMapHandler::Create(query_result.value);
+    const RocksData& query_result = this->Get(this->dest);
+    
+    MapStore store1(this->database, this->dest, true);
+    store1.Load(query_result.value);
+    std::shared_ptr<MultiMapHandler> handler1 = store1.FetchMulti();
     
     std::string lookup  = to_bin(this->value) + ":" + convto_string(convto_string(this->select_query)) + ":" + this->identified;
     
     std::string dbvalue;
-    rocksdb::Status fstatus = this->database->GetAddress()->Get(rocksdb::ReadOptions(), lookup, &dbvalue);     
+    rocksdb::Status fstatus = this->database->Get(this->database->Route(lookup), lookup, &dbvalue);     
     
-    if (!fstatus.ok())
+    MapStore store2(this->database, lookup, true);
+
+    if (!fstatus.ok() || !store2.Load(dbvalue))
     {
           access_set(DBL_NOT_FOUND);
           return;
     }
-    
-    std::shared_ptr<MultiMapHandler> handler2 = MultiMapHandler::Create(dbvalue);
+
+    std::shared_ptr<MultiMapHandler> handler2 = store2.FetchMulti();
     
     StringVector flist = DiffHandler::CompareMultiMap(handler2->GetList(), handler1->GetList());
     
@@ -186,12 +194,11 @@ void diff_query::Multis()
                                     if (aux_counter % ITER_LIMIT == 0)
                                     {
                                                 tracker++;
-                                                std::shared_ptr<diff_query> request = std::make_shared<diff_query>();
+                                                std::shared_ptr<diff_query> request = QueryPool::Make<diff_query>();
                                                 request->user = this->user;
                                                 request->partial = true;                                  
                                                 request->subresult = tracker;
-                                                request->VecData = result;
-                                                result.clear();
+                                                request->VecData.swap(result);
                                                 request->SetOK();
                                                 DataFlush::AttachResult(request);
                                       }
@@ -210,12 +217,11 @@ void diff_query::Multis()
                              if (aux_counter % ITER_LIMIT == 0)
                              {
                                         tracker++;
-                                        std::shared_ptr<diff_query> request = std::make_shared<diff_query>();
+                                        std::shared_ptr<diff_query> request = QueryPool::Make<diff_query>();
                                         request->user = this->user;
                                         request->partial = true;
                                         request->subresult = tracker;
-                                        request->VecData = result;
-                                        result.clear();
+                                        request->VecData.swap(result);
                                         request->SetOK();
                                         DataFlush::AttachResult(request);
                              }
@@ -227,7 +233,7 @@ void diff_query::Multis()
     this->subresult = ++tracker;
     this->partial = false;
     this->counter = aux_counter;
-    this->VecData = result;
+    this->VecData.swap(result);
     this->SetOK();
 
 }
@@ -237,7 +243,7 @@ void diff_query::Geos()
     std::string lookup  = to_bin(this->value) + ":" + convto_string(this->select_query) + ":" + this->identified;
     
     std::string dbvalue;
-    rocksdb::Status fstatus = this->database->GetAddress()->Get(rocksdb::ReadOptions(), lookup, &dbvalue);     
+    rocksdb::Status fstatus = this->database->Get(this->database->Route(lookup), lookup, &dbvalue);     
     
     if (!fstatus.ok())
     {
@@ -245,7 +251,7 @@ void diff_query::Geos()
           return;
     }
     
-    RocksData query_result = this->Get(this->dest);
+    const RocksData& query_result = this->Get(this->dest);
     
     if (query_result.value == dbvalue)
     {
@@ -260,14 +266,14 @@ void diff_query::Geos()
 
 void diff_query::Vectors()
 {
-    RocksData query_result = this->Get(this->dest);
+    const RocksData& query_result = this->Get(this->dest);
 
     std::shared_ptr<VectorHandler> handler1 = VectorHandler::Create(query_result.value);
     
     std::string lookup  = to_bin(this->value) + ":" + convto_string(this->select_query) + ":" + this->identified;
     
     std::string dbvalue;
-    rocksdb::Status fstatus = this->database->GetAddress()->Get(rocksdb::ReadOptions(), lookup, &dbvalue);     
+    rocksdb::Status fstatus = this->database->Get(this->database->Route(lookup), lookup, &dbvalue);     
     
     if (!fstatus.ok())
     {
@@ -305,12 +311,11 @@ void diff_query::Vectors()
                                     if (aux_counter % ITER_LIMIT == 0)
                                     {
                                                 tracker++;
-                                                std::shared_ptr<diff_query> request = std::make_shared<diff_query>();
+                                                std::shared_ptr<diff_query> request = QueryPool::Make<diff_query>();
                                                 request->user = this->user;
                                                 request->partial = true;                                  
                                                 request->subresult = tracker;
-                                                request->VecData = result;
-                                                result.clear();
+                                                request->VecData.swap(result);
                                                 request->SetOK();
                                                 DataFlush::AttachResult(request);
                                       }
@@ -329,12 +334,11 @@ void diff_query::Vectors()
                              if (aux_counter % ITER_LIMIT == 0)
                              {
                                         tracker++;
-                                        std::shared_ptr<diff_query> request = std::make_shared<diff_query>();
+                                        std::shared_ptr<diff_query> request = QueryPool::Make<diff_query>();
                                         request->user = this->user;
                                         request->partial = true;
                                         request->subresult = tracker;
-                                        request->VecData = result;
-                                        result.clear();
+                                        request->VecData.swap(result);
                                         request->SetOK();
                                         DataFlush::AttachResult(request);
                              }
@@ -346,29 +350,33 @@ void diff_query::Vectors()
     this->subresult = ++tracker;
     this->partial = false;
     this->counter = aux_counter;
-    this->VecData = result;
+    this->VecData.swap(result);
     this->SetOK();
 
 }
 
 void diff_query::Lists()
 {
-    RocksData query_result = this->Get(this->dest);
+    const RocksData& query_result = this->Get(this->dest);
     
-    std::shared_ptr<ListHandler> handler1 = ListHandler::Create(query_result.value);
+    ListStore store1(this->database, this->dest);
+    store1.Load(query_result.value);
+    std::shared_ptr<ListHandler> handler1 = store1.Fetch();
     
     std::string lookup  = to_bin(this->value) + ":" + convto_string(this->select_query) + ":" + this->identified;
     
     std::string dbvalue;
-    rocksdb::Status fstatus = this->database->GetAddress()->Get(rocksdb::ReadOptions(), lookup, &dbvalue);     
+    rocksdb::Status fstatus = this->database->Get(this->database->Route(lookup), lookup, &dbvalue);     
     
-    if (!fstatus.ok())
+    ListStore store2(this->database, lookup);
+
+    if (!fstatus.ok() || !store2.Load(dbvalue))
     {
           access_set(DBL_NOT_FOUND);
           return;
     }
     
-    std::shared_ptr<ListHandler> handler2 = ListHandler::Create(dbvalue);
+    std::shared_ptr<ListHandler> handler2 = store2.Fetch();
     
     ListMap flist = DiffHandler::CompareList(handler2->GetList(), handler1->GetList());
     
@@ -398,12 +406,11 @@ void diff_query::Lists()
                                     if (aux_counter % ITER_LIMIT == 0)
                                     {
                                                 tracker++;
-                                                std::shared_ptr<diff_query> request = std::make_shared<diff_query>();
+                                                std::shared_ptr<diff_query> request = QueryPool::Make<diff_query>();
                                                 request->user = this->user;
                                                 request->partial = true;                                  
                                                 request->subresult = tracker;
-                                                request->VecData = result;
-                                                result.clear();
+                                                request->VecData.swap(result);
                                                 request->SetOK();
                                                 DataFlush::AttachResult(request);
                                       }
@@ -422,12 +429,11 @@ void diff_query::Lists()
                              if (aux_counter % ITER_LIMIT == 0)
                              {
                                         tracker++;
-                                        std::shared_ptr<diff_query> request = std::make_shared<diff_query>();
+                                        std::shared_ptr<diff_query> request = QueryPool::Make<diff_query>();
                                         request->user = this->user;
                                         request->partial = true;
                                         request->subresult = tracker;
-                                        request->VecData = result;
-                                        result.clear();
+                                        request->VecData.swap(result);
                                         request->SetOK();
                                         DataFlush::AttachResult(request);
                              }
@@ -439,7 +445,7 @@ void diff_query::Lists()
     this->subresult = ++tracker;
     this->partial = false;
     this->counter = aux_counter;
-    this->VecData = result;
+    this->VecData.swap(result);
     this->SetOK();
 }
 
@@ -485,7 +491,7 @@ void diff_query::Process()
     }
     else if (this->identified == INT_MMAP || this->identified == INT_MAP)
     {
-         Dispatcher::MMapFlush(false, "Map", "Key", this);
+         Dispatcher::MMapFlush(false, "Map", "Key", this, DualMMap());
     }
     else if (this->identified == INT_KEY || this->identified == INT_GEO)
     {
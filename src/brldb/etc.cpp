@@ -20,7 +20,7 @@ void future_list_query::Run()
 {
        unsigned int total_counter = 0;
        
-       rocksdb::Iterator* it = this->database->GetAddress()->NewIterator(rocksdb::ReadOptions());
+       std::unique_ptr<rocksdb::Iterator> it(this->database->NewIterator(INT_FUTURE));
        
        for (it->SeekToFirst(); it->Valid(); it->Next()) 
        {
@@ -159,7 +159,7 @@ void future_exec_query::Run()
 {
       std::string lookup = to_bin(this->key) + ":" + convto_string(this->select_query) + ":" + INT_FUTURE + ":" + this->database->GetName();
       std::string dbvalue;
-      rocksdb::Status fstatus = this->database->GetAddress()->Get(rocksdb::ReadOptions(), lookup, &dbvalue);       
+      rocksdb::Status fstatus = this->database->Get(this->database->Route(lookup), lookup, &dbvalue);       
       
       if (fstatus.ok())
       {
@@ -194,7 +194,7 @@ void future_del_query::Run()
 {
       std::string lookup = to_bin(this->key) + ":" + convto_string(this->select_query) + ":" + INT_FUTURE + ":" + this->database->GetName();
       std::string dbvalue;
-      rocksdb::Status fstatus = this->database->GetAddress()->Get(rocksdb::ReadOptions(), lookup, &dbvalue);       
+      rocksdb::Status fstatus = this->database->Get(this->database->Route(lookup), lookup, &dbvalue);       
       
       if (fstatus.ok())
       {
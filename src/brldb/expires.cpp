@@ -20,88 +20,47 @@
 
 std::mutex ExpireManager::mute;
 
-ExpireManager::ExpireManager()
+ExpireManager::ExpireManager() : lag(0), expired(0)
 {
 
 }
 
-bool ExpireManager::Delete(std::shared_ptr<Database> database, const std::string& key, unsigned int select)
+bool ExpireManager::Delete(const std::shared_ptr<Database>& database, const std::string& key, unsigned int select)
 {
-        const ExpireMap& all = Kernel->Store->Expires->GetExpires();
-
-        /* Nothing to delete, at all. */
-        
-        if (!all.size())
-        {
-                return false;
-        }
-
         std::lock_guard<std::mutex> lg(ExpireManager::mute);
+        return Kernel->Store->Expires->ExpireList.Remove(database, key, select);
+}
 
-        for (ExpireMap::const_iterator it = all.begin(); it != all.end(); )
-        {
-                if (it->second.key != key)
-                {
-                       it++;
-                       continue;
-                }
-                
-                if (it->second.select != select)
-                {
-                       it++;
-                       continue;
-                }
-                
-                if (it->second.database != database)
-                {
-                       it++;
-                       continue;
-                }
+signed int ExpireManager::GetTIME(const std::shared_ptr<Database>& database, const std::string& key, unsigned int select)
+{
+        /* Most keys have no expire, so reads skip the lock altogether. */
 
-                Kernel->Store->Expires->ExpireList.erase(it);
-                return true;
+        if (!Kernel->Store->Expires->ExpireList.MayHave(key))
+        {
+                return -1;
         }
 
-        /* Key not found. */
-
-        return false;
-}
+        std::lock_guard<std::mutex> lg(ExpireManager::mute);
 
-signed int ExpireManager::GetTIME(std::shared_ptr<Database> database, const std::string& key, unsigned int select)
-{
-        const ExpireMap& expires = Kernel->Store->Expires->GetExpires();
+        ExpireEntry* entry = Kernel->Store->Expires->ExpireList.Find(database, key, select);
 
-        std::lock_guard<std::mutex> lg(ExpireManager::mute);
+        /* Not found, not expiring. */
 
-        for (ExpireMap::const_iterator it = expires.begin(); it != expires.end(); it++)
+        if (!entry)
         {
-                        if (it->second.key == key && it->second.select == select && it->second.database == database)
-                        {
-                                return it->first;
-                        }
+                return -1;
         }
 
-        /* Not found, not expiring. */
-
-        return -1;
+        return entry->schedule;
 }
 
-signed int ExpireManager::Add(std::shared_ptr<Database> database, signed int schedule, const std::string& key, unsigned int select, bool epoch)
+signed int ExpireManager::Add(const std::shared_ptr<Database>& database, signed int schedule, const std::string& key, unsigned int select, bool epoch)
 {
         if (schedule < 0)
         {
                 return -1;
         }
         
-        /* If entry already exists, we remove it and insert it again. */
-        
-        if (ExpireManager::GetTIME(database, key, select) > 0)
-        {
-              ExpireManager::Delete(database, key, select);
-        }
-        
-        std::lock_guard<std::mutex> lg(ExpireManager::mute);
-        
         time_t Now = Kernel->Now();
         ExpireEntry New;
         
@@ -122,72 +81,101 @@ signed int ExpireManager::Add(std::shared_ptr<Database> database, signed int sch
         New.secs 	= schedule;
         New.select 	= select;
         
-        Kernel->Store->Expires->ExpireList.insert(std::make_pair(New.schedule, New));
+        /* If entry already exists, it is replaced. */
+
+        std::lock_guard<std::mutex> lg(ExpireManager::mute);
+        Kernel->Store->Expires->ExpireList.Add(New);
         
-        //bprint(DONE, "Adding expire to %s (%s): %s", database->GetName().c_str(), key.c_str(), select.c_str());
         return New.schedule;
 }
 
-ExpireEntry ExpireManager::Find(std::shared_ptr<Database> database, const std::string& key, unsigned int select)
+ExpireEntry ExpireManager::Find(const std::shared_ptr<Database>& database, const std::string& key, unsigned int select)
 {
-        ExpireMap& current = Kernel->Store->Expires->GetExpires();
+        std::lock_guard<std::mutex> lg(ExpireManager::mute);
 
-        for (ExpireMap::iterator it = current.begin(); it != current.end(); it++)
-        {
-                        if (it->second.key == key && it->second.select == select && it->second.database == database)
-                        {
-                                return it->second;
-                        }
-        }
+        ExpireEntry* entry = this->ExpireList.Find(database, key, select);
 
         /* Not found, not expiring. */
 
-        throw KernelException("ne");
+        if (!entry)
+        {
+                throw KernelException("ne");
+        }
+
+        return *entry;
 }
 
-ExpireMap& ExpireManager::GetExpires()
+const ExpireMap& ExpireManager::GetExpires()
 {
        std::lock_guard<std::mutex> lg(ExpireManager::mute);
-       return this->ExpireList;
+       return this->ExpireList.GetTimeline();
 }
 
 void ExpireManager::Flush(time_t TIME)
 {
-        /* 
-         * Considering that Flush is an static function, this is the only 
-         * valid to get expiring entries. 
-         */
-           
-        ExpireMap& expiring = Kernel->Store->Expires->GetExpires();
-
-        if (!expiring.size())
+        std::map<std::shared_ptr<Database>, std::shared_ptr<expire_batch_query>> batches;
+        unsigned int counter = 0;
+
         {
-              return;
+                std::lock_guard<std::mutex> lg(ExpireManager::mute);
+
+                const ExpireMap& expiring = this->ExpireList.GetTimeline();
+
+                for (ExpireMap::const_iterator it = expiring.begin(); it != expiring.end() && it->first < TIME; )
+                {
+                        if (counter >= Kernel->Config->ExpireBatch)
+                        {
+                                break;
+                        }
+
+                        std::shared_ptr<expire_batch_query>& query = batches[it->second.database];
+
+                        if (!query)
+                        {
+                                query = QueryPool::Make<expire_batch_query>();
+                                query->user = Kernel->Clients->Global;
+                                query->database = it->second.database;
+                                query->flags = QUERY_FLAGS_QUIET;
+                        }
+
+                        ExpiredKey entry;
+                        entry.schedule = it->first;
+                        entry.select = it->second.select;
+                        entry.key = it->second.key;
+                        query->expired.push_back(entry);
+
+                        it = this->ExpireList.Erase(it);
+                        counter++;
+                }
+
+                /* Expires left behind, if any. */
+
+                if (!expiring.empty() && expiring.begin()->first < TIME)
+                {
+                        this->lag = TIME - expiring.begin()->first;
+                }
+                else
+                {
+                        this->lag = 0;
+                }
         }
-        
-        for (ExpireMap::iterator it = expiring.begin(); it != expiring.end(); )
+
+        this->expired += counter;
+
+        for (std::map<std::shared_ptr<Database>, std::shared_ptr<expire_batch_query>>::iterator i = batches.begin(); i != batches.end(); ++i)
         {
-              if (it->first >= TIME)
-              {
-                      break;
-              }
-              
-              ExpireEntry entry = it->second;
-              GlobalHelper::ExpireDelete(entry.database, entry.select, entry.key);
-              
-              it++;
-        }  
+                Kernel->Store->Push(i->second);
+        }
 }
 
-signed int ExpireManager::GetTTL(std::shared_ptr<Database> database, const std::string& key, unsigned int select)
+signed int ExpireManager::GetTTL(const std::shared_ptr<Database>& database, const std::string& key, unsigned int select)
 {
-      std::lock_guard<std::mutex> lg(ExpireManager::mute);
       return ExpireManager::GetTIME(database, key, select);
 }
 
 void ExpireManager::PreDBClose(const std::string& dbname)
 {
-      ExpireMap& expiring = Kernel->Store->Expires->GetExpires();
+      const ExpireMap& expiring = Kernel->Store->Expires->GetExpires();
 
       if (!expiring.size())
       {
@@ -203,7 +191,7 @@ void ExpireManager::PreDBClose(const std::string& dbname)
 
       std::lock_guard<std::mutex> lg(ExpireManager::mute);
 
-      for (ExpireMap::iterator it = expiring.begin(); it != expiring.end(); )
+      for (ExpireMap::const_iterator it = expiring.begin(); it != expiring.end(); )
       {
                 if (it->second.database != database)
                 {
@@ -211,13 +199,13 @@ void ExpireManager::PreDBClose(const std::string& dbname)
                        continue;
                 }
 
-                Kernel->Store->Expires->ExpireList.erase(it++);
+                it = Kernel->Store->Expires->ExpireList.Erase(it);
       }
 }
 
 unsigned int ExpireManager::DatabaseReset(const std::string& dbname)
 {
-      ExpireMap& expiring = Kernel->Store->Expires->GetExpires();
+      const ExpireMap& expiring = Kernel->Store->Expires->GetExpires();
 
       if (!expiring.size())
       {
@@ -235,7 +223,7 @@ unsigned int ExpireManager::DatabaseReset(const std::string& dbname)
 
       std::lock_guard<std::mutex> lg(ExpireManager::mute);
       
-      for (ExpireMap::iterator it = expiring.begin(); it != expiring.end(); )
+      for (ExpireMap::const_iterator it = expiring.begin(); it != expiring.end(); )
       {
             if (it->second.database == database)
             {
@@ -252,7 +240,7 @@ unsigned int ExpireManager::DatabaseReset(const std::string& dbname)
 
 void ExpireManager::DatabaseDestroy(const std::string& dbname)
 {
-      ExpireMap& expiring = Kernel->Store->Expires->GetExpires();
+      const ExpireMap& expiring = Kernel->Store->Expires->GetExpires();
 
       if (!expiring.size())
       {
@@ -268,11 +256,11 @@ void ExpireManager::DatabaseDestroy(const std::string& dbname)
 
       std::lock_guard<std::mutex> lg(ExpireManager::mute);
 
-      for (ExpireMap::iterator it = expiring.begin(); it != expiring.end(); )
+      for (ExpireMap::const_iterator it = expiring.begin(); it != expiring.end(); )
       {
             if (it->second.database == database)
             {
-                    expiring.erase(it++);
+                    it = this->ExpireList.Erase(it);
                     continue;
             }
 
@@ -286,7 +274,7 @@ unsigned int ExpireManager::SelectReset(const std::string& dbname, unsigned int
       
       unsigned int counter = 0;
 
-      ExpireMap& expiring = Kernel->Store->Expires->GetExpires();
+      const ExpireMap& expiring = Kernel->Store->Expires->GetExpires();
 
       if (!expiring.size())
       {
@@ -302,7 +290,7 @@ unsigned int ExpireManager::SelectReset(const std::string& dbname, unsigned int
 
       std::lock_guard<std::mutex> lg(ExpireManager::mute);
 
-      for (ExpireMap::iterator it = expiring.begin(); it != expiring.end(); it++)
+      for (ExpireMap::const_iterator it = expiring.begin(); it != expiring.end(); it++)
       {
             if (it->second.select == select && it->second.database == database)
             {
@@ -317,7 +305,7 @@ unsigned int ExpireManager::SelectReset(const std::string& dbname, unsigned int
 
 void ExpireManager::Reset()
 {
-      ExpireMap& expiring = Kernel->Store->Expires->GetExpires();
+      const ExpireMap& expiring = Kernel->Store->Expires->GetExpires();
 
       if (!expiring.size())
       {
@@ -326,7 +314,7 @@ void ExpireManager::Reset()
 
       std::lock_guard<std::mutex> lg(ExpireManager::mute);
 
-      for (ExpireMap::iterator it = expiring.begin(); it != expiring.end(); it++)
+      for (ExpireMap::const_iterator it = expiring.begin(); it != expiring.end(); it++)
       {
               ExpireEntry entry = it->second;
               ExpireHelper::Persist(Kernel->Clients->Global, entry.key, entry.select, entry.database);
@@ -335,7 +323,7 @@ void ExpireManager::Reset()
 
 unsigned int ExpireManager::Count(const std::string& dbname, unsigned int select)
 {
-        ExpireMap& expires = Kernel->Store->Expires->GetExpires();
+        const ExpireMap& expires = Kernel->Store->Expires->GetExpires();
         
         std::shared_ptr<UserDatabase> database = Kernel->Store->DBM->Find(dbname);
 
@@ -348,7 +336,7 @@ unsigned int ExpireManager::Count(const std::string& dbname, unsigned int select
         
         unsigned int counter = 0;
 
-        for (ExpireMap::iterator it = expires.begin(); it != expires.end(); it++)
+        for (ExpireMap::const_iterator it = expires.begin(); it != expires.end(); it++)
         {
                 ExpireEntry entry = it->second;
 
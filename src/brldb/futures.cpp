@@ -31,13 +31,6 @@ signed int FutureManager::Add(std::shared_ptr<Database> database, signed int sch
                 return -1;
         }
         
-        if (FutureManager::GetTIME(database, key, select) > 0)
-        {
-              FutureManager::Delete(database, key, select);
-        }
-
-        std::lock_guard<std::mutex> lg(FutureManager::mute);
-        
         time_t Now = Kernel->Now();
         FutureEntry New;
 
@@ -54,65 +47,35 @@ signed int FutureManager::Add(std::shared_ptr<Database> database, signed int sch
         
         New.database = database;
         New.key = key;
+        New.value = value;
         New.added = Now;
         New.secs = schedule;
         New.select = select;
-        Kernel->Store->Futures->FutureList.insert(std::make_pair(New.schedule, New));
+
+        /* If entry already exists, it is replaced. */
+
+        std::lock_guard<std::mutex> lg(FutureManager::mute);
+        Kernel->Store->Futures->FutureList.Add(New);
+
         return New.schedule;
 }
 
 bool FutureManager::Delete(std::shared_ptr<Database> database, const std::string& key, unsigned int select)
 {
-        FutureMap& all = Kernel->Store->Futures->GetFutures();
-
-        /* Nothing to delete, at all. */
-
-        if (!all.size())
-        {
-                return false;
-        }
-
         std::lock_guard<std::mutex> lg(FutureManager::mute);
-
-        for (FutureMap::iterator it = all.begin(); it != all.end(); )
-        {
-                if (it->second.key != key)
-                {
-                       it++;
-                       continue;
-                }
-
-                if (it->second.select != select)
-                {
-                       it++;
-                       continue;
-                }
-                
-                if (it->second.database != database)
-                {
-                       it++;
-                       continue;
-                }
-
-                Kernel->Store->Futures->FutureList.erase(it++);
-                return true;
-        }
-
-        /* Key not found. */
-
-        return false;
+        return Kernel->Store->Futures->FutureList.Remove(database, key, select);
 }
 
 void FutureManager::Flush(time_t TIME)
 {
-        FutureMap& futures = Kernel->Store->Futures->GetFutures();
+        const FutureMap& futures = Kernel->Store->Futures->GetFutures();
 
         if (!futures.size())
         {
               return;
         }
         
-        for (FutureMap::iterator it = futures.begin(); it != futures.end(); )
+        for (FutureMap::const_iterator it = futures.begin(); it != futures.end(); )
         {
               if (it->first >= TIME)
               {
@@ -128,19 +91,18 @@ void FutureManager::Flush(time_t TIME)
 
 FutureEntry FutureManager::Find(std::shared_ptr<Database> database, const std::string& key, unsigned int select)
 {
-        FutureMap& current = Kernel->Store->Futures->GetFutures();
+        std::lock_guard<std::mutex> lg(FutureManager::mute);
 
-        for (FutureMap::iterator it = current.begin(); it != current.end(); it++)
-        {
-                  if (it->second.key == key && it->second.select == select && it->second.database == database)
-                  {
-                          return it->second;
-                  }
-        }
+        FutureEntry* entry = Kernel->Store->Futures->FutureList.Find(database, key, select);
 
         /* Not found, not expiring. */
 
-        throw KernelException("ne");
+        if (!entry)
+        {
+                throw KernelException("ne");
+        }
+
+        return *entry;
 }
 
 std::tuple<int, std::string> FutureManager::GetVal(std::shared_ptr<Database> database, const std::string& key, unsigned int select)
@@ -178,38 +140,34 @@ bool FutureManager::Exec(std::shared_ptr<Database> database, const std::string&
 
 signed int FutureManager::GetTIME(std::shared_ptr<Database> database, const std::string& key, unsigned int select)
 {
-        FutureMap& futures = Kernel->Store->Futures->GetFutures();
-        
         std::lock_guard<std::mutex> lg(FutureManager::mute);
 
-        for (FutureMap::iterator it = futures.begin(); it != futures.end(); it++)
-        {
-                        if (it->second.key == key && it->second.select == select && it->second.database == database)
-                        {
-                                return it->first;
-                        }
-        }
+        FutureEntry* entry = Kernel->Store->Futures->FutureList.Find(database, key, select);
 
         /* Not found, not expiring. */
 
-        return -1;
+        if (!entry)
+        {
+                return -1;
+        }
+
+        return entry->schedule;
 }
 
 signed int FutureManager::GetTTE(std::shared_ptr<Database> database, const std::string& key, unsigned int select)
 {
-      std::lock_guard<std::mutex> lg(FutureManager::mute);
       return FutureManager::GetTIME(database, key, select);
 }
 
-FutureMap& FutureManager::GetFutures()
+const FutureMap& FutureManager::GetFutures()
 {
        std::lock_guard<std::mutex> lg(FutureManager::mute);
-       return this->FutureList;
+       return this->FutureList.GetTimeline();
 }
 
 void FutureManager::Reset()
 {
-      FutureMap& expiring = Kernel->Store->Futures->GetFutures();
+      const FutureMap& expiring = Kernel->Store->Futures->GetFutures();
 
       if (!expiring.size())
       {
@@ -218,7 +176,7 @@ void FutureManager::Reset()
 
       std::lock_guard<std::mutex> lg(FutureManager::mute);
 
-      for (FutureMap::iterator it = expiring.begin(); it != expiring.end(); it++)
+      for (FutureMap::const_iterator it = expiring.begin(); it != expiring.end(); it++)
       {
               FutureEntry entry = it->second;
               GlobalHelper::FutureGlobalCancel(entry.database, entry.select, entry.key);
@@ -227,7 +185,7 @@ void FutureManager::Reset()
 
 unsigned int FutureManager::DatabaseReset(const std::string& dbname)
 {
-      FutureMap& expiring = Kernel->Store->Futures->GetFutures();
+      const FutureMap& expiring = Kernel->Store->Futures->GetFutures();
 
       if (!expiring.size())
       {
@@ -245,7 +203,7 @@ unsigned int FutureManager::DatabaseReset(const std::string& dbname)
 
       std::lock_guard<std::mutex> lg(FutureManager::mute);
       
-      for (FutureMap::iterator it = expiring.begin(); it != expiring.end(); )
+      for (FutureMap::const_iterator it = expiring.begin(); it != expiring.end(); )
       {
             if (it->second.database == database)
             {
@@ -266,7 +224,7 @@ unsigned int FutureManager::SelectReset(const std::string& dbname, unsigned int
 
       unsigned int counter = 0;
 
-      FutureMap& futures = Kernel->Store->Futures->GetFutures();
+      const FutureMap& futures = Kernel->Store->Futures->GetFutures();
 
       std::shared_ptr<UserDatabase> database = Kernel->Store->DBM->Find(dbname);
 
@@ -277,7 +235,7 @@ unsigned int FutureManager::SelectReset(const std::string& dbname, unsigned int
 
       std::lock_guard<std::mutex> lg(FutureManager::mute);
 
-      for (FutureMap::iterator it = futures.begin(); it != futures.end(); )
+      for (FutureMap::const_iterator it = futures.begin(); it != futures.end(); )
       {
             if (it->second.select == select && it->second.database == database)
             {
@@ -294,7 +252,7 @@ unsigned int FutureManager::SelectReset(const std::string& dbname, unsigned int
 
 void FutureManager::PreDBClose(const std::string& dbname)
 {
-      FutureMap& futures = Kernel->Store->Futures->GetFutures();
+      const FutureMap& futures = Kernel->Store->Futures->GetFutures();
 
       if (!futures.size())
       {
@@ -310,7 +268,7 @@ void FutureManager::PreDBClose(const std::string& dbname)
 
       std::lock_guard<std::mutex> lg(FutureManager::mute);
 
-      for (FutureMap::iterator it = futures.begin(); it != futures.end(); )
+      for (FutureMap::const_iterator it = futures.begin(); it != futures.end(); )
       {
                 if (it->second.database != database)
                 {
@@ -318,17 +276,17 @@ void FutureManager::PreDBClose(const std::string& dbname)
                        continue;
                 }
 
-                Kernel->Store->Futures->FutureList.erase(it++);
+                it = Kernel->Store->Futures->FutureList.Erase(it);
       }
 }
 
 unsigned int FutureManager::Count(std::shared_ptr<Database> database, unsigned int select)
 {
-        FutureMap& expires = Kernel->Store->Futures->GetFutures();
+        const FutureMap& expires = Kernel->Store->Futures->GetFutures();
 
         unsigned int counter = 0;
 
-        for (FutureMap::iterator it = expires.begin(); it != expires.end(); it++)
+        for (FutureMap::const_iterator it = expires.begin(); it != expires.end(); it++)
         {
                 FutureEntry entry = it->second;
 
@@ -343,7 +301,7 @@ unsigned int FutureManager::Count(std::shared_ptr<Database> database, unsigned i
 
 void FutureManager::DatabaseDestroy(const std::string& dbname)
 {
-      FutureMap& futures = Kernel->Store->Futures->GetFutures();
+      const FutureMap& futures = Kernel->Store->Futures->GetFutures();
 
       if (!futures.size())
       {
@@ -359,11 +317,11 @@ void FutureManager::DatabaseDestroy(const std::string& dbname)
 
       std::lock_guard<std::mutex> lg(FutureManager::mute);
 
-      for (FutureMap::iterator it = futures.begin(); it != futures.end(); )
+      for (FutureMap::const_iterator it = futures.begin(); it != futures.end(); )
       {
             if (it->second.database == database)
             {
-                    futures.erase(it++);
+                    it = this->FutureList.Erase(it);
                     continue;
             }
 
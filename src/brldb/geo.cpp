@@ -15,10 +15,77 @@
 #include "engine.h"
 
 #include "brldb/geo.h"
+#include "brldb/geo_index.h"
+#include "brldb/packed_vector.h"
+
+namespace
+{
+        /* 
+         * Writes a geo entry, moving its index entry along within the same batch.
+         * 
+         * @parameters:
+	 *
+	 *         · QueryBase	: Query writing to its dest.
+	 *         · string	: Value previously stored, if any.
+	 *         · double	: Latitude.
+	 *         · double	: Longitude.
+         */    
+
+        bool Store(QueryBase* query, const std::string& previous, double latitude, double longitude)
+        {
+                rocksdb::WriteBatch batch;
+
+                batch.Put(query->database->Route(query->dest), query->dest, GeoIndex::Position(latitude, longitude));
+
+                if (!previous.empty())
+                {
+                        GeoIndex::Remove(query->database, batch, query->select_query, query->key, previous);
+                }
+
+                GeoIndex::Add(query->database, batch, query->select_query, query->key, latitude, longitude);
+
+                rocksdb::Status status = query->database->Write(batch);
+                Kernel->Store->Hot->Invalidate(query->database, query->dest);
+
+                return status.ok();
+        }
+
+        /* Adds keys found to a query, skipping a given key. */
+
+        void Attach(QueryBase* query, const GeoMatches& found, const std::string& skip = "")
+        {
+                signed int skipped = 0;
+
+                for (GeoMatches::const_iterator i = found.begin(); i != found.end(); ++i)
+                {
+                        if (i->key == skip)
+                        {
+                                continue;
+                        }
+
+                        if (skipped++ < query->offset)
+                        {
+                                continue;
+                        }
+
+                        if (query->limit != -1 && (signed int)query->VecData.size() >= query->limit)
+                        {
+                                break;
+                        }
+
+                        query->VecData.push_back(i->key);
+                }
+
+                query->counter = query->VecData.size();
+                query->subresult = 1;
+                query->partial = false;
+                query->SetOK();
+        }
+}
 
 void geoaddnx_query::Run()
 {
-     RocksData result = this->Get(this->dest);
+     const RocksData& result = this->Get(this->dest);
 
      if (result.status.ok())
      {
@@ -26,9 +93,7 @@ void geoaddnx_query::Run()
           return;
      }
      
-     const std::string& save = to_bin(this->hesh) + ":" + to_bin(this->value);
-
-     if (this->Write(this->dest, save))
+     if (Store(this, "", convto_num<double>(this->value), convto_num<double>(this->hesh)))
      {
             this->SetOK();
      }
@@ -36,8 +101,6 @@ void geoaddnx_query::Run()
      {
            access_set(DBL_UNABLE_WRITE);
      }
-
-     this->SetOK();
 }
 
 void geoaddnx_query::Process()
@@ -47,9 +110,9 @@ void geoaddnx_query::Process()
 
 void geoadd_query::Run()
 {
-     const std::string& save = to_bin(this->hesh) + ":" + to_bin(this->value);
-     
-     if (this->Write(this->dest, save))
+     const RocksData& result = this->Get(this->dest);
+
+     if (Store(this, result.status.ok() ? result.value : "", convto_num<double>(this->value), convto_num<double>(this->hesh)))
      {
             this->SetOK();
      }
@@ -66,9 +129,9 @@ void geoadd_query::Process()
 
 void geoadd_pub_query::Run()
 {
-     const std::string save = to_bin(this->value) + ":" + to_bin(this->hesh);
-     
-     if (this->Write(this->dest, save))
+     const RocksData& result = this->Get(this->dest);
+
+     if (Store(this, result.status.ok() ? result.value : "", convto_num<double>(this->value), convto_num<double>(this->hesh)))
      {
           this->SetOK();
      }	
@@ -106,13 +169,16 @@ void geoadd_pub_query::Process()
 
 void geoget_query::Run()
 {
-      RocksData result = this->Get(this->dest);
-      std::string dbvalue = result.value;
-    
-      size_t found =  dbvalue.find_first_of(":");
-      const std::string& path = dbvalue.substr(0,found);
-      const std::string& file = dbvalue.substr(found+1);
-      this->response = to_string(path) + " " + to_string(file);
+      const RocksData& result = this->Get(this->dest);
+      double latitude, longitude;
+
+      if (!GeoIndex::Parse(result.value, latitude, longitude))
+      {
+            access_set(DBL_NOT_FOUND);
+            return;
+      }
+
+      this->response = PackedVector::Format(longitude) + " " + PackedVector::Format(latitude);
       this->SetOK();
 }
 
@@ -123,22 +189,16 @@ void geoget_query::Process()
 
 void geoget_custom_query::Run()
 {
-      RocksData result = this->Get(this->dest);
-      std::string dbvalue = result.value;
+      const RocksData& result = this->Get(this->dest);
+      double latitude, longitude;
 
-      size_t found =  dbvalue.find_first_of(":");
-      
-      if (this->type == QUERY_TYPE_LONG)
+      if (!GeoIndex::Parse(result.value, latitude, longitude))
       {
-               const std::string& path = dbvalue.substr(0,found);
-               this->response = to_string(path);
-      }
-      else
-      {
-               const std::string& file = dbvalue.substr(found+1);
-               this->response = to_string(file);
+            access_set(DBL_NOT_FOUND);
+            return;
       }
 
+      this->response = PackedVector::Format(this->type == QUERY_TYPE_LONG ? longitude : latitude);
       this->SetOK();
 }
 
@@ -156,9 +216,10 @@ void gkeys_query::Run()
 
        std::string rawmap;
        
-       rocksdb::Iterator* it = this->database->GetAddress()->NewIterator(rocksdb::ReadOptions());
+       std::unique_ptr<rocksdb::Iterator> it(this->database->NewIterator(INT_GEO));
+       PrefixRange range(this->key);
 
-       for (it->SeekToFirst(); it->Valid(); it->Next()) 
+       for (range.Seek(it.get()); range.Valid(it.get()); range.Next(it.get())) 
        {
                 if (!Dispatcher::CheckIterator(this))
                 {
@@ -239,12 +300,11 @@ void gkeys_query::Run()
                                     if (aux_counter % ITER_LIMIT == 0)
                                     {
                                                 tracker++;
-                                                std::shared_ptr<gkeys_query> request = std::make_shared<gkeys_query>();
+                                                std::shared_ptr<gkeys_query> request = QueryPool::Make<gkeys_query>();
                                                 request->user = this->user;
                                                 request->partial = true;                                  
                                                 request->subresult = tracker;
-                                                request->VecData = result;
-                                                result.clear();
+                                                request->VecData.swap(result);
                                                 request->SetOK();
                                                 DataFlush::AttachResult(request);
                                       }
@@ -263,12 +323,11 @@ void gkeys_query::Run()
                              if (aux_counter % ITER_LIMIT == 0)
                              {
                                         tracker++;
-                                        std::shared_ptr<gkeys_query> request = std::make_shared<gkeys_query>();
+                                        std::shared_ptr<gkeys_query> request = QueryPool::Make<gkeys_query>();
                                         request->user = this->user;
                                         request->partial = true;
                                         request->subresult = tracker;
-                                        request->VecData = result;
-                                        result.clear();
+                                        request->VecData.swap(result);
                                         request->SetOK();
                                         DataFlush::AttachResult(request);
                              }
@@ -280,7 +339,7 @@ void gkeys_query::Run()
     this->subresult = ++tracker;
     this->partial = false;
     this->counter = aux_counter;
-    this->VecData = result;
+    this->VecData.swap(result);
     this->SetOK();
 }
 
@@ -291,37 +350,21 @@ void gkeys_query::Process()
 
 void geocalc_query::Run()
 {
-        std::string first = to_bin(this->key) + ":" + convto_string(this->select_query) + ":" + this->base_request;
+        this->list.push_back(this->key);
+        this->list.push_back(this->value);
 
-        std::string dbvalue;
-        this->database->GetAddress()->Get(rocksdb::ReadOptions(), first, &dbvalue);
-    
-        if (dbvalue.empty())
-        {
-               access_set(DBL_NOT_FOUND);
-               return;
-        }
-        
-        std::string second = to_bin(this->value) + ":" + convto_string(this->select_query) + ":" + this->base_request;
-        
-        std::string dbvalue2;
-        this->database->GetAddress()->Get(rocksdb::ReadOptions(), second, &dbvalue2);
-    
-        if (dbvalue2.empty())
+        std::vector<std::string> values;
+        const std::vector<bool>& found = this->MultiRead(INT_GEO, &values);
+
+        double lat1, lon1, lat2, lon2;
+
+        if (!found[0] || !found[1] || !GeoIndex::Parse(values[0], lat1, lon1) || !GeoIndex::Parse(values[1], lat2, lon2))
         {
                access_set(DBL_NOT_FOUND);
                return;
         }
-        
-        size_t found =  dbvalue.find_first_of(":");
-        std::string path = dbvalue.substr(0,found);
-        std::string file = dbvalue.substr(found+1);
-        
-        size_t found2 =  dbvalue2.find_first_of(":");
-        std::string path2 = dbvalue2.substr(0,found2);
-        std::string file2 = dbvalue2.substr(found2+1);
-        
-        this->response = convto_string(CalculateDistance(convto_num<double>(to_string(path)), convto_num<double>(to_string(file)), convto_num<double>(to_string(path2)), convto_num<double>(to_string(file2))));
+
+        this->response = convto_string(GeoIndex::Distance(lat1, lon1, lat2, lon2));
         this->SetOK();
 }
 
@@ -332,166 +375,21 @@ void geocalc_query::Process()
 
 void geodistance_query::Run()
 {
-    std::string first = to_bin(this->key) + ":" + convto_string(this->select_query) + ":" + this->base_request;
-    
-    StringVector result;
-    
-    unsigned int total_counter = 0;
-    unsigned int aux_counter = 0;
-    unsigned int tracker = 0;
-    std::string rawmap;
-    std::string dbvalue;
-    rocksdb::Status fstatus2 = this->database->GetAddress()->Get(rocksdb::ReadOptions(), first, &dbvalue);
+    const RocksData& result = this->Get(to_bin(this->key) + ":" + convto_string(this->select_query) + ":" + this->base_request);
+    double latitude, longitude;
 
-    if (dbvalue.empty())
+    if (!result.status.ok() || !GeoIndex::Parse(result.value, latitude, longitude))
     {
           access_set(DBL_NOT_FOUND);
           return;
     }
-    
-    size_t found1 =  dbvalue.find_first_of(":");
-    std::string path1 = dbvalue.substr(0,found1);
-    std::string file1 = dbvalue.substr(found1+1);
-    
-    rocksdb::Iterator* it = this->database->GetAddress()->NewIterator(rocksdb::ReadOptions());
-
-    for (it->SeekToFirst(); it->Valid(); it->Next()) 
-    {
-                if (!Dispatcher::CheckIterator(this))
-                {
-                       return;
-                }
-                
-                rawmap = it->key().ToString();
-                engine::colon_node_stream stream(rawmap);
-                std::string token;
-                std::string key_as_string;
-
-                unsigned int strcounter = 0;
-                bool skip = false;
-
-                while (stream.items_extract(token))
-                {
-                        if (skip)
-                        {
-                            break;
-                        }
-                        
-                        switch (strcounter)
-                        {
-                             case 0:
-                             {
-                                  key_as_string = to_string(token);
 
-                                  if (key_as_string == this->key)
-                                  {
-                                       skip = true;
-                                  }
-                             }
-
-                             break;
+    /* Only cells around this entry are visited. */
 
-                             case 1:
-                             {
-                                   if (convto_string(this->select_query) != token)
-                                   {
-                                        skip = true;
-                                   }
-                             }
-
-                             break;
-
-                             case 2:
-                             {
-                                  if (token != INT_GEO)
-                                  {
-                                         skip = true;   
-                                  }
-                             }
-                             
-                             break;
-
-                             default:
-                             {
-                                 break;   
-                             }
-                        }
-
-                        strcounter++;
-                }
-
-                if (skip)
-                {
-                        continue;
-                }
-
-                std::string rawvalue = it->value().ToString();
-                
-                size_t found2 =  rawvalue.find_first_of(":");
-                std::string path2 = rawvalue.substr(0,found2);
-                std::string file2 = rawvalue.substr(found2+1);
-
-                double distance = CalculateDistance(convto_num<double>(to_string(path1)), convto_num<double>(to_string(file1)), convto_num<double>(to_string(path2)), convto_num<double>(to_string(file2)));
-            
-                if (distance <= convto_num<double>(this->value))
-                {
-                      continue;
-                }
-                
-                if (this->limit != -1 && ((signed int)total_counter >= this->offset))
-                {
-                             if (((signed int)aux_counter < limit))
-                             {
-                                    aux_counter++;
-                                    
-                                    result.push_back(key_as_string);
-             
-                                    if (aux_counter % ITER_LIMIT == 0)
-                                    {
-                                                tracker++;
-                                                std::shared_ptr<geodistance_query> request = std::make_shared<geodistance_query>();
-                                                request->user = this->user;
-                                                request->partial = true;                                  
-                                                request->subresult = tracker;
-                                                request->VecData = result;
-                                                result.clear();
-                                                request->SetOK();
-                                                DataFlush::AttachResult(request);
-                                      }
-                                      
-                                      if (aux_counter == (unsigned int)limit)
-                                      {
-                                                break;               
-                                      }
-                             }
-                }
-                else if (limit == -1)
-                {
-                             aux_counter++;
-                             result.push_back(key_as_string);
-            
-                             if (aux_counter % ITER_LIMIT == 0)
-                             {
-                                        tracker++;
-                                        std::shared_ptr<geodistance_query> request = std::make_shared<geodistance_query>();
-                                        request->user = this->user;
-                                        request->partial = true;
-                                        request->subresult = tracker;
-                                        request->VecData = result;
-                                        result.clear();
-                                        request->SetOK();
-                                        DataFlush::AttachResult(request);
-                             }
-                }
-                         
-                total_counter++;
-    }
+    GeoMatches found;
+    GeoIndex::Radius(this->database, this->select_query, latitude, longitude, convto_num<double>(this->value), found);
 
-    this->subresult = ++tracker;
-    this->partial = false;
-    this->counter = aux_counter;
-    this->VecData = result;
-    this->SetOK();
+    Attach(this, found, this->key);
 }
 
 void geodistance_query::Process()
@@ -517,114 +415,62 @@ void geodistance_query::Process()
 
 void georem_query::Run()
 {
-    std::string first = to_bin(this->key) + ":" + convto_string(this->select_query) + ":" + this->base_request;
-    
-    StringVector result;
-    
-    unsigned int total_counter = 0;
+    const RocksData& result = this->Get(to_bin(this->key) + ":" + convto_string(this->select_query) + ":" + this->base_request);
+    double latitude, longitude;
 
-    std::string dbvalue;
-    rocksdb::Status fstatus2 = this->database->GetAddress()->Get(rocksdb::ReadOptions(), first, &dbvalue);
-
-    if (dbvalue.empty())
+    if (!result.status.ok() || !GeoIndex::Parse(result.value, latitude, longitude))
     {
           access_set(DBL_NOT_FOUND);
           return;
     }
-    
-    size_t found1 =  dbvalue.find_first_of(":");
-    std::string path1 = dbvalue.substr(0,found1);
-    std::string file1 = dbvalue.substr(found1+1);
-    
-    rocksdb::Iterator* it = this->database->GetAddress()->NewIterator(rocksdb::ReadOptions());
-
-    for (it->SeekToFirst(); it->Valid(); it->Next()) 
-    {
-                if (!Dispatcher::CheckIterator(this))
-                {
-                       return;
-                }
-                
-                std::string rawmap = it->key().ToString();
-                engine::colon_node_stream stream(rawmap);
-                std::string token;
-                std::string key_as_string;
 
-                unsigned int strcounter = 0;
-                bool skip = false;
-
-                while (stream.items_extract(token))
-                {
-                        if (skip)
-                        {
-                            break;
-                        }
-                        
-                        switch (strcounter)
-                        {
-                             case 0:
-                             {
-                                  key_as_string = to_string(token);
-                                  
-                                  if (key_as_string == this->key)
-                                  {
-                                       continue;
-                                  }
-                             }
-
-                             break;
+    GeoMatches found;
+    GeoIndex::Radius(this->database, this->select_query, latitude, longitude, convto_num<double>(this->value), found);
 
-                             case 1:
-                             {
-                                   if (convto_string(this->select_query) != token)
-                                   {
-                                        skip = true;
-                                   }
-                             }
+    const std::string& suffix = ":" + convto_string(this->select_query) + ":" + INT_GEO;
+    rocksdb::WriteBatch batch;
 
-                             break;
+    unsigned int total_counter = 0;
 
-                             case 2:
-                             {
-                                  if (token != INT_GEO)
-                                  {
-                                         skip = true;   
-                                  }
-                             }
-                             
-                             break;
+    for (GeoMatches::const_iterator i = found.begin(); i != found.end(); ++i)
+    {
+          if (i->key == this->key)
+          {
+                continue;
+          }
 
-                             default:
-                             {
-                                 break;   
-                             }
-                        }
+          const std::string& rawmap = to_bin(i->key) + suffix;
 
-                        strcounter++;
-                }
+          batch.Delete(this->database->Route(rawmap), rawmap);
+          batch.Delete(this->database->GetHandle(INT_GEO_ITEM), GeoIndex::Entry(this->select_query, i->key, i->latitude, i->longitude));
+          total_counter++;
+    }
 
-                if (skip)
-                {
-                        continue;
-                }
+    if (!total_counter)
+    {
+          this->counter = 0;
+          this->SetOK();
+          return;
+    }
 
-                std::string rawvalue = it->value().ToString();
-     
-                size_t found2 =  rawvalue.find_first_of(":");
-                std::string path2 = rawvalue.substr(0,found2);
-                std::string file2 = rawvalue.substr(found2+1);
+    if (!this->database->Write(batch).ok())
+    {
+          access_set(DBL_UNABLE_WRITE);
+          return;
+    }
 
-                double distance = CalculateDistance(convto_num<double>(to_string(path1)), convto_num<double>(to_string(file1)), convto_num<double>(to_string(path2)), convto_num<double>(to_string(file2)));
-                
-                if (distance >= convto_num<double>(this->value))
-                {
-                      continue;
-                }
+    /* Keys removed are known, so watches of other keys stay valid. */
 
-                this->Delete(rawmap);
-                total_counter++;
+    for (GeoMatches::const_iterator i = found.begin(); i != found.end(); ++i)
+    {
+          if (i->key != this->key)
+          {
+                this->Touch(this->select_query, i->key);
+          }
     }
 
+    DataFlush::Touched();
+
     this->counter = total_counter;
     this->SetOK();
 }
@@ -634,5 +480,124 @@ void georem_query::Process()
         user->SendProtocol(BRLD_OK, convto_string(this->counter));
 }
 
+void gradius_query::Run()
+{
+        GeoMatches found;
+        GeoIndex::Radius(this->database, this->select_query, this->latitude, this->longitude, this->radius, found);
+        Attach(this, found);
+}
+
+void gradius_query::Process()
+{
+        Dispatcher::VectorFlush(false, "Location", this);
+}
 
+void gbox_query::Run()
+{
+        GeoMatches found;
+        GeoIndex::Box(this->database, this->select_query, this->minlat, this->minlon, this->maxlat, this->maxlon, found);
+        Attach(this, found);
+}
+
+void gbox_query::Process()
+{
+        Dispatcher::VectorFlush(false, "Location", this);
+}
 
+void gnearest_query::Run()
+{
+        GeoMatches found;
+        GeoIndex::Nearest(this->database, this->select_query, this->latitude, this->longitude, this->limit, found);
+
+        /* Limit is the number of entries requested. */
+
+        this->limit = -1;
+        Attach(this, found);
+}
+
+void gnearest_query::Process()
+{
+        Dispatcher::VectorFlush(false, "Location", this);
+}
+
+void geomadd_query::Run()
+{
+       /* Keys defined as other types are not overwritten. */
+
+       for (std::vector<std::string>::const_iterator iter = TypeRegs.begin(); iter != TypeRegs.end(); ++iter)
+       {
+              if (*iter == INT_GEO)
+              {
+                     continue;
+              }
+
+              const std::vector<bool>& found = this->MultiRead(*iter);
+
+              if (std::find(found.begin(), found.end(), true) != found.end())
+              {
+                     access_set(DBL_INVALID_TYPE);
+                     this->response = *iter;
+                     return;
+              }
+       }
+
+       std::vector<std::string> previous;
+       const std::vector<bool>& found = this->MultiRead(INT_GEO, &previous);
+
+       /* Keys given more than once keep their last position. */
+
+       std::unordered_map<std::string, size_t> last;
+
+       for (size_t i = 0; i < this->list.size(); i++)
+       {
+              last[this->list[i]] = i;
+       }
+
+       const std::string& suffix = ":" + convto_string(this->select_query) + ":" + INT_GEO;
+       rocksdb::ColumnFamilyHandle* geos = this->database->GetHandle(INT_GEO);
+       rocksdb::WriteBatch batch;
+
+       for (size_t i = 0; i < this->list.size(); i++)
+       {
+              if (last[this->list[i]] != i)
+              {
+                     continue;
+              }
+
+              const double latitude = this->positions[i].first;
+              const double longitude = this->positions[i].second;
+
+              batch.Put(geos, to_bin(this->list[i]) + suffix, GeoIndex::Position(latitude, longitude));
+
+              if (found[i])
+              {
+                     GeoIndex::Remove(this->database, batch, this->select_query, this->list[i], previous[i]);
+              }
+
+              GeoIndex::Add(this->database, batch, this->select_query, this->list[i], latitude, longitude);
+       }
+
+       /* Positions and their index entries are written at once. */
+
+       if (!this->database->Write(batch).ok())
+       {
+              access_set(DBL_UNABLE_WRITE);
+              return;
+       }
+
+       /* Keys written are known, so watches of other keys stay valid. */
+
+       for (std::unordered_map<std::string, size_t>::const_iterator i = last.begin(); i != last.end(); ++i)
+       {
+              this->Touch(this->select_query, i->first);
+       }
+
+       DataFlush::Touched();
+       this->counter = last.size();
+       this->SetOK();
+}
+
+void geomadd_query::Process()
+{
+       user->SendProtocol(BRLD_OK, convto_string(this->counter));
+}
@@ -0,0 +1,452 @@
+/*
+ * BerylDB - A lightweight database.
+ * http://www.beryldb.com
+ *
+ * Copyright (C) 2021 - Carlos F. Ferry <cferry@beryldb.com>
+ *
+ * This file is part of BerylDB. BerylDB is free software: you can
+ * redistribute it and/or modify it under the terms of the BSD License
+ * version 3.
+ *
+ * More information about our licensing can be found at https://docs.beryl.dev
+ */
+
+#include <cstring>
+
+#include "beryl.h"
+#include "brldb/database.h"
+#include "brldb/container.h"
+#include "brldb/geo.h"
+#include "brldb/geo_index.h"
+
+namespace
+{
+        /* Bits per coordinate. */
+
+        const unsigned int GEO_STEP = 26;
+
+        /* Searches use the finest grid covering their area with this many cells, at most. */
+
+        const uint64_t GEO_MAX_CELLS = 9;
+
+        /* Select and geohash. */
+
+        const size_t GEO_PREFIX = 16;
+
+        /* Nearest entries are searched within this radius first, in kilometers. */
+
+        const double GEO_NEAREST_START = 1;
+
+        uint64_t Spread(uint32_t number)
+        {
+                uint64_t value = number;
+
+                value = (value | (value << 16)) & 0x0000FFFF0000FFFFULL;
+                value = (value | (value << 8)) & 0x00FF00FF00FF00FFULL;
+                value = (value | (value << 4)) & 0x0F0F0F0F0F0F0F0FULL;
+                value = (value | (value << 2)) & 0x3333333333333333ULL;
+                value = (value | (value << 1)) & 0x5555555555555555ULL;
+
+                return value;
+        }
+
+        uint64_t Interleave(uint32_t latitude, uint32_t longitude)
+        {
+                return Spread(latitude) | (Spread(longitude) << 1);
+        }
+
+        /* Returns cell of a coordinate, in a grid of 2^step cells. */
+
+        uint32_t Cell(double value, double min, double max, unsigned int step)
+        {
+                const double offset = (value - min) / (max - min);
+                const uint64_t cells = 1ULL << step;
+
+                if (!(offset > 0))
+                {
+                        return 0;
+                }
+
+                if (offset >= 1)
+                {
+                        return cells - 1;
+                }
+
+                return (uint32_t)(offset * cells);
+        }
+
+        std::string EncodeDouble(double value)
+        {
+                uint64_t bits;
+                memcpy(&bits, &value, sizeof(bits));
+                return Container::Encode(bits);
+        }
+
+        double DecodeDouble(const char* data)
+        {
+                const uint64_t bits = Container::GetId(rocksdb::Slice(data, 8));
+
+                double value;
+                memcpy(&value, &bits, sizeof(value));
+                return value;
+        }
+
+        bool Closer(const GeoMatch& first, const GeoMatch& second)
+        {
+                return first.distance < second.distance;
+        }
+}
+
+uint64_t GeoIndex::Hash(double latitude, double longitude)
+{
+        return Interleave(Cell(latitude, -90, 90, GEO_STEP), Cell(longitude, -180, 180, GEO_STEP));
+}
+
+std::string GeoIndex::Entry(unsigned int select, const std::string& key, double latitude, double longitude)
+{
+        return Container::Encode(select) + Container::Encode(Hash(latitude, longitude)) + key;
+}
+
+std::string GeoIndex::Position(double latitude, double longitude)
+{
+        return EncodeDouble(latitude) + EncodeDouble(longitude);
+}
+
+bool GeoIndex::Parse(const std::string& value, double& latitude, double& longitude)
+{
+        if (value.size() != 16)
+        {
+                return false;
+        }
+
+        latitude = DecodeDouble(value.data());
+        longitude = DecodeDouble(value.data() + 8);
+        return true;
+}
+
+bool GeoIndex::ParseLegacy(const std::string& value, double& latitude, double& longitude)
+{
+        const size_t found = value.find(':');
+
+        if (found == std::string::npos)
+        {
+                return false;
+        }
+
+        const std::string& first = to_string(value.substr(0, found));
+        const std::string& second = to_string(value.substr(found + 1));
+
+        /* Packed values never look like numbers, so both formats can be told apart. */
+
+        if (!is_number(first, true) || !is_number(second, true))
+        {
+                return false;
+        }
+
+        longitude = convto_num<double>(first);
+        latitude = convto_num<double>(second);
+        return true;
+}
+
+void GeoIndex::Add(std::shared_ptr<Database> database, rocksdb::WriteBatch& batch, unsigned int select, const std::string& key, double latitude, double longitude)
+{
+        batch.Put(database->GetHandle(INT_GEO_ITEM), Entry(select, key, latitude, longitude), Position(latitude, longitude));
+}
+
+void GeoIndex::Remove(std::shared_ptr<Database> database, rocksdb::WriteBatch& batch, unsigned int select, const std::string& key, const std::string& value)
+{
+        double latitude, longitude;
+
+        if (Parse(value, latitude, longitude))
+        {
+                batch.Delete(database->GetHandle(INT_GEO_ITEM), Entry(select, key, latitude, longitude));
+        }
+}
+
+void GeoIndex::Erase(std::shared_ptr<Database> database, unsigned int select, rocksdb::WriteBatch& batch)
+{
+        Container::Erase(database, INT_GEO_ITEM, select, batch);
+}
+
+bool GeoIndex::Index(std::shared_ptr<Database> database, unsigned int select, const std::string& key, const std::string& value)
+{
+        double latitude, longitude;
+
+        if (!Parse(value, latitude, longitude))
+        {
+                return false;
+        }
+
+        rocksdb::WriteBatch batch;
+        Add(database, batch, select, key, latitude, longitude);
+        return database->Write(batch).ok();
+}
+
+void GeoIndex::Drop(std::shared_ptr<Database> database, unsigned int select, const std::string& key, const std::string& value)
+{
+        rocksdb::WriteBatch batch;
+        Remove(database, batch, select, key, value);
+
+        if (batch.Count())
+        {
+                database->Write(batch);
+        }
+}
+
+double GeoIndex::Distance(double lat1, double lon1, double lat2, double lon2)
+{
+        return CalculateDistance(lat1, lon1, lat2, lon2);
+}
+
+void GeoIndex::Cover(double minlat, double maxlat, double minlon, double maxlon, std::vector<HashRange>& ranges)
+{
+        unsigned int step = GEO_STEP;
+
+        uint32_t latfirst, latlast, lonfirst, lonlast;
+
+        for (;; step--)
+        {
+                latfirst = Cell(minlat, -90, 90, step);
+                latlast = Cell(maxlat, -90, 90, step);
+                lonfirst = Cell(minlon, -180, 180, step);
+                lonlast = Cell(maxlon, -180, 180, step);
+
+                if (!step || (uint64_t)(latlast - latfirst + 1) * (lonlast - lonfirst + 1) <= GEO_MAX_CELLS)
+                {
+                        break;
+                }
+        }
+
+        /* A cell at this step spans every geohash sharing its leading bits. */
+
+        const unsigned int shift = 2 * (GEO_STEP - step);
+
+        for (uint32_t lat = latfirst; lat <= latlast; lat++)
+        {
+                for (uint32_t lon = lonfirst; lon <= lonlast; lon++)
+                {
+                        const uint64_t cell = Interleave(lat, lon);
+                        ranges.push_back(HashRange(cell << shift, (cell + 1) << shift));
+                }
+        }
+}
+
+void GeoIndex::Scan(std::shared_ptr<Database> database, unsigned int select, double minlat, double maxlat, double minlon, double maxlon, GeoMatches& found)
+{
+        std::vector<HashRange> ranges;
+
+        minlat = std::max(minlat, -90.0);
+        maxlat = std::min(maxlat, 90.0);
+
+        if (maxlon - minlon >= 360)
+        {
+                Cover(minlat, maxlat, -180, 180, ranges);
+        }
+        else if (minlon < -180)
+        {
+                Cover(minlat, maxlat, minlon + 360, 180, ranges);
+                Cover(minlat, maxlat, -180, maxlon, ranges);
+        }
+        else if (maxlon > 180)
+        {
+                Cover(minlat, maxlat, minlon, 180, ranges);
+                Cover(minlat, maxlat, -180, maxlon - 360, ranges);
+        }
+        else
+        {
+                Cover(minlat, maxlat, minlon, maxlon, ranges);
+        }
+
+        /* Neighbour cells are often contiguous, and are read with a single seek. */
+
+        std::sort(ranges.begin(), ranges.end());
+
+        std::vector<HashRange> merged;
+
+        for (std::vector<HashRange>::const_iterator i = ranges.begin(); i != ranges.end(); ++i)
+        {
+                if (!merged.empty() && i->first <= merged.back().second)
+                {
+                        merged.back().second = std::max(merged.back().second, i->second);
+                        continue;
+                }
+
+                merged.push_back(*i);
+        }
+
+        const std::string& prefix = Container::Encode(select);
+        std::unique_ptr<rocksdb::Iterator> it(database->NewIterator(INT_GEO_ITEM));
+
+        for (std::vector<HashRange>::const_iterator i = merged.begin(); i != merged.end(); ++i)
+        {
+                const std::string& last = prefix + Container::Encode(i->second);
+
+                for (it->Seek(prefix + Container::Encode(i->first)); it->Valid() && it->key().compare(last) < 0; it->Next())
+                {
+                        const rocksdb::Slice& key = it->key();
+                        const rocksdb::Slice& value = it->value();
+
+                        if (key.size() <= GEO_PREFIX || value.size() != 16)
+                        {
+                                continue;
+                        }
+
+                        GeoMatch match;
+                        match.key.assign(key.data() + GEO_PREFIX, key.size() - GEO_PREFIX);
+                        match.latitude = DecodeDouble(value.data());
+                        match.longitude = DecodeDouble(value.data() + 8);
+                        match.distance = 0;
+
+                        found.push_back(match);
+                }
+        }
+}
+
+void GeoIndex::Verify(std::shared_ptr<Database> database, unsigned int select, GeoMatches& found)
+{
+        const size_t total = found.size();
+
+        if (!total)
+        {
+                return;
+        }
+
+        const std::string& suffix = ":" + convto_string(select) + ":" + INT_GEO;
+
+        std::vector<std::string> dests(total);
+        std::vector<rocksdb::Slice> keys(total);
+
+        for (size_t i = 0; i < total; i++)
+        {
+                dests[i] = to_bin(found[i].key) + suffix;
+                keys[i] = rocksdb::Slice(dests[i]);
+        }
+
+        std::vector<rocksdb::PinnableSlice> pinned(total);
+        std::vector<rocksdb::Status> statuses(total);
+
+        database->MultiGet(database->GetHandle(INT_GEO), total, keys.data(), pinned.data(), statuses.data(), false);
+
+        rocksdb::WriteBatch stale;
+        size_t kept = 0;
+
+        for (size_t i = 0; i < total; i++)
+        {
+                double latitude, longitude;
+
+                if (!statuses[i].ok() || !Parse(pinned[i].ToString(), latitude, longitude) || Hash(latitude, longitude) != Hash(found[i].latitude, found[i].longitude))
+                {
+                        stale.Delete(database->GetHandle(INT_GEO_ITEM), Entry(select, found[i].key, found[i].latitude, found[i].longitude));
+                        continue;
+                }
+
+                if (kept != i)
+                {
+                        found[kept] = found[i];
+                }
+
+                kept++;
+        }
+
+        found.resize(kept);
+
+        /* 
+         * Only index entries are removed, so no key is modified (see Database::Write).
+         * Entries found stale within a transaction may be stale only until it
+         * is discarded, so they are left for a later lookup.
+         */
+
+        if (stale.Count() && !Database::Gathering())
+        {
+                database->GetAddress()->Write(rocksdb::WriteOptions(), &stale);
+        }
+}
+
+void GeoIndex::Radius(std::shared_ptr<Database> database, unsigned int select, double latitude, double longitude, double radius, GeoMatches& found)
+{
+        const double angle = radius / earth_radius_km;
+        const double dlat = rad2deg(angle);
+
+        double minlon = -180;
+        double maxlon = 180;
+
+        /* Boxes reaching a pole, or the other side of the earth, cover all longitudes. */
+
+        if (angle < M_PI / 2 && latitude - dlat > -90 && latitude + dlat < 90)
+        {
+                const double dlon = rad2deg(asin(sin(angle) / cos(deg2rad(latitude))));
+
+                minlon = longitude - dlon;
+                maxlon = longitude + dlon;
+        }
+
+        GeoMatches candidates;
+        Scan(database, select, latitude - dlat, latitude + dlat, minlon, maxlon, candidates);
+
+        for (GeoMatches::iterator i = candidates.begin(); i != candidates.end(); ++i)
+        {
+                i->distance = Distance(latitude, longitude, i->latitude, i->longitude);
+
+                if (i->distance <= radius)
+                {
+                        found.push_back(*i);
+                }
+        }
+
+        Verify(database, select, found);
+        std::sort(found.begin(), found.end(), Closer);
+}
+
+void GeoIndex::Box(std::shared_ptr<Database> database, unsigned int select, double minlat, double minlon, double maxlat, double maxlon, GeoMatches& found)
+{
+        if (minlon > maxlon)
+        {
+                maxlon += 360;
+        }
+
+        GeoMatches candidates;
+        Scan(database, select, minlat, maxlat, minlon, maxlon, candidates);
+
+        for (GeoMatches::iterator i = candidates.begin(); i != candidates.end(); ++i)
+        {
+                if (i->latitude < minlat || i->latitude > maxlat)
+                {
+                        continue;
+                }
+
+                if ((i->longitude >= minlon && i->longitude <= maxlon) || (i->longitude + 360 >= minlon && i->longitude + 360 <= maxlon))
+                {
+                        found.push_back(*i);
+                }
+        }
+
+        Verify(database, select, found);
+}
+
+void GeoIndex::Nearest(std::shared_ptr<Database> database, unsigned int select, double latitude, double longitude, size_t count, GeoMatches& found)
+{
+        if (!count)
+        {
+                return;
+        }
+
+        /* Radius grows until enough entries are found, or the whole earth is covered. */
+
+        const double farthest = M_PI * earth_radius_km;
+
+        for (double radius = GEO_NEAREST_START; ; radius *= 4)
+        {
+                found.clear();
+                Radius(database, select, latitude, longitude, std::min(radius, farthest), found);
+
+                if (found.size() >= count || radius >= farthest)
+                {
+                        break;
+                }
+        }
+
+        if (found.size() > count)
+        {
+                found.resize(count);
+        }
+}
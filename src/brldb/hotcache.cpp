@@ -0,0 +1,311 @@
+/*
+ * BerylDB - A lightweight database.
+ * http://www.beryldb.com
+ *
+ * Copyright (C) 2021 - Carlos F. Ferry <cferry@beryldb.com>
+ *
+ * This file is part of BerylDB. BerylDB is free software: you can
+ * redistribute it and/or modify it under the terms of the BSD License
+ * version 3.
+ *
+ * More information about our licensing can be found at https://docs.beryl.dev
+ */
+
+#include "beryl.h"
+#include "brldb/database.h"
+#include "brldb/hotcache.h"
+
+namespace
+{
+        const unsigned int SKETCH_ROWS = 4;
+
+        const unsigned char SKETCH_MAX = 15;
+
+        /* Position of a key in given row of a sketch. */
+
+        inline size_t Cell(size_t hash, unsigned int row, size_t width)
+        {
+                const size_t step = (hash >> 17) | 1;
+                return row * width + ((hash + row * step) & (width - 1));
+        }
+}
+
+HotCache::HotCache() : capacity(0), enabled(false), hits(0), misses(0), rejected(0)
+{
+
+}
+
+void HotCache::Configure(size_t entries)
+{
+        this->enabled = false;
+
+        if (!entries)
+        {
+                this->shards.reset();
+                this->capacity = 0;
+                return;
+        }
+
+        this->capacity = (entries + HOT_SHARDS - 1) / HOT_SHARDS;
+
+        size_t width = 64;
+
+        while (width < this->capacity)
+        {
+                width <<= 1;
+        }
+
+        this->shards.reset(new Shard[HOT_SHARDS]);
+
+        for (unsigned int i = 0; i < HOT_SHARDS; i++)
+        {
+                Shard& shard = this->shards[i];
+
+                shard.slots.reserve(this->capacity);
+                shard.index.reserve(this->capacity);
+                shard.hand = 0;
+                shard.sketch.assign(SKETCH_ROWS * width, 0);
+                shard.accesses = 0;
+        }
+
+        this->enabled = true;
+}
+
+std::string HotCache::Build(const std::shared_ptr<Database>& database, const std::string& dest)
+{
+        std::string entry;
+        entry.reserve(database->GetName().size() + dest.size() + 1);
+        entry.append(database->GetName());
+        entry.append(1, '\0');
+        entry.append(dest);
+        return entry;
+}
+
+HotCache::Shard& HotCache::Find(const std::string& entry, size_t& hash)
+{
+        hash = std::hash<std::string>()(entry);
+        return this->shards[(hash >> 8) % HOT_SHARDS];
+}
+
+void HotCache::Record(Shard& shard, size_t hash)
+{
+        const size_t width = shard.sketch.size() / SKETCH_ROWS;
+
+        for (unsigned int row = 0; row < SKETCH_ROWS; row++)
+        {
+                unsigned char& counter = shard.sketch[Cell(hash, row, width)];
+
+                if (counter < SKETCH_MAX)
+                {
+                        counter++;
+                }
+        }
+
+        /* Counters are halved often, so keys that were once hot fade away. */
+
+        if (++shard.accesses >= this->capacity * 10)
+        {
+                for (std::vector<unsigned char>::iterator i = shard.sketch.begin(); i != shard.sketch.end(); ++i)
+                {
+                        *i >>= 1;
+                }
+
+                shard.accesses = 0;
+        }
+}
+
+unsigned int HotCache::Frequency(const Shard& shard, size_t hash) const
+{
+        const size_t width = shard.sketch.size() / SKETCH_ROWS;
+        unsigned int lowest = SKETCH_MAX;
+
+        for (unsigned int row = 0; row < SKETCH_ROWS; row++)
+        {
+                lowest = std::min(lowest, (unsigned int)shard.sketch[Cell(hash, row, width)]);
+        }
+
+        return lowest;
+}
+
+void HotCache::Remove(Shard& shard, std::unordered_map<std::string, size_t>::iterator it)
+{
+        Entry& entry = shard.slots[it->second];
+
+        entry.key.clear();
+        entry.value.clear();
+        entry.value.shrink_to_fit();
+        entry.referenced = false;
+
+        shard.unused.push_back(it->second);
+        shard.index.erase(it);
+}
+
+bool HotCache::Fetch(const std::shared_ptr<Database>& database, const std::string& dest, std::string* value)
+{
+        if (!this->Enabled())
+        {
+                return false;
+        }
+
+        const std::string& entry = Build(database, dest);
+
+        size_t hash;
+        Shard& shard = this->Find(entry, hash);
+
+        std::lock_guard<std::mutex> lock(shard.lock);
+
+        this->Record(shard, hash);
+
+        std::unordered_map<std::string, size_t>::const_iterator it = shard.index.find(entry);
+
+        if (it == shard.index.end())
+        {
+                this->misses++;
+                return false;
+        }
+
+        Entry& found = shard.slots[it->second];
+        found.referenced = true;
+
+        if (value)
+        {
+                value->assign(found.value);
+        }
+
+        this->hits++;
+        return true;
+}
+
+void HotCache::Add(const std::shared_ptr<Database>& database, const std::string& dest, const std::string& value)
+{
+        if (!this->Enabled() || value.size() > HOT_MAX_VALUE)
+        {
+                return;
+        }
+
+        std::string entry = Build(database, dest);
+
+        size_t hash;
+        Shard& shard = this->Find(entry, hash);
+
+        std::lock_guard<std::mutex> lock(shard.lock);
+
+        std::unordered_map<std::string, size_t>::iterator it = shard.index.find(entry);
+
+        if (it != shard.index.end())
+        {
+                shard.slots[it->second].value = value;
+                return;
+        }
+
+        size_t position;
+
+        if (!shard.unused.empty())
+        {
+                position = shard.unused.back();
+                shard.unused.pop_back();
+        }
+        else if (shard.slots.size() < this->capacity)
+        {
+                position = shard.slots.size();
+                shard.slots.push_back(Entry());
+        }
+        else
+        {
+                /* Clock hand moves until it finds an entry not accessed since last pass. */
+
+                while (shard.slots[shard.hand].referenced)
+                {
+                        shard.slots[shard.hand].referenced = false;
+                        shard.hand = (shard.hand + 1) % shard.slots.size();
+                }
+
+                Entry& victim = shard.slots[shard.hand];
+
+                if (this->Frequency(shard, hash) <= this->Frequency(shard, std::hash<std::string>()(victim.key)))
+                {
+                        this->rejected++;
+                        return;
+                }
+
+                position = shard.hand;
+                shard.hand = (shard.hand + 1) % shard.slots.size();
+                shard.index.erase(victim.key);
+        }
+
+        Entry& target = shard.slots[position];
+
+        target.key = entry;
+        target.value = value;
+        target.referenced = false;
+
+        shard.index[std::move(entry)] = position;
+}
+
+void HotCache::Invalidate(const std::shared_ptr<Database>& database, const std::string& dest)
+{
+        if (!this->Enabled())
+        {
+                return;
+        }
+
+        const std::string& entry = Build(database, dest);
+
+        size_t hash;
+        Shard& shard = this->Find(entry, hash);
+
+        std::lock_guard<std::mutex> lock(shard.lock);
+
+        std::unordered_map<std::string, size_t>::iterator it = shard.index.find(entry);
+
+        if (it != shard.index.end())
+        {
+                this->Remove(shard, it);
+        }
+}
+
+void HotCache::Clear(const std::string& dbname)
+{
+        if (!this->Enabled())
+        {
+                return;
+        }
+
+        const std::string prefix = dbname + std::string(1, '\0');
+
+        for (unsigned int i = 0; i < HOT_SHARDS; i++)
+        {
+                Shard& shard = this->shards[i];
+                std::lock_guard<std::mutex> lock(shard.lock);
+
+                for (std::unordered_map<std::string, size_t>::iterator it = shard.index.begin(); it != shard.index.end(); )
+                {
+                        if (it->first.compare(0, prefix.size(), prefix) == 0)
+                        {
+                                this->Remove(shard, it++);
+                        }
+                        else
+                        {
+                                ++it;
+                        }
+                }
+        }
+}
+
+size_t HotCache::Count()
+{
+        if (!this->Enabled())
+        {
+                return 0;
+        }
+
+        size_t total = 0;
+
+        for (unsigned int i = 0; i < HOT_SHARDS; i++)
+        {
+                std::lock_guard<std::mutex> lock(this->shards[i].lock);
+                total += this->shards[i].index.size();
+        }
+
+        return total;
+}
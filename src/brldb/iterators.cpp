@@ -11,6 +11,8 @@
  * More information about our licensing can be found at https://docs.beryl.dev
  */
 
+#include <algorithm>
+
 #include "beryl.h"
 #include "brldb/iterators.h"
 
@@ -22,4 +24,101 @@ LoopIterator::LoopIterator()
 /*void LoopIterator::Run::()
 {
 
-}*/
\ No newline at end of file
+}*/
+
+PrefixRange::PrefixRange(const std::string& pattern) : current(0)
+{
+        const size_t found = pattern.find_first_of("*?");
+        const std::string& literal = pattern.substr(0, found);
+
+        std::vector<std::string> variants;
+        variants.push_back("");
+
+        for (std::string::const_iterator c = literal.begin(); c != literal.end(); ++c)
+        {
+                /* Characters matched by Daemon::Match() as equal. */
+
+                std::vector<char> equals;
+
+                for (unsigned int b = 0; b < 256; ++b)
+                {
+                        if (locale_case_insensitive_map[b] == locale_case_insensitive_map[(unsigned char)*c])
+                        {
+                                equals.push_back((char)b);
+                        }
+                }
+
+                /* A shorter prefix is still a valid bound. */
+
+                if (variants.size() * equals.size() > MAX_PREFIX_RANGES)
+                {
+                        break;
+                }
+
+                std::vector<std::string> expanded;
+
+                for (std::vector<std::string>::const_iterator v = variants.begin(); v != variants.end(); ++v)
+                {
+                        for (std::vector<char>::const_iterator e = equals.begin(); e != equals.end(); ++e)
+                        {
+                                expanded.push_back(*v + *e);
+                        }
+                }
+
+                variants.swap(expanded);
+        }
+
+        for (std::vector<std::string>::const_iterator v = variants.begin(); v != variants.end(); ++v)
+        {
+                this->prefixes.push_back(to_bin(*v));
+        }
+
+        std::sort(this->prefixes.begin(), this->prefixes.end());
+}
+
+void PrefixRange::Skip(rocksdb::Iterator* it)
+{
+        while (this->current < this->prefixes.size())
+        {
+                it->Seek(this->prefixes[this->current]);
+
+                if (!it->Valid())
+                {
+                        /* Remaining prefixes are greater than any entry. */
+
+                        this->current = this->prefixes.size();
+                        return;
+                }
+
+                if (it->key().starts_with(this->prefixes[this->current]))
+                {
+                        return;
+                }
+
+                this->current++;
+        }
+}
+
+void PrefixRange::Seek(rocksdb::Iterator* it)
+{
+        this->current = 0;
+        this->Skip(it);
+}
+
+bool PrefixRange::Valid(rocksdb::Iterator* it)
+{
+        return this->current < this->prefixes.size() && it->Valid();
+}
+
+void PrefixRange::Next(rocksdb::Iterator* it)
+{
+        it->Next();
+
+        if (it->Valid() && it->key().starts_with(this->prefixes[this->current]))
+        {
+                return;
+        }
+
+        this->current++;
+        this->Skip(it);
+}
@@ -22,7 +22,7 @@ void expire_list_query::Run()
 {
        unsigned int total_counter = 0;
 
-       rocksdb::Iterator* it = this->database->GetAddress()->NewIterator(rocksdb::ReadOptions());
+       std::unique_ptr<rocksdb::Iterator> it(this->database->NewIterator(INT_EXPIRE));
        
        for (it->SeekToFirst(); it->Valid(); it->Next()) 
        {
@@ -164,6 +164,66 @@ void expire_del_query::Process()
         }
 }
 
+void expire_batch_query::Run()
+{
+       rocksdb::WriteBatch batch;
+       std::vector<std::string> deleted;
+
+       for (std::vector<ExpiredKey>::const_iterator i = this->expired.begin(); i != this->expired.end(); ++i)
+       {
+              const std::string& lookup = to_bin(i->key) + ":" + convto_string(i->select) + ":" + INT_EXPIRE + ":" + this->database->GetName();
+              const std::string& kdest = to_bin(i->key) + ":" + convto_string(i->select) + ":" + INT_KEY;
+
+              /* Keys persisted, or expired again, since being scheduled are kept. */
+
+              const RocksData& result = this->Get(lookup);
+
+              if (!result.status.ok() || convto_num<time_t>(result.value) != i->schedule)
+              {
+                     continue;
+              }
+
+              batch.Delete(this->database->Route(lookup), lookup);
+              batch.Delete(this->database->Route(kdest), kdest);
+              Kernel->Store->Hot->Invalidate(this->database, kdest);
+
+              if (Kernel->Store->Watches->Active())
+              {
+                     deleted.push_back(WatchTable::Build(this->database, i->select, i->key));
+              }
+       }
+
+       rocksdb::Status stats = this->database->Write(batch);
+
+       if (!stats.ok())
+       {
+              /* Expires are scheduled again, so next flush retries them. */
+
+              for (std::vector<ExpiredKey>::const_iterator i = this->expired.begin(); i != this->expired.end(); ++i)
+              {
+                     Kernel->Store->Expires->Add(this->database, i->schedule, i->key, i->select, true);
+              }
+
+              access_set(DBL_BATCH_FAILED);
+              return;
+       }
+
+       /* Only keys expired are touched, so that watches of other keys stay valid. */
+
+       for (std::vector<std::string>::const_iterator i = deleted.begin(); i != deleted.end(); ++i)
+       {
+              Kernel->Store->Watches->Touch(*i);
+       }
+
+       DataFlush::Touched();
+       this->SetOK();
+}
+
+void expire_batch_query::Process()
+{
+
+}
+
 void set_query::Run()
 {
        if (this->Write(this->dest, to_bin(this->value)))
@@ -183,7 +243,7 @@ void set_query::Process()
 
 void get_substr_query::Run()
 {
-       RocksData result = this->Get(this->dest);
+       const RocksData& result = this->Get(this->dest);
        this->response = to_string(result.value);
        
        if ((unsigned int)(this->offset + this->limit) > this->response.length())
@@ -206,12 +266,12 @@ void get_substr_query::Run()
 
 void get_substr_query::Process()
 {
-       user->SendProtocol(BRLD_OK, Helpers::Format(this->response).c_str());
+       user->SendProtocol(BRLD_OK, this->Quote(this->response));
 }
 
 void modify_query::Run()
 {
-       RocksData result = this->Get(this->dest);
+       const RocksData& result = this->Get(this->dest);
        this->response = to_string(result.value);
        
        if (this->function == STR_TO_UPPER)
@@ -247,7 +307,7 @@ void modify_query::Process()
 
 void get_occurs_query::Run()
 {
-       RocksData result = this->Get(this->dest);
+       const RocksData& result = this->Get(this->dest);
        this->response = to_string(result.value);
        this->response = convto_string(count_occur(this->response, this->value));
        this->SetOK();
@@ -260,7 +320,7 @@ void get_occurs_query::Process()
 
 void alpha_query::Run()
 {
-       RocksData result = this->Get(this->dest);
+       const RocksData& result = this->Get(this->dest);
 
        if (isalpha(to_string(result.value)))
        {
@@ -281,7 +341,7 @@ void alpha_query::Process()
 
 void char_query::Run()
 {
-       RocksData result = this->Get(this->dest);
+       const RocksData& result = this->Get(this->dest);
 
        const std::string& found = to_string(result.value);
        const unsigned int flength = convto_num<unsigned int>(this->value);
@@ -306,7 +366,7 @@ void char_query::Process()
 
 void isnum_query::Run()
 {
-       RocksData result = this->Get(this->dest);
+       const RocksData& result = this->Get(this->dest);
 
        if (is_number(to_string(result.value), true))
        {
@@ -327,7 +387,7 @@ void isnum_query::Process()
 
 void isbool_query::Run()
 {
-       RocksData result = this->Get(this->dest);
+       const RocksData& result = this->Get(this->dest);
        const std::string& as_str = to_string(result.value);
        
        if (as_str == "0" || as_str == "1" || as_str == "true" || as_str == "false" || as_str == "on" || as_str == "off")
@@ -349,7 +409,7 @@ void isbool_query::Process()
 
 void getpersist_query::Run()
 {
-       RocksData result = this->Get(this->dest);
+       const RocksData& result = this->Get(this->dest);
        this->response = to_string(result.value);
        
        this->DelExpire();
@@ -358,24 +418,168 @@ void getpersist_query::Run()
 
 void getpersist_query::Process()
 {
-       user->SendProtocol(BRLD_OK, Helpers::Format(this->response));
+       user->SendProtocol(BRLD_OK, this->Quote(this->response));
+}
+
+void mgetkeys_query::Run()
+{
+       std::vector<std::string> values;
+       const std::vector<bool>& found = this->MultiRead(INT_KEY, &values);
+
+       for (size_t i = 0; i < this->list.size(); i++)
+       {
+              /* Keys whose expire already passed are not returned. */
+
+              if (!found[i] || this->ExpireLazy(this->select_query, this->list[i]))
+              {
+                     this->VecData.push_back(PROCESS_NULL);
+                     continue;
+              }
+
+              this->VecData.push_back(this->Quote(to_string(values[i])));
+       }
+
+       this->subresult = 1;
+       this->SetOK();
+}
+
+void mgetkeys_query::Process()
+{
+       Dispatcher::VectorFlush(false, "Value", this);
+}
+
+void msetkeys_query::Run()
+{
+       /* Keys defined as other types are not overwritten. */
+
+       for (std::vector<std::string>::const_iterator iter = TypeRegs.begin(); iter != TypeRegs.end(); ++iter)
+       {
+              if (*iter == INT_KEY)
+              {
+                     continue;
+              }
+
+              const std::vector<bool>& found = this->MultiRead(*iter, NULL);
+
+              if (std::find(found.begin(), found.end(), true) != found.end())
+              {
+                     access_set(DBL_INVALID_TYPE);
+                     this->response = *iter;
+                     return;
+              }
+       }
+
+       const std::string& select = convto_string(this->select_query);
+       rocksdb::WriteBatch batch;
+
+       for (size_t i = 0; i < this->list.size(); i++)
+       {
+              const std::string& kdest = to_bin(this->list[i]) + ":" + select + ":" + INT_KEY;
+
+              batch.Put(this->database->GetHandle(INT_KEY), kdest, to_bin(this->VecData[i]));
+              Kernel->Store->Hot->Invalidate(this->database, kdest);
+       }
+
+       if (!this->database->Write(batch).ok())
+       {
+              access_set(DBL_UNABLE_WRITE);
+              return;
+       }
+
+       /* Keys written are known, so watches of other keys stay valid. */
+
+       for (std::vector<std::string>::const_iterator i = this->list.begin(); i != this->list.end(); ++i)
+       {
+              this->Touch(this->select_query, *i);
+       }
+
+       DataFlush::Touched();
+       this->SetOK();
+}
+
+void msetkeys_query::Process()
+{
+       user->SendProtocol(BRLD_OK, PROCESS_OK);
+}
+
+void mdelkeys_query::Run()
+{
+       const std::vector<bool>& found = this->MultiRead(INT_KEY, NULL);
+       const std::string& select = convto_string(this->select_query);
+
+       std::set<std::string> removed;
+       rocksdb::WriteBatch batch;
+
+       for (size_t i = 0; i < this->list.size(); i++)
+       {
+              if (!found[i] || !removed.insert(this->list[i]).second)
+              {
+                     continue;
+              }
+
+              const std::string& lookup = to_bin(this->list[i]) + ":" + select + ":" + INT_EXPIRE + ":" + this->database->GetName();
+              const std::string& kdest = to_bin(this->list[i]) + ":" + select + ":" + INT_KEY;
+
+              batch.Delete(this->database->Route(kdest), kdest);
+              batch.Delete(this->database->Route(lookup), lookup);
+              Kernel->Store->Hot->Invalidate(this->database, kdest);
+       }
+
+       if (!this->database->Write(batch).ok())
+       {
+              access_set(DBL_BATCH_FAILED);
+              return;
+       }
+
+       for (std::set<std::string>::const_iterator i = removed.begin(); i != removed.end(); ++i)
+       {
+              Kernel->Store->Expires->Delete(this->database, *i, this->select_query);
+              this->Touch(this->select_query, *i);
+       }
+
+       DataFlush::Touched();
+
+       this->counter = removed.size();
+       this->SetOK();
+}
+
+void mdelkeys_query::Process()
+{
+       user->SendProtocol(BRLD_OK, convto_string(this->counter));
 }
 
 void get_query::Run()
 {
-       RocksData result = this->Get(this->dest);
-       this->response = to_string(result.value);
+       const RocksData& result = this->Get(this->dest);
+
+       /* Reply is decoded and quoted here, so it is not copied again when sent. */
+
+       this->response.reserve(result.value.size() + 2);
+       this->response.clear();
+
+       if (!this->delimited)
+       {
+              this->response.assign(1, '"');
+       }
+
+       to_string(result.value.data(), result.value.size(), this->response);
+
+       if (!this->delimited)
+       {
+              this->response.append(1, '"');
+       }
+
        this->SetOK();
 }
 
 void get_query::Process()
 {
-       user->SendProtocol(BRLD_OK, Helpers::Format(this->response));
+       user->SendProtocol(BRLD_OK, std::move(this->response));
 }
 
 void strlen_query::Run()
 {
-       RocksData result = this->Get(this->dest);
+       const RocksData& result = this->Get(this->dest);
        this->response = convto_string(to_string(result.value).length());
        this->SetOK();
 }
@@ -389,9 +593,10 @@ void count_query::Run()
 {
        unsigned int total_counter = 0;
 
-       rocksdb::Iterator* it = this->database->GetAddress()->NewIterator(rocksdb::ReadOptions());
+       std::unique_ptr<rocksdb::Iterator> it(this->database->NewIterator(INT_KEY));
+       PrefixRange range(this->key);
 
-       for (it->SeekToFirst(); it->Valid(); it->Next()) 
+       for (range.Seek(it.get()); range.Valid(it.get()); range.Next(it.get())) 
        {
                 if (!Dispatcher::CheckIterator(this))
                 {
@@ -476,7 +681,7 @@ void count_query::Process()
 
 void getdel_query::Run()
 {
-       RocksData result = this->Get(this->dest);
+       const RocksData& result = this->Get(this->dest);
        this->response = to_string(result.value);
        this->Delete(this->dest);
        this->SetOK();
@@ -484,12 +689,12 @@ void getdel_query::Run()
 
 void getdel_query::Process()
 {
-       user->SendProtocol(BRLD_OK, Helpers::Format(this->response));
+       user->SendProtocol(BRLD_OK, this->Quote(this->response));
 }
 
 void getset_query::Run()
 {
-       RocksData result = this->Get(this->dest);
+       const RocksData& result = this->Get(this->dest);
        this->response = to_string(result.value);
 
        if (this->Write(this->dest, to_bin(this->value)))
@@ -504,7 +709,7 @@ void getset_query::Run()
 
 void getset_query::Process()
 {
-       user->SendProtocol(BRLD_OK, Helpers::Format(this->response.c_str()));
+       user->SendProtocol(BRLD_OK, this->Quote(this->response));
 }
 
 void wdel_query::Run()
@@ -513,9 +718,10 @@ void wdel_query::Run()
 
        std::string rawmap;
        
-       rocksdb::Iterator* it = this->database->GetAddress()->NewIterator(rocksdb::ReadOptions());
+       std::unique_ptr<rocksdb::Iterator> it(this->database->NewIterator(INT_KEY));
+       PrefixRange range(this->key);
 
-       for (it->SeekToFirst(); it->Valid(); it->Next()) 
+       for (range.Seek(it.get()); range.Valid(it.get()); range.Next(it.get())) 
        {
                 if (!Dispatcher::CheckIterator(this))
                 {
@@ -603,7 +809,7 @@ void wdel_query::Process()
 
 void setnx_query::Run()
 {
-       RocksData result = this->Get(this->dest);
+       const RocksData& result = this->Get(this->dest);
        
        if (!result.status.ok())
        {
@@ -629,8 +835,6 @@ void setnx_query::Process()
 
 void settx_query::Run()
 {
-       RocksData result = this->Get(this->dest);
-       
        if (this->IsExpiring() == (unsigned int)0)
        {
             this->Write(this->dest, to_bin(this->value));
@@ -654,7 +858,7 @@ void search_query::Run()
        unsigned int aux_counter = 0;
        unsigned int tracker = 0;
 
-       rocksdb::Iterator* it = this->database->GetAddress()->NewIterator(rocksdb::ReadOptions());
+       std::unique_ptr<rocksdb::Iterator> it(this->database->NewIterator(INT_KEY));
 
        for (it->SeekToFirst(); it->Valid(); it->Next()) 
        {
@@ -738,12 +942,11 @@ void search_query::Run()
              
                                     if (aux_counter % ITER_LIMIT == 0)
                                     {
-                                                std::shared_ptr<search_query> request = std::make_shared<search_query>();
+                                                std::shared_ptr<search_query> request = QueryPool::Make<search_query>();
                                                 request->user = this->user;
                                                 request->partial = true;                                  
                                                 request->subresult = ++tracker;
-                                                request->mmap = result;
-                                                result.clear();
+                                                request->mmap.swap(result);
                                                 request->SetOK();
                                                 DataFlush::AttachResult(request);
                                       }
@@ -761,12 +964,11 @@ void search_query::Run()
             
                              if (aux_counter % ITER_LIMIT == 0)
                              {
-                                        std::shared_ptr<search_query> request = std::make_shared<search_query>();
+                                        std::shared_ptr<search_query> request = QueryPool::Make<search_query>();
                                         request->user = this->user;
                                         request->partial = true;
                                         request->subresult = ++tracker;
-                                        request->mmap = result;
-                                        result.clear();
+                                        request->mmap.swap(result);
                                         request->SetOK();
                                         DataFlush::AttachResult(request);
                              }
@@ -778,13 +980,13 @@ void search_query::Run()
     this->subresult = ++tracker;
     this->partial = false;
     this->counter = aux_counter;
-    this->mmap = result;
+    this->mmap.swap(result);
     this->SetOK();
 }
 
 void search_query::Process()
 {
-        Dispatcher::MMapFlush(true, "Key", "Value", this);
+        Dispatcher::MMapFlush(true, "Key", "Value", this, this->mmap);
 }
 
 void keys_query::Run()
@@ -796,9 +998,10 @@ void keys_query::Run()
 
        std::string rawmap;
        
-       rocksdb::Iterator* it = this->database->GetAddress()->NewIterator(rocksdb::ReadOptions());
+       std::unique_ptr<rocksdb::Iterator> it(this->database->NewIterator(INT_KEY));
+       PrefixRange range(this->key);
        
-       for (it->SeekToFirst(); it->Valid(); it->Next()) 
+       for (range.Seek(it.get()); range.Valid(it.get()); range.Next(it.get())) 
        {
                 if (!Dispatcher::CheckIterator(this))
                 {
@@ -879,12 +1082,11 @@ void keys_query::Run()
                                     if (aux_counter % ITER_LIMIT == 0)
                                     {
                                                 tracker++;
-                                                std::shared_ptr<keys_query> request = std::make_shared<keys_query>();
+                                                std::shared_ptr<keys_query> request = QueryPool::Make<keys_query>();
                                                 request->user = this->user;
                                                 request->partial = true;                                  
                                                 request->subresult = tracker;
-                                                request->VecData = result;
-                                                result.clear();
+                                                request->VecData.swap(result);
                                                 request->SetOK();
                                                 DataFlush::AttachResult(request);
                                       }
@@ -903,12 +1105,11 @@ void keys_query::Run()
                              if (aux_counter % ITER_LIMIT == 0)
                              {
                                         tracker++;
-                                        std::shared_ptr<keys_query> request = std::make_shared<keys_query>();
+                                        std::shared_ptr<keys_query> request = QueryPool::Make<keys_query>();
                                         request->user = this->user;
                                         request->partial = true;
                                         request->subresult = tracker;
-                                        request->VecData = result;
-                                        result.clear();
+                                        request->VecData.swap(result);
                                         request->SetOK();
                                         DataFlush::AttachResult(request);
                              }
@@ -920,7 +1121,7 @@ void keys_query::Run()
     this->subresult = ++tracker;
     this->partial = false;
     this->counter = aux_counter;
-    this->VecData = result;
+    this->VecData.swap(result);
     this->SetOK();
 }
 
@@ -931,7 +1132,7 @@ void keys_query::Process()
 
 void append_query::Run()
 {
-       RocksData result = this->Get(this->dest);
+       const RocksData& result = this->Get(this->dest);
        this->response = to_string(result.value) + this->value;
        
        if (this->Write(this->dest, to_bin(this->response)))
@@ -946,7 +1147,7 @@ void append_query::Run()
 
 void append_query::Process()
 {
-       user->SendProtocol(BRLD_OK, Helpers::Format(this->response).c_str());
+       user->SendProtocol(BRLD_OK, this->Quote(this->response));
 }
 
 void random_query::Run()
@@ -955,7 +1156,7 @@ void random_query::Run()
        
        std::string foundkey;
 
-       rocksdb::Iterator* it = this->database->GetAddress()->NewIterator(rocksdb::ReadOptions());
+       std::unique_ptr<rocksdb::Iterator> it(this->database->NewIterator(INT_KEY));
 
        for (it->SeekToFirst(); it->Valid(); it->Next()) 
        {
@@ -1062,7 +1263,7 @@ void random_query::Process()
 
 void getexp_query::Run()
 {
-       RocksData result = this->Get(this->dest);
+       const RocksData& result = this->Get(this->dest);
        this->response = to_string(result.value);
        
        this->WriteExpire(this->key, this->select_query, this->id);
@@ -1071,12 +1272,12 @@ void getexp_query::Run()
 
 void getexp_query::Process()
 {
-       user->SendProtocol(BRLD_OK, Helpers::Format(this->response));
+       user->SendProtocol(BRLD_OK, this->Quote(this->response));
 }
 
 void asbool_query::Run()
 {
-       RocksData result = this->Get(this->dest);
+       const RocksData& result = this->Get(this->dest);
 
        std::string as_str = to_string(result.value);
        
@@ -1099,7 +1300,7 @@ void asbool_query::Process()
 
 void ismatch_query::Run()
 {
-       RocksData result = this->Get(this->dest);
+       const RocksData& result = this->Get(this->dest);
 
        std::string as_str = to_string(result.value);
 
@@ -1122,7 +1323,7 @@ void ismatch_query::Process()
 
 void insert_query::Run()
 {       
-       RocksData result = this->Get(this->dest);
+       const RocksData& result = this->Get(this->dest);
        std::string as_str = to_string(result.value);
        
        if (as_str.length() < this->id)
@@ -1146,5 +1347,5 @@ void insert_query::Run()
 
 void insert_query::Process()
 {
-       user->SendProtocol(BRLD_OK, Helpers::Format(this->response));
+       user->SendProtocol(BRLD_OK, this->Quote(this->response));
 }
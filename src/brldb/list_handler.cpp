@@ -330,6 +330,11 @@ std::string ListHandler::FPOP()
 
 double ListHandler::GetLow()
 {
+      if (!this->mhandler.size())
+      {
+            return 0;
+      }
+
       double value = convto_num<double>(mhandler.front());
 
       for (ListMap::const_iterator i = this->mhandler.begin(); i != this->mhandler.end(); i++)
@@ -348,7 +353,12 @@ double ListHandler::GetLow()
 
 double ListHandler::GetHigh()
 {
-      double value = 0;
+      if (!this->mhandler.size())
+      {
+            return 0;
+      }
+
+      double value = convto_num<double>(this->mhandler.front());
 
       for (ListMap::const_iterator i = this->mhandler.begin(); i != this->mhandler.end(); i++)
       {
@@ -0,0 +1,203 @@
+/*
+ * BerylDB - A lightweight database.
+ * http://www.beryldb.com
+ *
+ * Copyright (C) 2021 - Carlos F. Ferry <cferry@beryldb.com>
+ *
+ * This file is part of BerylDB. BerylDB is free software: you can
+ * redistribute it and/or modify it under the terms of the BSD License
+ * version 3.
+ *
+ * More information about our licensing can be found at https://docs.beryl.dev
+ */
+
+#include "beryl.h"
+#include "engine.h"
+#include "brldb/database.h"
+#include "brldb/container.h"
+#include "brldb/list_store.h"
+
+ListStore::ListStore(std::shared_ptr<Database> db, const std::string& regdest) : database(db), dest(regdest), id(0), head(0), tail(0)
+{
+
+}
+
+std::string ListStore::ItemKey(uint64_t container, uint64_t seq)
+{
+        return Container::Encode(container) + Container::Encode(seq);
+}
+
+std::string ListStore::Registry(uint64_t container, uint64_t first, uint64_t last)
+{
+        return convto_string(container) + ":" + convto_string(first) + ":" + convto_string(last);
+}
+
+bool ListStore::Load(const std::string& registry)
+{
+        engine::colon_node_stream stream(registry);
+        std::string container, first, last;
+
+        if (!stream.items_extract(container) || !stream.items_extract(first) || !stream.items_extract(last))
+        {
+                return false;
+        }
+
+        this->id = convto_num<uint64_t>(container);
+        this->head = convto_num<uint64_t>(first);
+        this->tail = convto_num<uint64_t>(last);
+
+        return (this->id != 0 && this->head <= this->tail);
+}
+
+void ListStore::Create()
+{
+        this->id = this->database->NewContainer();
+        this->head = 0;
+        this->tail = 0;
+}
+
+bool ListStore::Commit(rocksdb::WriteBatch& batch)
+{
+        if (!this->Count())
+        {
+                batch.Delete(this->database->Route(this->dest), this->dest);
+        }
+        else
+        {
+                batch.Put(this->database->Route(this->dest), this->dest, Registry(this->id, this->head, this->tail));
+        }
+
+        return this->database->Write(batch).ok();
+}
+
+bool ListStore::Push(const std::string& item)
+{
+        rocksdb::WriteBatch batch;
+        batch.Put(this->database->GetHandle(INT_LIST_ITEM), ItemKey(this->id, this->tail++), item);
+        return this->Commit(batch);
+}
+
+bool ListStore::Pop(bool front, std::string& item)
+{
+        if (!this->Count())
+        {
+                return false;
+        }
+
+        const uint64_t seq = (front ? this->head : this->tail - 1);
+        const std::string& lookup = ItemKey(this->id, seq);
+
+        rocksdb::Status fstatus = this->database->Get(this->database->GetHandle(INT_LIST_ITEM), lookup, &item);
+
+        if (!fstatus.ok())
+        {
+                return false;
+        }
+
+        rocksdb::WriteBatch batch;
+        batch.Delete(this->database->GetHandle(INT_LIST_ITEM), lookup);
+
+        if (front)
+        {
+                this->head++;
+        }
+        else
+        {
+                this->tail--;
+        }
+
+        return this->Commit(batch);
+}
+
+bool ListStore::At(unsigned int pos, std::string& item)
+{
+        if (pos >= this->Count())
+        {
+                return false;
+        }
+
+        return this->database->Get(this->database->GetHandle(INT_LIST_ITEM), ItemKey(this->id, this->head + pos), &item).ok();
+}
+
+std::shared_ptr<ListHandler> ListStore::Fetch()
+{
+        std::shared_ptr<ListHandler> handler = std::make_shared<ListHandler>();
+
+        const std::string& last = ItemKey(this->id, this->tail);
+        std::unique_ptr<rocksdb::Iterator> it(this->database->NewIterator(INT_LIST_ITEM));
+
+        for (it->Seek(ItemKey(this->id, this->head)); it->Valid() && it->key().compare(last) < 0; it->Next())
+        {
+                handler->Add(it->value().ToString());
+        }
+
+        return handler;
+}
+
+bool ListStore::Replace(std::shared_ptr<ListHandler> handler)
+{
+        rocksdb::WriteBatch batch;
+        rocksdb::ColumnFamilyHandle* items = this->database->GetHandle(INT_LIST_ITEM);
+
+        Container::Erase(this->database, INT_LIST_ITEM, this->id, batch);
+
+        this->head = 0;
+        this->tail = 0;
+
+        ListMap& all = handler->GetList();
+
+        for (ListMap::const_iterator i = all.begin(); i != all.end(); ++i)
+        {
+                batch.Put(items, ItemKey(this->id, this->tail++), *i);
+        }
+
+        return this->Commit(batch);
+}
+
+bool ListStore::Truncate(unsigned int size)
+{
+        if (size >= this->Count())
+        {
+                return true;
+        }
+
+        rocksdb::WriteBatch batch;
+        batch.DeleteRange(this->database->GetHandle(INT_LIST_ITEM), ItemKey(this->id, this->head + size), ItemKey(this->id + 1, 0));
+
+        this->tail = this->head + size;
+        return this->Commit(batch);
+}
+
+bool ListStore::Erase()
+{
+        rocksdb::WriteBatch batch;
+        Container::Erase(this->database, INT_LIST_ITEM, this->id, batch);
+
+        this->head = 0;
+        this->tail = 0;
+
+        return this->Commit(batch);
+}
+
+bool ListStore::CopyTo(std::shared_ptr<Database> target, const std::string& newdest)
+{
+        ListStore copy(target, newdest);
+        copy.Create();
+        copy.head = this->head;
+        copy.tail = this->tail;
+
+        rocksdb::WriteBatch batch;
+
+        /* Items of a list being overwritten are removed. */
+
+        std::string previous;
+        ListStore replaced(target, newdest);
+
+        if (target->Get(target->Route(newdest), newdest, &previous).ok() && replaced.Load(previous))
+        {
+                Container::Erase(target, INT_LIST_ITEM, replaced.id, batch);
+        }
+
+        Container::Copy(this->database, target, INT_LIST_ITEM, this->id, copy.id, batch);
+        return copy.Commit(batch);
+}
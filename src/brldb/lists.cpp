@@ -15,6 +15,25 @@
 #include "engine.h"
 
 #include "brldb/list_handler.h"
+#include "brldb/list_store.h"
+
+namespace
+{
+        /* Loads the list registered at query->dest. */
+
+        bool LoadList(QueryBase* query, ListStore& store)
+        {
+                const RocksData& result = query->Get(query->dest);
+
+                if (!result.status.ok() || !store.Load(result.value))
+                {
+                        query->access_set(DBL_NOT_FOUND);
+                        return false;
+                }
+
+                return true;
+        }
+}
 
 void lkeys_query::Run()
 {
@@ -23,9 +42,10 @@ void lkeys_query::Run()
        unsigned int aux_counter = 0;
        unsigned int tracker = 0;
 
-       rocksdb::Iterator* it = this->database->GetAddress()->NewIterator(rocksdb::ReadOptions());
+       std::unique_ptr<rocksdb::Iterator> it(this->database->NewIterator(INT_LIST));
+       PrefixRange range(this->key);
 
-       for (it->SeekToFirst(); it->Valid(); it->Next()) 
+       for (range.Seek(it.get()); range.Valid(it.get()); range.Next(it.get())) 
        {
                 if (!Dispatcher::CheckIterator(this))
                 {
@@ -108,12 +128,11 @@ void lkeys_query::Run()
                                     if (aux_counter % ITER_LIMIT == 0)
                                     {
                                                 tracker++;
-                                                std::shared_ptr<lkeys_query> request = std::make_shared<lkeys_query>();
+                                                std::shared_ptr<lkeys_query> request = QueryPool::Make<lkeys_query>();
                                                 request->user = this->user;
                                                 request->partial = true;                                  
                                                 request->subresult = tracker;
-                                                request->VecData = result;
-                                                result.clear();
+                                                request->VecData.swap(result);
                                                 request->SetOK();
                                                 DataFlush::AttachResult(request);
                                       }
@@ -132,12 +151,11 @@ void lkeys_query::Run()
                              if (aux_counter % ITER_LIMIT == 0)
                              {
                                         tracker++;
-                                        std::shared_ptr<lkeys_query> request = std::make_shared<lkeys_query>();
+                                        std::shared_ptr<lkeys_query> request = QueryPool::Make<lkeys_query>();
                                         request->user = this->user;
                                         request->partial = true;
                                         request->subresult = tracker;
-                                        request->VecData = result;
-                                        result.clear();
+                                        request->VecData.swap(result);
                                         request->SetOK();
                                         DataFlush::AttachResult(request);
                              }
@@ -149,7 +167,7 @@ void lkeys_query::Run()
     this->subresult = ++tracker;
     this->partial = false;
     this->counter = aux_counter;
-    this->VecData = result;
+    this->VecData.swap(result);
     this->SetOK();
 }
 
@@ -166,44 +184,19 @@ void lpush_query::Run()
              return;
        }
 
-       RocksData result = this->Get(this->dest);
-       std::shared_ptr<ListHandler> handler;
+       const RocksData& result = this->Get(this->dest);
+       ListStore store(this->database, this->dest);
        
-       if (!result.status.ok())
+       if (!result.status.ok() || !store.Load(result.value))
        {
                /* Create a new entry. */   
     
-               handler = std::make_shared<ListHandler>();
-               handler->Add(this->value);
-               
-               if (handler->GetLast() == HANDLER_MSG_OK)
-               {
-                     this->Write(this->dest, handler->as_string());
-                     this->SetOK();
-               }
-               else
-               {
-                     access_set(DBL_UNABLE_WRITE);
-               }
-
-               return;
+               store.Create();
        }
        
-       handler = ListHandler::Create(result.value);
-       handler->Add(this->value);
-       
-       if (handler->GetLast() == HANDLER_MSG_OK)
-       {
-               if (this->Write(this->dest, handler->as_string()))
-               {
-                     this->SetOK();
-               }
-               else
-               {
-                     access_set(DBL_UNABLE_WRITE);
-               }
-               
-               return;
+       if (store.Push(this->value))
+       {
+               this->SetOK();
        }
        else
        {
@@ -218,18 +211,17 @@ void lpush_query::Process()
 
 void lreverse_query::Run()
 {
-       RocksData result = this->Get(this->dest);
+       ListStore store(this->database, this->dest);
 
-       if (!result.status.ok())
+       if (!LoadList(this, store))
        {
-               access_set(DBL_NOT_FOUND);
                return;
        }
 
-       std::shared_ptr<ListHandler> handler = ListHandler::Create(result.value);
+       std::shared_ptr<ListHandler> handler = store.Fetch();
        handler->Reverse();
        
-       if (this->Write(this->dest, handler->as_string()))
+       if (store.Replace(handler))
        {
               this->SetOK();
        }
@@ -237,8 +229,6 @@ void lreverse_query::Run()
        {
               access_set(DBL_UNABLE_WRITE);
        }
-       
-       return;
 }
 
 void lsort_query::Process()
@@ -248,49 +238,47 @@ void lsort_query::Process()
 
 void lsort_query::Run()
 {
-       RocksData result = this->Get(this->dest);
+       ListStore store(this->database, this->dest);
 
-       if (!result.status.ok())
+       if (!LoadList(this, store))
        {
-               access_set(DBL_NOT_FOUND);
                return;
        }
 
-       std::shared_ptr<ListHandler> handler = ListHandler::Create(result.value);
+       std::shared_ptr<ListHandler> handler = store.Fetch();
        handler->Reverse();
        
-       if (this->Write(this->dest, handler->as_string()))
+       if (store.Replace(handler))
        {
-             this->SetOK();
+              this->SetOK();
        }
        else
        {
-             access_set(DBL_UNABLE_WRITE);
+              access_set(DBL_UNABLE_WRITE);
        }
-       
-       return;
 }
 
 void lpos_query::Run()
 {
-       RocksData result = this->Get(this->dest);
+       ListStore store(this->database, this->dest);
 
-       std::shared_ptr<ListHandler> handler = ListHandler::Create(result.value);
-       std::string reply = handler->Index(convto_num<unsigned int>(this->value));
-       
-       if (handler->GetLast() == HANDLER_MSG_NOT_FOUND)
+       if (!LoadList(this, store))
+       {
+               return;
+       }
+
+       if (!store.At(convto_num<unsigned int>(this->value), this->response))
        {
             access_set(DBL_NOT_FOUND);
             return;
        }
        
-       this->response = reply;
        this->SetOK();
 }
 
 void lpos_query::Process()
 {
-       user->SendProtocol(BRLD_OK, Helpers::Format(this->response));
+       user->SendProtocol(BRLD_OK, this->Quote(this->response));
 }
 
 void lreverse_query::Process()
@@ -300,35 +288,21 @@ void lreverse_query::Process()
 
 void lresize_query::Run()
 {
-       RocksData result = this->Get(this->dest);
+       ListStore store(this->database, this->dest);
 
-       if (!result.status.ok())
+       if (!LoadList(this, store))
        {
-               access_set(DBL_NOT_FOUND);
                return;
        }
 
-       std::shared_ptr<ListHandler> handler = ListHandler::Create(result.value);
-
-       handler->Resize(convto_num<unsigned int>(this->value));
-       
-       if (handler->Count() > 0)
-       {
-               if (this->Write(this->dest, handler->as_string()))
-               {
-                     this->SetOK();
-               }
-               else
-               {
-                     access_set(DBL_UNABLE_WRITE);
-               }
-               
-               return;
+       if (store.Truncate(convto_num<unsigned int>(this->value)))
+       {
+               this->SetOK();
        }
        else
        {
-               this->Delete(this->dest);
-       } 
+               access_set(DBL_UNABLE_WRITE);
+       }
 }
 
 void lresize_query::Process()
@@ -338,35 +312,20 @@ void lresize_query::Process()
 
 void lpop_front_query::Run()
 {
-       RocksData result = this->Get(this->dest);
-       std::shared_ptr<ListHandler> handler;
+       ListStore store(this->database, this->dest);
 
-       if (!result.status.ok())
+       if (!LoadList(this, store))
        {
-               access_set(DBL_NOT_FOUND);
                return;
        }
 
-       handler = ListHandler::Create(result.value);
-       handler->PopFront();
- 
-       if (handler->Count() > 0)
-       {
-               if (this->Write(this->dest, handler->as_string()))
-               {
-                     this->SetOK();
-               }
-               else
-               {
-                     access_set(DBL_UNABLE_WRITE);
-               }
-               
+       if (!store.Pop(true, this->response))
+       {
+               access_set(DBL_UNABLE_WRITE);
                return;
        }
-       else
-       {
-               this->Delete(this->dest);
-       } 
+
+       this->SetOK();
 }
 
 void lpop_front_query::Process()
@@ -376,35 +335,20 @@ void lpop_front_query::Process()
 
 void lpop_back_query::Run()
 {
-       RocksData result = this->Get(this->dest);
-       std::shared_ptr<ListHandler> handler;
+       ListStore store(this->database, this->dest);
 
-       if (!result.status.ok())
+       if (!LoadList(this, store))
        {
-               access_set(DBL_NOT_FOUND);
                return;
        }
 
-       handler = ListHandler::Create(result.value);
-       handler->PopBack();
-       
-       if (handler->Count() > 0)
-       {
-               if (this->Write(this->dest, handler->as_string()))
-               {
-                     this->SetOK();
-               }
-               else
-               {
-                     access_set(DBL_UNABLE_WRITE);
-               }
-               
+       if (!store.Pop(false, this->response))
+       {
+               access_set(DBL_UNABLE_WRITE);
                return;
        }
-       else
-       {
-               this->Delete(this->dest);
-       } 
+
+       this->SetOK();
 }
 
 void lpop_back_query::Process()
@@ -414,36 +358,24 @@ void lpop_back_query::Process()
 
 void lpopall_query::Run()
 {
-       RocksData result = this->Get(this->dest);
+       ListStore store(this->database, this->dest);
 
-       if (!result.status.ok())
+       if (!LoadList(this, store))
        {
-               access_set(DBL_NOT_FOUND);
                return;
        }
 
-       std::shared_ptr<ListHandler> handler = ListHandler::Create(result.value);
+       std::shared_ptr<ListHandler> handler = store.Fetch();
        handler->PopAll(this->value);
-
-       if (handler->Count() > 0)
-       {
-               if (this->Write(this->dest, handler->as_string()))
-               {
-                     this->SetOK();
-               }
-               else
-               {
-                     access_set(DBL_UNABLE_WRITE);
-               }
-               
-               return;
+       
+       if (store.Replace(handler))
+       {
+              this->SetOK();
        }
        else
-       {             
-               this->Delete(this->dest);
-       }        
-       
-       this->SetOK();
+       {
+              access_set(DBL_UNABLE_WRITE);
+       }
 }
 
 void lpopall_query::Process()
@@ -453,16 +385,14 @@ void lpopall_query::Process()
 
 void lcount_query::Run()
 {
-       RocksData query_result = this->Get(this->dest);
+       ListStore store(this->database, this->dest);
 
-       if (!query_result.status.ok())
+       if (!LoadList(this, store))
        {
-               access_set(DBL_NOT_FOUND);
                return;
        }
 
-       std::shared_ptr<ListHandler> handler = ListHandler::Create(query_result.value);
-       this->counter = handler->Count();
+       this->counter = store.Count();
        this->SetOK();
 }
 
@@ -477,17 +407,16 @@ void lget_query::Run()
        unsigned int aux_counter = 0;
        unsigned int tracker = 0;
        
-       RocksData query_result = this->Get(this->dest);
-       
-       if (!query_result.status.ok())
+       ListStore store(this->database, this->dest);
+
+       if (!LoadList(this, store))
        {
-               access_set(DBL_NOT_FOUND);
                return;
        }
        
-       std::shared_ptr<ListHandler> handler = ListHandler::Create(query_result.value);
+       std::shared_ptr<ListHandler> handler = store.Fetch();
        
-       ListMap result = handler->GetList();
+       ListMap& result = handler->GetList();
 
        StringVector result_return;
        
@@ -517,12 +446,11 @@ void lget_query::Run()
              
                                     if (aux_counter % ITER_LIMIT == 0)
                                     {
-                                                std::shared_ptr<lget_query> request = std::make_shared<lget_query>();
+                                                std::shared_ptr<lget_query> request = QueryPool::Make<lget_query>();
                                                 request->user = this->user;
                                                 request->partial = true;                                  
                                                 request->subresult = ++tracker;
-                                                request->VecData = result_return;
-                                                result_return.clear();
+                                                request->VecData.swap(result_return);
                                                 request->SetOK();
                                                 DataFlush::AttachResult(request);
                                       }
@@ -540,12 +468,11 @@ void lget_query::Run()
             
                              if (aux_counter % ITER_LIMIT == 0)
                              {
-                                        std::shared_ptr<lget_query> request = std::make_shared<lget_query>();
+                                        std::shared_ptr<lget_query> request = QueryPool::Make<lget_query>();
                                         request->user = this->user;
                                         request->partial = true;
                                         request->subresult = ++tracker;
-                                        request->VecData = result_return;
-                                        result_return.clear();
+                                        request->VecData.swap(result_return);
                                         request->SetOK();
                                         DataFlush::AttachResult(request);
                              }
@@ -557,7 +484,7 @@ void lget_query::Run()
      this->subresult = ++tracker;
      this->partial = false;
      this->counter = total_counter;
-     this->VecData = result_return;
+     this->VecData.swap(result_return);
      this->SetOK();
 
 }
@@ -580,15 +507,14 @@ void lexist_query::Process()
 
 void lexist_query::Run()
 {
-       RocksData result = this->Get(this->dest);
+       ListStore store(this->database, this->dest);
 
-       if (!result.status.ok())
+       if (!LoadList(this, store))
        {
-               access_set(DBL_NOT_FOUND);
                return;
        }
 
-       std::shared_ptr<ListHandler> handler = ListHandler::Create(result.value);
+       std::shared_ptr<ListHandler> handler = store.Fetch();
        
        if (handler->Exist(this->value))
        {
@@ -609,15 +535,14 @@ void ldel_query::Process()
 
 void ldel_query::Run()
 {
-       RocksData query_result = this->Get(this->dest);
+       ListStore store(this->database, this->dest);
 
-       if (!query_result.status.ok())
+       if (!LoadList(this, store))
        {
-               access_set(DBL_NOT_FOUND);
                return;
        }
 
-       std::shared_ptr<ListHandler> handler = ListHandler::Create(query_result.value);
+       std::shared_ptr<ListHandler> handler = store.Fetch();
        
        if (!handler->Exist(this->value))
        {
@@ -627,38 +552,26 @@ void ldel_query::Run()
        
        handler->Remove(this->value);
 
-       if (handler->Count() > 0)
-       {
-               if (this->Write(this->dest, handler->as_string()))
-               {
-                     this->SetOK();
-               }
-               else
-               {
-                     access_set(DBL_UNABLE_WRITE);
-               }
-               
-               return;
+       if (store.Replace(handler))
+       {
+               this->SetOK();
        }
        else
        {
-               this->Delete(this->dest);
-       } 
-       
-       this->SetOK();
+               access_set(DBL_UNABLE_WRITE);
+       }
 }
 
 void lrepeats_query::Run()
 {
-       RocksData result = this->Get(this->dest);
+       ListStore store(this->database, this->dest);
 
-       if (!result.status.ok())
+       if (!LoadList(this, store))
        {
-               access_set(DBL_NOT_FOUND);
                return;
        }
 
-       std::shared_ptr<ListHandler> handler = ListHandler::Create(result.value);
+       std::shared_ptr<ListHandler> handler = store.Fetch();
        this->response = convto_string(handler->Repeats(this->value));
        this->SetOK();
 }
@@ -670,110 +583,60 @@ void lrepeats_query::Process()
 
 void lrop_query::Run()
 {
-       RocksData result = this->Get(this->dest);
+       ListStore store(this->database, this->dest);
 
-       if (!result.status.ok())
+       if (!LoadList(this, store))
        {
-               access_set(DBL_NOT_FOUND);
                return;
        }
 
-       std::shared_ptr<ListHandler> handler = ListHandler::Create(result.value);
-       
-       this->response = handler->RPOP();
-       
-       if (handler->GetLast() == HANDLER_MSG_NOT_FOUND)
+       if (!store.Pop(false, this->response))
        {
-             access_set(DBL_NOT_FOUND);
-             return;
+               access_set(DBL_NOT_FOUND);
+               return;
        }
 
-       if (handler->Count() > 0)
-       {
-               if (this->Write(this->dest, handler->as_string()))
-               {
-                     this->SetOK();
-               }
-               else
-               {
-                     access_set(DBL_UNABLE_WRITE);
-                     return;
-               }
-       }
-       else
-       {
-               this->Delete(this->dest);
-       } 
-       
        this->SetOK();
 }
 
 void lrop_query::Process()
 {
-       user->SendProtocol(BRLD_OK, Helpers::Format(this->response));
+       user->SendProtocol(BRLD_OK, this->Quote(this->response));
 }
 
 void lrfront_query::Run()
 {
-       RocksData result = this->Get(this->dest);
+       ListStore store(this->database, this->dest);
 
-       if (!result.status.ok())
+       if (!LoadList(this, store))
        {
-               access_set(DBL_NOT_FOUND);
                return;
        }
 
-       std::shared_ptr<ListHandler> handler = ListHandler::Create(result.value);
-
-       this->response = handler->FPOP();
-
-       if (handler->GetLast() == HANDLER_MSG_NOT_FOUND)
-       {
-             access_set(DBL_NOT_FOUND);
-             return;
-       }
-
-       if (handler->Count() > 0)
+       if (!store.Pop(true, this->response))
        {
-               if (this->Write(this->dest, handler->as_string()))
-               {
-                     this->SetOK();
-               }
-               else
-               {
-                     access_set(DBL_UNABLE_WRITE);
-               }
-               
+               access_set(DBL_NOT_FOUND);
                return;
        }
-       else
-       {
-               this->Delete(this->dest);
-       } 
 
        this->SetOK();
 }
 
 void lrfront_query::Process()
 {
-       user->SendProtocol(BRLD_OK, Helpers::Format(this->response));
+       user->SendProtocol(BRLD_OK, this->Quote(this->response));
 }
 
 void lback_query::Run()
 {
-       RocksData result = this->Get(this->dest);
+       ListStore store(this->database, this->dest);
 
-       if (!result.status.ok())
+       if (!LoadList(this, store))
        {
-               access_set(DBL_NOT_FOUND);
                return;
        }
 
-       std::shared_ptr<ListHandler> handler = ListHandler::Create(result.value);
-
-       this->response = handler->Back();
-
-       if (handler->GetLast() == HANDLER_MSG_NOT_FOUND)
+       if (!store.At(store.Count() - 1, this->response))
        {
              access_set(DBL_NOT_FOUND);
              return;
@@ -784,24 +647,19 @@ void lback_query::Run()
 
 void lback_query::Process()
 {
-       user->SendProtocol(BRLD_OK, Helpers::Format(this->response));
+       user->SendProtocol(BRLD_OK, this->Quote(this->response));
 }
 
 void lfront_query::Run()
 {
-       RocksData result = this->Get(this->dest);
+       ListStore store(this->database, this->dest);
 
-       if (!result.status.ok())
+       if (!LoadList(this, store))
        {
-               access_set(DBL_NOT_FOUND);
                return;
        }
 
-       std::shared_ptr<ListHandler> handler = ListHandler::Create(result.value);
-
-       this->response = handler->Front();
-
-       if (handler->GetLast() == HANDLER_MSG_NOT_FOUND)
+       if (!store.At(0, this->response))
        {
              access_set(DBL_NOT_FOUND);
              return;
@@ -812,37 +670,32 @@ void lfront_query::Run()
 
 void lfront_query::Process()
 {
-       user->SendProtocol(BRLD_OK, Helpers::Format(this->response));
+       user->SendProtocol(BRLD_OK, this->Quote(this->response));
 }
 
 void lpushnx_query::Run()
 {
-       RocksData query_result = this->Get(this->dest);
-
-       std::shared_ptr<ListHandler> handler = ListHandler::Create(query_result.value);
+       const RocksData& result = this->Get(this->dest);
+       ListStore store(this->database, this->dest);
        
-       if (handler->Exist(this->value))
+       if (!result.status.ok() || !store.Load(result.value))
+       {
+               store.Create();
+       }
+       else if (store.Fetch()->Exist(this->value))
        {
               access_set(DBL_ENTRY_EXISTS);
               return;
        }
+
+       if (store.Push(this->value))
+       {
+               this->SetOK();
+       }
        else
        {
-             handler->Add(this->value);
-             
-             if (this->Write(this->dest, handler->as_string()))
-             {
-                     this->SetOK();
-             }
-             else
-             {
-                     access_set(DBL_UNABLE_WRITE);
-             }
-             
-             return;
+               access_set(DBL_UNABLE_WRITE);
        }
-
-       this->SetOK();
 }
 
 void lpushnx_query::Process()
@@ -852,15 +705,14 @@ void lpushnx_query::Process()
 
 void lavg_query::Run()
 {
-       RocksData result = this->Get(this->dest);
+       ListStore store(this->database, this->dest);
 
-       if (!result.status.ok())
+       if (!LoadList(this, store))
        {
-               access_set(DBL_NOT_FOUND);
                return;
        }
 
-       std::shared_ptr<ListHandler> handler = ListHandler::Create(result.value);
+       std::shared_ptr<ListHandler> handler = store.Fetch();
 
        if (!handler->IsNumeric())
        {
@@ -879,15 +731,14 @@ void lavg_query::Process()
 
 void lhigh_query::Run()
 {
-       RocksData result = this->Get(this->dest);
+       ListStore store(this->database, this->dest);
 
-       if (!result.status.ok())
+       if (!LoadList(this, store))
        {
-               access_set(DBL_NOT_FOUND);
                return;
        }
 
-       std::shared_ptr<ListHandler> handler = ListHandler::Create(result.value);
+       std::shared_ptr<ListHandler> handler = store.Fetch();
        
        if (!handler->IsNumeric())
        {
@@ -906,15 +757,14 @@ void lhigh_query::Process()
 
 void llow_query::Run()
 {
-       RocksData result = this->Get(this->dest);
+       ListStore store(this->database, this->dest);
 
-       if (!result.status.ok())
+       if (!LoadList(this, store))
        {
-               access_set(DBL_NOT_FOUND);
                return;
        }
 
-       std::shared_ptr<ListHandler> handler = ListHandler::Create(result.value);
+       std::shared_ptr<ListHandler> handler = store.Fetch();
 
        if (!handler->IsNumeric())
        {
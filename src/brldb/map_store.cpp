@@ -0,0 +1,272 @@
+/*
+ * BerylDB - A lightweight database.
+ * http://www.beryldb.com
+ *
+ * Copyright (C) 2021 - Carlos F. Ferry <cferry@beryldb.com>
+ *
+ * This file is part of BerylDB. BerylDB is free software: you can
+ * redistribute it and/or modify it under the terms of the BSD License
+ * version 3.
+ *
+ * More information about our licensing can be found at https://docs.beryl.dev
+ */
+
+#include "beryl.h"
+#include "engine.h"
+#include "brldb/database.h"
+#include "brldb/container.h"
+#include "brldb/map_store.h"
+
+MapStore::MapStore(std::shared_ptr<Database> db, const std::string& regdest, bool is_multi) : database(db), dest(regdest), type(is_multi ? INT_MMAP_ITEM : INT_MAP_ITEM), multi(is_multi), id(0), count(0), next(0)
+{
+
+}
+
+std::string MapStore::Registry(uint64_t container, uint64_t items, uint64_t seq)
+{
+        return convto_string(container) + ":" + convto_string(items) + ":" + convto_string(seq);
+}
+
+std::string MapStore::ItemKey(bool is_multi, uint64_t container, const std::string& field, uint64_t seq)
+{
+        if (!is_multi)
+        {
+                return Container::Encode(container) + field;
+        }
+
+        return Container::Encode(container) + to_bin(field) + ":" + Container::Encode(seq);
+}
+
+std::string MapStore::FieldKey(const std::string& field)
+{
+        if (!this->multi)
+        {
+                return ItemKey(false, this->id, field);
+        }
+
+        return Container::Encode(this->id) + to_bin(field) + ":";
+}
+
+bool MapStore::Load(const std::string& registry)
+{
+        engine::colon_node_stream stream(registry);
+        std::string container, items, seq;
+
+        if (!stream.items_extract(container) || !stream.items_extract(items) || !stream.items_extract(seq))
+        {
+                return false;
+        }
+
+        this->id = convto_num<uint64_t>(container);
+        this->count = convto_num<uint64_t>(items);
+        this->next = convto_num<uint64_t>(seq);
+
+        return (this->id != 0);
+}
+
+void MapStore::Create()
+{
+        this->id = this->database->NewContainer();
+        this->count = 0;
+        this->next = 0;
+}
+
+bool MapStore::Commit(rocksdb::WriteBatch& batch)
+{
+        if (!this->count)
+        {
+                batch.Delete(this->database->Route(this->dest), this->dest);
+        }
+        else
+        {
+                batch.Put(this->database->Route(this->dest), this->dest, Registry(this->id, this->count, this->next));
+        }
+
+        return this->database->Write(batch).ok();
+}
+
+bool MapStore::Set(const std::string& field, const std::string& value)
+{
+        rocksdb::WriteBatch batch;
+
+        if (this->multi)
+        {
+                batch.Put(this->database->GetHandle(this->type), ItemKey(true, this->id, field, this->next++), value);
+                this->count++;
+                return this->Commit(batch);
+        }
+
+        if (!this->Exists(field))
+        {
+                this->count++;
+        }
+
+        batch.Put(this->database->GetHandle(this->type), this->FieldKey(field), value);
+        return this->Commit(batch);
+}
+
+bool MapStore::Get(const std::string& field, std::string& value)
+{
+        if (!this->multi)
+        {
+                return this->database->Get(this->database->GetHandle(this->type), this->FieldKey(field), &value).ok();
+        }
+
+        std::unique_ptr<rocksdb::Iterator> it(this->NewIterator());
+        this->Seek(it.get(), field);
+
+        if (!this->Valid(it.get()))
+        {
+                return false;
+        }
+
+        value = it->value().ToString();
+        return true;
+}
+
+bool MapStore::Exists(const std::string& field)
+{
+        std::string value;
+        return this->Get(field, value);
+}
+
+unsigned int MapStore::Remove(const std::string& field)
+{
+        rocksdb::WriteBatch batch;
+        unsigned int removed = 0;
+
+        if (!this->multi)
+        {
+                if (!this->Exists(field))
+                {
+                        return 0;
+                }
+
+                batch.Delete(this->database->GetHandle(this->type), this->FieldKey(field));
+                removed = 1;
+        }
+        else
+        {
+                std::unique_ptr<rocksdb::Iterator> it(this->NewIterator());
+
+                for (this->Seek(it.get(), field); this->Valid(it.get()); it->Next())
+                {
+                        batch.Delete(this->database->GetHandle(this->type), it->key());
+                        removed++;
+                }
+
+                if (!removed)
+                {
+                        return 0;
+                }
+        }
+
+        this->count = (removed > this->count ? 0 : this->count - removed);
+
+        if (!this->Commit(batch))
+        {
+                return 0;
+        }
+
+        return removed;
+}
+
+rocksdb::Iterator* MapStore::NewIterator()
+{
+        return this->database->NewIterator(this->type);
+}
+
+void MapStore::Seek(rocksdb::Iterator* it, const std::string& field)
+{
+        if (field.empty())
+        {
+                this->bound = Container::Encode(this->id + 1);
+                it->Seek(Container::Encode(this->id));
+                return;
+        }
+
+        /* Values of a multimap field are between "field:" and "field;". */
+
+        const std::string& prefix = this->FieldKey(field);
+
+        this->bound = prefix.substr(0, prefix.size() - 1) + ";";
+        it->Seek(prefix);
+}
+
+bool MapStore::Valid(rocksdb::Iterator* it)
+{
+        return it->Valid() && it->key().compare(this->bound) < 0;
+}
+
+std::string MapStore::Field(rocksdb::Iterator* it)
+{
+        rocksdb::Slice key = it->key();
+        key.remove_prefix(8);
+
+        if (!this->multi)
+        {
+                return key.ToString();
+        }
+
+        /* Removes ':' and sequence. */
+
+        return to_string(std::string(key.data(), key.size() - 9));
+}
+
+std::shared_ptr<MapHandler> MapStore::FetchMap()
+{
+        std::shared_ptr<MapHandler> handler = std::make_shared<MapHandler>();
+        std::unique_ptr<rocksdb::Iterator> it(this->NewIterator());
+
+        for (this->Seek(it.get()); this->Valid(it.get()); it->Next())
+        {
+                handler->Add(this->Field(it.get()), it->value().ToString());
+        }
+
+        return handler;
+}
+
+std::shared_ptr<MultiMapHandler> MapStore::FetchMulti()
+{
+        std::shared_ptr<MultiMapHandler> handler = std::make_shared<MultiMapHandler>();
+        std::unique_ptr<rocksdb::Iterator> it(this->NewIterator());
+
+        for (this->Seek(it.get()); this->Valid(it.get()); it->Next())
+        {
+                handler->Add(this->Field(it.get()), it->value().ToString());
+        }
+
+        return handler;
+}
+
+bool MapStore::Erase()
+{
+        rocksdb::WriteBatch batch;
+        Container::Erase(this->database, this->type, this->id, batch);
+
+        this->count = 0;
+        return this->Commit(batch);
+}
+
+bool MapStore::CopyTo(std::shared_ptr<Database> target, const std::string& newdest)
+{
+        MapStore copy(target, newdest, this->multi);
+        copy.Create();
+        copy.count = this->count;
+        copy.next = this->next;
+
+        rocksdb::WriteBatch batch;
+
+        /* Items of a map being overwritten are removed. */
+
+        std::string previous;
+        MapStore replaced(target, newdest, this->multi);
+
+        if (target->Get(target->Route(newdest), newdest, &previous).ok() && replaced.Load(previous))
+        {
+                Container::Erase(target, this->type, replaced.id, batch);
+        }
+
+        Container::Copy(this->database, target, this->type, this->id, copy.id, batch);
+        return copy.Commit(batch);
+}
@@ -15,6 +15,18 @@
 #include "engine.h"
 
 #include "brldb/map_handler.h"
+#include "brldb/map_store.h"
+
+namespace
+{
+        /* Loads the map registered at query->dest. */
+
+        bool LoadMap(QueryBase* query, MapStore& store)
+        {
+                const RocksData& result = query->Get(query->dest);
+                return (result.status.ok() && store.Load(result.value));
+        }
+}
 
 void hfind_query::Run()
 {
@@ -25,9 +37,10 @@ void hfind_query::Run()
 
        std::string rawmap;
        
-       rocksdb::Iterator* it = this->database->GetAddress()->NewIterator(rocksdb::ReadOptions());
+       std::unique_ptr<rocksdb::Iterator> it(this->database->NewIterator(INT_MAP));
+       PrefixRange range(this->key);
        
-       for (it->SeekToFirst(); it->Valid(); it->Next()) 
+       for (range.Seek(it.get()); range.Valid(it.get()); range.Next(it.get())) 
        {
                 if (!Dispatcher::CheckIterator(this))
                 {
@@ -107,12 +120,11 @@ void hfind_query::Run()
                                     if (aux_counter % ITER_LIMIT == 0)
                                     {
                                                 tracker++;
-                                                std::shared_ptr<hfind_query> request = std::make_shared<hfind_query>();
+                                                std::shared_ptr<hfind_query> request = QueryPool::Make<hfind_query>();
                                                 request->user = this->user;
                                                 request->partial = true;                                  
                                                 request->subresult = tracker;
-                                                request->VecData = result;
-                                                result.clear();
+                                                request->VecData.swap(result);
                                                 request->SetOK();
                                                 DataFlush::AttachResult(request);
                                       }
@@ -131,12 +143,11 @@ void hfind_query::Run()
                              if (aux_counter % ITER_LIMIT == 0)
                              {
                                         tracker++;
-                                        std::shared_ptr<hfind_query> request = std::make_shared<hfind_query>();
+                                        std::shared_ptr<hfind_query> request = QueryPool::Make<hfind_query>();
                                         request->user = this->user;
                                         request->partial = true;
                                         request->subresult = tracker;
-                                        request->VecData = result;
-                                        result.clear();
+                                        request->VecData.swap(result);
                                         request->SetOK();
                                         DataFlush::AttachResult(request);
                              }
@@ -148,7 +159,7 @@ void hfind_query::Run()
     this->subresult = ++tracker;
     this->partial = false;
     this->counter = aux_counter;
-    this->VecData = result;
+    this->VecData.swap(result);
     this->SetOK();
 }
 
@@ -165,43 +176,20 @@ void hset_query::Run()
                return;
        }
        
-       RocksData resultq = this->Get(this->dest);
+       MapStore store(this->database, this->dest);
        
-       std::shared_ptr<MapHandler> handler;
-       
-       if (!resultq.status.ok())
+       if (!LoadMap(this, store))
        {
-               handler = std::make_shared<MapHandler>();
-               handler->Add(this->hesh, this->value);
-               
-               if (handler->GetLast() == HANDLER_MSG_OK)
-               {
-                    if (this->Write(this->dest, handler->as_string()))
-                    {
-                        this->SetOK();
-                    }
-               }
-               else
-               {
-                        access_set(DBL_UNABLE_WRITE);
-               }
-               
-               return;
+               store.Create();
        }
        
-       handler = MapHandler::Create(resultq.value);
-       handler->Add(this->hesh, this->value);
-       
-       if (handler->GetLast() == HANDLER_MSG_OK)
+       if (store.Set(this->hesh, this->value))
        {
-            if (this->Write(this->dest, handler->as_string()))
-            {
-                   this->SetOK();
-                   return;
-            }
-        }
+               this->SetOK();
+               return;
+       }
       
-        access_set(DBL_UNABLE_WRITE);
+       access_set(DBL_UNABLE_WRITE);
 }
 
 void hset_query::Process()
@@ -211,32 +199,31 @@ void hset_query::Process()
 
 void hsetnx_query::Run()
 {
-       RocksData resultq = this->Get(this->dest);
+       if (this->hesh.empty())
+       {
+               access_set(DBL_UNABLE_WRITE);
+               return;
+       }
 
-       std::shared_ptr<MapHandler> handler = MapHandler::Create(resultq.value);
+       MapStore store(this->database, this->dest);
 
-       if (resultq.status.ok())
+       if (!LoadMap(this, store))
        {
-               if (handler->Exists(this->hesh))
-               {
-                    access_set(DBL_ENTRY_EXISTS);
-                    return;
-               }
+               store.Create();
        }
-       
-       handler->Add(this->hesh, this->value);
-
-       if (handler->GetLast() == HANDLER_MSG_OK)
-       {  
-                 if (this->Write(this->dest, handler->as_string()))
-                 {
-                      this->SetOK();
-                 }
+       else if (store.Exists(this->hesh))
+       {
+               access_set(DBL_ENTRY_EXISTS);
+               return;
        }
-       else
+       
+       if (store.Set(this->hesh, this->value))
        {
-            access_set(DBL_UNABLE_WRITE);
+               this->SetOK();
+               return;
        }
+
+       access_set(DBL_UNABLE_WRITE);
 }
 
 void hsetnx_query::Process()
@@ -252,18 +239,13 @@ void hexists_query::Run()
                 return;
        }
 
-       RocksData resultq = this->Get(this->dest);
+       MapStore store(this->database, this->dest);
        
-       if (resultq.status.ok())
+       if (LoadMap(this, store) && store.Exists(this->hesh))
        {
-              std::shared_ptr<MapHandler> handler = MapHandler::Create(resultq.value);
-
-               if (handler->Exists(this->hesh))
-               {
-                    this->response = "1";
-                    this->SetOK();
-                    return;
-               }
+               this->response = "1";
+               this->SetOK();
+               return;
        }
        
        this->response = "0"; 
@@ -283,25 +265,17 @@ void hstrlen_query::Run()
                 return;
        }
 
-       RocksData result = this->Get(this->dest);
+       MapStore store(this->database, this->dest);
+       std::string field;
 
-       if (!result.status.ok())
+       if (!LoadMap(this, store) || !store.Get(this->hesh, field))
        {
                access_set(DBL_NOT_FOUND);
                return;
        }
 
-       std::shared_ptr<MapHandler> handler = MapHandler::Create(result.value);
-       this->response = convto_string(handler->Strlen(this->hesh));
-       
-       if (handler->GetLast() == HANDLER_MSG_OK)
-       {
-               this->SetOK();
-       }
-       else
-       {
-               access_set(DBL_NOT_FOUND);
-       }
+       this->response = convto_string(field.length());
+       this->SetOK();
 }
 
 void hstrlen_query::Process()
@@ -317,68 +291,37 @@ void hget_query::Run()
                 return;
        }
 
-       RocksData result = this->Get(this->dest);
-       
-       if (!result.status.ok())
+       MapStore store(this->database, this->dest);
+
+       if (!LoadMap(this, store) || !store.Get(this->hesh, this->response))
        {
                access_set(DBL_NOT_FOUND);
                return;
        }
 
-       std::shared_ptr<MapHandler> handler = MapHandler::Create(result.value);
-       this->response = handler->Get(this->hesh);
-
-       if (handler->GetLast() == HANDLER_MSG_OK)
-       {
-               this->SetOK();
-       }
-       else
-       {
-               access_set(DBL_NOT_FOUND);
-       }
+       this->SetOK();
 }
 
 void hget_query::Process()
 {
-       user->SendProtocol(BRLD_OK, Helpers::Format(this->response));
+       user->SendProtocol(BRLD_OK, this->Quote(this->response));
 }
 
 void hdel_query::Run()
 {
-       RocksData result = this->Get(this->dest);
-
-       std::shared_ptr<MapHandler> handler = MapHandler::Create(result.value);
+       MapStore store(this->database, this->dest);
 
-       if (handler->Get(this->hesh).empty())
+       if (!LoadMap(this, store) || !store.Exists(this->hesh))
        {
-               if (handler->GetLast() == HANDLER_MSG_NOT_FOUND)
-               {
-                          access_set(DBL_NOT_FOUND);
-                          return;
-                }
-       }
-       else
-       {
-               handler->Remove(this->hesh);
+               access_set(DBL_NOT_FOUND);
+               return;
        }
 
-       if (handler->Count() > 0)
+       if (!store.Remove(this->hesh))
        {
-               if (this->Write(this->dest, handler->as_string()))
-               {
-                     this->SetOK();
-               }
-               else
-               {
-                     access_set(DBL_UNABLE_WRITE);
-               }
-               
+               access_set(DBL_UNABLE_WRITE);
                return;
        }
-       else
-       {
-               this->Delete(this->dest);
-       } 
        
        this->SetOK();
 }
@@ -394,17 +337,26 @@ void hlist_query::Run()
        unsigned int aux_counter = 0;
        unsigned int tracker = 0;
        
-       RocksData query_result = this->Get(this->dest);
+       StringVector result_return;
+       MapStore store(this->database, this->dest);
        
-       std::shared_ptr<MapHandler> handler = MapHandler::Create(query_result.value);
+       if (!LoadMap(this, store))
+       {
+               this->counter = 0;
+               this->SetOK();
+               return;
+       }
        
-       DualMap result = handler->GetList();
-
-       StringVector result_return;
+       std::unique_ptr<rocksdb::Iterator> it(store.NewIterator());
        
-       for (DualMap::iterator i = result.begin(); i != result.end(); ++i)
+       for (store.Seek(it.get()); store.Valid(it.get()); it->Next())
        {
-                std::string hesh_as_string = i->first;
+                if (!Dispatcher::CheckIterator(this))
+                {
+                       return;
+                }
+                
+                std::string hesh_as_string = store.Field(it.get());
                 
                 if (this->flags == QUERY_FLAGS_CORE)
                 {
@@ -428,12 +380,11 @@ void hlist_query::Run()
              
                                     if (aux_counter % ITER_LIMIT == 0)
                                     {
-                                                std::shared_ptr<hlist_query> request = std::make_shared<hlist_query>();
+                                                std::shared_ptr<hlist_query> request = QueryPool::Make<hlist_query>();
                                                 request->user = this->user;
                                                 request->partial = true;                                  
                                                 request->subresult = ++tracker;
-                                                request->VecData = result_return;
-                                                result.clear();
+                                                request->VecData.swap(result_return);
                                                 request->SetOK();
                                                 DataFlush::AttachResult(request);
                                       }
@@ -451,12 +402,11 @@ void hlist_query::Run()
             
                              if (aux_counter % ITER_LIMIT == 0)
                              {
-                                        std::shared_ptr<hlist_query> request = std::make_shared<hlist_query>();
+                                        std::shared_ptr<hlist_query> request = QueryPool::Make<hlist_query>();
                                         request->user = this->user;
                                         request->partial = true;
                                         request->subresult = ++tracker;
-                                        request->VecData = result_return;
-                                        result.clear();
+                                        request->VecData.swap(result_return);
                                         request->SetOK();
                                         DataFlush::AttachResult(request);
                              }
@@ -468,7 +418,7 @@ void hlist_query::Run()
      this->subresult = ++tracker;
      this->partial = false;
      this->counter = total_counter;
-     this->VecData = result_return;
+     this->VecData.swap(result_return);
      this->SetOK();
 }
 
@@ -489,17 +439,26 @@ void hvals_query::Run()
        unsigned int aux_counter = 0;
        unsigned int tracker = 0;
        
-       RocksData query_result = this->Get(this->dest);
+       StringVector result_return;
+       MapStore store(this->database, this->dest);
        
-       std::shared_ptr<MapHandler> handler = MapHandler::Create(query_result.value);
+       if (!LoadMap(this, store))
+       {
+               this->counter = 0;
+               this->SetOK();
+               return;
+       }
        
-       StringVector result = handler->GetValues();
-
-       StringVector result_return;
+       std::unique_ptr<rocksdb::Iterator> it(store.NewIterator());
        
-       for (StringVector::iterator i = result.begin(); i != result.end(); ++i)
+       for (store.Seek(it.get()); store.Valid(it.get()); it->Next())
        {
-                std::string hesh_as_string = (*i);
+                if (!Dispatcher::CheckIterator(this))
+                {
+                       return;
+                }
+                
+                std::string hesh_as_string = it->value().ToString();
                 
                 if (this->limit != -1 && ((signed int)total_counter >= this->offset))
                 {
@@ -510,12 +469,11 @@ void hvals_query::Run()
              
                                     if (aux_counter % ITER_LIMIT == 0)
                                     {
-                                                std::shared_ptr<hvals_query> request = std::make_shared<hvals_query>();
+                                                std::shared_ptr<hvals_query> request = QueryPool::Make<hvals_query>();
                                                 request->user = this->user;
                                                 request->partial = true;                                  
                                                 request->subresult = ++tracker;
-                                                request->VecData = result_return;
-                                                result.clear();
+                                                request->VecData.swap(result_return);
                                                 request->SetOK();
                                                 DataFlush::AttachResult(request);
                                       }
@@ -533,12 +491,11 @@ void hvals_query::Run()
             
                              if (aux_counter % ITER_LIMIT == 0)
                              {
-                                        std::shared_ptr<hvals_query> request = std::make_shared<hvals_query>();
+                                        std::shared_ptr<hvals_query> request = QueryPool::Make<hvals_query>();
                                         request->user = this->user;
                                         request->partial = true;
                                         request->subresult = ++tracker;
-                                        request->VecData = result_return;
-                                        result.clear();
+                                        request->VecData.swap(result_return);
                                         request->SetOK();
                                         DataFlush::AttachResult(request);
                              }
@@ -550,7 +507,7 @@ void hvals_query::Run()
      this->subresult = ++tracker;
      this->partial = false;
      this->counter = total_counter;
-     this->VecData = result_return;
+     this->VecData.swap(result_return);
      this->SetOK();
 }
 
@@ -565,18 +522,27 @@ void hgetall_query::Run()
        unsigned int aux_counter = 0;
        unsigned int tracker = 0;
        
-       RocksData query_result = this->Get(this->dest);
+       std::multimap<std::string, std::string> result_return;
+       MapStore store(this->database, this->dest);
        
-       std::shared_ptr<MapHandler> handler = MapHandler::Create(query_result.value);
+       if (!LoadMap(this, store))
+       {
+               this->counter = 0;
+               this->SetOK();
+               return;
+       }
        
-       DualMap result = handler->GetAll();
-
-       std::multimap<std::string, std::string> result_return;
+       std::unique_ptr<rocksdb::Iterator> it(store.NewIterator());
        
-       for (DualMap::iterator i = result.begin(); i != result.end(); ++i)
+       for (store.Seek(it.get()); store.Valid(it.get()); it->Next())
        {
-                std::string vkey = i->first;
-                std::string vvalue = i->second;
+                if (!Dispatcher::CheckIterator(this))
+                {
+                       return;
+                }
+                
+                std::string vkey = store.Field(it.get());
+                std::string vvalue = it->value().ToString();
                 
                 if (this->limit != -1 && ((signed int)total_counter >= this->offset))
                 {
@@ -587,12 +553,11 @@ void hgetall_query::Run()
              
                                     if (aux_counter % ITER_LIMIT == 0)
                                     {
-                                                std::shared_ptr<hgetall_query> request = std::make_shared<hgetall_query>();
+                                                std::shared_ptr<hgetall_query> request = QueryPool::Make<hgetall_query>();
                                                 request->user = this->user;
                                                 request->partial = true;                                  
                                                 request->subresult = ++tracker;
-                                                request->mmap = result_return;
-                                                result.clear();
+                                                request->mmap.swap(result_return);
                                                 request->SetOK();
                                                 DataFlush::AttachResult(request);
                                       }
@@ -610,12 +575,11 @@ void hgetall_query::Run()
             
                              if (aux_counter % ITER_LIMIT == 0)
                              {
-                                        std::shared_ptr<hgetall_query> request = std::make_shared<hgetall_query>();
+                                        std::shared_ptr<hgetall_query> request = QueryPool::Make<hgetall_query>();
                                         request->user = this->user;
                                         request->partial = true;
                                         request->subresult = ++tracker;
-                                        request->mmap = result_return;
-                                        result.clear();
+                                        request->mmap.swap(result_return);
                                         request->SetOK();
                                         DataFlush::AttachResult(request);
                              }
@@ -627,13 +591,11 @@ void hgetall_query::Run()
      this->subresult = ++tracker;
      this->partial = false;
      this->counter = total_counter;
-     this->mmap = result_return;
+     this->mmap.swap(result_return);
      this->SetOK();
 }
 
 void hgetall_query::Process()
 {
-     Dispatcher::MMapFlush(true, "Map", "Value", this);
+     Dispatcher::MMapFlush(true, "Map", "Value", this, this->mmap);
 }
-
-
@@ -13,21 +13,25 @@
 
 #include "beryl.h"
 #include "helpers.h"
+#include "brldb/geo_index.h"
 
 void move_query::Keys()
 {
-     RocksData result = this->Get(this->dest);
+     const RocksData& result = this->Get(this->dest);
      
      const std::string& newdest = to_bin(this->key) + ":" + this->value + ":" + this->identified;
      const std::string& lookup = to_bin(this->key) + ":" + this->value + ":" + INT_EXPIRE + ":" + this->database->GetName();
 
      rocksdb::WriteBatch batch;
 
-     batch.Put(newdest, result.value);
-     batch.Delete(this->dest);
-     batch.Put(lookup, convto_string(this->id));
+     batch.Put(this->database->Route(newdest), newdest, result.value);
+     batch.Delete(this->database->Route(this->dest), this->dest);
+     batch.Put(this->database->Route(lookup), lookup, convto_string(this->id));
 
-     rocksdb::Status stats = this->database->GetAddress()->Write(rocksdb::WriteOptions(), &batch);
+     rocksdb::Status stats = this->database->Write(batch);
+
+     Kernel->Store->Hot->Invalidate(this->database, newdest);
+     Kernel->Store->Hot->Invalidate(this->database, this->dest);
 
      if (stats.ok())
      {
@@ -53,7 +57,14 @@ void move_query::Multis()
 
 void move_query::Geos()
 {
+    /* Index entry follows the entry into its new select. */
+
+    const RocksData& result = this->Get(this->dest);
 
+    if (result.status.ok() && GeoIndex::Index(this->database, convto_num<unsigned int>(this->value), this->key, result.value))
+    {
+          GeoIndex::Drop(this->database, this->select_query, this->key, result.value);
+    }
 }
 
 void move_query::Lists()
@@ -100,7 +111,7 @@ void move_query::Run()
           this->Vectors();
     }   
     
-    RocksData result = this->Get(this->dest);
+    const RocksData& result = this->Get(this->dest);
     const std::string& newdest = to_bin(this->key) + ":" + this->value + ":" + this->identified;
     
     if (!this->Swap(newdest, this->dest, result.value))
@@ -20,31 +20,28 @@
 #include "brldb/expires.h"
 #include "brldb/functions.h"
 #include "brldb/multimap_handler.h"
+#include "brldb/map_store.h"
+
+namespace
+{
+        /* Loads the multimap registered at query->dest. */
+
+        bool LoadMulti(QueryBase* query, MapStore& store)
+        {
+                const RocksData& result = query->Get(query->dest);
+                return (result.status.ok() && store.Load(result.value));
+        }
+}
 
 void mdel_query::Run()
 {
-       RocksData result = this->Get(this->dest);
+       MapStore store(this->database, this->dest, true);
 
-       std::shared_ptr<MultiMapHandler> handler = MultiMapHandler::Create(result.value);
-       handler->Remove(this->value);
-       
-       if (handler->Count() > 0)
+       if (LoadMulti(this, store) && store.Exists(this->value) && !store.Remove(this->value))
        {
-               if (this->Write(this->dest, handler->as_string()))
-               {
-                       this->SetOK();
-               }
-               else
-               {
-                       access_set(DBL_UNABLE_WRITE);
-               }
-               
+               access_set(DBL_UNABLE_WRITE);
                return;
        }
-       else
-       {
-               this->Delete(this->dest);
-       } 
        
        this->SetOK();
 }
@@ -56,57 +53,31 @@ void mdel_query::Process()
 
 void msetnx_query::Run()
 {
-       RocksData result = this->Get(this->dest);
-
-       std::shared_ptr<MultiMapHandler> handler;
-
-       if (!result.status.ok())
+       if (this->hesh.empty())
        {
-               handler = std::make_shared<MultiMapHandler>();
-        
-               handler->Add(this->hesh, this->value);
-
-               if (handler->GetLast() == HANDLER_MSG_OK)
-               {
-                    if (this->Write(this->dest, handler->as_string()))
-                    {
-                             this->SetOK();
-                    }
-                    else
-                    {
-                          access_set(DBL_UNABLE_WRITE);
-                    }
-               }
-               
+               this->SetOK();
                return;
        }
 
-       handler = MultiMapHandler::Create(result.value);
-       
-       if (handler->Exists(this->hesh))
+       MapStore store(this->database, this->dest, true);
+
+       if (!LoadMulti(this, store))
+       {
+               store.Create();
+       }
+       else if (store.Exists(this->hesh))
        {
                access_set(DBL_ENTRY_EXISTS);                                       
                return;
        }
 
-       handler->Add(this->hesh, this->value);
-
-       if (handler->GetLast() == HANDLER_MSG_OK)
+       if (store.Set(this->hesh, this->value))
        {
-            if (this->Write(this->dest, handler->as_string()))
-            {
-                   this->SetOK();
-            }
-            else
-            {
-                   access_set(DBL_UNABLE_WRITE);
-            }
-            
-            return;
-            
+               this->SetOK();
+               return;
        }
 
-       this->SetOK();
+       access_set(DBL_UNABLE_WRITE);
 }
 
 void msetnx_query::Process()
@@ -117,50 +88,26 @@ void msetnx_query::Process()
 
 void mset_query::Run()
 {
-       RocksData result = this->Get(this->dest);
-
-       std::shared_ptr<MultiMapHandler> handler;
-
-       if (!result.status.ok())
+       if (this->hesh.empty())
        {
-               handler = std::make_shared<MultiMapHandler>();
-               handler->Add(this->hesh, this->value);
-
-               if (handler->GetLast() == HANDLER_MSG_OK)
-               {
-                    if (this->Write(this->dest, handler->as_string()))
-                    {
-                             this->SetOK();
-                    }
-                    else
-                    {
-                          access_set(DBL_UNABLE_WRITE);
-                    }
-                    
-               }
-               
+               this->SetOK();
                return;
        }
 
-       handler = MultiMapHandler::Create(result.value);
-       handler->Add(this->hesh, this->value);
+       MapStore store(this->database, this->dest, true);
 
-       if (handler->GetLast() == HANDLER_MSG_OK)
+       if (!LoadMulti(this, store))
        {
-            if (this->Write(this->dest, handler->as_string()))
-            {
-                   this->SetOK();
-            }
-            else
-            {
-                   access_set(DBL_UNABLE_WRITE);
-            }
-            
-            return;
-            
+               store.Create();
        }
 
-       this->SetOK();
+       if (store.Set(this->hesh, this->value))
+       {
+               this->SetOK();
+               return;
+       }
+
+       access_set(DBL_UNABLE_WRITE);
 }
 
 void mset_query::Process()
@@ -172,14 +119,15 @@ void mkeys_query::Run()
 {
        StringVector result;
 
-       rocksdb::Iterator* it = this->database->GetAddress()->NewIterator(rocksdb::ReadOptions());
+       std::unique_ptr<rocksdb::Iterator> it(this->database->NewIterator(this->base_request));
+       PrefixRange range(this->key);
        std::string rawmap;
        
        unsigned int aux_counter = 0;
        unsigned int total_counter = 0;
        unsigned int tracker = 0;
        
-       for (it->SeekToFirst(); it->Valid(); it->Next()) 
+       for (range.Seek(it.get()); range.Valid(it.get()); range.Next(it.get())) 
        {
                 if (!Dispatcher::CheckIterator(this))
                 {
@@ -261,12 +209,11 @@ void mkeys_query::Run()
              
                                     if (aux_counter % ITER_LIMIT == 0)
                                     {
-                                                std::shared_ptr<mkeys_query> request = std::make_shared<mkeys_query>();
+                                                std::shared_ptr<mkeys_query> request = QueryPool::Make<mkeys_query>();
                                                 request->user = this->user;
                                                 request->partial = true;                                  
                                                 request->subresult = ++tracker;
-                                                request->VecData = result;
-                                                result.clear();
+                                                request->VecData.swap(result);
                                                 request->SetOK();
                                                 DataFlush::AttachResult(request);
                                       }
@@ -284,12 +231,11 @@ void mkeys_query::Run()
             
                              if (aux_counter % ITER_LIMIT == 0)
                              {
-                                        std::shared_ptr<mkeys_query> request = std::make_shared<mkeys_query>();
+                                        std::shared_ptr<mkeys_query> request = QueryPool::Make<mkeys_query>();
                                         request->user = this->user;
                                         request->partial = true;
                                         request->subresult = ++tracker;
-                                        request->VecData = result;
-                                        result.clear();
+                                        request->VecData.swap(result);
                                         request->SetOK();
                                         DataFlush::AttachResult(request);
                              }
@@ -301,7 +247,7 @@ void mkeys_query::Run()
        this->subresult = ++tracker;
        this->partial = false;
        this->counter = aux_counter;
-       this->VecData = result;
+       this->VecData.swap(result);
        this->SetOK();
 }              
 
@@ -316,23 +262,25 @@ void mget_query::Run()
        unsigned int aux_counter = 0;
        unsigned int tracker = 0;
        
-       RocksData query_result = this->Get(this->dest);
+       StringVector result_return;
+       MapStore store(this->database, this->dest, true);
        
-       if (!query_result.status.ok())
+       if (!LoadMulti(this, store))
        {
                access_set(DBL_NOT_FOUND);
                return;
        }
        
-       std::shared_ptr<MultiMapHandler> handler = MultiMapHandler::Create(query_result.value);
+       std::unique_ptr<rocksdb::Iterator> it(store.NewIterator());
        
-       DualMMap result = handler->GetList();
-
-       StringVector result_return;
-       
-       for (DualMap::iterator i = result.begin(); i != result.end(); ++i)
+       for (store.Seek(it.get()); store.Valid(it.get()); it->Next())
        {
-                std::string hesh_as_string = i->first;
+                if (!Dispatcher::CheckIterator(this))
+                {
+                       return;
+                }
+                
+                std::string hesh_as_string = store.Field(it.get());
                 
                 if (this->flags == QUERY_FLAGS_CORE)
                 {
@@ -356,12 +304,11 @@ void mget_query::Run()
              
                                     if (aux_counter % ITER_LIMIT == 0)
                                     {
-                                                std::shared_ptr<mget_query> request = std::make_shared<mget_query>();
+                                                std::shared_ptr<mget_query> request = QueryPool::Make<mget_query>();
                                                 request->user = this->user;
                                                 request->partial = true;                                  
                                                 request->subresult = ++tracker;
-                                                request->VecData = result_return;
-                                                result.clear();
+                                                request->VecData.swap(result_return);
                                                 request->SetOK();
                                                 DataFlush::AttachResult(request);
                                       }
@@ -379,12 +326,11 @@ void mget_query::Run()
             
                              if (aux_counter % ITER_LIMIT == 0)
                              {
-                                        std::shared_ptr<mget_query> request = std::make_shared<mget_query>();
+                                        std::shared_ptr<mget_query> request = QueryPool::Make<mget_query>();
                                         request->user = this->user;
                                         request->partial = true;
                                         request->subresult = ++tracker;
-                                        request->VecData = result_return;
-                                        result.clear();
+                                        request->VecData.swap(result_return);
                                         request->SetOK();
                                         DataFlush::AttachResult(request);
                              }
@@ -396,7 +342,7 @@ void mget_query::Run()
      this->subresult = ++tracker;
      this->partial = false;
      this->counter = total_counter;
-     this->VecData = result_return;
+     this->VecData.swap(result_return);
      this->SetOK();
 }
 
@@ -413,10 +359,20 @@ void mget_query::Process()
 
 void mrepeats_query::Run()
 {
-       RocksData result = this->Get(this->dest);
+       unsigned int repeats = 0;
+       MapStore store(this->database, this->dest, true);
+
+       if (LoadMulti(this, store) && !this->value.empty())
+       {
+               std::unique_ptr<rocksdb::Iterator> it(store.NewIterator());
+
+               for (store.Seek(it.get(), this->value); store.Valid(it.get()); it->Next())
+               {
+                       repeats++;
+               }
+       }
 
-       std::shared_ptr<MultiMapHandler> handler = MultiMapHandler::Create(result.value);
-       this->response = convto_string(handler->Repeats(this->value));
+       this->response = convto_string(repeats);
        this->SetOK();
 }
 
@@ -432,17 +388,26 @@ void mvals_query::Run()
        unsigned int aux_counter = 0;
        unsigned int tracker = 0;
        
-       RocksData query_result = this->Get(this->dest);
+       StringVector result_return;
+       MapStore store(this->database, this->dest, true);
        
-       std::shared_ptr<MultiMapHandler> handler = MultiMapHandler::Create(query_result.value);
+       if (!LoadMulti(this, store))
+       {
+               this->counter = 0;
+               this->SetOK();
+               return;
+       }
        
-       StringVector result = handler->GetValues();
-
-       StringVector result_return;
+       std::unique_ptr<rocksdb::Iterator> it(store.NewIterator());
        
-       for (StringVector::iterator i = result.begin(); i != result.end(); ++i)
+       for (store.Seek(it.get()); store.Valid(it.get()); it->Next())
        {
-                std::string hesh_as_string = (*i);
+                if (!Dispatcher::CheckIterator(this))
+                {
+                       return;
+                }
+                
+                std::string hesh_as_string = it->value().ToString();
                 
                 if (this->limit != -1 && ((signed int)total_counter >= this->offset))
                 {
@@ -453,12 +418,11 @@ void mvals_query::Run()
              
                                     if (aux_counter % ITER_LIMIT == 0)
                                     {
-                                                std::shared_ptr<hvals_query> request = std::make_shared<hvals_query>();
+                                                std::shared_ptr<mvals_query> request = QueryPool::Make<mvals_query>();
                                                 request->user = this->user;
                                                 request->partial = true;                                  
                                                 request->subresult = ++tracker;
-                                                request->VecData = result_return;
-                                                result.clear();
+                                                request->VecData.swap(result_return);
                                                 request->SetOK();
                                                 DataFlush::AttachResult(request);
                                       }
@@ -476,12 +440,11 @@ void mvals_query::Run()
             
                              if (aux_counter % ITER_LIMIT == 0)
                              {
-                                        std::shared_ptr<hvals_query> request = std::make_shared<hvals_query>();
+                                        std::shared_ptr<mvals_query> request = QueryPool::Make<mvals_query>();
                                         request->user = this->user;
                                         request->partial = true;
                                         request->subresult = ++tracker;
-                                        request->VecData = result_return;
-                                        result.clear();
+                                        request->VecData.swap(result_return);
                                         request->SetOK();
                                         DataFlush::AttachResult(request);
                              }
@@ -493,7 +456,7 @@ void mvals_query::Run()
      this->subresult = ++tracker;
      this->partial = false;
      this->counter = total_counter;
-     this->VecData = result_return;
+     this->VecData.swap(result_return);
      this->SetOK();
 }
 
@@ -508,18 +471,27 @@ void mgetall_query::Run()
        unsigned int aux_counter = 0;
        unsigned int tracker = 0;
        
-       RocksData query_result = this->Get(this->dest);
+       std::multimap<std::string, std::string> result_return;
+       MapStore store(this->database, this->dest, true);
        
-       std::shared_ptr<MultiMapHandler> handler = MultiMapHandler::Create(query_result.value);
+       if (!LoadMulti(this, store))
+       {
+               this->counter = 0;
+               this->SetOK();
+               return;
+       }
        
-       DualMMap result = handler->GetAll();
-
-       std::multimap<std::string, std::string> result_return;
+       std::unique_ptr<rocksdb::Iterator> it(store.NewIterator());
        
-       for (DualMMap::iterator i = result.begin(); i != result.end(); ++i)
+       for (store.Seek(it.get()); store.Valid(it.get()); it->Next())
        {
-                std::string vkey = i->first;
-                std::string vvalue = i->second;
+                if (!Dispatcher::CheckIterator(this))
+                {
+                       return;
+                }
+                
+                std::string vkey = store.Field(it.get());
+                std::string vvalue = it->value().ToString();
                 
                 if (this->limit != -1 && ((signed int)total_counter >= this->offset))
                 {
@@ -530,12 +502,11 @@ void mgetall_query::Run()
              
                                     if (aux_counter % ITER_LIMIT == 0)
                                     {
-                                                std::shared_ptr<mgetall_query> request = std::make_shared<mgetall_query>();
+                                                std::shared_ptr<mgetall_query> request = QueryPool::Make<mgetall_query>();
                                                 request->user = this->user;
                                                 request->partial = true;                                  
                                                 request->subresult = ++tracker;
-                                                request->mmap = result_return;
-                                                result.clear();
+                                                request->mmap.swap(result_return);
                                                 request->SetOK();
                                                 DataFlush::AttachResult(request);
                                       }
@@ -553,12 +524,11 @@ void mgetall_query::Run()
             
                              if (aux_counter % ITER_LIMIT == 0)
                              {
-                                        std::shared_ptr<mgetall_query> request = std::make_shared<mgetall_query>();
+                                        std::shared_ptr<mgetall_query> request = QueryPool::Make<mgetall_query>();
                                         request->user = this->user;
                                         request->partial = true;
                                         request->subresult = ++tracker;
-                                        request->mmap = result_return;
-                                        result.clear();
+                                        request->mmap.swap(result_return);
                                         request->SetOK();
                                         DataFlush::AttachResult(request);
                              }
@@ -570,13 +540,13 @@ void mgetall_query::Run()
      this->subresult = ++tracker;
      this->partial = false;
      this->counter = total_counter;
-     this->mmap = result_return;
+     this->mmap.swap(result_return);
      this->SetOK();
 }
 
 void mgetall_query::Process()
 {
-        Dispatcher::MMapFlush(true, "Multimap", "Value", this);
+        Dispatcher::MMapFlush(true, "Multimap", "Value", this, this->mmap);
 }
 
 void miter_query::Run()
@@ -584,41 +554,49 @@ void miter_query::Run()
        unsigned int total_counter = 0;
        unsigned int aux_counter = 0;
        unsigned int tracker = 0;
-
-       RocksData query_result = this->Get(this->dest);
-
-       std::shared_ptr<MultiMapHandler> handler = MultiMapHandler::Create(query_result.value);
-
-       StringVector result = handler->GetVals(this->value);
-
+       
        StringVector result_return;
-
-       for (StringVector::iterator i = result.begin(); i != result.end(); ++i)
+       MapStore store(this->database, this->dest, true);
+       
+       if (!LoadMulti(this, store) || this->value.empty())
        {
-                std::string hesh_as_string = (*i);
-
+               this->counter = 0;
+               this->SetOK();
+               return;
+       }
+       
+       std::unique_ptr<rocksdb::Iterator> it(store.NewIterator());
+       
+       for (store.Seek(it.get(), this->value); store.Valid(it.get()); it->Next())
+       {
+                if (!Dispatcher::CheckIterator(this))
+                {
+                       return;
+                }
+                
+                std::string hesh_as_string = it->value().ToString();
+                
                 if (this->limit != -1 && ((signed int)total_counter >= this->offset))
                 {
                              if (((signed int)aux_counter < limit))
                              {
                                     aux_counter++;
                                     result_return.push_back(hesh_as_string);
-
+             
                                     if (aux_counter % ITER_LIMIT == 0)
                                     {
-                                                std::shared_ptr<miter_query> request = std::make_shared<miter_query>();
+                                                std::shared_ptr<miter_query> request = QueryPool::Make<miter_query>();
                                                 request->user = this->user;
-                                                request->partial = true;
+                                                request->partial = true;                                  
                                                 request->subresult = ++tracker;
-                                                request->VecData = result_return;
-                                                result.clear();
+                                                request->VecData.swap(result_return);
                                                 request->SetOK();
                                                 DataFlush::AttachResult(request);
                                       }
-
+                                      
                                       if (aux_counter == (unsigned int)limit)
                                       {
-                                                break;
+                                                break;               
                                       }
                              }
                 }
@@ -626,27 +604,26 @@ void miter_query::Run()
                 {
                              aux_counter++;
                              result_return.push_back(hesh_as_string);
-
+            
                              if (aux_counter % ITER_LIMIT == 0)
                              {
-                                        std::shared_ptr<miter_query> request = std::make_shared<miter_query>();
+                                        std::shared_ptr<miter_query> request = QueryPool::Make<miter_query>();
                                         request->user = this->user;
                                         request->partial = true;
                                         request->subresult = ++tracker;
-                                        request->VecData = result_return;
-                                        result.clear();
+                                        request->VecData.swap(result_return);
                                         request->SetOK();
                                         DataFlush::AttachResult(request);
                              }
                 }
-
+                         
                 total_counter++;
     }
 
      this->subresult = ++tracker;
      this->partial = false;
      this->counter = total_counter;
-     this->VecData = result_return;
+     this->VecData.swap(result_return);
      this->SetOK();
 }
 
@@ -654,4 +631,3 @@ void miter_query::Process()
 {
        Dispatcher::VectorFlush(true, "Key", this);
 }
-     
\ No newline at end of file
@@ -20,25 +20,35 @@
 #include "brldb/query.h"
 #include "brldb/dbnumeric.h"
 #include "brldb/dbmanager.h"
+#include "brldb/list_store.h"
+#include "brldb/map_store.h"
+#include "brldb/zset_store.h"
+#include "brldb/geo_index.h"
 #include "helpers.h"
 
 void dbsize_query::Run()
 {
-    rocksdb::Iterator* it = this->database->GetAddress()->NewIterator(rocksdb::ReadOptions());
-    std::string rawmap;
     double size_calc = 0;
 
-    for (it->SeekToFirst(); it->Valid(); it->Next()) 
+    std::vector<std::string> all = TypeRegs;
+    all.insert(all.end(), ItemRegs.begin(), ItemRegs.end());
+
+    for (std::vector<std::string>::const_iterator iter = all.begin(); iter != all.end(); ++iter)
     {
-            if (!Dispatcher::CheckIterator(this))
+            std::unique_ptr<rocksdb::Iterator> it(this->database->NewIterator(*iter));
+
+            for (it->SeekToFirst(); it->Valid(); it->Next()) 
             {
-                    return;
-            }
+                    if (!Dispatcher::CheckIterator(this))
+                    {
+                            return;
+                    }
     
-            /* We directly count byte size from binary keys/values. */
+                    /* We directly count byte size from binary keys/values. */
             
-            size_calc += it->key().size() + 2;
-            size_calc += it->value().size() + 2;  
+                    size_calc += it->key().size() + 2;
+                    size_calc += it->value().size() + 2;  
+            }
     }
     
     float as_mb = size_calc / 1024 / 1024;
@@ -91,7 +101,7 @@ void op_query::Run()
          real_oper = convto_num<double>(oper);
     }
 
-    RocksData result = this->Get(this->dest);
+    const RocksData& result = this->Get(this->dest);
     this->response = to_string(result.value);
   
     if (!result.status.ok())
@@ -189,10 +199,12 @@ void op_query::Process()
 
 void sflush_query::Run()
 {
-     rocksdb::Iterator* it = this->database->GetAddress()->NewIterator(rocksdb::ReadOptions());
-
-     for (it->SeekToFirst(); it->Valid(); it->Next()) 
+     for (std::vector<std::string>::const_iterator iter = TypeRegs.begin(); iter != TypeRegs.end(); ++iter)
      {
+          std::unique_ptr<rocksdb::Iterator> it(this->database->NewIterator(*iter));
+
+          for (it->SeekToFirst(); it->Valid(); it->Next()) 
+          {
                 if (!Dispatcher::CheckIterator(this))
                 {
                        return;
@@ -203,44 +215,59 @@ void sflush_query::Run()
                 engine::colon_node_stream stream(rawmap);
                 std::string token;
 
-                unsigned int strcounter = 0;
-                bool skip = false;
-                
-               while (stream.items_extract(token))
-               {
-                        if (skip)
+                /* Entries are formatted as key:select:type. */
+
+                if (!stream.items_extract(token) || !stream.items_extract(token) || this->key != token)
+                {
+                        continue;
+                }
+
+                if (*iter == INT_LIST)
+                {
+                        /* Removes list items too. */
+
+                        ListStore store(this->database, rawmap);
+
+                        if (store.Load(it->value().ToString()))
                         {
-                            break;
+                                store.Erase();
+                                continue;
                         }
-                     
-                        switch (strcounter)
+                }
+                else if (*iter == INT_ZSET)
+                {
+                        /* Removes sorted set members. */
+
+                        ZSetStore store(this->database, rawmap);
+
+                        if (store.Load(it->value().ToString()))
                         {
-                             case 1:
-                             {
-                                   if (this->key != token)
-                                   {
-                                          skip = true;
-                                   }
-                             }
-                             
-                             break;
-                             
-                             default:
-                             {
-                                 break;   
-                             }                                     
+                                store.Erase();
+                                continue;
                         }
-                        
-                        strcounter++;
                 }
-                
-                if (skip)
+                else if (*iter == INT_MAP || *iter == INT_MMAP)
                 {
-                        continue;
+                        /* Removes map fields. */
+
+                        MapStore store(this->database, rawmap, *iter == INT_MMAP);
+
+                        if (store.Load(it->value().ToString()))
+                        {
+                                store.Erase();
+                                continue;
+                        }
                 }
                 
                 this->Delete(rawmap);
-    }    
+          }
+     }
+
+     /* Removes geo index of this select. */
+
+     rocksdb::WriteBatch batch;
+     GeoIndex::Erase(this->database, convto_num<unsigned int>(this->key), batch);
+     this->database->Write(batch);
      
     this->SetOK();	
 }
@@ -310,70 +337,35 @@ void ntouch_query::Process()
 void list_query::Run()
 {
        std::map<std::string, unsigned int> result;
+       const std::string& select = convto_string(this->select_query);
 
        for (std::vector<std::string>::const_iterator iter = TypeRegs.begin(); iter != TypeRegs.end(); ++iter)
        {
               std::string ltype = *iter;
               result[ltype] = 0;
-       }
 
-       rocksdb::Iterator* it = this->database->GetAddress()->NewIterator(rocksdb::ReadOptions());
+              /* Every type has its own column family, so only selects are checked. */
 
-       for (it->SeekToFirst(); it->Valid(); it->Next()) 
-       {
-                if (!Dispatcher::CheckIterator(this))
-                {
-                       return;
-                }
+              std::unique_ptr<rocksdb::Iterator> it(this->database->NewIterator(ltype));
 
-                std::string rawmap = it->key().ToString();
-                std::string rawvalue = to_string(it->value().ToString());
-                         
-                engine::colon_node_stream stream(rawmap);
-                std::string token;
-                unsigned int strcounter = 0;
-                bool skip = false;
+              for (it->SeekToFirst(); it->Valid(); it->Next()) 
+              {
+                     if (!Dispatcher::CheckIterator(this))
+                     {
+                            return;
+                     }
 
-                std::string key_as_string;
-                
-                while (stream.items_extract(token))
-                {
-                        if (skip)
-                        {
-                            break;
-                        }
-
-                        switch (strcounter)
-                        {
-
-                             case 1:
-                             {
-                                   if (convto_string(this->select_query) != token)
-                                   {
-                                        skip = true;
-                                   }
-                             }
-
-                             break;
-                             
-                             case 2:
-                             {
-                                  result[token]++; 
-                             }
-
-                             break;
-
-                             default:
-                             {
-                                 break;   
-                             }
-                        }
+                     engine::colon_node_stream stream(it->key().ToString());
+                     std::string token;
 
-                        strcounter++;
-                }
-    }
+                     if (stream.items_extract(token) && stream.items_extract(token) && token == select)
+                     {
+                            result[ltype]++;
+                     }
+              }
+       }
                 
-    this->nmap = result;
+    this->nmap.swap(result);
     this->SetOK();
 }
 
@@ -395,62 +387,28 @@ void list_query::Process()
 void total_query::Run()
 {
        unsigned int total_counter = 0;
+       const std::string& select = convto_string(this->select_query);
        
-       rocksdb::Iterator* it = this->database->GetAddress()->NewIterator(rocksdb::ReadOptions());
-
-       for (it->SeekToFirst(); it->Valid(); it->Next()) 
+       for (std::vector<std::string>::const_iterator iter = TypeRegs.begin(); iter != TypeRegs.end(); ++iter)
        {
-                if (!Dispatcher::CheckIterator(this))
-                {
-                       return;
-                }
-
-                std::string rawmap = it->key().ToString();
-                std::string rawvalue = to_string(it->value().ToString());
-                         
-                engine::colon_node_stream stream(rawmap);
-                std::string token;
-                unsigned int strcounter = 0;
-                bool skip = false;
-
-                std::string key_as_string;
-                
-                while (stream.items_extract(token))
-                {
-                        if (skip)
-                        {
-                            break;
-                        }
-
-                        switch (strcounter)
-                        {
-
-                             case 1:
-                             {
-                                   if (convto_string(this->select_query) != token)
-                                   {
-                                        skip = true;
-                                   }
-                             }
-
-                             break;
-                             
-                             default:
-                             {
-                                 break;   
-                             }
-                        }
-
-                        strcounter++;
-                }
-                
-                if (skip)
-                {
-                     continue;
-                }
-                
-                total_counter++;
-    }
+              std::unique_ptr<rocksdb::Iterator> it(this->database->NewIterator(*iter));
+
+              for (it->SeekToFirst(); it->Valid(); it->Next()) 
+              {
+                     if (!Dispatcher::CheckIterator(this))
+                     {
+                            return;
+                     }
+
+                     engine::colon_node_stream stream(it->key().ToString());
+                     std::string token;
+
+                     if (stream.items_extract(token) && stream.items_extract(token) && token == select)
+                     {
+                            total_counter++;
+                     }
+              }
+       }
                 
     this->counter = total_counter;
     this->SetOK();
@@ -469,62 +427,21 @@ void glist_query::Run()
        {
               std::string ltype = *iter;
               result[ltype] = 0;
-       }
 
-       rocksdb::Iterator* it = this->database->GetAddress()->NewIterator(rocksdb::ReadOptions());
+              std::unique_ptr<rocksdb::Iterator> it(this->database->NewIterator(ltype));
 
-       for (it->SeekToFirst(); it->Valid(); it->Next()) 
-       {
-                if (!Dispatcher::CheckIterator(this))
-                {
-                       return;
-                }
-
-                std::string rawmap = it->key().ToString();
-                std::string rawvalue = to_string(it->value().ToString());
-                         
-                engine::colon_node_stream stream(rawmap);
-                std::string token;
-                unsigned int strcounter = 0;
-                bool skip = false;
-
-                std::string key_as_string;
-                
-                while (stream.items_extract(token))
-                {
-                        if (skip)
-                        {
-                            break;
-                        }
-
-                        switch (strcounter)
-                        {
-
-                             case 1:
-                             {
-                             
-                             }
-
-                             break;
-                             
-                             case 2:
-                             {
-                                  result[token]++; 
-                             }
+              for (it->SeekToFirst(); it->Valid(); it->Next()) 
+              {
+                     if (!Dispatcher::CheckIterator(this))
+                     {
+                            return;
+                     }
 
-                             break;
-
-                             default:
-                             {
-                                 break;   
-                             }
-                        }
-
-                        strcounter++;
-                }
-    }
+                     result[ltype]++;
+              }
+       }
                 
-    this->nmap = result;
+    this->nmap.swap(result);
     this->SetOK();
 }
 
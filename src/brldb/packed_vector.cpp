@@ -0,0 +1,537 @@
+/*
+ * BerylDB - A lightweight database.
+ * http://www.beryldb.com
+ *
+ * Copyright (C) 2021 - Carlos F. Ferry <cferry@beryldb.com>
+ *
+ * This file is part of BerylDB. BerylDB is free software: you can
+ * redistribute it and/or modify it under the terms of the BSD License
+ * version 3.
+ *
+ * More information about our licensing can be found at https://docs.beryl.dev
+ */
+
+#include <cmath>
+#include <cerrno>
+#include <cstring>
+
+#include "beryl.h"
+#include "brldb/packed_vector.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define PACKED_X86
+#include <immintrin.h>
+#endif
+
+namespace
+{
+        /* Size of header: BIN_ESCAPE and type. */
+
+        const size_t HEADER_SIZE = 2;
+
+        const size_t ITEM_SIZE = 8;
+
+        template <typename T>
+        struct Totals
+        {
+                T sum;
+
+                T low;
+
+                T high;
+
+                /* Whether sum overflowed. Only used by ints. */
+
+                bool overflow;
+        };
+
+        /* Reads a little-endian item. */
+
+        inline uint64_t Load(const char* data)
+        {
+                uint64_t value = 0;
+
+                for (int i = ITEM_SIZE - 1; i >= 0; i--)
+                {
+                        value = (value << 8) | (unsigned char)data[i];
+                }
+
+                return value;
+        }
+
+        inline void Store(std::string& packed, uint64_t value)
+        {
+                for (size_t i = 0; i < ITEM_SIZE; i++)
+                {
+                        packed += (char)(value & 0xff);
+                        value >>= 8;
+                }
+        }
+
+        inline double AsDouble(uint64_t bits)
+        {
+                double value;
+                memcpy(&value, &bits, sizeof(value));
+                return value;
+        }
+
+        inline uint64_t FromDouble(double value)
+        {
+                uint64_t bits;
+                memcpy(&bits, &value, sizeof(bits));
+                return bits;
+        }
+
+        void ScalarDoubles(const char* data, size_t count, Totals<double>& totals)
+        {
+                for (size_t i = 0; i < count; i++)
+                {
+                        const double item = AsDouble(Load(data + i * ITEM_SIZE));
+
+                        totals.sum += item;
+                        totals.low = std::min(totals.low, item);
+                        totals.high = std::max(totals.high, item);
+                }
+        }
+
+        void ScalarInts(const char* data, size_t count, Totals<int64_t>& totals)
+        {
+                for (size_t i = 0; i < count; i++)
+                {
+                        const int64_t item = (int64_t)Load(data + i * ITEM_SIZE);
+
+                        if (__builtin_add_overflow(totals.sum, item, &totals.sum))
+                        {
+                                totals.overflow = true;
+                        }
+
+                        totals.low = std::min(totals.low, item);
+                        totals.high = std::max(totals.high, item);
+                }
+        }
+
+        /* Sums ints as doubles, once an int64 sum has overflowed. */
+
+        double IntsAsDoubles(const char* data, size_t count)
+        {
+                double sum = 0;
+
+                for (size_t i = 0; i < count; i++)
+                {
+                        sum += (double)(int64_t)Load(data + i * ITEM_SIZE);
+                }
+
+                return sum;
+        }
+
+#ifdef PACKED_X86
+
+        /* x86 is little-endian, so items can be loaded as they are stored. */
+
+        bool HasAVX2()
+        {
+                static const bool avx2 = __builtin_cpu_supports("avx2");
+                return avx2;
+        }
+
+        __attribute__((target("avx2")))
+        size_t AVXDoubles(const char* data, size_t count, Totals<double>& totals)
+        {
+                __m256d sum = _mm256_setzero_pd();
+                __m256d low = _mm256_set1_pd(totals.low);
+                __m256d high = _mm256_set1_pd(totals.high);
+
+                size_t i = 0;
+
+                for (; i + 4 <= count; i += 4)
+                {
+                        const __m256d items = _mm256_loadu_pd((const double*)(data + i * ITEM_SIZE));
+
+                        sum = _mm256_add_pd(sum, items);
+                        low = _mm256_min_pd(low, items);
+                        high = _mm256_max_pd(high, items);
+                }
+
+                double lanes[4];
+
+                _mm256_storeu_pd(lanes, sum);
+                totals.sum += (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+
+                _mm256_storeu_pd(lanes, low);
+                totals.low = std::min(std::min(lanes[0], lanes[1]), std::min(lanes[2], lanes[3]));
+
+                _mm256_storeu_pd(lanes, high);
+                totals.high = std::max(std::max(lanes[0], lanes[1]), std::max(lanes[2], lanes[3]));
+
+                return i;
+        }
+
+        __attribute__((target("avx2")))
+        size_t AVXInts(const char* data, size_t count, Totals<int64_t>& totals)
+        {
+                __m256i sum = _mm256_setzero_si256();
+                __m256i overflow = _mm256_setzero_si256();
+                __m256i low = _mm256_set1_epi64x(totals.low);
+                __m256i high = _mm256_set1_epi64x(totals.high);
+
+                size_t i = 0;
+
+                for (; i + 4 <= count; i += 4)
+                {
+                        const __m256i items = _mm256_loadu_si256((const __m256i*)(data + i * ITEM_SIZE));
+
+                        const __m256i added = _mm256_add_epi64(sum, items);
+
+                        /* A lane overflowed if its result's sign differs from both operands. */
+
+                        overflow = _mm256_or_si256(overflow, _mm256_and_si256(_mm256_xor_si256(sum, added), _mm256_xor_si256(items, added)));
+                        sum = added;
+                        low = _mm256_blendv_epi8(low, items, _mm256_cmpgt_epi64(low, items));
+                        high = _mm256_blendv_epi8(high, items, _mm256_cmpgt_epi64(items, high));
+                }
+
+                int64_t lanes[4];
+
+                if (_mm256_movemask_pd(_mm256_castsi256_pd(overflow)))
+                {
+                        totals.overflow = true;
+                }
+
+                _mm256_storeu_si256((__m256i*)lanes, sum);
+
+                for (int lane = 0; lane < 4; lane++)
+                {
+                        if (__builtin_add_overflow(totals.sum, lanes[lane], &totals.sum))
+                        {
+                                totals.overflow = true;
+                        }
+                }
+
+                _mm256_storeu_si256((__m256i*)lanes, low);
+                totals.low = std::min(std::min(lanes[0], lanes[1]), std::min(lanes[2], lanes[3]));
+
+                _mm256_storeu_si256((__m256i*)lanes, high);
+                totals.high = std::max(std::max(lanes[0], lanes[1]), std::max(lanes[2], lanes[3]));
+
+                return i;
+        }
+
+#ifdef __SSE2__
+
+        size_t SSEDoubles(const char* data, size_t count, Totals<double>& totals)
+        {
+                __m128d sum = _mm_setzero_pd();
+                __m128d low = _mm_set1_pd(totals.low);
+                __m128d high = _mm_set1_pd(totals.high);
+
+                size_t i = 0;
+
+                for (; i + 2 <= count; i += 2)
+                {
+                        const __m128d items = _mm_loadu_pd((const double*)(data + i * ITEM_SIZE));
+
+                        sum = _mm_add_pd(sum, items);
+                        low = _mm_min_pd(low, items);
+                        high = _mm_max_pd(high, items);
+                }
+
+                double lanes[2];
+
+                _mm_storeu_pd(lanes, sum);
+                totals.sum += lanes[0] + lanes[1];
+
+                _mm_storeu_pd(lanes, low);
+                totals.low = std::min(lanes[0], lanes[1]);
+
+                _mm_storeu_pd(lanes, high);
+                totals.high = std::max(lanes[0], lanes[1]);
+
+                return i;
+        }
+
+#endif
+#endif
+
+        /* Runs the fastest kernel available, and finishes remaining items in scalar code. */
+
+        void Doubles(const char* data, size_t count, Totals<double>& totals)
+        {
+                size_t done = 0;
+
+#ifdef PACKED_X86
+                if (HasAVX2())
+                {
+                        done = AVXDoubles(data, count, totals);
+                }
+#ifdef __SSE2__
+                else
+                {
+                        done = SSEDoubles(data, count, totals);
+                }
+#endif
+#endif
+
+                ScalarDoubles(data + done * ITEM_SIZE, count - done, totals);
+        }
+
+        void Ints(const char* data, size_t count, Totals<int64_t>& totals)
+        {
+                size_t done = 0;
+
+#ifdef PACKED_X86
+                if (HasAVX2())
+                {
+                        done = AVXInts(data, count, totals);
+                }
+#endif
+
+                ScalarInts(data + done * ITEM_SIZE, count - done, totals);
+        }
+
+        bool ParseInt(const std::string& item, int64_t& value)
+        {
+                if (item.empty())
+                {
+                        return false;
+                }
+
+                char* end = NULL;
+                errno = 0;
+
+                const long long parsed = strtoll(item.c_str(), &end, 10);
+
+                if (errno || *end != '\0')
+                {
+                        return false;
+                }
+
+                value = parsed;
+                return true;
+        }
+
+        bool ParseDouble(const std::string& item, double& value)
+        {
+                if (item.empty())
+                {
+                        return false;
+                }
+
+                char* end = NULL;
+                errno = 0;
+
+                const double parsed = strtod(item.c_str(), &end);
+
+                if (errno || *end != '\0' || !std::isfinite(parsed))
+                {
+                        return false;
+                }
+
+                value = parsed;
+                return true;
+        }
+}
+
+VECTOR_TYPE PackedVector::GetType(const std::string& load)
+{
+        if (load.size() < HEADER_SIZE || load[0] != BIN_ESCAPE || (load.size() - HEADER_SIZE) % ITEM_SIZE)
+        {
+                return VECTOR_TYPE_STRING;
+        }
+
+        switch (load[1])
+        {
+                case 'I':
+
+                        return VECTOR_TYPE_INT;
+
+                case 'D':
+
+                        return VECTOR_TYPE_DOUBLE;
+
+                default:
+
+                        return VECTOR_TYPE_STRING;
+        }
+}
+
+std::string PackedVector::Header(VECTOR_TYPE type)
+{
+        std::string header(1, BIN_ESCAPE);
+        header += (type == VECTOR_TYPE_INT ? 'I' : 'D');
+        return header;
+}
+
+bool PackedVector::Valid(VECTOR_TYPE type, const std::string& item)
+{
+        int64_t ivalue;
+        double dvalue;
+
+        switch (type)
+        {
+                case VECTOR_TYPE_INT:
+
+                        return ParseInt(item, ivalue);
+
+                case VECTOR_TYPE_DOUBLE:
+
+                        return ParseDouble(item, dvalue);
+
+                default:
+
+                        return !item.empty();
+        }
+}
+
+bool PackedVector::Pack(VECTOR_TYPE type, const std::string& item, std::string& packed)
+{
+        if (type == VECTOR_TYPE_INT)
+        {
+                int64_t value;
+
+                if (!ParseInt(item, value))
+                {
+                        return false;
+                }
+
+                Store(packed, (uint64_t)value);
+                return true;
+        }
+
+        double value;
+
+        if (!ParseDouble(item, value))
+        {
+                return false;
+        }
+
+        Store(packed, FromDouble(value));
+        return true;
+}
+
+StringVector PackedVector::Unpack(const std::string& load)
+{
+        const VECTOR_TYPE type = GetType(load);
+        StringVector items;
+
+        if (type == VECTOR_TYPE_STRING)
+        {
+                return items;
+        }
+
+        items.reserve((load.size() - HEADER_SIZE) / ITEM_SIZE);
+
+        for (size_t i = HEADER_SIZE; i < load.size(); i += ITEM_SIZE)
+        {
+                const uint64_t bits = Load(load.data() + i);
+
+                if (type == VECTOR_TYPE_INT)
+                {
+                        items.push_back(convto_string((int64_t)bits));
+                }
+                else
+                {
+                        items.push_back(Format(AsDouble(bits)));
+                }
+        }
+
+        return items;
+}
+
+std::string PackedVector::Format(double value)
+{
+        /* Shortest format is preferred, as long as no precision is lost. */
+
+        char buffer[32];
+        snprintf(buffer, sizeof(buffer), "%.15g", value);
+
+        if (strtod(buffer, NULL) != value)
+        {
+                snprintf(buffer, sizeof(buffer), "%.17g", value);
+        }
+
+        return buffer;
+}
+
+bool PackedVector::Aggregate(const std::string& load, VECTOR_AGGREGATE aggregate, std::string& result)
+{
+        const VECTOR_TYPE type = GetType(load);
+        const size_t count = (load.size() - HEADER_SIZE) / ITEM_SIZE;
+
+        if (type == VECTOR_TYPE_STRING || !count)
+        {
+                return false;
+        }
+
+        const char* data = load.data() + HEADER_SIZE;
+
+        if (type == VECTOR_TYPE_DOUBLE)
+        {
+                Totals<double> totals;
+                totals.sum = 0;
+                totals.overflow = false;
+                totals.low = totals.high = AsDouble(Load(data));
+
+                Doubles(data, count, totals);
+
+                switch (aggregate)
+                {
+                        case VECTOR_AGGREGATE_SUM:
+
+                                result = Format(totals.sum);
+                        break;
+
+                        case VECTOR_AGGREGATE_AVG:
+
+                                result = Format(totals.sum / (double)count);
+                        break;
+
+                        case VECTOR_AGGREGATE_HIGH:
+
+                                result = Format(totals.high);
+                        break;
+
+                        case VECTOR_AGGREGATE_LOW:
+
+                                result = Format(totals.low);
+                        break;
+                }
+
+                return true;
+        }
+
+        Totals<int64_t> totals;
+        totals.sum = 0;
+        totals.overflow = false;
+        totals.low = totals.high = (int64_t)Load(data);
+
+        Ints(data, count, totals);
+
+        /* Sums beyond int64 are returned as doubles, as the legacy format did. */
+
+        const double overflowed = totals.overflow ? IntsAsDoubles(data, count) : 0;
+
+        switch (aggregate)
+        {
+                case VECTOR_AGGREGATE_SUM:
+
+                        result = totals.overflow ? Format(overflowed) : convto_string(totals.sum);
+                break;
+
+                case VECTOR_AGGREGATE_AVG:
+
+                        result = Format((totals.overflow ? overflowed : (double)totals.sum) / (double)count);
+                break;
+
+                case VECTOR_AGGREGATE_HIGH:
+
+                        result = convto_string(totals.high);
+                break;
+
+                case VECTOR_AGGREGATE_LOW:
+
+                        result = convto_string(totals.low);
+                break;
+        }
+
+        return true;
+}
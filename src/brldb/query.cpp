@@ -14,6 +14,7 @@
 #include "beryl.h"
 #include "brldb/query.h"
 #include "brldb/dbmanager.h"
+#include "helpers.h"
 
 bool QueryBase::Swap(const std::string& newdest, const std::string& ldest, const std::string& lvalue, std::shared_ptr<Database> db)
 {
@@ -24,9 +25,12 @@ bool QueryBase::Swap(const std::string& newdest, const std::string& ldest, const
        
        rocksdb::WriteBatch batch;
 
-       batch.Put(newdest, lvalue);
-       batch.Delete(ldest);
-       rocksdb::Status status = db->GetAddress()->Write(rocksdb::WriteOptions(), &batch);
+       batch.Put(db->Route(newdest), newdest, lvalue);
+       batch.Delete(db->Route(ldest), ldest);
+       rocksdb::Status status = db->Write(batch);
+
+       Kernel->Store->Hot->Invalidate(db, newdest);
+       Kernel->Store->Hot->Invalidate(db, ldest);
        
        if (status.ok())
        {
@@ -40,14 +44,17 @@ bool QueryBase::SwapWithExpire(const std::string& newdest, const std::string& ld
 {
        rocksdb::WriteBatch batch;
 
-       batch.Put(newdest, lvalue);
-       batch.Delete(ldest);
+       batch.Put(this->database->Route(newdest), newdest, lvalue);
+       batch.Delete(this->database->Route(ldest), ldest);
        
        const std::string& lookup = to_bin(lkey) + ":" + convto_string(select) + ":" + INT_EXPIRE + ":" + this->database->GetName();
 
-       batch.Put(lookup, convto_string(ttl));
+       batch.Put(this->database->Route(lookup), lookup, convto_string(ttl));
+
+       rocksdb::Status stats = this->database->Write(batch);
 
-       rocksdb::Status stats = this->database->GetAddress()->Write(rocksdb::WriteOptions(), &batch);
+       Kernel->Store->Hot->Invalidate(this->database, newdest);
+       Kernel->Store->Hot->Invalidate(this->database, ldest);
 
        if (stats.ok())
        {
@@ -65,10 +72,12 @@ void QueryBase::ExpireBatch(const std::string& wdest, const std::string& lvalue,
        rocksdb::WriteBatch batch;
        std::string lookup = to_bin(e_key) + ":" + convto_string(select) + ":" + INT_EXPIRE + ":" + this->database->GetName();
        
-       batch.Put(lookup, convto_string(ttl));
-       batch.Put(wdest, to_bin(lvalue));
+       batch.Put(this->database->Route(lookup), lookup, convto_string(ttl));
+       batch.Put(this->database->Route(wdest), wdest, to_bin(lvalue));
        
-       rocksdb::Status stats = this->database->GetAddress()->Write(rocksdb::WriteOptions(), &batch);
+       rocksdb::Status stats = this->database->Write(batch);
+
+       Kernel->Store->Hot->Invalidate(this->database, wdest);
        
        if (stats.ok())
        {
@@ -78,7 +87,9 @@ void QueryBase::ExpireBatch(const std::string& wdest, const std::string& lvalue,
 
 bool QueryBase::Write(const std::string& wdest, const std::string& lvalue)
 {
-       rocksdb::Status status = this->database->GetAddress()->Put(rocksdb::WriteOptions(), wdest, lvalue);
+       rocksdb::Status status = this->database->Put(this->database->Route(wdest), wdest, lvalue);
+
+       Kernel->Store->Hot->Invalidate(this->database, wdest);
        
        if (status.ok())
        {
@@ -90,7 +101,8 @@ bool QueryBase::Write(const std::string& wdest, const std::string& lvalue)
 
 void QueryBase::Delete(const std::string& wdest)
 {
-       this->database->GetAddress()->Delete(rocksdb::WriteOptions(), wdest);
+       this->database->Delete(this->database->Route(wdest), wdest);
+       Kernel->Store->Hot->Invalidate(this->database, wdest);
 }
 
 void QueryBase::WriteExpire(const std::string& e_key, unsigned int select, unsigned int ttl, std::shared_ptr<Database> db)
@@ -138,6 +150,72 @@ signed int QueryBase::IsExpiring()
       return -1;
 }
 
+bool QueryBase::ExpireLazy(unsigned int select, const std::string& regkey)
+{
+      if (!Kernel->Config->LazyExpire)
+      {
+             return false;
+      }
+
+      const signed int schedule = ExpireManager::GetTIME(this->database, regkey, select);
+
+      if (schedule < 0 || schedule >= Kernel->Now())
+      {
+             return false;
+      }
+
+      const std::string& lookup = to_bin(regkey) + ":" + convto_string(select) + ":" + INT_EXPIRE + ":" + this->database->GetName();
+      const std::string& kdest = to_bin(regkey) + ":" + convto_string(select) + ":" + INT_KEY;
+
+      /* Schedules are kept when a transaction is discarded, so stored expire must match. */
+
+      std::string stored;
+
+      if (!this->database->Get(this->database->Route(lookup), lookup, &stored).ok() || convto_num<signed int>(stored) != schedule)
+      {
+             return false;
+      }
+
+      rocksdb::WriteBatch batch;
+      batch.Delete(this->database->Route(lookup), lookup);
+      batch.Delete(this->database->Route(kdest), kdest);
+
+      const bool written = this->database->Write(batch).ok();
+
+      Kernel->Store->Hot->Invalidate(this->database, kdest);
+
+      if (!written)
+      {
+             return false;
+      }
+
+      /* Expired key is known, so watches of other keys stay valid. */
+
+      this->Touch(select, regkey);
+      DataFlush::Touched();
+
+      Kernel->Store->Expires->Delete(this->database, regkey, select);
+      return true;
+}
+
+std::string QueryBase::Quote(const std::string& reply) const
+{
+      if (this->delimited)
+      {
+             return reply;
+      }
+
+      return Helpers::Format(reply);
+}
+
+void QueryBase::Touch(unsigned int select, const std::string& regkey)
+{
+      if (Kernel->Store->Watches->Active())
+      {
+             Kernel->Store->Watches->Touch(WatchTable::Build(this->database, select, regkey));
+      }
+}
+
 void QueryBase::DelExpire()
 {
         /* Deletes key in case it is expiring. */
@@ -147,19 +225,69 @@ void QueryBase::DelExpire()
         this->Delete(lookup);
 }
 
-RocksData QueryBase::Get(const std::string& where)
+const RocksData& QueryBase::Get(const std::string& where)
 {
        if (this->mapped.loaded)
        {
             return this->mapped;   
        }
        
-       RocksData result;
-       std::string dbvalue;
-       
-       result.status = this->database->GetAddress()->Get(rocksdb::ReadOptions(), where, &dbvalue);
-       result.value = dbvalue;
-       return result;
+       this->fetched.value.clear();
+       this->fetched.status = this->database->Get(this->database->Route(where), where, &this->fetched.value);
+       return this->fetched;
+}
+
+std::vector<bool> QueryBase::MultiRead(const std::string& regtype, std::vector<std::string>* values)
+{
+        const std::string& select = convto_string(this->select_query);
+        const size_t total = this->list.size();
+
+        std::vector<std::pair<std::string, size_t>> lookups;
+        lookups.reserve(total);
+
+        for (size_t i = 0; i < total; i++)
+        {
+                lookups.push_back(std::make_pair(to_bin(this->list[i]) + ":" + select + ":" + regtype, i));
+        }
+
+        std::sort(lookups.begin(), lookups.end());
+
+        std::vector<rocksdb::Slice> keys;
+        keys.reserve(total);
+
+        for (size_t i = 0; i < total; i++)
+        {
+                keys.push_back(rocksdb::Slice(lookups[i].first));
+        }
+
+        std::vector<rocksdb::PinnableSlice> pinned(total);
+        std::vector<rocksdb::Status> statuses(total);
+
+        this->database->MultiGet(this->database->GetHandle(regtype), total, keys.data(), pinned.data(), statuses.data(), true);
+
+        std::vector<bool> found(total, false);
+
+        if (values)
+        {
+                values->assign(total, std::string());
+        }
+
+        for (size_t i = 0; i < total; i++)
+        {
+                if (!statuses[i].ok())
+                {
+                        continue;
+                }
+
+                found[lookups[i].second] = true;
+
+                if (values)
+                {
+                        (*values)[lookups[i].second] = pinned[i].ToString();
+                }
+        }
+
+        return found;
 }
 
 int QueryBase::CheckDest(unsigned int select, const std::string& regkey, const std::string& ltype, std::shared_ptr<Database> db)
@@ -180,7 +308,7 @@ int QueryBase::CheckDest(unsigned int select, const std::string& regkey, const s
               std::string saved = to_bin(regkey) + ":" + convto_string(select) + ":" + found_type;
        
               std::string dbvalue;
-              rocksdb::Status fstatus2 = db->GetAddress()->Get(rocksdb::ReadOptions(), saved, &dbvalue);
+              rocksdb::Status fstatus2 = db->Get(db->Route(saved), saved, &dbvalue);
        
               if (!dbvalue.empty())
               {
@@ -206,24 +334,65 @@ int QueryBase::CheckDest(unsigned int select, const std::string& regkey, const s
 
 bool QueryBase::GetRegistry(unsigned int select, const std::string& regkey, bool do_load)
 {
+       /* Hot keys are served from memory, skipping a lookup on every type. */
+
+       if (Kernel->Store->Hot->Enabled())
+       {
+             const std::string& cached = to_bin(regkey) + ":" + convto_string(select) + ":" + INT_KEY;
+
+             if (Kernel->Store->Hot->Fetch(this->database, cached, do_load ? &mapped.value : NULL))
+             {
+                    if (this->ExpireLazy(select, regkey))
+                    {
+                           this->identified = PROCESS_NULL;
+                           return false;
+                    }
+
+                    this->identified = INT_KEY;
+                    this->dest = cached;
+
+                    if (do_load)
+                    {
+                          mapped.status = rocksdb::Status::OK();
+                          mapped.loaded = true;
+                    }
+
+                    return true;
+             }
+       }
+
        for (std::vector<std::string>::const_iterator iter = TypeRegs.begin(); iter != TypeRegs.end(); ++iter)
        {
              std::string found_type = *iter;
              std::string lookup = to_bin(regkey) + ":" + convto_string(select) + ":" + found_type;
              
-             std::string dbvalue;
-             rocksdb::Status fstatus2 = this->database->GetAddress()->Get(rocksdb::ReadOptions(), lookup, &dbvalue);
+             /* Values are pinned, so they are only copied if requested. */
+
+             rocksdb::PinnableSlice dbvalue;
+             rocksdb::Status fstatus2 = this->database->Get(this->database->Route(lookup), lookup, &dbvalue);
 
              if (fstatus2.ok())
              {
+                    if (found_type == INT_KEY && this->ExpireLazy(select, regkey))
+                    {
+                           break;
+                    }
+
                     this->identified = found_type;
                     this->SetDest(regkey, select, found_type);
                    
                     if (do_load)
                     {
-                          mapped.value = dbvalue;
+                          mapped.value.assign(dbvalue.data(), dbvalue.size());
                           mapped.status = fstatus2;
                           mapped.loaded = true;
+
+                          /* Values about to be overwritten are not worth caching. */
+
+                          if (found_type == INT_KEY && this->type != QUERY_TYPE_WRITE)
+                          {
+                                Kernel->Store->Hot->Add(this->database, this->dest, mapped.value);
+                          }
                     }
                    
                     return true;
@@ -272,6 +441,32 @@ bool QueryBase::CheckKey()
       return true;
 }
 
+bool QueryBase::Exclusive()
+{
+      if (this->key.empty())
+      {
+             return true;
+      }
+
+      switch (this->type)
+      {
+             case QUERY_TYPE_READ:
+             case QUERY_TYPE_READ_ALLOW:
+             case QUERY_TYPE_WRITE:
+             case QUERY_TYPE_DELETE:
+             case QUERY_TYPE_EXISTS:
+             case QUERY_TYPE_TYPE:
+             case QUERY_TYPE_EXPIRE:
+             case QUERY_TYPE_SETEX:
+
+                   return false;
+
+             default:
+
+                   return true;
+      }
+}
+
 bool QueryBase::Prepare()
 {
      if (!this->Check())
@@ -0,0 +1,113 @@
+/*
+ * BerylDB - A lightweight database.
+ * http://www.beryldb.com
+ *
+ * Copyright (C) 2021 - Carlos F. Ferry <cferry@beryldb.com>
+ *
+ * This file is part of BerylDB. BerylDB is free software: you can
+ * redistribute it and/or modify it under the terms of the BSD License
+ * version 3.
+ *
+ * More information about our licensing can be found at https://docs.beryl.dev
+ */
+
+#include <atomic>
+
+#include "beryl.h"
+#include "brldb/query_pool.h"
+
+namespace
+{
+        struct Block
+        {
+                Block* next;
+        };
+
+        const size_t CLASSES = QUERY_POOL_SIZE / QUERY_POOL_ALIGN;
+
+        /* Blocks freed, by class. */
+
+        std::atomic<Block*> shared[CLASSES];
+
+        /* Blocks kept, by class, either shared or owned by a thread. */
+
+        std::atomic<size_t> kept[CLASSES];
+
+        /* Blocks taken by current thread, by class. */
+
+        thread_local Block* owned[CLASSES];
+
+        /* Returns class of a given size, or CLASSES if not pooled. */
+
+        inline size_t ClassOf(size_t size)
+        {
+                if (!size || size > QUERY_POOL_SIZE)
+                {
+                        return CLASSES;
+                }
+
+                return (size - 1) / QUERY_POOL_ALIGN;
+        }
+}
+
+void* QueryPool::Allocate(size_t size)
+{
+        const size_t index = ClassOf(size);
+
+        if (index == CLASSES)
+        {
+                return ::operator new(size);
+        }
+
+        Block* block = owned[index];
+
+        if (!block)
+        {
+                block = owned[index] = shared[index].exchange(NULL, std::memory_order_acquire);
+        }
+
+        if (!block)
+        {
+                return ::operator new((index + 1) * QUERY_POOL_ALIGN);
+        }
+
+        owned[index] = block->next;
+        kept[index].fetch_sub(1, std::memory_order_relaxed);
+        return block;
+}
+
+void QueryPool::Release(void* ptr, size_t size)
+{
+        const size_t index = ClassOf(size);
+
+        if (index == CLASSES || kept[index].fetch_add(1, std::memory_order_relaxed) >= QUERY_POOL_BLOCKS)
+        {
+                if (index != CLASSES)
+                {
+                        kept[index].fetch_sub(1, std::memory_order_relaxed);
+                }
+
+                ::operator delete(ptr);
+                return;
+        }
+
+        Block* block = static_cast<Block*>(ptr);
+        block->next = shared[index].load(std::memory_order_relaxed);
+
+        while (!shared[index].compare_exchange_weak(block->next, block, std::memory_order_release, std::memory_order_relaxed))
+        {
+
+        }
+}
+
+size_t QueryPool::Pooled()
+{
+        size_t total = 0;
+
+        for (size_t index = 0; index < CLASSES; index++)
+        {
+                total += kept[index].load(std::memory_order_relaxed);
+        }
+
+        return total;
+}
@@ -13,6 +13,7 @@
 
 #include "beryl.h"
 #include "brldb/expires.h"
+#include "brldb/geo_index.h"
 #include "helpers.h"
 
 void rename_query::Vectors()
@@ -28,7 +29,7 @@ void rename_query::Lists()
 
 void rename_query::Keys()
 {
-     RocksData result = this->Get(this->dest);
+     const RocksData& result = this->Get(this->dest);
      const std::string& newdest = to_bin(this->value) + ":" + convto_string(this->select_query) + ":" + this->identified;
 
      if (!this->SwapWithExpire(newdest, this->dest, result.value, this->select_query, this->value, this->id, this->key))
@@ -53,7 +54,14 @@ void rename_query::Maps()
 
 void rename_query::Geos()
 {
+    /* Index entry follows the new name. */
 
+    const RocksData& result = this->Get(this->dest);
+
+    if (result.status.ok() && GeoIndex::Index(this->database, this->select_query, this->value, result.value))
+    {
+          GeoIndex::Drop(this->database, this->select_query, this->key, result.value);
+    }
 }
 
 void rename_query::Run()
@@ -90,7 +98,7 @@ void rename_query::Run()
           this->Vectors();
     }   
     
-    RocksData result = this->Get(this->dest);
+    const RocksData& result = this->Get(this->dest);
     const std::string& newdest = to_bin(this->value) + ":" + convto_string(this->select_query) + ":" + this->identified;
 
     if (!this->Swap(newdest, this->dest, result.value))
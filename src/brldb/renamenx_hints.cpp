@@ -13,6 +13,7 @@
 
 #include "beryl.h"
 #include "brldb/expires.h"
+#include "brldb/geo_index.h"
 #include "helpers.h"
 
 void renamenx_query::Vectors()
@@ -27,7 +28,7 @@ void renamenx_query::Lists()
 
 void renamenx_query::Keys()
 {
-     RocksData result = this->Get(this->dest);
+     const RocksData& result = this->Get(this->dest);
      const std::string& newdest = to_bin(this->value) + ":" + convto_string(this->select_query) + ":" + this->identified;
 
      if (!this->SwapWithExpire(newdest, this->dest, result.value, this->select_query, this->value, this->id, this->key))
@@ -52,7 +53,14 @@ void renamenx_query::Maps()
 
 void renamenx_query::Geos()
 {
+    /* Index entry follows the new name. */
 
+    const RocksData& result = this->Get(this->dest);
+
+    if (result.status.ok() && GeoIndex::Index(this->database, this->select_query, this->value, result.value))
+    {
+          GeoIndex::Drop(this->database, this->select_query, this->key, result.value);
+    }
 }
 
 void renamenx_query::Run()
@@ -89,7 +97,7 @@ void renamenx_query::Run()
           this->Vectors();
     }   
 
-    RocksData result = this->Get(this->dest);
+    const RocksData& result = this->Get(this->dest);
     const std::string& newdest = to_bin(this->value) + ":" + convto_string(this->select_query) + ":" + this->identified;
 
     if (!this->Swap(newdest, this->dest, result.value))
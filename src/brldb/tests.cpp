@@ -25,19 +25,22 @@ void test_dump_query::Run()
 {
        std::string rawmap;
 
-       rocksdb::Iterator* it = this->database->GetAddress()->NewIterator(rocksdb::ReadOptions());
-
-       for (it->SeekToFirst(); it->Valid(); it->Next()) 
+       for (std::vector<std::string>::const_iterator iter = TypeRegs.begin(); iter != TypeRegs.end(); ++iter)
        {
-                if (!Dispatcher::CheckIterator(this))
-                {
-                       return;
-                }
+              std::unique_ptr<rocksdb::Iterator> it(this->database->NewIterator(*iter));
+
+              for (it->SeekToFirst(); it->Valid(); it->Next()) 
+              {
+                     if (!Dispatcher::CheckIterator(this))
+                     {
+                            return;
+                     }
 
-                rawmap = it->key().ToString();
+                     rawmap = it->key().ToString();
                 
-                std::cout << rawmap << std::endl;
-        }
+                     std::cout << rawmap << std::endl;
+              }
+       }
 }
 
 void test_dump_query::Process()
@@ -0,0 +1,153 @@
+/*
+ * BerylDB - A lightweight database.
+ * http://www.beryldb.com
+ *
+ * Copyright (C) 2021 - Carlos F. Ferry <cferry@beryldb.com>
+ *
+ * This file is part of BerylDB. BerylDB is free software: you can
+ * redistribute it and/or modify it under the terms of the BSD License
+ * version 3.
+ *
+ * More information about our licensing can be found at https://docs.beryl.dev
+ */
+
+#include "beryl.h"
+#include "engine.h"
+
+transaction_query::~transaction_query()
+{
+       /* Never ran, ie, user quit before. */
+
+       if (!this->watching.empty())
+       {
+              Kernel->Store->Watches->Unwatch(this->watching);
+       }
+}
+
+bool transaction_query::Collect(const std::shared_ptr<QueryBase>& result)
+{
+       this->results.push_back(std::make_pair(this->position, result));
+       return true;
+}
+
+void transaction_query::Run()
+{
+       /* 
+        * This query is exclusive, so no other query may write to a
+        * watched key between this check and the queries below.
+        */
+
+       this->aborted = Kernel->Store->Watches->Changed(this->watching, this->epoch);
+       Kernel->Store->Watches->Unwatch(this->watching);
+       this->watching.clear();
+
+       if (this->aborted)
+       {
+              this->queries.clear();
+              this->SetOK();
+              return;
+       }
+
+       /* Writes are gathered and committed at once, so that all writes to a database apply or none does. */
+
+       std::vector<std::shared_ptr<QueryBase>> globals;
+       Database::Begin();
+
+       for (this->position = 0; this->position < this->queries.size(); this->position++)
+       {
+              std::shared_ptr<QueryBase> request = this->queries[this->position];
+
+              if (this->user->IsQuitting())
+              {
+                     break;
+              }
+
+              if (request->access != DBL_INVALID_FORMAT)
+              {
+                     DataFlush::Execute(request.get());
+              }
+
+              if (request->flags == QUERY_FLAGS_QUIET)
+              {
+                     continue;
+              }
+
+              if (request->flags == QUERY_FLAGS_GLOBAL)
+              {
+                     globals.push_back(request);
+                     continue;
+              }
+
+              this->results.push_back(std::make_pair(this->position, request));
+       }
+
+       this->queries.clear();
+
+       if (this->user->IsQuitting())
+       {
+              Database::Discard();
+              this->SetOK();
+              return;
+       }
+
+       if (!Database::Commit())
+       {
+              this->failed = true;
+              this->results.clear();
+              this->SetOK();
+              return;
+       }
+
+       for (std::vector<std::shared_ptr<QueryBase>>::const_iterator i = globals.begin(); i != globals.end(); ++i)
+       {
+              DataFlush::AttachGlobal(*i);
+       }
+
+       this->SetOK();
+}
+
+void transaction_query::Process()
+{
+       LocalUser* const luser = IS_LOCAL(this->user);
+
+       if (!luser)
+       {
+              return;
+       }
+
+       /* Direct replies are sent in the same order their commands were queued. */
+
+       std::vector<std::pair<size_t, ProtocolTrigger::SerializedMessage>>::const_iterator reply = this->replies.begin();
+
+       if (!this->aborted && !this->failed)
+       {
+              for (std::vector<std::pair<size_t, std::shared_ptr<QueryBase>>>::iterator i = this->results.begin(); i != this->results.end(); ++i)
+              {
+                     for (; reply != this->replies.end() && reply->first <= i->first; ++reply)
+                     {
+                            luser->Write(reply->second);
+                     }
+
+                     DataFlush::Reply(this->user, i->second);
+              }
+       }
+
+       for (; reply != this->replies.end(); ++reply)
+       {
+              luser->Write(reply->second);
+       }
+
+       if (this->aborted)
+       {
+              user->SendProtocol(ERR_INPUT2, ERR_MULTI, MULTI_ABORTED);
+              return;
+       }
+
+       if (this->failed)
+       {
+              user->SendProtocol(ERR_INPUT2, ERR_MULTI, PROCESS_ERROR);
+              return;
+       }
+
+       user->SendProtocol(BRLD_MULTI_OK, PROCESS_OK);
+}
@@ -16,6 +16,10 @@
 #include "brldb/query.h"
 #include "brldb/dbnumeric.h"
 #include "brldb/expires.h"
+#include "brldb/list_store.h"
+#include "brldb/map_store.h"
+#include "brldb/zset_store.h"
+#include "brldb/geo_index.h"
 #include "helpers.h"
 
 void transfer_query::Keys()
@@ -32,22 +36,102 @@ void transfer_query::Keys()
 
 void transfer_query::Maps()
 {
+     MapStore store(this->database, this->dest);
+     const RocksData& result = this->Get(this->dest);
 
+     if (!result.status.ok() || !store.Load(result.value))
+     {
+          access_set(DBL_NOT_FOUND);
+          return;
+     }
+
+     const std::string& newdest = to_bin(this->key) + ":" + convto_string(this->select_query) + ":" + this->identified;
+
+     if (!store.CopyTo(this->transf_db, newdest) || !store.Erase())
+     {
+          access_set(DBL_UNABLE_WRITE);
+          return;
+     }
+
+     this->SetOK();
 }
 
 void transfer_query::Multis()
 {
+     MapStore store(this->database, this->dest, true);
+     const RocksData& result = this->Get(this->dest);
+
+     if (!result.status.ok() || !store.Load(result.value))
+     {
+          access_set(DBL_NOT_FOUND);
+          return;
+     }
+
+     const std::string& newdest = to_bin(this->key) + ":" + convto_string(this->select_query) + ":" + this->identified;
 
+     if (!store.CopyTo(this->transf_db, newdest) || !store.Erase())
+     {
+          access_set(DBL_UNABLE_WRITE);
+          return;
+     }
+
+     this->SetOK();
 }
 
 void transfer_query::Geos()
 {
+    /* Index entry moves into the target database. */
 
+    const RocksData& result = this->Get(this->dest);
+
+    if (result.status.ok() && GeoIndex::Index(this->transf_db, this->select_query, this->key, result.value))
+    {
+          GeoIndex::Drop(this->database, this->select_query, this->key, result.value);
+    }
 }
 
 void transfer_query::Lists()
 {
+     ListStore store(this->database, this->dest);
+     const RocksData& result = this->Get(this->dest);
+
+     if (!result.status.ok() || !store.Load(result.value))
+     {
+          access_set(DBL_NOT_FOUND);
+          return;
+     }
+
+     const std::string& newdest = to_bin(this->key) + ":" + convto_string(this->select_query) + ":" + this->identified;
 
+     if (!store.CopyTo(this->transf_db, newdest) || !store.Erase())
+     {
+          access_set(DBL_UNABLE_WRITE);
+          return;
+     }
+
+     this->SetOK();
+}
+
+void transfer_query::ZSets()
+{
+     ZSetStore store(this->database, this->dest);
+     const RocksData& result = this->Get(this->dest);
+
+     if (!result.status.ok() || !store.Load(result.value))
+     {
+          access_set(DBL_NOT_FOUND);
+          return;
+     }
+
+     const std::string& newdest = to_bin(this->key) + ":" + convto_string(this->select_query) + ":" + this->identified;
+
+     if (!store.CopyTo(this->transf_db, newdest) || !store.Erase())
+     {
+          access_set(DBL_UNABLE_WRITE);
+          return;
+     }
+
+     this->SetOK();
 }
 
 void transfer_query::Vectors()
@@ -63,11 +147,17 @@ void transfer_query::Run()
     } 
     else if (this->identified == INT_MAP)
     {
+          /* Items are copied into the target database. */
+
           this->Maps();
+          return;
     }
     else if (this->identified == INT_MMAP)
     {
+          /* Items are copied into the target database. */
+
           this->Multis();
+          return;
     }
     else if (this->identified == INT_GEO)
     {
@@ -75,16 +165,27 @@ void transfer_query::Run()
     }
     else if (this->identified == INT_LIST)
     {
+          /* Items are copied into the target database. */
+
           this->Lists();
+          return;
+    }
+    else if (this->identified == INT_ZSET)
+    {
+          /* Members are copied into the target database. */
+
+          this->ZSets();
+          return;
     }
     else if (this->identified == INT_VECTOR)
     {    
           this->Vectors();
     }   
     
-    RocksData result = this->Get(this->dest);
+    const RocksData& result = this->Get(this->dest);
     const std::string& newdest = to_bin(this->key) + ":" + convto_string(this->select_query) + ":" + this->identified;
-    this->transf_db->GetAddress()->Put(rocksdb::WriteOptions(), newdest, result.value);
+    this->transf_db->Put(this->transf_db->Route(newdest), newdest, result.value);
+    Kernel->Store->Hot->Invalidate(this->transf_db, newdest);
     this->Delete(this->dest);
 }
 
@@ -18,7 +18,7 @@
 #include "engine.h"
 #include "brldb/vector_handler.h"
 
-VectorHandler::VectorHandler()
+VectorHandler::VectorHandler() : numeric(VECTOR_TYPE_STRING)
 {
 
 }
@@ -26,6 +26,13 @@ VectorHandler::VectorHandler()
 std::shared_ptr<VectorHandler> VectorHandler::Create(const std::string& load)
 {
         std::shared_ptr<VectorHandler> New = std::make_shared<VectorHandler>();
+        New->numeric = PackedVector::GetType(load);
+
+        if (New->numeric != VECTOR_TYPE_STRING)
+        {
+                New->mhandler = PackedVector::Unpack(load);
+                return New;
+        }
         
         engine::colon_node_stream stream(load);
         std::string mask;
@@ -84,7 +91,7 @@ void VectorHandler::PopBack()
 
 void VectorHandler::Add(const std::string& key)
 {
-      if (key.empty() || key == "")
+      if (key.empty() || key == "" || !PackedVector::Valid(this->numeric, key))
       {
            this->LastMsg = HANDLER_MSG_INVALID;
            return;
@@ -171,9 +178,46 @@ double VectorHandler::GetSMA()
       return value/size;
 }
 
+bool VectorHandler::SetType(VECTOR_TYPE type)
+{
+      for (StringVector::const_iterator i = this->mhandler.begin(); i != this->mhandler.end(); i++)
+      {
+               if (!PackedVector::Valid(type, *i))
+               {
+                    this->LastMsg = HANDLER_MSG_INVALID;
+                    return false;
+               }
+      }
+
+      this->numeric = type;
+      this->LastMsg = HANDLER_MSG_OK;
+      return true;
+}
+
+void VectorHandler::Sort()
+{
+      this->LastMsg = HANDLER_MSG_OK;
+
+      if (this->numeric == VECTOR_TYPE_STRING)
+      {
+            std::sort(this->mhandler.begin(), this->mhandler.end());
+            return;
+      }
+
+      std::sort(this->mhandler.begin(), this->mhandler.end(), [](const std::string& first, const std::string& second)
+      {
+            return convto_num<double>(first) < convto_num<double>(second);
+      });
+}
+
 double VectorHandler::GetHigh()
 {
-      double value = 0;
+      if (!this->mhandler.size())
+      {
+            return 0;
+      }
+
+      double value = convto_num<double>(mhandler.front());
       
       for (StringVector::const_iterator i = this->mhandler.begin(); i != this->mhandler.end(); i++)
       {
@@ -204,6 +248,11 @@ double VectorHandler::Sum()
 
 double VectorHandler::GetLow()
 {
+      if (!this->mhandler.size())
+      {
+            return 0;
+      }
+
       double value = convto_num<double>(mhandler.front());
       
       for (StringVector::const_iterator i = this->mhandler.begin(); i != this->mhandler.end(); i++)
@@ -223,6 +272,19 @@ double VectorHandler::GetLow()
 std::string VectorHandler::as_string()
 {
         std::string final;
+
+        if (this->numeric != VECTOR_TYPE_STRING)
+        {
+                final = PackedVector::Header(this->numeric);
+                final.reserve(final.size() + this->mhandler.size() * 8);
+
+                for (StringVector::const_iterator i = this->mhandler.begin(); i != this->mhandler.end(); ++i)
+                {
+                        PackedVector::Pack(this->numeric, *i, final);
+                }
+
+                return final;
+        }
         
         unsigned int size = this->mhandler.size();
         
@@ -16,6 +16,7 @@
 
 #include "brldb/query.h"
 #include "brldb/vector_handler.h"
+#include "brldb/packed_vector.h"
 
 void vfind_query::Run()
 {
@@ -24,7 +25,7 @@ void vfind_query::Run()
        unsigned int tracker = 0;
        
        std::string dbvalue;
-       rocksdb::Status fstatus2 = this->database->GetAddress()->Get(rocksdb::ReadOptions(), this->dest, &dbvalue);
+       rocksdb::Status fstatus2 = this->database->Get(this->database->Route(this->dest), this->dest, &dbvalue);
 
        if (!fstatus2.ok())
        {
@@ -51,12 +52,11 @@ void vfind_query::Run()
              
                                     if (aux_counter % ITER_LIMIT == 0)
                                     {
-                                                std::shared_ptr<vfind_query> request = std::make_shared<vfind_query>();
+                                                std::shared_ptr<vfind_query> request = QueryPool::Make<vfind_query>();
                                                 request->user = this->user;
                                                 request->partial = true;                                  
                                                 request->subresult = ++tracker;
-                                                request->VecData = result;
-                                                result.clear();
+                                                request->VecData.swap(result);
                                                 request->SetOK();
                                                 DataFlush::AttachResult(request);
                                       }
@@ -74,12 +74,11 @@ void vfind_query::Run()
             
                              if (aux_counter % ITER_LIMIT == 0)
                              {
-                                        std::shared_ptr<vfind_query> request = std::make_shared<vfind_query>();
+                                        std::shared_ptr<vfind_query> request = QueryPool::Make<vfind_query>();
                                         request->user = this->user;
                                         request->partial = true;
                                         request->subresult = ++tracker;
-                                        request->VecData = result;
-                                        result.clear();
+                                        request->VecData.swap(result);
                                         request->SetOK();
                                         DataFlush::AttachResult(request);
                              }
@@ -91,7 +90,7 @@ void vfind_query::Run()
     this->subresult = ++tracker;
     this->partial = false;
     this->counter = aux_counter;
-    this->VecData = result;
+    this->VecData.swap(result);
     this->SetOK();
 }
 
@@ -107,7 +106,7 @@ void vsort_query::Process()
 
 void vsort_query::Run()
 {
-       RocksData result = this->Get(this->dest);
+       const RocksData& result = this->Get(this->dest);
 
        if (!result.status.ok())
        {
@@ -135,9 +134,10 @@ void vkeys_query::Run()
        unsigned int aux_counter = 0;
        unsigned int tracker = 0;
 
-       rocksdb::Iterator* it = this->database->GetAddress()->NewIterator(rocksdb::ReadOptions());
+       std::unique_ptr<rocksdb::Iterator> it(this->database->NewIterator(INT_VECTOR));
+       PrefixRange range(this->key);
 
-       for (it->SeekToFirst(); it->Valid(); it->Next()) 
+       for (range.Seek(it.get()); range.Valid(it.get()); range.Next(it.get())) 
        {
                 if (!Dispatcher::CheckIterator(this))
                 {
@@ -219,12 +219,11 @@ void vkeys_query::Run()
                                     if (aux_counter % ITER_LIMIT == 0)
                                     {
                                                 tracker++;
-                                                std::shared_ptr<vkeys_query> request = std::make_shared<vkeys_query>();
+                                                std::shared_ptr<vkeys_query> request = QueryPool::Make<vkeys_query>();
                                                 request->user = this->user;
                                                 request->partial = true;                                  
                                                 request->subresult = tracker;
-                                                request->VecData = result;
-                                                result.clear();
+                                                request->VecData.swap(result);
                                                 request->SetOK();
                                                 DataFlush::AttachResult(request);
                                       }
@@ -243,12 +242,11 @@ void vkeys_query::Run()
                              if (aux_counter % ITER_LIMIT == 0)
                              {
                                         tracker++;
-                                        std::shared_ptr<vkeys_query> request = std::make_shared<vkeys_query>();
+                                        std::shared_ptr<vkeys_query> request = QueryPool::Make<vkeys_query>();
                                         request->user = this->user;
                                         request->partial = true;
                                         request->subresult = tracker;
-                                        request->VecData = result;
-                                        result.clear();
+                                        request->VecData.swap(result);
                                         request->SetOK();
                                         DataFlush::AttachResult(request);
                              }
@@ -260,7 +258,7 @@ void vkeys_query::Run()
     this->subresult = ++tracker;
     this->partial = false;
     this->counter = aux_counter;
-    this->VecData = result;
+    this->VecData.swap(result);
     this->SetOK();
 }
 
@@ -271,7 +269,7 @@ void vkeys_query::Process()
 
 void vresize_query::Run()
 {
-       RocksData result = this->Get(this->dest);
+       const RocksData& result = this->Get(this->dest);
 
        if (!result.status.ok())
        {
@@ -317,7 +315,7 @@ void vpush_query::Run()
              return;
        }
 
-       RocksData result = this->Get(this->dest);
+       const RocksData& result = this->Get(this->dest);
        std::shared_ptr<VectorHandler> handler;
        
        if (!result.status.ok())
@@ -379,7 +377,7 @@ void vget_query::Run()
        unsigned int aux_counter = 0;
        unsigned int tracker = 0;
        
-       RocksData query_result = this->Get(this->dest);
+       const RocksData& query_result = this->Get(this->dest);
        
        if (!query_result.status.ok())
        {
@@ -418,12 +416,11 @@ void vget_query::Run()
              
                                     if (aux_counter % ITER_LIMIT == 0)
                                     {
-                                                std::shared_ptr<vget_query> request = std::make_shared<vget_query>();
+                                                std::shared_ptr<vget_query> request = QueryPool::Make<vget_query>();
                                                 request->user = this->user;
                                                 request->partial = true;                                  
                                                 request->subresult = ++tracker;
-                                                request->VecData = result_return;
-                                                result_return.clear();
+                                                request->VecData.swap(result_return);
                                                 request->SetOK();
                                                 DataFlush::AttachResult(request);
                                       }
@@ -441,12 +438,11 @@ void vget_query::Run()
             
                              if (aux_counter % ITER_LIMIT == 0)
                              {
-                                        std::shared_ptr<vget_query> request = std::make_shared<vget_query>();
+                                        std::shared_ptr<vget_query> request = QueryPool::Make<vget_query>();
                                         request->user = this->user;
                                         request->partial = true;
                                         request->subresult = ++tracker;
-                                        request->VecData = result_return;
-                                        result_return.clear();
+                                        request->VecData.swap(result_return);
                                         request->SetOK();
                                         DataFlush::AttachResult(request);
                              }
@@ -458,7 +454,7 @@ void vget_query::Run()
      this->subresult = ++tracker;
      this->partial = false;
      this->counter = total_counter;
-     this->VecData = result_return;
+     this->VecData.swap(result_return);
      this->SetOK();
 }
 
@@ -475,7 +471,7 @@ void vget_query::Process()
 
 void vcount_query::Run()
 {
-       RocksData query_result = this->Get(this->dest);
+       const RocksData& query_result = this->Get(this->dest);
 
        if (!query_result.status.ok())
        {
@@ -496,7 +492,7 @@ void vcount_query::Process()
 
 void vpos_query::Run()
 {
-       RocksData result = this->Get(this->dest);
+       const RocksData& result = this->Get(this->dest);
 
        std::shared_ptr<VectorHandler> handler = VectorHandler::Create(result.value);
        std::string reply = handler->Index(convto_num<unsigned int>(this->value));
@@ -513,7 +509,7 @@ void vpos_query::Run()
 
 void vpos_query::Process()
 {
-       user->SendProtocol(BRLD_OK, Helpers::Format(this->response));
+       user->SendProtocol(BRLD_OK, this->Quote(this->response));
 }
 
 void vexist_query::Process()
@@ -523,7 +519,7 @@ void vexist_query::Process()
 
 void vexist_query::Run()
 {
-       RocksData result = this->Get(this->dest);
+       const RocksData& result = this->Get(this->dest);
 
        if (!result.status.ok())
        {
@@ -547,7 +543,7 @@ void vexist_query::Run()
 
 void vpop_front_query::Run()
 {
-       RocksData result = this->Get(this->dest);
+       const RocksData& result = this->Get(this->dest);
        std::shared_ptr<VectorHandler> handler;
 
        handler = VectorHandler::Create(result.value);
@@ -580,7 +576,7 @@ void vpop_front_query::Process()
 
 void vpop_back_query::Run()
 {
-       RocksData result = this->Get(this->dest);
+       const RocksData& result = this->Get(this->dest);
        std::shared_ptr<VectorHandler> handler;
 
        handler = VectorHandler::Create(result.value);
@@ -619,7 +615,7 @@ void vdel_query::Process()
 
 void vpushnx_query::Run()
 {
-       RocksData query_result = this->Get(this->dest);
+       const RocksData& query_result = this->Get(this->dest);
 
        std::shared_ptr<VectorHandler> handler = VectorHandler::Create(query_result.value);
        
@@ -655,7 +651,7 @@ void vpushnx_query::Process()
 
 void vdel_query::Run()
 {
-       RocksData query_result = this->Get(this->dest);
+       const RocksData& query_result = this->Get(this->dest);
 
        std::shared_ptr<VectorHandler> handler = VectorHandler::Create(query_result.value);
        
@@ -688,7 +684,7 @@ void vdel_query::Run()
 
 void vreverse_query::Run()
 {
-       RocksData result = this->Get(this->dest);
+       const RocksData& result = this->Get(this->dest);
 
        if (!result.status.ok())
        {
@@ -716,7 +712,7 @@ void vreverse_query::Process()
 
 void vrepeats_query::Run()
 {
-       RocksData result = this->Get(this->dest);
+       const RocksData& result = this->Get(this->dest);
 
        if (!result.status.ok())
        {
@@ -736,7 +732,7 @@ void vrepeats_query::Process()
 
 void vavg_query::Run()
 {
-       RocksData result = this->Get(this->dest);
+       const RocksData& result = this->Get(this->dest);
 
        if (!result.status.ok())
        {
@@ -744,6 +740,14 @@ void vavg_query::Run()
                return;
        }
 
+       /* Numeric vectors are aggregated without unpacking them. */
+
+       if (PackedVector::Aggregate(result.value, VECTOR_AGGREGATE_AVG, this->response))
+       {
+              this->SetOK();
+              return;
+       }
+
        std::shared_ptr<VectorHandler> handler = VectorHandler::Create(result.value);
        
        if (!handler->IsNumeric())
@@ -763,7 +767,7 @@ void vavg_query::Process()
 
 void vhigh_query::Run()
 {
-       RocksData result = this->Get(this->dest);
+       const RocksData& result = this->Get(this->dest);
 
        if (!result.status.ok())
        {
@@ -771,6 +775,14 @@ void vhigh_query::Run()
                return;
        }
 
+       /* Numeric vectors are aggregated without unpacking them. */
+
+       if (PackedVector::Aggregate(result.value, VECTOR_AGGREGATE_HIGH, this->response))
+       {
+              this->SetOK();
+              return;
+       }
+
        std::shared_ptr<VectorHandler> handler = VectorHandler::Create(result.value);
        
        if (!handler->IsNumeric())
@@ -790,7 +802,7 @@ void vhigh_query::Process()
 
 void vlow_query::Run()
 {
-       RocksData result = this->Get(this->dest);
+       const RocksData& result = this->Get(this->dest);
 
        if (!result.status.ok())
        {
@@ -798,6 +810,14 @@ void vlow_query::Run()
                return;
        }
 
+       /* Numeric vectors are aggregated without unpacking them. */
+
+       if (PackedVector::Aggregate(result.value, VECTOR_AGGREGATE_LOW, this->response))
+       {
+              this->SetOK();
+              return;
+       }
+
        std::shared_ptr<VectorHandler> handler = VectorHandler::Create(result.value);
        
        if (!handler->IsNumeric())
@@ -817,7 +837,7 @@ void vlow_query::Process()
 
 void vsum_query::Run()
 {
-       RocksData result = this->Get(this->dest);
+       const RocksData& result = this->Get(this->dest);
 
        if (!result.status.ok())
        {
@@ -825,6 +845,14 @@ void vsum_query::Run()
                return;
        }
 
+       /* Numeric vectors are aggregated without unpacking them. */
+
+       if (PackedVector::Aggregate(result.value, VECTOR_AGGREGATE_SUM, this->response))
+       {
+              this->SetOK();
+              return;
+       }
+
        std::shared_ptr<VectorHandler> handler = VectorHandler::Create(result.value);
 
        if (!handler->IsNumeric())
@@ -844,7 +872,7 @@ void vsum_query::Process()
 
 void vback_query::Run()
 {
-       RocksData result = this->Get(this->dest);
+       const RocksData& result = this->Get(this->dest);
 
        if (!result.status.ok())
        {
@@ -867,12 +895,12 @@ void vback_query::Run()
 
 void vback_query::Process()
 {
-       user->SendProtocol(BRLD_OK, Helpers::Format(this->response));
+       user->SendProtocol(BRLD_OK, this->Quote(this->response));
 }
 
 void vfront_query::Run()
 {
-       RocksData result = this->Get(this->dest);
+       const RocksData& result = this->Get(this->dest);
 
        if (!result.status.ok())
        {
@@ -895,5 +923,38 @@ void vfront_query::Run()
 
 void vfront_query::Process()
 {
-       user->SendProtocol(BRLD_OK, Helpers::Format(this->response));
+       user->SendProtocol(BRLD_OK, this->Quote(this->response));
+}
+
+void vtype_query::Run()
+{
+       const RocksData& result = this->Get(this->dest);
+
+       if (!result.status.ok())
+       {
+               access_set(DBL_NOT_FOUND);
+               return;
+       }
+
+       std::shared_ptr<VectorHandler> handler = VectorHandler::Create(result.value);
+
+       if (!handler->SetType(static_cast<VECTOR_TYPE>(this->data)))
+       {
+              access_set(DBL_INVALID_RANGE);
+              return;
+       }
+
+       if (this->Write(this->dest, handler->as_string()))
+       {
+              this->SetOK();
+       }
+       else
+       {
+              access_set(DBL_UNABLE_WRITE);
+       }
+}
+
+void vtype_query::Process()
+{
+       user->SendProtocol(BRLD_OK, PROCESS_OK);
 }
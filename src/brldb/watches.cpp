@@ -0,0 +1,88 @@
+/*
+ * BerylDB - A lightweight database.
+ * http://www.beryldb.com
+ *
+ * Copyright (C) 2021 - Carlos F. Ferry <cferry@beryldb.com>
+ *
+ * This file is part of BerylDB. BerylDB is free software: you can
+ * redistribute it and/or modify it under the terms of the BSD License
+ * version 3.
+ *
+ * More information about our licensing can be found at https://docs.beryl.dev
+ */
+
+#include "beryl.h"
+#include "brldb/database.h"
+#include "brldb/watches.h"
+
+WatchTable::WatchTable() : watched(0), epoch(0)
+{
+
+}
+
+std::string WatchTable::Build(const std::shared_ptr<Database>& database, unsigned int select, const std::string& key)
+{
+        return database->GetName() + ":" + convto_string(select) + ":" + key;
+}
+
+uint64_t WatchTable::Watch(const std::string& id)
+{
+        std::lock_guard<std::mutex> guard(this->lock);
+
+        Entry& entry = this->entries[id];
+        entry.watchers++;
+
+        this->watched = this->entries.size();
+        return entry.version;
+}
+
+void WatchTable::Unwatch(const WatchMap& keys)
+{
+        std::lock_guard<std::mutex> guard(this->lock);
+
+        for (WatchMap::const_iterator i = keys.begin(); i != keys.end(); ++i)
+        {
+                std::unordered_map<std::string, Entry>::iterator it = this->entries.find(i->first);
+
+                if (it != this->entries.end() && --it->second.watchers == 0)
+                {
+                        this->entries.erase(it);
+                }
+        }
+
+        this->watched = this->entries.size();
+}
+
+bool WatchTable::Changed(const WatchMap& keys, uint64_t since)
+{
+        if (this->epoch.load() != since)
+        {
+                return true;
+        }
+
+        std::lock_guard<std::mutex> guard(this->lock);
+
+        for (WatchMap::const_iterator i = keys.begin(); i != keys.end(); ++i)
+        {
+                std::unordered_map<std::string, Entry>::const_iterator it = this->entries.find(i->first);
+
+                if (it == this->entries.end() || it->second.version != i->second)
+                {
+                        return true;
+                }
+        }
+
+        return false;
+}
+
+void WatchTable::Touch(const std::string& id)
+{
+        std::lock_guard<std::mutex> guard(this->lock);
+
+        std::unordered_map<std::string, Entry>::iterator it = this->entries.find(id);
+
+        if (it != this->entries.end())
+        {
+                it->second.version++;
+        }
+}
@@ -0,0 +1,366 @@
+/*
+ * BerylDB - A lightweight database.
+ * http://www.beryldb.com
+ *
+ * Copyright (C) 2021 - Carlos F. Ferry <cferry@beryldb.com>
+ *
+ * This file is part of BerylDB. BerylDB is free software: you can
+ * redistribute it and/or modify it under the terms of the BSD License
+ * version 3.
+ *
+ * More information about our licensing can be found at https://docs.beryl.dev
+ */
+
+#include "beryl.h"
+#include "brldb/database.h"
+#include "brldb/container.h"
+#include "brldb/zset_index.h"
+
+namespace
+{
+        const unsigned int MAX_LEVEL = 32;
+}
+
+ZSetIndex::ZSetIndex() : head(new Node()), level(1), length(0)
+{
+        Link empty = { NULL, 0 };
+        this->head->score = 0;
+        this->head->next.assign(MAX_LEVEL, empty);
+}
+
+ZSetIndex::~ZSetIndex()
+{
+        Node* node = this->head;
+
+        while (node)
+        {
+                Node* following = node->next[0].node;
+                delete node;
+                node = following;
+        }
+}
+
+bool ZSetIndex::Before(const Node* node, double score, const std::string& member)
+{
+        return node->score < score || (node->score == score && node->member < member);
+}
+
+unsigned int ZSetIndex::RandomLevel()
+{
+        /* Each level holds a fourth of the items of the level below. */
+
+        static thread_local uint32_t seed = 2463534242u;
+        unsigned int found = 1;
+
+        while (found < MAX_LEVEL)
+        {
+                seed ^= seed << 13;
+                seed ^= seed >> 17;
+                seed ^= seed << 5;
+
+                if ((seed & 3) != 0)
+                {
+                        break;
+                }
+
+                found++;
+        }
+
+        return found;
+}
+
+void ZSetIndex::Insert(double score, const std::string& member)
+{
+        Node* update[MAX_LEVEL];
+        size_t rank[MAX_LEVEL];
+
+        Node* node = this->head;
+
+        for (int i = this->level - 1; i >= 0; i--)
+        {
+                rank[i] = (i == (int)this->level - 1) ? 0 : rank[i + 1];
+
+                while (node->next[i].node && Before(node->next[i].node, score, member))
+                {
+                        rank[i] += node->next[i].span;
+                        node = node->next[i].node;
+                }
+
+                update[i] = node;
+        }
+
+        const unsigned int levels = RandomLevel();
+
+        if (levels > this->level)
+        {
+                for (unsigned int i = this->level; i < levels; i++)
+                {
+                        rank[i] = 0;
+                        update[i] = this->head;
+                        this->head->next[i].span = this->length;
+                }
+
+                this->level = levels;
+        }
+
+        Node* created = new Node();
+        created->member = member;
+        created->score = score;
+        created->next.resize(levels);
+
+        for (unsigned int i = 0; i < levels; i++)
+        {
+                created->next[i].node = update[i]->next[i].node;
+                update[i]->next[i].node = created;
+
+                created->next[i].span = update[i]->next[i].span - (rank[0] - rank[i]);
+                update[i]->next[i].span = (rank[0] - rank[i]) + 1;
+        }
+
+        for (unsigned int i = levels; i < this->level; i++)
+        {
+                update[i]->next[i].span++;
+        }
+
+        this->length++;
+}
+
+bool ZSetIndex::Erase(double score, const std::string& member)
+{
+        Node* update[MAX_LEVEL];
+        Node* node = this->head;
+
+        for (int i = this->level - 1; i >= 0; i--)
+        {
+                while (node->next[i].node && Before(node->next[i].node, score, member))
+                {
+                        node = node->next[i].node;
+                }
+
+                update[i] = node;
+        }
+
+        node = node->next[0].node;
+
+        if (!node || node->score != score || node->member != member)
+        {
+                return false;
+        }
+
+        for (unsigned int i = 0; i < this->level; i++)
+        {
+                if (update[i]->next[i].node == node)
+                {
+                        update[i]->next[i].span += node->next[i].span - 1;
+                        update[i]->next[i].node = node->next[i].node;
+                }
+                else
+                {
+                        update[i]->next[i].span--;
+                }
+        }
+
+        while (this->level > 1 && !this->head->next[this->level - 1].node)
+        {
+                this->level--;
+        }
+
+        this->length--;
+        delete node;
+        return true;
+}
+
+signed long ZSetIndex::Rank(double score, const std::string& member) const
+{
+        size_t rank = 0;
+        const Node* node = this->head;
+
+        for (int i = this->level - 1; i >= 0; i--)
+        {
+                while (node->next[i].node && (Before(node->next[i].node, score, member) || (node->next[i].node->score == score && node->next[i].node->member == member)))
+                {
+                        rank += node->next[i].span;
+                        node = node->next[i].node;
+                }
+
+                if (node != this->head && node->score == score && node->member == member)
+                {
+                        return (signed long)rank - 1;
+                }
+        }
+
+        return -1;
+}
+
+void ZSetIndex::Range(size_t start, size_t count, ZSetItems& items) const
+{
+        if (start >= this->length || !count)
+        {
+                return;
+        }
+
+        /* Finds item at given rank, counting from 1. */
+
+        const size_t target = start + 1;
+        size_t traversed = 0;
+        const Node* node = this->head;
+
+        for (int i = this->level - 1; i >= 0 && traversed != target; i--)
+        {
+                while (node->next[i].node && traversed + node->next[i].span <= target)
+                {
+                        traversed += node->next[i].span;
+                        node = node->next[i].node;
+                }
+        }
+
+        for (; node && count; node = node->next[0].node, count--)
+        {
+                items.push_back(ZSetItem(node->member, node->score));
+        }
+}
+
+ZSetCache::ZSetCache() : budget(0), used(0)
+{
+
+}
+
+std::string ZSetCache::Build(const std::shared_ptr<Database>& database, uint64_t id)
+{
+        return database->GetName() + std::string(1, '\0') + Container::Encode(id);
+}
+
+void ZSetCache::Configure(size_t items)
+{
+        std::lock_guard<std::mutex> guard(this->lock);
+
+        this->entries.clear();
+        this->lookup.clear();
+        this->used = 0;
+        this->budget = items;
+}
+
+void ZSetCache::Trim()
+{
+        while (this->used > this->budget && !this->entries.empty())
+        {
+                Entry& last = this->entries.back();
+
+                this->used -= last.counted;
+                this->lookup.erase(last.name);
+                this->entries.pop_back();
+        }
+}
+
+std::shared_ptr<ZSetIndex> ZSetCache::Find(const std::shared_ptr<Database>& database, uint64_t id)
+{
+        if (!this->Enabled())
+        {
+                return NULL;
+        }
+
+        std::lock_guard<std::mutex> guard(this->lock);
+
+        std::unordered_map<std::string, std::list<Entry>::iterator>::iterator it = this->lookup.find(Build(database, id));
+
+        if (it == this->lookup.end())
+        {
+                return NULL;
+        }
+
+        this->entries.splice(this->entries.begin(), this->entries, it->second);
+
+        /* Index may have grown or shrunk since last accounted. */
+
+        Entry& entry = this->entries.front();
+        std::shared_ptr<ZSetIndex> index = entry.index;
+
+        this->used = this->used - entry.counted + index->Count();
+        entry.counted = index->Count();
+
+        this->Trim();
+        return index;
+}
+
+void ZSetCache::Add(const std::shared_ptr<Database>& database, uint64_t id, const std::shared_ptr<ZSetIndex>& index)
+{
+        if (!this->Enabled() || index->Count() > this->budget)
+        {
+                return;
+        }
+
+        const std::string& name = Build(database, id);
+
+        std::lock_guard<std::mutex> guard(this->lock);
+
+        std::unordered_map<std::string, std::list<Entry>::iterator>::iterator it = this->lookup.find(name);
+
+        if (it != this->lookup.end())
+        {
+                this->used -= it->second->counted;
+                this->entries.erase(it->second);
+                this->lookup.erase(it);
+        }
+
+        Entry entry;
+        entry.name = name;
+        entry.index = index;
+        entry.counted = index->Count();
+
+        this->entries.push_front(entry);
+        this->lookup[name] = this->entries.begin();
+        this->used += entry.counted;
+
+        this->Trim();
+}
+
+void ZSetCache::Drop(const std::shared_ptr<Database>& database, uint64_t id)
+{
+        if (!this->Enabled())
+        {
+                return;
+        }
+
+        std::lock_guard<std::mutex> guard(this->lock);
+
+        std::unordered_map<std::string, std::list<Entry>::iterator>::iterator it = this->lookup.find(Build(database, id));
+
+        if (it != this->lookup.end())
+        {
+                this->used -= it->second->counted;
+                this->entries.erase(it->second);
+                this->lookup.erase(it);
+        }
+}
+
+void ZSetCache::Clear(const std::string& dbname)
+{
+        if (!this->Enabled())
+        {
+                return;
+        }
+
+        const std::string prefix = dbname + std::string(1, '\0');
+
+        std::lock_guard<std::mutex> guard(this->lock);
+
+        for (std::list<Entry>::iterator it = this->entries.begin(); it != this->entries.end(); )
+        {
+                if (it->name.compare(0, prefix.size(), prefix) == 0)
+                {
+                        this->used -= it->counted;
+                        this->lookup.erase(it->name);
+                        it = this->entries.erase(it);
+                }
+                else
+                {
+                        ++it;
+                }
+        }
+}
+
+size_t ZSetCache::Count()
+{
+        std::lock_guard<std::mutex> guard(this->lock);
+        return this->entries.size();
+}
@@ -0,0 +1,457 @@
+/*
+ * BerylDB - A lightweight database.
+ * http://www.beryldb.com
+ *
+ * Copyright (C) 2021 - Carlos F. Ferry <cferry@beryldb.com>
+ *
+ * This file is part of BerylDB. BerylDB is free software: you can
+ * redistribute it and/or modify it under the terms of the BSD License
+ * version 3.
+ *
+ * More information about our licensing can be found at https://docs.beryl.dev
+ */
+
+#include <cmath>
+#include <cerrno>
+#include <cstring>
+
+#include "beryl.h"
+#include "engine.h"
+#include "brldb/database.h"
+#include "brldb/container.h"
+#include "brldb/packed_vector.h"
+#include "brldb/zset_store.h"
+
+namespace
+{
+        const uint64_t SIGN_BIT = 0x8000000000000000ULL;
+
+        /* Size of id and entry kind ('m' or 's'). */
+
+        const size_t PREFIX_SIZE = 9;
+
+        const size_t SCORE_SIZE = 8;
+}
+
+ZSetStore::ZSetStore(std::shared_ptr<Database> db, const std::string& regdest) : database(db), dest(regdest), id(0), count(0)
+{
+
+}
+
+std::string ZSetStore::EncodeScore(double score)
+{
+        /* -0 and 0 are the same score. */
+
+        if (score == 0)
+        {
+                score = 0;
+        }
+
+        uint64_t bits;
+        memcpy(&bits, &score, sizeof(bits));
+
+        /* Negative numbers sort in reverse, so all their bits are flipped. */
+
+        bits = (bits & SIGN_BIT) ? ~bits : (bits | SIGN_BIT);
+        return Container::Encode(bits);
+}
+
+double ZSetStore::DecodeScore(const char* data)
+{
+        uint64_t bits = Container::GetId(rocksdb::Slice(data, SCORE_SIZE));
+        bits = (bits & SIGN_BIT) ? (bits & ~SIGN_BIT) : ~bits;
+
+        double score;
+        memcpy(&score, &bits, sizeof(score));
+        return score;
+}
+
+bool ZSetStore::ParseScore(const std::string& text, double& score)
+{
+        if (text.empty())
+        {
+                return false;
+        }
+
+        char* end = NULL;
+        errno = 0;
+
+        const double parsed = strtod(text.c_str(), &end);
+
+        if (*end != '\0' || std::isnan(parsed) || (errno == ERANGE && !std::isinf(parsed)))
+        {
+                return false;
+        }
+
+        score = parsed;
+        return true;
+}
+
+std::string ZSetStore::FormatScore(double score)
+{
+        if (std::isinf(score))
+        {
+                return score > 0 ? "+inf" : "-inf";
+        }
+
+        return PackedVector::Format(score);
+}
+
+std::string ZSetStore::MemberKey(const std::string& member)
+{
+        return Container::Encode(this->id) + "m" + member;
+}
+
+std::string ZSetStore::ScoreKey(double score, const std::string& member)
+{
+        return Container::Encode(this->id) + "s" + EncodeScore(score) + member;
+}
+
+bool ZSetStore::Load(const std::string& registry)
+{
+        engine::colon_node_stream stream(registry);
+        std::string container, items;
+
+        if (!stream.items_extract(container) || !stream.items_extract(items))
+        {
+                return false;
+        }
+
+        this->id = convto_num<uint64_t>(container);
+        this->count = convto_num<uint64_t>(items);
+
+        return (this->id != 0);
+}
+
+void ZSetStore::Create()
+{
+        this->id = this->database->NewContainer();
+        this->count = 0;
+}
+
+bool ZSetStore::Commit(rocksdb::WriteBatch& batch)
+{
+        if (!this->count)
+        {
+                batch.Delete(this->database->Route(this->dest), this->dest);
+        }
+        else
+        {
+                batch.Put(this->database->Route(this->dest), this->dest, convto_string(this->id) + ":" + convto_string(this->count));
+        }
+
+        return this->database->Write(batch).ok();
+}
+
+std::shared_ptr<ZSetIndex> ZSetStore::GetIndex()
+{
+        std::shared_ptr<ZSetIndex> index = Kernel->Store->ZSets->Find(this->database, this->id);
+
+        if (index || !Kernel->Store->ZSets->Enabled())
+        {
+                return index;
+        }
+
+        /* Score entries are visited in order, so every insert lands at the end. */
+
+        index = std::make_shared<ZSetIndex>();
+
+        const std::string& prefix = Container::Encode(this->id) + "s";
+        std::unique_ptr<rocksdb::Iterator> it(this->database->NewIterator(INT_ZSET_ITEM));
+
+        for (it->Seek(prefix); it->Valid() && it->key().starts_with(prefix); it->Next())
+        {
+                const rocksdb::Slice& key = it->key();
+
+                if (key.size() < PREFIX_SIZE + SCORE_SIZE)
+                {
+                        continue;
+                }
+
+                index->Insert(DecodeScore(key.data() + PREFIX_SIZE), std::string(key.data() + PREFIX_SIZE + SCORE_SIZE, key.size() - PREFIX_SIZE - SCORE_SIZE));
+        }
+
+        Kernel->Store->ZSets->Add(this->database, this->id, index);
+        return index;
+}
+
+bool ZSetStore::Score(const std::string& member, double& score)
+{
+        rocksdb::PinnableSlice value;
+
+        if (!this->database->Get(this->database->GetHandle(INT_ZSET_ITEM), this->MemberKey(member), &value).ok() || value.size() != SCORE_SIZE)
+        {
+                return false;
+        }
+
+        score = DecodeScore(value.data());
+        return true;
+}
+
+int ZSetStore::Add(const std::string& member, double score)
+{
+        double previous = 0;
+        const bool exists = this->Score(member, previous);
+
+        if (exists && EncodeScore(previous) == EncodeScore(score))
+        {
+                return 0;
+        }
+
+        rocksdb::ColumnFamilyHandle* items = this->database->GetHandle(INT_ZSET_ITEM);
+        rocksdb::WriteBatch batch;
+
+        if (exists)
+        {
+                batch.Delete(items, this->ScoreKey(previous, member));
+        }
+        else
+        {
+                this->count++;
+        }
+
+        batch.Put(items, this->MemberKey(member), EncodeScore(score));
+        batch.Put(items, this->ScoreKey(score, member), "");
+
+        if (!this->Commit(batch))
+        {
+                if (!exists)
+                {
+                        this->count--;
+                }
+
+                return -1;
+        }
+
+        std::shared_ptr<ZSetIndex> index = Kernel->Store->ZSets->Find(this->database, this->id);
+
+        if (index)
+        {
+                if (exists)
+                {
+                        index->Erase(previous, member);
+                }
+
+                index->Insert(score, member);
+        }
+
+        return exists ? 0 : 1;
+}
+
+bool ZSetStore::Remove(const std::string& member)
+{
+        double score;
+
+        if (!this->Score(member, score))
+        {
+                return false;
+        }
+
+        rocksdb::ColumnFamilyHandle* items = this->database->GetHandle(INT_ZSET_ITEM);
+        rocksdb::WriteBatch batch;
+
+        batch.Delete(items, this->MemberKey(member));
+        batch.Delete(items, this->ScoreKey(score, member));
+
+        this->count--;
+
+        if (!this->Commit(batch))
+        {
+                this->count++;
+                return false;
+        }
+
+        std::shared_ptr<ZSetIndex> index = Kernel->Store->ZSets->Find(this->database, this->id);
+
+        if (index)
+        {
+                index->Erase(score, member);
+        }
+
+        return true;
+}
+
+bool ZSetStore::PopMin(ZSetItem& item)
+{
+        const std::string& prefix = Container::Encode(this->id) + "s";
+        std::unique_ptr<rocksdb::Iterator> it(this->database->NewIterator(INT_ZSET_ITEM));
+
+        it->Seek(prefix);
+
+        if (!it->Valid() || !it->key().starts_with(prefix) || it->key().size() < PREFIX_SIZE + SCORE_SIZE)
+        {
+                return false;
+        }
+
+        const rocksdb::Slice& key = it->key();
+
+        item.second = DecodeScore(key.data() + PREFIX_SIZE);
+        item.first.assign(key.data() + PREFIX_SIZE + SCORE_SIZE, key.size() - PREFIX_SIZE - SCORE_SIZE);
+
+        rocksdb::ColumnFamilyHandle* items = this->database->GetHandle(INT_ZSET_ITEM);
+        rocksdb::WriteBatch batch;
+
+        batch.Delete(items, key);
+        batch.Delete(items, this->MemberKey(item.first));
+
+        this->count--;
+
+        if (!this->Commit(batch))
+        {
+                this->count++;
+                return false;
+        }
+
+        std::shared_ptr<ZSetIndex> index = Kernel->Store->ZSets->Find(this->database, this->id);
+
+        if (index)
+        {
+                index->Erase(item.second, item.first);
+        }
+
+        return true;
+}
+
+signed long ZSetStore::Rank(const std::string& member)
+{
+        double score;
+
+        if (!this->Score(member, score))
+        {
+                return -1;
+        }
+
+        std::shared_ptr<ZSetIndex> index = this->GetIndex();
+
+        if (index)
+        {
+                return index->Rank(score, member);
+        }
+
+        /* Without an index, members with lower scores are counted. */
+
+        const std::string& prefix = Container::Encode(this->id) + "s";
+        const std::string& target = this->ScoreKey(score, member);
+
+        std::unique_ptr<rocksdb::Iterator> it(this->database->NewIterator(INT_ZSET_ITEM));
+        signed long rank = 0;
+
+        for (it->Seek(prefix); it->Valid() && it->key().compare(target) < 0; it->Next())
+        {
+                rank++;
+        }
+
+        return rank;
+}
+
+void ZSetStore::Range(signed long start, signed long stop, ZSetItems& items)
+{
+        const signed long total = (signed long)this->count;
+
+        if (start < 0)
+        {
+                start += total;
+        }
+
+        if (stop < 0)
+        {
+                stop += total;
+        }
+
+        if (start < 0)
+        {
+                start = 0;
+        }
+
+        if (stop >= total)
+        {
+                stop = total - 1;
+        }
+
+        if (start > stop || start >= total)
+        {
+                return;
+        }
+
+        std::shared_ptr<ZSetIndex> index = this->GetIndex();
+
+        if (index)
+        {
+                index->Range(start, stop - start + 1, items);
+                return;
+        }
+
+        const std::string& prefix = Container::Encode(this->id) + "s";
+        std::unique_ptr<rocksdb::Iterator> it(this->database->NewIterator(INT_ZSET_ITEM));
+        signed long rank = 0;
+
+        for (it->Seek(prefix); it->Valid() && it->key().starts_with(prefix) && rank <= stop; it->Next(), rank++)
+        {
+                const rocksdb::Slice& key = it->key();
+
+                if (rank < start || key.size() < PREFIX_SIZE + SCORE_SIZE)
+                {
+                        continue;
+                }
+
+                items.push_back(ZSetItem(std::string(key.data() + PREFIX_SIZE + SCORE_SIZE, key.size() - PREFIX_SIZE - SCORE_SIZE), DecodeScore(key.data() + PREFIX_SIZE)));
+        }
+}
+
+void ZSetStore::RangeByScore(double min, double max, ZSetItems& items, size_t limit)
+{
+        const std::string& prefix = Container::Encode(this->id) + "s";
+        std::unique_ptr<rocksdb::Iterator> it(this->database->NewIterator(INT_ZSET_ITEM));
+
+        for (it->Seek(prefix + EncodeScore(min)); it->Valid() && it->key().starts_with(prefix) && items.size() < limit; it->Next())
+        {
+                const rocksdb::Slice& key = it->key();
+
+                if (key.size() < PREFIX_SIZE + SCORE_SIZE)
+                {
+                        continue;
+                }
+
+                const double score = DecodeScore(key.data() + PREFIX_SIZE);
+
+                if (score > max)
+                {
+                        break;
+                }
+
+                items.push_back(ZSetItem(std::string(key.data() + PREFIX_SIZE + SCORE_SIZE, key.size() - PREFIX_SIZE - SCORE_SIZE), score));
+        }
+}
+
+bool ZSetStore::Erase()
+{
+        rocksdb::WriteBatch batch;
+        Container::Erase(this->database, INT_ZSET_ITEM, this->id, batch);
+        Kernel->Store->ZSets->Drop(this->database, this->id);
+
+        this->count = 0;
+        return this->Commit(batch);
+}
+
+bool ZSetStore::CopyTo(std::shared_ptr<Database> target, const std::string& newdest)
+{
+        ZSetStore copy(target, newdest);
+        copy.Create();
+        copy.count = this->count;
+
+        rocksdb::WriteBatch batch;
+
+        /* Members of a set being overwritten are removed. */
+
+        std::string previous;
+        ZSetStore replaced(target, newdest);
+
+        if (target->Get(target->Route(newdest), newdest, &previous).ok() && replaced.Load(previous))
+        {
+                Container::Erase(target, INT_ZSET_ITEM, replaced.id, batch);
+                Kernel->Store->ZSets->Drop(target, replaced.id);
+        }
+
+        Container::Copy(this->database, target, INT_ZSET_ITEM, this->id, copy.id, batch);
+        return copy.Commit(batch);
+}
@@ -0,0 +1,248 @@
+/*
+ * BerylDB - A lightweight database.
+ * http://www.beryldb.com
+ *
+ * Copyright (C) 2021 - Carlos F. Ferry <cferry@beryldb.com>
+ *
+ * This file is part of BerylDB. BerylDB is free software: you can
+ * redistribute it and/or modify it under the terms of the BSD License
+ * version 3.
+ *
+ * More information about our licensing can be found at https://docs.beryl.dev
+ */
+
+#include "beryl.h"
+#include "engine.h"
+#include "brldb/zset_store.h"
+
+namespace
+{
+        /* Loads the sorted set registered at query->dest. */
+
+        bool LoadZSet(QueryBase* query, ZSetStore& store)
+        {
+                const RocksData& result = query->Get(query->dest);
+
+                if (!result.status.ok() || !store.Load(result.value))
+                {
+                        query->access_set(DBL_NOT_FOUND);
+                        return false;
+                }
+
+                return true;
+        }
+
+        /* Adds members found to a query, as an array. */
+
+        void Attach(QueryBase* query, const ZSetItems& items)
+        {
+                for (ZSetItems::const_iterator i = items.begin(); i != items.end(); ++i)
+                {
+                        query->VecData.push_back(query->Quote(i->first));
+                }
+
+                query->subresult = 1;
+                query->SetOK();
+        }
+}
+
+void zadd_query::Run()
+{
+       double score;
+
+       if (this->hesh.empty() || !ZSetStore::ParseScore(this->value, score))
+       {
+             this->access_set(DBL_MISS_ARGS);
+             return;
+       }
+
+       const RocksData& result = this->Get(this->dest);
+       ZSetStore store(this->database, this->dest);
+
+       if (!result.status.ok() || !store.Load(result.value))
+       {
+               /* Create a new entry. */
+
+               store.Create();
+       }
+
+       if (store.Add(this->hesh, score) < 0)
+       {
+               access_set(DBL_UNABLE_WRITE);
+               return;
+       }
+
+       this->SetOK();
+}
+
+void zadd_query::Process()
+{
+       user->SendProtocol(BRLD_OK, PROCESS_OK);
+}
+
+void zrem_query::Run()
+{
+       ZSetStore store(this->database, this->dest);
+
+       if (!LoadZSet(this, store))
+       {
+               return;
+       }
+
+       if (!store.Remove(this->value))
+       {
+               access_set(DBL_NOT_FOUND);
+               return;
+       }
+
+       this->SetOK();
+}
+
+void zrem_query::Process()
+{
+       user->SendProtocol(BRLD_OK, PROCESS_OK);
+}
+
+void zscore_query::Run()
+{
+       ZSetStore store(this->database, this->dest);
+
+       if (!LoadZSet(this, store))
+       {
+               return;
+       }
+
+       double score;
+
+       if (!store.Score(this->value, score))
+       {
+               access_set(DBL_NOT_FOUND);
+               return;
+       }
+
+       this->response = ZSetStore::FormatScore(score);
+       this->SetOK();
+}
+
+void zscore_query::Process()
+{
+       user->SendProtocol(BRLD_OK, this->response);
+}
+
+void zcount_query::Run()
+{
+       ZSetStore store(this->database, this->dest);
+
+       if (!LoadZSet(this, store))
+       {
+               return;
+       }
+
+       this->counter = store.Count();
+       this->SetOK();
+}
+
+void zcount_query::Process()
+{
+       user->SendProtocol(BRLD_OK, convto_string(this->counter));
+}
+
+void zrank_query::Run()
+{
+       ZSetStore store(this->database, this->dest);
+
+       if (!LoadZSet(this, store))
+       {
+               return;
+       }
+
+       const signed long rank = store.Rank(this->value);
+
+       if (rank < 0)
+       {
+               access_set(DBL_NOT_FOUND);
+               return;
+       }
+
+       this->response = convto_string(rank);
+       this->SetOK();
+}
+
+void zrank_query::Process()
+{
+       user->SendProtocol(BRLD_OK, this->response);
+}
+
+void zrange_query::Run()
+{
+       ZSetStore store(this->database, this->dest);
+
+       if (!LoadZSet(this, store))
+       {
+               return;
+       }
+
+       ZSetItems items;
+       store.Range(this->offset, this->limit, items);
+       Attach(this, items);
+}
+
+void zrange_query::Process()
+{
+       Dispatcher::VectorFlush(false, "Member", this);
+}
+
+void zrangebyscore_query::Run()
+{
+       double min, max;
+
+       if (!ZSetStore::ParseScore(this->value, min) || !ZSetStore::ParseScore(this->hesh, max))
+       {
+               this->access_set(DBL_MISS_ARGS);
+               return;
+       }
+
+       ZSetStore store(this->database, this->dest);
+
+       if (!LoadZSet(this, store))
+       {
+               return;
+       }
+
+       ZSetItems items;
+       store.RangeByScore(min, max, items, store.Count());
+       Attach(this, items);
+}
+
+void zrangebyscore_query::Process()
+{
+       Dispatcher::VectorFlush(false, "Member", this);
+}
+
+void zpopmin_query::Run()
+{
+       ZSetStore store(this->database, this->dest);
+
+       if (!LoadZSet(this, store))
+       {
+               return;
+       }
+
+       ZSetItem item;
+
+       if (!store.PopMin(item))
+       {
+               access_set(DBL_UNABLE_WRITE);
+               return;
+       }
+
+       this->VecData.push_back(this->Quote(item.first));
+       this->VecData.push_back(ZSetStore::FormatScore(item.second));
+       this->subresult = 1;
+       this->SetOK();
+}
+
+void zpopmin_query::Process()
+{
+       Dispatcher::VectorFlush(false, "Member", this);
+}
@@ -89,6 +89,13 @@ Subscription* Channel::AddUser(User* user)
 	}
 
 	Subscription* member = new(added.first->second) Subscription(user, this);
+
+	if (IS_LOCAL(user))
+	{
+		member->local = locals.size();
+		locals.push_back(member);
+	}
+
 	return member;
 }
 
@@ -105,6 +112,17 @@ void Channel::DeleteUser(User* user)
 void Channel::DeleteUser(const SubscriptionMap::iterator& subsiter)
 {
 	Subscription* subs = subsiter->second;
+
+	if (IS_LOCAL(subsiter->first))
+	{
+		/* Last local takes the place of the one removed. */
+
+		Subscription* const moved = locals.back();
+		moved->local = subs->local;
+		locals[subs->local] = moved;
+		locals.pop_back();
+	}
+
 	subs->discard();
 	subs->~Subscription();
 	subscribedlist.erase(subsiter);
@@ -243,11 +261,16 @@ bool Channel::PartUser(User* user)
 
 void Channel::Write(ProtocolTrigger::Event& protoev, char status, const DiscardList& except_list, User* joining)
 {
-	for (SubscriptionMap::iterator i = subscribedlist.begin(); i != subscribedlist.end(); i++)
+	/* 
+	 * Serializations are cached in protoev's messages, so every local
+	 * user shares the same buffer (see LocalUser::Write).
+	 */
+
+	for (std::vector<Subscription*>::const_iterator i = locals.begin(); i != locals.end(); ++i)
 	{
-		LocalUser* user = IS_LOCAL(i->first);
+		LocalUser* user = static_cast<LocalUser*>((*i)->user);
 
-		if ((user) && (!except_list.count(user)))
+		if (except_list.empty() || !except_list.count(user))
 		{
 			user->Send(protoev);
 		}
@@ -429,10 +429,21 @@ void CommandHandler::ProcessBuffer(LocalUser* user, const std::string& buffer)
 		return;
 	}
 
+	this->ProcessOutput(user, parseoutput);
+}
+
+void CommandHandler::ProcessOutput(LocalUser* user, ProtocolTrigger::ParseOutput& parseoutput)
+{
         std::string& command = parseoutput.cmd;
+
+        if (command.empty())
+        {
+                return;
+        }
+
         std::transform(command.begin(), command.end(), command.begin(), ::toupper);
 
-	CommandModel::Params parameters(parseoutput.params, parseoutput.tags);
+	CommandModel::Params parameters(std::move(parseoutput.params), std::move(parseoutput.tags));
   
         this->Queue->Add(user, command, parameters);
 }
@@ -537,22 +548,21 @@ void CommandQueue::Add(LocalUser* user, const std::string& command, CommandModel
              return;
         }
 
-        PendingCMD adding(user, cmd_params, command);
+        PendingCMD adding(user, std::move(cmd_params), command);
 
         if (command == "PONG")
         {       
-                user->PendingList.push_back(adding);
+                user->PendingList.push_back(std::move(adding));
                 return;
         }
 
         if (command == "MULTIRESET")
         {
 		user->PendingMulti.clear();
-		user->MultiRunning = false;
 	}
 	else
 	{        
-	        if (user->Multi && command == "MULTI")
+	        if (user->Multi && (command == "MULTI" || command == "WATCH"))
 	        {
                 	user->SendProtocol(ERR_INPUT2, ERR_MULTI, PROCESS_ERROR);
                 	return;
@@ -560,7 +570,7 @@ void CommandQueue::Add(LocalUser* user, const std::string& command, CommandModel
 
 	        if (user->Multi && command != "MRUN")
 	        {
-	      		user->PendingMulti.push_back(adding);
+	      		user->PendingMulti.push_back(std::move(adding));
 	      		user->SendProtocol(BRLD_OK, "QUEUED");
 	      		return;
 		}
@@ -572,7 +582,7 @@ void CommandQueue::Add(LocalUser* user, const std::string& command, CommandModel
 	        }
 	}
         
-        user->PendingList.push_back(adding);
+        user->PendingList.push_back(std::move(adding));
 }
 
 void CommandQueue::Reset()
@@ -592,19 +602,48 @@ void CommandQueue::Reset()
 	}
 }
 
-void CommandQueue::Flush()
+void CommandQueue::Transaction(LocalUser* user)
+{
+       std::shared_ptr<transaction_query> query = QueryPool::Make<transaction_query>();
+       query->watching.swap(user->Watching);
+       query->epoch = user->WatchEpoch;
+
+       user->Multi = false;
+       user->Transaction = query;
+
+       /* Queries of these commands are queued into this transaction (see DataFlush::Queue). */
+
+       while (user->PendingMulti.size() && !user->IsQuitting())
+       {
+               PendingCMD event = std::move(user->PendingMulti.front());
+               user->PendingMulti.pop_front();
+
+               Kernel->Commander->Execute(user, event.command, event.cmd_params);
+               Kernel->Interval->Incr();
+       }
+
+       user->PendingMulti.clear();
+       user->Transaction = NULL;
+
+       Helpers::make_query(user, query);
+       Kernel->Store->Push(query);
+}
+
+bool CommandQueue::Flush()
 {
        if (!Kernel->Ready)
        {
-        	return;
+        	return false;
        }
        
        const ClientManager::LocalList& users = Kernel->Clients->GetLocals();
        
        if (!users.size())
        {
-               return;
+               return false;
        }
+
+       bool ran = false;
       
        for (ClientManager::LocalList::const_iterator u = users.begin(); u != users.end(); ++u)
        {
@@ -625,45 +664,59 @@ void CommandQueue::Flush()
                      continue;
                }
                
-               PendingCMD event = user->PendingList.front();
+               /* 
+                * Runs up to <settings:pipeline> commands of this user. Replies are written
+                * in the same order commands were received (see LocalUser::Write).
+                */
 
-               /* PONGS are allowed at any time when processing queries, even when locked. */
-
-               if (event.command == "PONG")
+               for (unsigned int count = 0; count < Kernel->Config->Pipeline && user->PendingList.size() && !user->IsQuitting(); count++)
                {
+                       /* Commands are moved out of the queue only once they run, as parameters may be large. */
+
+                       PendingCMD& next = user->PendingList.front();
+
+                       /* PONGS are allowed at any time when processing queries, even when locked. */
+
+                       if (next.command == "PONG")
+                       {
+                               PendingCMD event = std::move(next);
+                               user->PendingList.pop_front();
+                               Kernel->Commander->Execute(user, event.command, event.cmd_params);
+                               ran = true;
+                               continue;
+                       }
+
+                       /* 
+                        * Only queries on a single key are pipelined. Commands following an
+                        * exclusive query wait until its result is delivered (see DataFlush::Ready).
+                        */
+
+                       if (user->AwaitingExclusive())
+                       {
+                               break;
+                       }
+
+                       /* Too many queries awaiting results. */
+
+                       if (user->Outstanding() >= Kernel->Config->DB.depth)
+                       {
+                               break;
+                       }
+
+                       /* Commands sent after LOGIN wait until its password is verified. */
+
+                       if (user->registered != REG_OK && user->Outstanding())
+                       {
+                               break;
+                       }
+
+                       PendingCMD event = std::move(next);
                        user->PendingList.pop_front();
                        Kernel->Commander->Execute(user, event.command, event.cmd_params);
-                       return;
+                       Kernel->Interval->Incr();
+                       ran = true;
                }
-                  
-               if (user->IsLocked())
-               {
-                 	continue; 
-               }
-               
-               if (user->Multi && event.command == "MRUN")
-               {
-	               	user->MultiRunning = true;
-	               	user->Multi = false;
-	       }
-	       
-	       if (user->MultiRunning)
-	       {        
-  		      if (!user->PendingMulti.size())
-                      {
-                           user->MultiRunning = false;
-                           continue;
-                      }
-
-	       	      PendingCMD m_event = user->PendingMulti.front();
-	       	      Kernel->Commander->Execute(user, m_event.command, m_event.cmd_params);
-	              Kernel->Interval->Incr();
-	              user->PendingMulti.pop_front();
-	              continue;
-	        }
-               
-	       user->PendingList.pop_front();
-               Kernel->Commander->Execute(user, event.command, event.cmd_params);
-               Kernel->Interval->Incr();
         }
+
+        return ran;
 }
@@ -226,9 +226,13 @@ void Configuration::Fill()
 	
 	KeepFutures =  ttls->as_bool("futures", true);
         KeepExpires =  ttls->as_bool("expires", true);
+        ExpireBatch =  ttls->as_uint("batch", 5000, 1);
+        LazyExpire  =  ttls->as_bool("lazy", true);
         
 	
 	MaxClients = settings->as_uint("maxclients", 1500);
+	Pipeline = settings->as_uint("pipeline", 64, 1, 4096);
+	AuthThreads = settings->as_uint("auththreads", 2, 1, 64);
 	
 	Network = server->as_string("network", "Network", 1);
 	ModifiedVersion = settings->as_string("customversion");
@@ -285,8 +289,38 @@ void Configuration::CheckDatabases()
         DB.datathread = databases->as_uint("threads", 2, 1, CORE_COUNT, true);
         DB.increaseparal = databases->as_uint("parallels", 2, 1, 5, true);        
         DB.yieldusec = databases->as_uint("yield_usec", 20, 0, 100000, true);        
+        DB.depth = databases->as_uint("depth", 32, 1, 1024, true);
+        DB.spin = databases->as_uint("spin", 1000, 0, 1000000, true);
+        DB.pinthreads = databases->as_bool("pin", false);
         DB.createim = databases->as_bool("createim", true);        
         DB.pipeline = databases->as_bool("pipeline", true);        
+        DB.migrate = databases->as_bool("migrate", true);
+
+        config_rule* tuning = GetConf("dbtuning");
+        DB.cachesize = tuning->as_uint("cache", 64, 0, 1048576);
+        DB.cachetype = tuning->as_string("cachetype", "lru");
+        DB.bloombits = tuning->as_uint("bloombits", 10, 0, 64);
+        DB.wholekey = tuning->as_bool("wholekey", true);
+        DB.compression = tuning->as_string("compression", "lz4");
+        DB.bottommost = tuning->as_string("bottommost", "zstd");
+        DB.writebuffer = tuning->as_uint("writebuffer", 256, 0, 1048576);
+        DB.hotkeys = tuning->as_uint("hotkeys", 0, 0, 16777216);
+        DB.zsetitems = tuning->as_uint("zsetitems", 1000000, 0, UINT32_MAX);
+
+        if (!stdhelpers::string::equalsci(DB.cachetype, "lru") && !stdhelpers::string::equalsci(DB.cachetype, "hyperclock"))
+        {
+                throw KernelException("<dbtuning:cachetype> must be set to 'lru' or 'hyperclock'");
+        }
+
+        const std::string compressions[] = { DB.compression, DB.bottommost };
+
+        for (unsigned int i = 0; i < 2; i++)
+        {
+                if (!stdhelpers::string::equalsci(compressions[i], "none") && !stdhelpers::string::equalsci(compressions[i], "lz4") && !stdhelpers::string::equalsci(compressions[i], "zstd"))
+                {
+                        throw KernelException("<dbtuning:" + std::string(i ? "bottommost" : "compression") + "> must be set to 'none', 'lz4' or 'zstd'");
+                }
+        }
 }
 
 void Configuration::SetAll()
@@ -43,7 +43,7 @@ COMMAND_RESULT CommandSFlush::Handle(User* user, const Params& parameters)
               return FAILED;
        }
        
-       KeyHelper::Simple(user, std::make_shared<sflush_query>(), select, "", false);
+       KeyHelper::Simple(user, QueryPool::Make<sflush_query>(), select, "", false);
        return SUCCESS;
 }
 
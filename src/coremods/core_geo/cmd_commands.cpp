@@ -14,6 +14,26 @@
 #include "beryl.h"
 #include "core_geo.h"
 
+namespace
+{
+        bool CheckPosition(User* user, const std::string& latitude, const std::string& longitude)
+        {
+                if (!is_number(latitude, true) || !is_number(longitude, true))
+                {
+                        user->SendProtocol(ERR_INPUT, MUST_BE_NUMERIC);
+                        return false;
+                }
+
+                if (!ValidLat(convto_num<int>(latitude)) || !ValidLong(convto_num<int>(longitude)))
+                {
+                        user->SendProtocol(ERR_INPUT, INVALID_COORD);
+                        return false;
+                }
+
+                return true;
+        }
+}
+
 CommandGeoAddPub::CommandGeoAddPub(Module* Creator) : Command(Creator, "GAPUB", 4, 4)
 {
         check_key       =       0;
@@ -44,7 +64,7 @@ COMMAND_RESULT CommandGeoAddPub::Handle(User* user, const Params& parameters)
               return FAILED;
        }
 
-       KeyHelper::AddPub(user, std::make_shared<geoadd_pub_query>(), parameters[1], parameters[0], latitude, longitude);
+       KeyHelper::AddPub(user, QueryPool::Make<geoadd_pub_query>(), parameters[1], parameters[0], latitude, longitude);
        return SUCCESS;
 }
 
@@ -78,7 +98,7 @@ COMMAND_RESULT CommandGeoAdd::Handle(User* user, const Params& parameters)
              return FAILED;
        }
        
-       KeyHelper::HeshVal(user, std::make_shared<geoadd_query>(), parameters[0], latitude, longitude);
+       KeyHelper::HeshVal(user, QueryPool::Make<geoadd_query>(), parameters[0], latitude, longitude);
        return SUCCESS;
 }
 
@@ -112,7 +132,40 @@ COMMAND_RESULT CommandGeoAddNX::Handle(User* user, const Params& parameters)
              return FAILED;
        }
 
-       KeyHelper::HeshVal(user, std::make_shared<geoaddnx_query>(), parameters[0], latitude, longitude);
+       KeyHelper::HeshVal(user, QueryPool::Make<geoaddnx_query>(), parameters[0], latitude, longitude);
+       return SUCCESS;
+}
+
+CommandGeoMAdd::CommandGeoMAdd(Module* Creator) : Command(Creator, "GEOMADD", 3)
+{
+         group  	 = 	'g';
+         syntax 	 = 	"<name> <latitude> <longitude> <name> <latitude> <longitude> ...";
+}
+
+COMMAND_RESULT CommandGeoMAdd::Handle(User* user, const Params& parameters)
+{
+       if (parameters.size() % 3)
+       {
+              user->SendProtocol(ERR_INPUT, MIS_ARGS);
+              return FAILED;
+       }
+
+       std::shared_ptr<geomadd_query> query = QueryPool::Make<geomadd_query>();
+       query->list.reserve(parameters.size() / 3);
+       query->positions.reserve(parameters.size() / 3);
+
+       for (Params::const_iterator i = parameters.begin(); i != parameters.end(); i += 3)
+       {
+              if (!CheckKey(user, *i) || !CheckPosition(user, *(i + 1), *(i + 2)))
+              {
+                     return FAILED;
+              }
+
+              query->list.push_back(*i);
+              query->positions.push_back(std::make_pair(convto_num<double>(*(i + 1)), convto_num<double>(*(i + 2))));
+       }
+
+       KeyHelper::Quick(user, query);
        return SUCCESS;
 }
 
@@ -125,7 +178,7 @@ CommandGeoGet::CommandGeoGet(Module* Creator) : Command(Creator, "GEOGET", 1, 1)
 
 COMMAND_RESULT CommandGeoGet::Handle(User* user, const Params& parameters)
 {
-       KeyHelper::Retro(user, std::make_shared<geoget_query>(), parameters[0]);
+       KeyHelper::Retro(user, QueryPool::Make<geoget_query>(), parameters[0]);
        return SUCCESS;
 }
 
@@ -139,7 +192,7 @@ CommandGFind::CommandGFind(Module* Creator) : Command(Creator, "GKEYS", 1, 3)
 
 COMMAND_RESULT CommandGFind::Handle(User* user, const Params& parameters)
 {  
-       KeyHelper::RetroLimits(user, std::make_shared<gkeys_query>(), parameters[0], this->offset, this->limit);
+       KeyHelper::RetroLimits(user, QueryPool::Make<gkeys_query>(), parameters[0], this->offset, this->limit);
        return SUCCESS;
 }
 
@@ -151,7 +204,7 @@ CommandGeoCalc::CommandGeoCalc(Module* Creator) : Command(Creator, "GCALC", 2, 2
 
 COMMAND_RESULT CommandGeoCalc::Handle(User* user, const Params& parameters)
 {  
-         KeyHelper::Simple(user, std::make_shared<geocalc_query>(), parameters[1], parameters[0], false);
+         KeyHelper::Simple(user, QueryPool::Make<geocalc_query>(), parameters[1], parameters[0], false);
          return SUCCESS;
 }
 
@@ -165,7 +218,7 @@ CommandGeoDistance::CommandGeoDistance(Module* Creator) : Command(Creator, "GDIS
 
 COMMAND_RESULT CommandGeoDistance::Handle(User* user, const Params& parameters)
 {  
-       std::shared_ptr<geodistance_query> query = std::make_shared<geodistance_query>();
+       std::shared_ptr<geodistance_query> query = QueryPool::Make<geodistance_query>();
        query->value 				= parameters[1]; 
        
        KeyHelper::RetroLimits(user, query, parameters[0], this->offset, this->limit);
@@ -180,7 +233,7 @@ CommandGeoRemove::CommandGeoRemove(Module* Creator) : Command(Creator, "GREM", 2
 
 COMMAND_RESULT CommandGeoRemove::Handle(User* user, const Params& parameters)
 {  
-         KeyHelper::SimpleRetro(user, std::make_shared<georem_query>(), parameters[0], parameters[1]);
+         KeyHelper::SimpleRetro(user, QueryPool::Make<georem_query>(), parameters[0], parameters[1]);
          return SUCCESS;
 }
 
@@ -193,7 +246,7 @@ CommandGeoLoGet::CommandGeoLoGet(Module* Creator) : Command(Creator, "GLOGET", 1
 
 COMMAND_RESULT CommandGeoLoGet::Handle(User* user, const Params& parameters)
 {
-       KeyHelper::SimpleType(user, std::make_shared<geoget_custom_query>(), parameters[0], QUERY_TYPE_LONG);
+       KeyHelper::SimpleType(user, QueryPool::Make<geoget_custom_query>(), parameters[0], QUERY_TYPE_LONG);
        return SUCCESS;
 }
 
@@ -206,6 +259,95 @@ CommandGeoLaGet::CommandGeoLaGet(Module* Creator) : Command(Creator, "GLAGET", 1
 
 COMMAND_RESULT CommandGeoLaGet::Handle(User* user, const Params& parameters)
 {       
-       KeyHelper::SimpleType(user, std::make_shared<geoget_custom_query>(), parameters[0], QUERY_TYPE_LAT);
+       KeyHelper::SimpleType(user, QueryPool::Make<geoget_custom_query>(), parameters[0], QUERY_TYPE_LAT);
+       return SUCCESS;
+}
+
+CommandGRadius::CommandGRadius(Module* Creator) : Command(Creator, "GRADIUS", 3, 5)
+{
+         run_conf	=	true;
+         group 		= 	'g';
+         syntax 	= 	"<latitude> <longitude> <radius> <offset> <limit>";
+}
+
+COMMAND_RESULT CommandGRadius::Handle(User* user, const Params& parameters)
+{  
+       const std::string& radius 	= 	parameters[2];
+
+       if (!CheckPosition(user, parameters[0], parameters[1]))
+       {
+              return FAILED;
+       }
+
+       if (!is_number(radius, true) || !(convto_num<double>(radius) > 0))
+       {
+              user->SendProtocol(ERR_INPUT, MUST_BE_POSIT);
+              return FAILED;
+       }
+
+       std::shared_ptr<gradius_query> query = QueryPool::Make<gradius_query>();
+       query->latitude 			= convto_num<double>(parameters[0]);
+       query->longitude 		= convto_num<double>(parameters[1]);
+       query->radius 			= convto_num<double>(radius);
+       query->offset 			= this->offset;
+       query->limit 			= this->limit;
+
+       KeyHelper::Quick(user, query);
+       return SUCCESS;
+}
+
+CommandGBox::CommandGBox(Module* Creator) : Command(Creator, "GBOX", 4, 6)
+{
+         run_conf	=	true;
+         group 		= 	'g';
+         syntax 	= 	"<min latitude> <min longitude> <max latitude> <max longitude> <offset> <limit>";
+}
+
+COMMAND_RESULT CommandGBox::Handle(User* user, const Params& parameters)
+{  
+       if (!CheckPosition(user, parameters[0], parameters[1]) || !CheckPosition(user, parameters[2], parameters[3]))
+       {
+              return FAILED;
+       }
+
+       std::shared_ptr<gbox_query> query = QueryPool::Make<gbox_query>();
+       query->minlat 			= convto_num<double>(parameters[0]);
+       query->minlon 			= convto_num<double>(parameters[1]);
+       query->maxlat 			= convto_num<double>(parameters[2]);
+       query->maxlon 			= convto_num<double>(parameters[3]);
+       query->offset 			= this->offset;
+       query->limit 			= this->limit;
+
+       if (query->minlat > query->maxlat)
+       {
+              user->SendProtocol(ERR_INPUT, INVALID_COORD);
+              return FAILED;
+       }
+
+       KeyHelper::Quick(user, query);
+       return SUCCESS;
+}
+
+CommandGNearest::CommandGNearest(Module* Creator) : Command(Creator, "GNEAREST", 3, 3)
+{
+         group 		= 	'g';
+         syntax 	= 	"<latitude> <longitude> <count>";
+}
+
+COMMAND_RESULT CommandGNearest::Handle(User* user, const Params& parameters)
+{  
+       const std::string& count 	= 	parameters[2];
+
+       if (!CheckPosition(user, parameters[0], parameters[1]) || !CheckValidPos(user, count))
+       {
+              return FAILED;
+       }
+
+       std::shared_ptr<gnearest_query> query = QueryPool::Make<gnearest_query>();
+       query->latitude 			= convto_num<double>(parameters[0]);
+       query->longitude 		= convto_num<double>(parameters[1]);
+       query->limit 			= convto_num<signed int>(count);
+
+       KeyHelper::Quick(user, query);
        return SUCCESS;
 }
@@ -28,6 +28,10 @@ class CoreModuleGeo : public Module
         CommandGeoLoGet  	cmdgeologet;
         CommandGeoAddPub 	cmdgapub;
         CommandGeoAddNX  	cmdgeoaddnx;
+        CommandGeoMAdd  	cmdgeomadd;
+        CommandGRadius  	cmdgradius;
+        CommandGBox  		cmdgbox;
+        CommandGNearest  	cmdgnearest;
         
     public:     
         
@@ -40,7 +44,11 @@ class CoreModuleGeo : public Module
                           cmdgeolaget(this),
                           cmdgeologet(this),
                           cmdgapub(this),
-                          cmdgeoaddnx(this)
+                          cmdgeoaddnx(this),
+                          cmdgeomadd(this),
+                          cmdgradius(this),
+                          cmdgbox(this),
+                          cmdgnearest(this)
         {
         
         }
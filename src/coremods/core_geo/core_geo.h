@@ -66,6 +66,31 @@ class CommandGeoAddNX : public Command
         COMMAND_RESULT Handle(User* user, const Params& parameters);
 };
 
+/* 
+ * Adds many geo-keys at once. All positions, along with their
+ * index entries, are written in a single batch.
+ * 
+ * @parameters:
+ *
+ *         · string      :  Name to this geo key.
+ *         · string      :  Valid latitude.
+ *         · string      :  Valid longitude.
+ *           ....
+ * 
+ * @protocol:
+ *
+ *         · int	 :  Geo keys written.
+ */ 
+
+class CommandGeoMAdd : public Command 
+{
+    public: 
+
+        CommandGeoMAdd(Module* parent);
+
+        COMMAND_RESULT Handle(User* user, const Params& parameters);
+};
+
 /* 
  * Adds a new geo-key and then publishes it to a channel.
  * 
@@ -221,3 +246,77 @@ class CommandGeoLaGet : public Command
         COMMAND_RESULT Handle(User* user, const Params& parameters);
 };
 
+
+/* 
+ * Finds geo keys within a distance of a position, closest first.
+ * Only the cells of the geo index covering this area are visited.
+ * 
+ * @parameters:
+ *
+ *         · string     : Latitude.
+ *         · string     : Longitude.
+ *         · string     : Radius, as expressed in kilometers.
+ *         · { offset, limit }
+ * 
+ * @protocol:
+ *
+ *         · vector     : Geo keys found.
+ */ 
+
+class CommandGRadius : public Command 
+{
+    public: 
+
+        CommandGRadius(Module* parent);
+
+        COMMAND_RESULT Handle(User* user, const Params& parameters);
+};
+
+/* 
+ * Finds geo keys within a box. Boxes whose lowest longitude is higher
+ * than their highest one cross the antimeridian.
+ * 
+ * @parameters:
+ *
+ *         · string     : Lowest latitude.
+ *         · string     : Lowest longitude.
+ *         · string     : Highest latitude.
+ *         · string     : Highest longitude.
+ *         · { offset, limit }
+ * 
+ * @protocol:
+ *
+ *         · vector     : Geo keys found.
+ */ 
+
+class CommandGBox : public Command 
+{
+    public: 
+
+        CommandGBox(Module* parent);
+
+        COMMAND_RESULT Handle(User* user, const Params& parameters);
+};
+
+/* 
+ * Finds closest geo keys to a position, closest first.
+ * 
+ * @parameters:
+ *
+ *         · string     : Latitude.
+ *         · string     : Longitude.
+ *         · int        : Geo keys to find.
+ * 
+ * @protocol:
+ *
+ *         · vector     : Geo keys found.
+ */ 
+
+class CommandGNearest : public Command 
+{
+    public: 
+
+        CommandGNearest(Module* parent);
+
+        COMMAND_RESULT Handle(User* user, const Params& parameters);
+};
@@ -51,7 +51,7 @@ CommandRename::CommandRename(Module* Creator) : Command(Creator, "RENAME", 2, 2)
 
 COMMAND_RESULT CommandRename::Handle(User* user, const Params& parameters)
 {  
-       KeyHelper::SimpleRetro(user, std::make_shared<rename_query>(), parameters[0], parameters[1]);
+       KeyHelper::SimpleRetro(user, QueryPool::Make<rename_query>(), parameters[0], parameters[1]);
        return SUCCESS;
 }
 
@@ -65,7 +65,7 @@ CommandRenameNX::CommandRenameNX(Module* Creator) : Command(Creator, "RENAMENX",
 
 COMMAND_RESULT CommandRenameNX::Handle(User* user, const Params& parameters)
 {  
-       KeyHelper::SimpleRetro(user, std::make_shared<renamenx_query>(), parameters[0], parameters[1]);
+       KeyHelper::SimpleRetro(user, QueryPool::Make<renamenx_query>(), parameters[0], parameters[1]);
        return SUCCESS;
 }
 
@@ -77,7 +77,7 @@ CommandDel::CommandDel(Module* Creator) : Command(Creator, "DEL", 1)
 
 COMMAND_RESULT CommandDel::Handle(User* user, const Params& parameters)
 {  
-       KeyHelper::Retro(user, std::make_shared<del_query>(), parameters[0]);
+       KeyHelper::Retro(user, QueryPool::Make<del_query>(), parameters[0]);
        return SUCCESS;
 }
 
@@ -91,7 +91,7 @@ CommandCopy::CommandCopy(Module* Creator) : Command(Creator, "COPY", 2, 2)
 
 COMMAND_RESULT CommandCopy::Handle(User* user, const Params& parameters)
 {  
-       KeyHelper::SimpleRetro(user, std::make_shared<copy_query>(), parameters[0], parameters[1]);
+       KeyHelper::SimpleRetro(user, QueryPool::Make<copy_query>(), parameters[0], parameters[1]);
        return SUCCESS;
 }
 
@@ -104,7 +104,7 @@ CommandExists::CommandExists(Module* Creator) : Command(Creator, "EXISTS", 1, 1)
 
 COMMAND_RESULT CommandExists::Handle(User* user, const Params& parameters)
 {  
-       KeyHelper::Retro(user, std::make_shared<exists_query>(), parameters[0]);
+       KeyHelper::Retro(user, QueryPool::Make<exists_query>(), parameters[0]);
        return SUCCESS;
 }
 
@@ -129,7 +129,7 @@ COMMAND_RESULT CommandMove::Handle(User* user, const Params& parameters)
                return FAILED;
        }
 
-       KeyHelper::Simple(user, std::make_shared<move_query>(), parameters[0], new_select, false);
+       KeyHelper::Simple(user, QueryPool::Make<move_query>(), parameters[0], new_select, false);
        return SUCCESS;
 }
 
@@ -141,7 +141,7 @@ CommandType::CommandType(Module* Creator) : Command(Creator, "TYPE", 1, 1)
 
 COMMAND_RESULT CommandType::Handle(User* user, const Params& parameters)
 {  
-       KeyHelper::SimpleType(user, std::make_shared<type_query>(),  parameters[0], QUERY_TYPE_TYPE);
+       KeyHelper::SimpleType(user, QueryPool::Make<type_query>(),  parameters[0], QUERY_TYPE_TYPE);
        return SUCCESS;
 }
 
@@ -154,7 +154,7 @@ CommandTouch::CommandTouch(Module* Creator) : Command(Creator, "TOUCH", 1, 1)
 
 COMMAND_RESULT CommandTouch::Handle(User* user, const Params& parameters)
 {  
-        KeyHelper::Simple(user, std::make_shared<touch_query>(), "", parameters.back(), false);
+        KeyHelper::Simple(user, QueryPool::Make<touch_query>(), "", parameters.back(), false);
         return SUCCESS;
 }
 
@@ -167,7 +167,7 @@ CommandNTouch::CommandNTouch(Module* Creator) : Command(Creator, "NTOUCH", 1, 1)
 
 COMMAND_RESULT CommandNTouch::Handle(User* user, const Params& parameters)
 {  
-        KeyHelper::Simple(user, std::make_shared<ntouch_query>(), "", parameters.back(), false);
+        KeyHelper::Simple(user, QueryPool::Make<ntouch_query>(), "", parameters.back(), false);
         return SUCCESS;
 }
 
@@ -192,7 +192,7 @@ COMMAND_RESULT CommandClone::Handle(User* user, const Params& parameters)
                return FAILED;
        }
 
-       KeyHelper::SimpleRetro(user, std::make_shared<clone_query>(), parameters[0], value);
+       KeyHelper::SimpleRetro(user, QueryPool::Make<clone_query>(), parameters[0], value);
        return SUCCESS;
 }
 
@@ -206,7 +206,7 @@ CommandDiff::CommandDiff(Module* Creator) : Command(Creator, "DIFF", 2, 4)
 
 COMMAND_RESULT CommandDiff::Handle(User* user, const Params& parameters)
 {  
-       std::shared_ptr<diff_query> query = std::make_shared<diff_query>();
+       std::shared_ptr<diff_query> query = QueryPool::Make<diff_query>();
        query->value 			 = parameters[1];
 
        KeyHelper::RetroLimits(user, query, parameters[0], this->offset, this->limit);
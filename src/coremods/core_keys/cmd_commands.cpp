@@ -23,7 +23,7 @@ CommandKeys::CommandKeys(Module* Creator) : Command(Creator, "KEYS", 1, 3)
 
 COMMAND_RESULT CommandKeys::Handle(User* user, const Params& parameters)
 {  
-       KeyHelper::RetroLimits(user, std::make_shared<keys_query>(), parameters[0], this->offset, this->limit, true);
+       KeyHelper::RetroLimits(user, QueryPool::Make<keys_query>(), parameters[0], this->offset, this->limit, true);
        return SUCCESS;
 }
 
@@ -36,7 +36,7 @@ CommandSearch::CommandSearch(Module* Creator) : Command(Creator, "SEARCH", 1, 3)
 
 COMMAND_RESULT CommandSearch::Handle(User* user, const Params& parameters)
 {  
-       KeyHelper::RetroLimits(user, std::make_shared<search_query>(), parameters[0], this->offset, this->limit, true);
+       KeyHelper::RetroLimits(user, QueryPool::Make<search_query>(), parameters[0], this->offset, this->limit, true);
        return SUCCESS;
 }
 
@@ -47,6 +47,83 @@ CommandRKey::CommandRKey(Module* Creator) : Command(Creator, "RKEY", 0, 0)
 
 COMMAND_RESULT CommandRKey::Handle(User* user, const Params& parameters)
 {
-       KeyHelper::Quick(user, std::make_shared<random_query>());
+       KeyHelper::Quick(user, QueryPool::Make<random_query>());
+       return SUCCESS;
+}
+
+CommandMGetKeys::CommandMGetKeys(Module* Creator) : Command(Creator, "MGETKEYS", 1)
+{
+         group  	= 	'k';
+         syntax 	= 	"<key> <key> ...";
+}
+
+COMMAND_RESULT CommandMGetKeys::Handle(User* user, const Params& parameters)
+{  
+       for (Params::const_iterator i = parameters.begin(); i != parameters.end(); ++i)
+       {
+              if (!CheckKey(user, *i))
+              {
+                     return FAILED;
+              }
+       }
+
+       std::shared_ptr<mgetkeys_query> query = QueryPool::Make<mgetkeys_query>();
+       query->list.assign(parameters.begin(), parameters.end());
+
+       KeyHelper::Quick(user, query);
+       return SUCCESS;
+}
+
+CommandMSetKeys::CommandMSetKeys(Module* Creator) : Command(Creator, "MSETKEYS", 2)
+{
+         group  	= 	'k';
+         syntax 	= 	"<key> \"value\" <key> \"value\" ...";
+}
+
+COMMAND_RESULT CommandMSetKeys::Handle(User* user, const Params& parameters)
+{  
+       if (parameters.size() % 2)
+       {
+              user->SendProtocol(ERR_INPUT, MIS_ARGS);
+              return FAILED;
+       }
+
+       std::shared_ptr<msetkeys_query> query = QueryPool::Make<msetkeys_query>();
+
+       for (Params::const_iterator i = parameters.begin(); i != parameters.end(); i += 2)
+       {
+              if (!CheckKey(user, *i) || !CheckFormat(user, *(i + 1)))
+              {
+                     return FAILED;
+              }
+
+              query->list.push_back(*i);
+              query->VecData.push_back(stripe(user, *(i + 1)));
+       }
+
+       KeyHelper::Quick(user, query);
+       return SUCCESS;
+}
+
+CommandMDelKeys::CommandMDelKeys(Module* Creator) : Command(Creator, "MDELKEYS", 1)
+{
+         group  	= 	'k';
+         syntax 	= 	"<key> <key> ...";
+}
+
+COMMAND_RESULT CommandMDelKeys::Handle(User* user, const Params& parameters)
+{  
+       for (Params::const_iterator i = parameters.begin(); i != parameters.end(); ++i)
+       {
+              if (!CheckKey(user, *i))
+              {
+                     return FAILED;
+              }
+       }
+
+       std::shared_ptr<mdelkeys_query> query = QueryPool::Make<mdelkeys_query>();
+       query->list.assign(parameters.begin(), parameters.end());
+
+       KeyHelper::Quick(user, query);
        return SUCCESS;
 }
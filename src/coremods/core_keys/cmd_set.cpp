@@ -31,7 +31,7 @@ COMMAND_RESULT CommandChar::Handle(User* user, const Params& parameters)
                 return FAILED;
        }
        
-       KeyHelper::Simple(user, std::make_shared<char_query>(), parameters[0], value, false);
+       KeyHelper::Simple(user, QueryPool::Make<char_query>(), parameters[0], value, false);
        return SUCCESS;
 }
 
@@ -45,7 +45,7 @@ CommandSet::CommandSet(Module* Creator) : Command(Creator, "SET", 2, 2)
 
 COMMAND_RESULT CommandSet::Handle(User* user, const Params& parameters)
 {  
-       KeyHelper::Simple(user, std::make_shared<set_query>(), parameters[0], parameters.back());
+       KeyHelper::Simple(user, QueryPool::Make<set_query>(), parameters[0], parameters.back());
        return SUCCESS;
 }
 
@@ -59,7 +59,7 @@ CommandSetNX::CommandSetNX(Module* Creator) : Command(Creator, "SETNX", 2, 2)
 
 COMMAND_RESULT CommandSetNX::Handle(User* user, const Params& parameters)
 {  
-       KeyHelper::Simple(user, std::make_shared<setnx_query>(), parameters[0], parameters.back());
+       KeyHelper::Simple(user, QueryPool::Make<setnx_query>(), parameters[0], parameters.back());
        return SUCCESS;
 }
 
@@ -73,7 +73,7 @@ CommandSetTX::CommandSetTX(Module* Creator) : Command(Creator, "SETTX", 2, 2)
 
 COMMAND_RESULT CommandSetTX::Handle(User* user, const Params& parameters)
 {  
-       KeyHelper::Simple(user, std::make_shared<settx_query>(), parameters[0], parameters.back());
+       KeyHelper::Simple(user, QueryPool::Make<settx_query>(), parameters[0], parameters.back());
        return SUCCESS;
 }
 
@@ -87,7 +87,7 @@ CommandGetSet::CommandGetSet(Module* Creator) : Command(Creator, "GETSET", 2, 2)
 
 COMMAND_RESULT CommandGetSet::Handle(User* user, const Params& parameters)
 {  
-       KeyHelper::Simple(user, std::make_shared<getset_query>(), parameters[0], parameters.back());
+       KeyHelper::Simple(user, QueryPool::Make<getset_query>(), parameters[0], parameters.back());
        return SUCCESS;
 }
 
@@ -101,7 +101,7 @@ CommandAppend::CommandAppend(Module* Creator) : Command(Creator, "APPEND", 2, 2)
 
 COMMAND_RESULT CommandAppend::Handle(User* user, const Params& parameters)
 {  
-       KeyHelper::Simple(user, std::make_shared<append_query>(), parameters[0], parameters.back());
+       KeyHelper::Simple(user, QueryPool::Make<append_query>(), parameters[0], parameters.back());
        return SUCCESS;
 }
 
@@ -126,7 +126,7 @@ COMMAND_RESULT CommandCount::Handle(User* user, const Params& parameters)
              key = parameters[0];
        }
        
-       KeyHelper::Retro(user, std::make_shared<count_query>(), key, true);
+       KeyHelper::Retro(user, QueryPool::Make<count_query>(), key, true);
        return SUCCESS;
 }
 
@@ -140,7 +140,7 @@ CommandGetOccurs::CommandGetOccurs(Module* Creator) : Command(Creator, "OCCURS",
 
 COMMAND_RESULT CommandGetOccurs::Handle(User* user, const Params& parameters)
 {  
-       KeyHelper::Simple(user, std::make_shared<get_occurs_query>(), parameters[0], parameters.back());
+       KeyHelper::Simple(user, QueryPool::Make<get_occurs_query>(), parameters[0], parameters.back());
        return SUCCESS;
 }
 
@@ -153,7 +153,7 @@ CommandGet::CommandGet(Module* Creator) : Command(Creator, "GET", 1, 1)
 
 COMMAND_RESULT CommandGet::Handle(User* user, const Params& parameters)
 {  
-       KeyHelper::Retro(user, std::make_shared<get_query>(), parameters[0]);
+       KeyHelper::Retro(user, QueryPool::Make<get_query>(), parameters[0]);
        return SUCCESS;
 }
 
@@ -166,7 +166,7 @@ CommandStrlen::CommandStrlen(Module* Creator) : Command(Creator, "STRLEN", 1, 1)
 
 COMMAND_RESULT CommandStrlen::Handle(User* user, const Params& parameters)
 {  
-       KeyHelper::Retro(user, std::make_shared<strlen_query>(), parameters[0]);
+       KeyHelper::Retro(user, QueryPool::Make<strlen_query>(), parameters[0]);
        return SUCCESS;
 }
 
@@ -179,7 +179,7 @@ CommandGetDel::CommandGetDel(Module* Creator) : Command(Creator, "GETDEL", 1, 1)
 
 COMMAND_RESULT CommandGetDel::Handle(User* user, const Params& parameters)
 {  
-       KeyHelper::Retro(user, std::make_shared<getdel_query>(), parameters[0]);
+       KeyHelper::Retro(user, QueryPool::Make<getdel_query>(), parameters[0]);
        return SUCCESS;
 }
 
@@ -192,7 +192,7 @@ CommandGetSubstr::CommandGetSubstr(Module* Creator) : Command(Creator, "SUBSTR",
 
 COMMAND_RESULT CommandGetSubstr::Handle(User* user, const Params& parameters)
 {
-       KeyHelper::RetroLimits(user, std::make_shared<get_substr_query>(), parameters[0], convto_num<int>(parameters[1]), convto_num<int>(parameters[2]));
+       KeyHelper::RetroLimits(user, QueryPool::Make<get_substr_query>(), parameters[0], convto_num<int>(parameters[1]), convto_num<int>(parameters[2]));
        return SUCCESS;
 }
 
@@ -212,7 +212,7 @@ COMMAND_RESULT CommandGetExp::Handle(User* user, const Params& parameters)
                return FAILED;
          }
 
-         KeyHelper::IDRetro(user, std::make_shared<getexp_query>(), parameters[1], seconds);
+         KeyHelper::IDRetro(user, QueryPool::Make<getexp_query>(), parameters[1], seconds);
          return SUCCESS;
 }
 
@@ -225,7 +225,7 @@ CommandIsAlpha::CommandIsAlpha(Module* Creator) : Command(Creator, "ISALPHA", 1,
 
 COMMAND_RESULT CommandIsAlpha::Handle(User* user, const Params& parameters)
 {  
-         KeyHelper::Retro(user, std::make_shared<alpha_query>(), parameters[0]);
+         KeyHelper::Retro(user, QueryPool::Make<alpha_query>(), parameters[0]);
          return SUCCESS;
 }
 
@@ -238,7 +238,7 @@ CommandIsNum::CommandIsNum(Module* Creator) : Command(Creator, "ISNUM", 1, 1)
 
 COMMAND_RESULT CommandIsNum::Handle(User* user, const Params& parameters)
 {  
-         KeyHelper::Retro(user, std::make_shared<isnum_query>(), parameters[0]);
+         KeyHelper::Retro(user, QueryPool::Make<isnum_query>(), parameters[0]);
          return SUCCESS;
 }
 
@@ -251,7 +251,7 @@ CommandGetPersist::CommandGetPersist(Module* Creator) : Command(Creator, "GETPER
 
 COMMAND_RESULT CommandGetPersist::Handle(User* user, const Params& parameters)
 {  
-         KeyHelper::Retro(user, std::make_shared<getpersist_query>(), parameters[0]);
+         KeyHelper::Retro(user, QueryPool::Make<getpersist_query>(), parameters[0]);
          return SUCCESS;
 }
 
@@ -270,7 +270,7 @@ COMMAND_RESULT CommandWDel::Handle(User* user, const Params& parameters)
              return FAILED;
          }
 
-         KeyHelper::Retro(user, std::make_shared<wdel_query>(), stripe(key), true);
+         KeyHelper::Retro(user, QueryPool::Make<wdel_query>(), stripe(key), true);
          return SUCCESS;
 }
 
@@ -283,7 +283,7 @@ CommandIsBool::CommandIsBool(Module* Creator) : Command(Creator, "ISBOOL", 1, 1)
 
 COMMAND_RESULT CommandIsBool::Handle(User* user, const Params& parameters)
 {  
-         KeyHelper::Retro(user, std::make_shared<isbool_query>(), parameters[0]);
+         KeyHelper::Retro(user, QueryPool::Make<isbool_query>(), parameters[0]);
          return SUCCESS;
 }
 
@@ -296,7 +296,7 @@ CommandAsBool::CommandAsBool(Module* Creator) : Command(Creator, "ASBOOL", 1, 1)
 
 COMMAND_RESULT CommandAsBool::Handle(User* user, const Params& parameters)
 {  
-         KeyHelper::Retro(user, std::make_shared<asbool_query>(), parameters[0]);
+         KeyHelper::Retro(user, QueryPool::Make<asbool_query>(), parameters[0]);
          return SUCCESS;
 }
 
@@ -310,7 +310,7 @@ CommandIsMatch::CommandIsMatch(Module* Creator) : Command(Creator, "ISMATCH", 2,
 
 COMMAND_RESULT CommandIsMatch::Handle(User* user, const Params& parameters)
 {  
-         KeyHelper::Simple(user, std::make_shared<ismatch_query>(), parameters[0], parameters.back());
+         KeyHelper::Simple(user, QueryPool::Make<ismatch_query>(), parameters[0], parameters.back());
          return SUCCESS;
 }
 
@@ -332,7 +332,7 @@ COMMAND_RESULT CommandInsert::Handle(User* user, const Params& parameters)
                 return FAILED;
          }
 
-         std::shared_ptr<insert_query> query = std::make_shared<insert_query>();
+         std::shared_ptr<insert_query> query = QueryPool::Make<insert_query>();
          query->id 			   = convto_num<unsigned int>(where);
         
          KeyHelper::Simple(user, query, parameters[0], parameters.back(), true);
@@ -348,7 +348,7 @@ CommandToLower::CommandToLower(Module* Creator) : Command(Creator, "TOLOWER", 1,
 
 COMMAND_RESULT CommandToLower::Handle(User* user, const Params& parameters)
 {  
-        KeyHelper::RetroFunc(user, std::make_shared<modify_query>(), parameters[0], STR_TO_LOW);
+        KeyHelper::RetroFunc(user, QueryPool::Make<modify_query>(), parameters[0], STR_TO_LOW);
         return SUCCESS;
 }
 
@@ -361,7 +361,7 @@ CommandToUpper::CommandToUpper(Module* Creator) : Command(Creator, "TOUPPER", 1,
 
 COMMAND_RESULT CommandToUpper::Handle(User* user, const Params& parameters)
 {  
-        KeyHelper::RetroFunc(user, std::make_shared<modify_query>(), parameters[0], STR_TO_UPPER);
+        KeyHelper::RetroFunc(user, QueryPool::Make<modify_query>(), parameters[0], STR_TO_UPPER);
         return SUCCESS;
 }
 
@@ -374,7 +374,7 @@ CommandToCap::CommandToCap(Module* Creator) : Command(Creator, "TOCAP", 1, 1)
 
 COMMAND_RESULT CommandToCap::Handle(User* user, const Params& parameters)
 {  
-        KeyHelper::RetroFunc(user, std::make_shared<modify_query>(), parameters[0], STR_TO_CAP);
+        KeyHelper::RetroFunc(user, QueryPool::Make<modify_query>(), parameters[0], STR_TO_CAP);
         return SUCCESS;
 }
 
@@ -45,6 +45,9 @@ class CoreModKeys : public Module
         CommandToUpper 		cmdtoupper;
         CommandToCap 		cmdtocap;
         CommandChar		cmdchar;
+        CommandMGetKeys		cmdmgetkeys;
+        CommandMSetKeys		cmdmsetkeys;
+        CommandMDelKeys		cmdmdelkeys;
         
     public:	
         
@@ -74,7 +77,10 @@ class CoreModKeys : public Module
                         cmdtolower(this),
                         cmdtoupper(this),
                         cmdtocap(this),
-                        cmdchar(this)
+                        cmdchar(this),
+                        cmdmgetkeys(this),
+                        cmdmsetkeys(this),
+                        cmdmdelkeys(this)
         {
         
         }
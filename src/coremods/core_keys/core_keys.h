@@ -606,3 +606,67 @@ class CommandGetPersist : public Command
         COMMAND_RESULT Handle(User* user, const Params& parameters);
 };
 
+
+/* 
+ * Obtains several keys at once.
+ * 
+ * @parameters:
+ *
+ *         · string   : Keys to get.
+ * 
+ * @protocol:
+ *
+ *         · vector   : Values, in the same order keys were requested
+ *                      (NULL for keys not defined).
+ */
+
+class CommandMGetKeys : public Command 
+{
+    public: 
+
+        CommandMGetKeys(Module* Creator);
+
+        COMMAND_RESULT Handle(User* user, const Params& parameters);
+};
+
+/* 
+ * Sets several keys at once. Either all keys are set, or none.
+ * 
+ * @parameters:
+ *
+ *         · string   : Keys and values to set.
+ * 
+ * @protocol:
+ *
+ *         · enum     : ERROR or OK.
+ */
+
+class CommandMSetKeys : public Command 
+{
+    public: 
+
+        CommandMSetKeys(Module* Creator);
+
+        COMMAND_RESULT Handle(User* user, const Params& parameters);
+};
+
+/* 
+ * Removes several keys at once.
+ * 
+ * @parameters:
+ *
+ *         · string   : Keys to remove.
+ * 
+ * @protocol:
+ *
+ *         · int      : Keys removed.
+ */
+
+class CommandMDelKeys : public Command 
+{
+    public: 
+
+        CommandMDelKeys(Module* Creator);
+
+        COMMAND_RESULT Handle(User* user, const Params& parameters);
+};
@@ -30,7 +30,7 @@ COMMAND_RESULT CommandLResize::Handle(User* user, const Params& parameters)
               return FAILED;
        }
        
-       KeyHelper::Simple(user, std::make_shared<lresize_query>(), parameters[0], value);
+       KeyHelper::Simple(user, QueryPool::Make<lresize_query>(), parameters[0], value);
        return SUCCESS;  
 }
 
@@ -44,7 +44,7 @@ CommandLGet::CommandLGet(Module* Creator) : Command(Creator, "LGET", 1, 3)
 
 COMMAND_RESULT CommandLGet::Handle(User* user, const Params& parameters)
 {  
-       KeyHelper::RetroLimits(user, std::make_shared<lget_query>(), parameters[0], this->offset, this->limit);
+       KeyHelper::RetroLimits(user, QueryPool::Make<lget_query>(), parameters[0], this->offset, this->limit);
        return SUCCESS;  
 }
 
@@ -57,7 +57,7 @@ CommandLKeys::CommandLKeys(Module* Creator) : Command(Creator, "LKEYS", 1, 3)
 
 COMMAND_RESULT CommandLKeys::Handle(User* user, const Params& parameters)
 {  
-       KeyHelper::RetroLimits(user, std::make_shared<lkeys_query>(), parameters[0], this->offset, this->limit, true);
+       KeyHelper::RetroLimits(user, QueryPool::Make<lkeys_query>(), parameters[0], this->offset, this->limit, true);
        return SUCCESS;  
 }
 
@@ -77,7 +77,7 @@ COMMAND_RESULT CommandLPos::Handle(User* user, const Params& parameters)
               return FAILED;
        }
        
-       KeyHelper::SimpleRetro(user, std::make_shared<lpos_query>(), parameters[0], value);
+       KeyHelper::SimpleRetro(user, QueryPool::Make<lpos_query>(), parameters[0], value);
        return SUCCESS;  
 }
 
@@ -91,7 +91,7 @@ CommandLRepeats::CommandLRepeats(Module* Creator) : Command(Creator, "LREPEATS",
 
 COMMAND_RESULT CommandLRepeats::Handle(User* user, const Params& parameters)
 {  
-       KeyHelper::SimpleRetro(user, std::make_shared<lrepeats_query>(), parameters[0], parameters.back());
+       KeyHelper::SimpleRetro(user, QueryPool::Make<lrepeats_query>(), parameters[0], parameters.back());
        return SUCCESS;  
 }
 
@@ -104,7 +104,7 @@ CommandLRop::CommandLRop(Module* Creator) : Command(Creator, "LRPOP", 1, 1)
 
 COMMAND_RESULT CommandLRop::Handle(User* user, const Params& parameters)
 {  
-       KeyHelper::Retro(user, std::make_shared<lrop_query>(), parameters[0]);
+       KeyHelper::Retro(user, QueryPool::Make<lrop_query>(), parameters[0]);
        return SUCCESS;  
 }
 
@@ -117,7 +117,7 @@ CommandFRop::CommandFRop(Module* Creator) : Command(Creator, "LFPOP", 1, 1)
 
 COMMAND_RESULT CommandFRop::Handle(User* user, const Params& parameters)
 {  
-       KeyHelper::Retro(user, std::make_shared<lrop_query>(), parameters[0]);
+       KeyHelper::Retro(user, QueryPool::Make<lrop_query>(), parameters[0]);
        return SUCCESS;  
 }
 
@@ -131,7 +131,7 @@ CommandLPush::CommandLPush(Module* Creator) : Command(Creator, "LPUSH", 2, 2)
 
 COMMAND_RESULT CommandLPush::Handle(User* user, const Params& parameters)
 {  
-        KeyHelper::Simple(user, std::make_shared<lpush_query>(), parameters[0], parameters.back());
+        KeyHelper::Simple(user, QueryPool::Make<lpush_query>(), parameters[0], parameters.back());
         return SUCCESS;  
 }
 
@@ -145,7 +145,7 @@ CommandLExist::CommandLExist(Module* Creator) : Command(Creator, "LEXISTS", 2, 2
 
 COMMAND_RESULT CommandLExist::Handle(User* user, const Params& parameters)
 {  
-       KeyHelper::Simple(user, std::make_shared<lexist_query>(), parameters[0], parameters.back());
+       KeyHelper::Simple(user, QueryPool::Make<lexist_query>(), parameters[0], parameters.back());
        return SUCCESS;  
 }
 
@@ -158,7 +158,7 @@ CommandLCount::CommandLCount(Module* Creator) : Command(Creator, "LCOUNT", 1, 1)
 
 COMMAND_RESULT CommandLCount::Handle(User* user, const Params& parameters)
 {  
-       KeyHelper::Retro(user, std::make_shared<lcount_query>(), parameters[0]);
+       KeyHelper::Retro(user, QueryPool::Make<lcount_query>(), parameters[0]);
        return SUCCESS;  
 }
 
@@ -171,7 +171,7 @@ CommandLBack::CommandLBack(Module* Creator) : Command(Creator, "LBACK", 1, 1)
 
 COMMAND_RESULT CommandLBack::Handle(User* user, const Params& parameters)
 {  
-       KeyHelper::Retro(user, std::make_shared<lback_query>(), parameters[0]);
+       KeyHelper::Retro(user, QueryPool::Make<lback_query>(), parameters[0]);
        return SUCCESS;  
 }
 
@@ -184,7 +184,7 @@ CommandLFront::CommandLFront(Module* Creator) : Command(Creator, "LFRONT", 1, 1)
 
 COMMAND_RESULT CommandLFront::Handle(User* user, const Params& parameters)
 {  
-       KeyHelper::Retro(user, std::make_shared<lfront_query>(), parameters[0]);
+       KeyHelper::Retro(user, QueryPool::Make<lfront_query>(), parameters[0]);
        return SUCCESS;  
 }
 
@@ -198,7 +198,7 @@ CommandLPushNX::CommandLPushNX(Module* Creator) : Command(Creator, "LPUSHNX", 2,
 
 COMMAND_RESULT CommandLPushNX::Handle(User* user, const Params& parameters)
 {  
-        KeyHelper::Simple(user, std::make_shared<lpushnx_query>(), parameters[0], parameters.back());
+        KeyHelper::Simple(user, QueryPool::Make<lpushnx_query>(), parameters[0], parameters.back());
         return SUCCESS;  
 }
 
@@ -211,7 +211,7 @@ CommandLAvg::CommandLAvg(Module* Creator) : Command(Creator, "LAVG", 1, 1)
 
 COMMAND_RESULT CommandLAvg::Handle(User* user, const Params& parameters)
 {  
-       KeyHelper::Retro(user, std::make_shared<lavg_query>(), parameters[0]);
+       KeyHelper::Retro(user, QueryPool::Make<lavg_query>(), parameters[0]);
        return SUCCESS;  
 }
 
@@ -224,7 +224,7 @@ CommandLHigh::CommandLHigh(Module* Creator) : Command(Creator, "LHIGH", 1, 1)
 
 COMMAND_RESULT CommandLHigh::Handle(User* user, const Params& parameters)
 {  
-       KeyHelper::Retro(user, std::make_shared<lhigh_query>(), parameters[0]);
+       KeyHelper::Retro(user, QueryPool::Make<lhigh_query>(), parameters[0]);
        return SUCCESS;  
 }
 
@@ -237,7 +237,7 @@ CommandLLow::CommandLLow(Module* Creator) : Command(Creator, "LLOW", 1, 1)
 
 COMMAND_RESULT CommandLLow::Handle(User* user, const Params& parameters)
 {  
-       KeyHelper::Retro(user, std::make_shared<llow_query>(), parameters[0]);
+       KeyHelper::Retro(user, QueryPool::Make<llow_query>(), parameters[0]);
        return SUCCESS;  
 }
 
@@ -24,7 +24,7 @@ CommandHGet::CommandHGet(Module* Creator) : Command(Creator, "HGET", 2, 2)
 
 COMMAND_RESULT CommandHGet::Handle(User* user, const Params& parameters)
 {  
-       KeyHelper::HeshRetro(user, std::make_shared<hget_query>(), parameters[0], parameters[1]);
+       KeyHelper::HeshRetro(user, QueryPool::Make<hget_query>(), parameters[0], parameters[1]);
        return SUCCESS;
 }
 
@@ -37,7 +37,7 @@ CommandHCount::CommandHCount(Module* Creator) : Command(Creator, "HCOUNT", 1, 1)
 
 COMMAND_RESULT CommandHCount::Handle(User* user, const Params& parameters)
 {  
-       std::shared_ptr<hlist_query> query = std::make_shared<hlist_query>();
+       std::shared_ptr<hlist_query> query = QueryPool::Make<hlist_query>();
        query->flags 			  = QUERY_FLAGS_COUNT;
 
        KeyHelper::Retro(user, query, parameters[0]);
@@ -54,7 +54,7 @@ CommandHExists::CommandHExists(Module* Creator) : Command(Creator, "HEXISTS", 2,
 
 COMMAND_RESULT CommandHExists::Handle(User* user, const Params& parameters)
 {  
-       KeyHelper::HeshRetro(user, std::make_shared<hexists_query>(), parameters[0], parameters[1]);
+       KeyHelper::HeshRetro(user, QueryPool::Make<hexists_query>(), parameters[0], parameters[1]);
        return SUCCESS;
 }
 
@@ -68,7 +68,7 @@ CommandHStrlen::CommandHStrlen(Module* Creator) : Command(Creator, "HSTRLEN", 2,
 
 COMMAND_RESULT CommandHStrlen::Handle(User* user, const Params& parameters)
 {  
-       KeyHelper::HeshRetro(user, std::make_shared<hstrlen_query>(), parameters[0], parameters[1]);
+       KeyHelper::HeshRetro(user, QueryPool::Make<hstrlen_query>(), parameters[0], parameters[1]);
        return SUCCESS;
 }
 
@@ -82,7 +82,7 @@ CommandHVals::CommandHVals(Module* Creator) : Command(Creator, "HVALS", 1, 3)
 
 COMMAND_RESULT CommandHVals::Handle(User* user, const Params& parameters)
 {  
-       KeyHelper::RetroLimits(user, std::make_shared<hvals_query>(), parameters[0], this->offset, this->limit);
+       KeyHelper::RetroLimits(user, QueryPool::Make<hvals_query>(), parameters[0], this->offset, this->limit);
        return SUCCESS;
 }
 
@@ -96,7 +96,7 @@ CommandHGetAll::CommandHGetAll(Module* Creator) : Command(Creator, "HGETALL", 1,
 
 COMMAND_RESULT CommandHGetAll::Handle(User* user, const Params& parameters)
 {  
-       KeyHelper::RetroLimits(user, std::make_shared<hgetall_query>(), parameters[0], this->offset, this->limit);
+       KeyHelper::RetroLimits(user, QueryPool::Make<hgetall_query>(), parameters[0], this->offset, this->limit);
        return SUCCESS;
 }
 
@@ -110,7 +110,7 @@ CommandHDel::CommandHDel(Module* Creator) : Command(Creator, "HDEL", 2, 2)
 
 COMMAND_RESULT CommandHDel::Handle(User* user, const Params& parameters)
 {  
-       KeyHelper::HeshRetro(user, std::make_shared<hdel_query>(), parameters[0], parameters[1]);
+       KeyHelper::HeshRetro(user, QueryPool::Make<hdel_query>(), parameters[0], parameters[1]);
        return SUCCESS;
 }
 
@@ -125,7 +125,7 @@ CommandHSet::CommandHSet(Module* Creator) : Command(Creator, "HSET", 3, 3)
 
 COMMAND_RESULT CommandHSet::Handle(User* user, const Params& parameters)
 {
-       KeyHelper::SimpleHesh(user, std::make_shared<hset_query>(),  parameters[0], parameters[1], parameters.back());
+       KeyHelper::SimpleHesh(user, QueryPool::Make<hset_query>(),  parameters[0], parameters[1], parameters.back());
        return SUCCESS;
 }
 
@@ -140,7 +140,7 @@ CommandHSetNX::CommandHSetNX(Module* Creator) : Command(Creator, "HSETNX", 3, 3)
 
 COMMAND_RESULT CommandHSetNX::Handle(User* user, const Params& parameters)
 {  
-       KeyHelper::SimpleHesh(user, std::make_shared<hsetnx_query>(), parameters[0], parameters[1], parameters.back());
+       KeyHelper::SimpleHesh(user, QueryPool::Make<hsetnx_query>(), parameters[0], parameters[1], parameters.back());
        return SUCCESS;
 }
 
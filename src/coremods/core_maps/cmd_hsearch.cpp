@@ -23,7 +23,7 @@ CommandHKeys::CommandHKeys(Module* Creator) : Command(Creator, "HKEYS", 1, 3)
 
 COMMAND_RESULT CommandHKeys::Handle(User* user, const Params& parameters)
 {  
-       KeyHelper::RetroLimits(user, std::make_shared<hfind_query>(), parameters[0], this->offset, this->limit, true);
+       KeyHelper::RetroLimits(user, QueryPool::Make<hfind_query>(), parameters[0], this->offset, this->limit, true);
        return SUCCESS;
 }
 
@@ -37,6 +37,6 @@ CommandHList::CommandHList(Module* Creator) : Command(Creator, "HLIST", 1, 3)
 
 COMMAND_RESULT CommandHList::Handle(User* user, const Params& parameters)
 {  
-       KeyHelper::RetroLimits(user, std::make_shared<hlist_query>(), parameters[0], this->offset, this->limit);
+       KeyHelper::RetroLimits(user, QueryPool::Make<hlist_query>(), parameters[0], this->offset, this->limit);
        return SUCCESS;
 }
\ No newline at end of file
@@ -24,7 +24,7 @@ CommandMGet::CommandMGet(Module* Creator) : Command(Creator, "MGET", 1, 3)
 
 COMMAND_RESULT CommandMGet::Handle(User* user, const Params& parameters)
 {  
-       KeyHelper::RetroLimits(user, std::make_shared<mget_query>(), parameters[0], this->offset, this->limit);
+       KeyHelper::RetroLimits(user, QueryPool::Make<mget_query>(), parameters[0], this->offset, this->limit);
        return SUCCESS;
 }
 
@@ -37,7 +37,7 @@ CommandMCount::CommandMCount(Module* Creator) : Command(Creator, "MCOUNT", 1, 1)
 
 COMMAND_RESULT CommandMCount::Handle(User* user, const Params& parameters)
 {  
-       std::shared_ptr<mget_query> query = std::make_shared<mget_query>();
+       std::shared_ptr<mget_query> query = QueryPool::Make<mget_query>();
        query->flags 			 = QUERY_FLAGS_COUNT;
 
        KeyHelper::Retro(user, query, parameters[0]);
@@ -55,7 +55,7 @@ CommandMPush::CommandMPush(Module* Creator) : Command(Creator, "MPUSH", 3, 3)
 
 COMMAND_RESULT CommandMPush::Handle(User* user, const Params& parameters)
 {  
-       KeyHelper::SimpleHesh(user, std::make_shared<mset_query>(), parameters[0], parameters[1], parameters.back());
+       KeyHelper::SimpleHesh(user, QueryPool::Make<mset_query>(), parameters[0], parameters[1], parameters.back());
        return SUCCESS;
 }
 
@@ -70,7 +70,7 @@ CommandMPushNX::CommandMPushNX(Module* Creator) : Command(Creator, "MPUSHNX", 3,
 
 COMMAND_RESULT CommandMPushNX::Handle(User* user, const Params& parameters)
 {  
-       KeyHelper::SimpleHesh(user, std::make_shared<msetnx_query>(), parameters[0], parameters[1], parameters.back());
+       KeyHelper::SimpleHesh(user, QueryPool::Make<msetnx_query>(), parameters[0], parameters[1], parameters.back());
        return SUCCESS;
 }
 
@@ -83,7 +83,7 @@ CommandMKeys::CommandMKeys(Module* Creator) : Command(Creator, "MKEYS", 1, 3)
 
 COMMAND_RESULT CommandMKeys::Handle(User* user, const Params& parameters)
 {  
-       KeyHelper::RetroLimits(user, std::make_shared<mkeys_query>(), parameters[0], this->offset, this->limit, true);
+       KeyHelper::RetroLimits(user, QueryPool::Make<mkeys_query>(), parameters[0], this->offset, this->limit, true);
        return SUCCESS;
 }
 
@@ -97,7 +97,7 @@ CommandMDel::CommandMDel(Module* Creator) : Command(Creator, "MDEL", 2, 2)
 
 COMMAND_RESULT CommandMDel::Handle(User* user, const Params& parameters)
 {
-       KeyHelper::Simple(user, std::make_shared<mdel_query>(), parameters[0], parameters[1]);
+       KeyHelper::Simple(user, QueryPool::Make<mdel_query>(), parameters[0], parameters[1]);
        return SUCCESS;
 }
 
@@ -111,7 +111,7 @@ CommandMRepeats::CommandMRepeats(Module* Creator) : Command(Creator, "MREPEATS",
 
 COMMAND_RESULT CommandMRepeats::Handle(User* user, const Params& parameters)
 {  
-       KeyHelper::Simple(user, std::make_shared<mrepeats_query>(), parameters[0], parameters[1]);
+       KeyHelper::Simple(user, QueryPool::Make<mrepeats_query>(), parameters[0], parameters[1]);
        return SUCCESS;
 }
 
@@ -125,7 +125,7 @@ CommandMVals::CommandMVals(Module* Creator) : Command(Creator, "MVALS", 1, 3)
 
 COMMAND_RESULT CommandMVals::Handle(User* user, const Params& parameters)
 {  
-       KeyHelper::RetroLimits(user, std::make_shared<mvals_query>(), parameters[0], this->offset, this->limit);
+       KeyHelper::RetroLimits(user, QueryPool::Make<mvals_query>(), parameters[0], this->offset, this->limit);
        return SUCCESS;
 }
 
@@ -139,7 +139,7 @@ CommandMGetAll::CommandMGetAll(Module* Creator) : Command(Creator, "MGETALL", 1,
 
 COMMAND_RESULT CommandMGetAll::Handle(User* user, const Params& parameters)
 {  
-       KeyHelper::RetroLimits(user, std::make_shared<mgetall_query>(), parameters[0], this->offset, this->limit);
+       KeyHelper::RetroLimits(user, QueryPool::Make<mgetall_query>(), parameters[0], this->offset, this->limit);
        return SUCCESS;
 }
 
@@ -154,7 +154,7 @@ CommandMIter::CommandMIter(Module* Creator) : Command(Creator, "MITER", 2, 4)
 
 COMMAND_RESULT CommandMIter::Handle(User* user, const Params& parameters)
 {  
-       std::shared_ptr<miter_query> query = std::make_shared<miter_query>();
+       std::shared_ptr<miter_query> query = QueryPool::Make<miter_query>();
        query->value 			  = parameters[1];
        
        KeyHelper::RetroLimits(user, query, parameters[0], this->offset, this->limit);
@@ -14,10 +14,10 @@
 #include "beryl.h"
 #include "core_monitor.h"
 
-CommandMonitor::CommandMonitor(Module* Creator) : Command(Creator, "MONITOR", 0, 1)
+CommandMonitor::CommandMonitor(Module* Creator) : Command(Creator, "MONITOR", 0, 3)
 {
          flags = 'm';
-         syntax = "<level>";
+         syntax = "<level> <*rate> <*commands>";
 }
 
 COMMAND_RESULT CommandMonitor::Handle(User* user, const Params& parameters)
@@ -26,32 +26,54 @@ COMMAND_RESULT CommandMonitor::Handle(User* user, const Params& parameters)
        
        Kernel->Monitor->Remove(user);
        
+       MonitorEntry entry(MONITOR_DEFAULT, 1);
+
        if (parameters.size())
        {
              const std::string& level = to_upper(parameters[0]);
        
-             MONITOR_LEVEL monitor = MONITOR_DEFAULT;
-             
              if (level == "DEFAULT")
              {
-                    monitor = MONITOR_DEFAULT;
+                    entry.level = MONITOR_DEFAULT;
              }
              else if (level == "DEBUG")
              {
-                    monitor = MONITOR_DEBUG;
+                    entry.level = MONITOR_DEBUG;
              }
              else
              {
                     user->SendProtocol(ERR_INPUT, PROCESS_ERROR);
                     return FAILED;
              }
-       
-             Kernel->Monitor->Add(user, monitor);
-             user->SendProtocol(BRLD_OK, PROCESS_OK);       
-             return SUCCESS;  
+       }
+
+       /* Delivers only 1 out of every 'rate' commands. */
+
+       if (parameters.size() > 1)
+       {
+             entry.rate = is_positive_number(parameters[1]) ? convto_num<unsigned int>(parameters[1]) : 0;
+
+             if (!entry.rate)
+             {
+                    user->SendProtocol(ERR_INPUT, MUST_BE_GREAT_ZERO);
+                    return FAILED;
+             }
+       }
+
+       /* Comma separated list of commands to deliver. */
+
+       if (parameters.size() > 2 && parameters[2] != "*")
+       {
+             engine::comma_node_stream commands(parameters[2]);
+             std::string command;
+
+             while (commands.items_extract(command))
+             {
+                    entry.filter.insert(to_upper(command));
+             }
        }
        
-       Kernel->Monitor->Add(user, MONITOR_DEFAULT);
+       Kernel->Monitor->Add(user, entry);
        user->SendProtocol(BRLD_OK, PROCESS_OK);          
        return SUCCESS;
 }
@@ -100,15 +122,27 @@ COMMAND_RESULT CommandMonitorList::Handle(User* user, const Params& parameters)
         const MonitorMap& all = Kernel->Monitor->GetList(arg);
         
         Dispatcher::JustAPI(user, BRLD_START_LIST);
-        Dispatcher::JustEmerald(user, BRLD_START_LIST, Daemon::Format("%-30s | %-10s", "Monitor", "Level"));
-        Dispatcher::JustEmerald(user, BRLD_START_LIST, Daemon::Format("%-30s | %-10s", Dispatcher::Repeat("―", 30).c_str(), Dispatcher::Repeat("―", 10).c_str()));
+        Dispatcher::JustEmerald(user, BRLD_START_LIST, Daemon::Format("%-30s | %-10s | %-6s | %-20s", "Monitor", "Level", "Rate", "Commands"));
+        Dispatcher::JustEmerald(user, BRLD_START_LIST, Daemon::Format("%-30s | %-10s | %-6s | %-20s", Dispatcher::Repeat("―", 30).c_str(), Dispatcher::Repeat("―", 10).c_str(), Dispatcher::Repeat("―", 6).c_str(), Dispatcher::Repeat("―", 20).c_str()));
         
         unsigned int counter = 0;
 
         for (MonitorMap::const_iterator uit = all.begin(); uit != all.end(); uit++)
         {
                User* umonitor = uit->first;
-               MONITOR_LEVEL level = uit->second;
+               MONITOR_LEVEL level = uit->second.level;
+               
+               std::string commands;
+
+               for (std::set<std::string>::const_iterator i = uit->second.filter.begin(); i != uit->second.filter.end(); ++i)
+               {
+                    commands.append(commands.empty() ? *i : "," + *i);
+               }
+
+               if (commands.empty())
+               {
+                    commands = "*";
+               }
                
                std::string strlevel;
                
@@ -121,7 +155,7 @@ COMMAND_RESULT CommandMonitorList::Handle(User* user, const Params& parameters)
                     strlevel = "DEBUG";
                }
                
-               Dispatcher::ListDepend(user, BRLD_ITEM_LIST, Daemon::Format("%-30s | %-10s", umonitor->instance.c_str(), strlevel.c_str()), Daemon::Format("%s %s", umonitor->instance.c_str(), strlevel.c_str()));
+               Dispatcher::ListDepend(user, BRLD_ITEM_LIST, Daemon::Format("%-30s | %-10s | %-6u | %-20s", umonitor->instance.c_str(), strlevel.c_str(), uit->second.rate, commands.c_str()), Daemon::Format("%s %s %u %s", umonitor->instance.c_str(), strlevel.c_str(), uit->second.rate, commands.c_str()));
                counter++;
         }
         
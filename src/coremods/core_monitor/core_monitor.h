@@ -22,11 +22,15 @@
  * Monitor handles the 'monitor' command, which is used to
  * activate monitoring handling.
  * 
- * Monitoring levels are: DEFAULT and DEBUG.
+ * Monitoring levels are: DEFAULT and DEBUG. Commands may be sampled,
+ * so that only 1 out of every 'rate' commands is delivered, and
+ * filtered, so that only given commands are delivered.
  * 
  * @parameters:
  *
  *         · string	: level.
+ *         · uint	: Sampling rate, 1 by default (all commands).
+ *         · string	: Comma separated commands to deliver, or '*'.
  * 
  * @protocol:
  *
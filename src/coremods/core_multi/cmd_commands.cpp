@@ -21,12 +21,6 @@ CommandMulti::CommandMulti(Module* Creator) : Command(Creator, "MULTI", 0, 0)
 
 COMMAND_RESULT CommandMulti::Handle(User* user, const Params& parameters)
 {  
-      if (user->MultiRunning)
-      {
-            user->SendProtocol(ERR_INPUT, PROCESS_ERROR);
-            return FAILED;
-      }
-      
       user->Multi = true;
       user->SendProtocol(BRLD_OK, PROCESS_OK);
       return SUCCESS;
@@ -42,7 +36,7 @@ COMMAND_RESULT CommandMultiReset::Handle(User* user, const Params& parameters)
       if (user->Multi)
       {
             user->Multi 	= false;
-            user->MultiRunning  = false;
+            user->Unwatch();
             user->SendProtocol(BRLD_OK, PROCESS_OK);
             
             return SUCCESS;
@@ -59,5 +53,67 @@ CommandMRUN::CommandMRUN(Module* Creator) : Command(Creator, "MRUN", 0, 0)
 
 COMMAND_RESULT CommandMRUN::Handle(User* user, const Params& parameters)
 {  
+      LocalUser* localuser = IS_LOCAL(user);
+
+      if (!localuser || !user->Multi)
+      {
+            user->SendProtocol(ERR_INPUT2, ERR_MULTI, PROCESS_ERROR);
+            return FAILED;
+      }
+
+      Kernel->Commander->Queue->Transaction(localuser);
+      return SUCCESS;
+}
+
+CommandWatch::CommandWatch(Module* Creator) : Command(Creator, "WATCH", 1)
+{
+      group = 'w';
+      syntax = "<key> <key2> ...";
+}
+
+COMMAND_RESULT CommandWatch::Handle(User* user, const Params& parameters)
+{  
+      if (user->Multi)
+      {
+            user->SendProtocol(ERR_INPUT2, ERR_MULTI, PROCESS_ERROR);
+            return FAILED;
+      }
+
+      for (Params::const_iterator i = parameters.begin(); i != parameters.end(); ++i)
+      {
+            if (!CheckKey(user, *i))
+            {
+                  return FAILED;
+            }
+      }
+
+      if (user->Watching.empty())
+      {
+            user->WatchEpoch = Kernel->Store->Watches->GetEpoch();
+      }
+
+      for (Params::const_iterator i = parameters.begin(); i != parameters.end(); ++i)
+      {
+            const std::string& id = WatchTable::Build(user->GetDatabase(), user->select, *i);
+
+            if (user->Watching.find(id) == user->Watching.end())
+            {
+                  user->Watching[id] = Kernel->Store->Watches->Watch(id);
+            }
+      }
+
+      user->SendProtocol(BRLD_OK, PROCESS_OK);
+      return SUCCESS;
+}
+
+CommandUnwatch::CommandUnwatch(Module* Creator) : Command(Creator, "UNWATCH", 0, 0)
+{
+      group = 'w';
+}
+
+COMMAND_RESULT CommandUnwatch::Handle(User* user, const Params& parameters)
+{  
+      user->Unwatch();
+      user->SendProtocol(BRLD_OK, PROCESS_OK);
       return SUCCESS;
 }
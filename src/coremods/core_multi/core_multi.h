@@ -14,6 +14,7 @@
 #pragma once
 
 #include "beryl.h"
+#include "maker.h"
 #include "engine.h"
 
 /* 
@@ -35,11 +36,14 @@ class CommandMulti : public Command
 };
 
 /* 
- * Flushes elements added to a multi.
+ * Flushes elements added to a multi. Queries of all commands are run as
+ * one, with no other query running in between, and their results are
+ * sent before a final MULTI_OK. Nothing is run if a watched key was
+ * written to since WATCH.
  *
  * @protocol:
  *
- *         · protocol        : OK or ERROR.
+ *         · protocol        : MULTI_OK, ABORTED or ERROR.
  */ 
  
 class CommandMRUN : public Command 
@@ -70,3 +74,45 @@ class CommandMultiReset : public Command
         COMMAND_RESULT Handle(User* user, const Params& parameters);
 };
 
+
+/* 
+ * Watches keys until next MRUN. MRUN is aborted if any of these keys is
+ * written to meanwhile, including writes already running when WATCH
+ * was sent.
+ *
+ * @parameters:
+ *
+ *         · keys	: Keys to watch.
+ *
+ * @protocol:
+ *
+ *         · protocol        : OK or ERROR.
+ */ 
+
+class CommandWatch : public Command 
+{
+
+    public: 
+
+        CommandWatch(Module* parent);
+
+        COMMAND_RESULT Handle(User* user, const Params& parameters);
+};
+
+/* 
+ * Forgets all watched keys.
+ * 
+ * @protocol:
+ *
+ *         · protocol        : OK.
+ */ 
+
+class CommandUnwatch : public Command 
+{
+
+    public: 
+
+        CommandUnwatch(Module* parent);
+
+        COMMAND_RESULT Handle(User* user, const Params& parameters);
+};
@@ -13,14 +13,145 @@
 
 #include "beryl.h"
 
-class Serializer : public ProtocolTrigger::Serializer
+namespace
 {
+	/* 
+	 * Handles PROTOCOL <name>, which changes the serializer of a given user.
+	 * It is handled as soon as it is parsed, so that input following it is
+	 * read by the new serializer. Thus, it is only allowed when no earlier
+	 * command is pending.
+	 */
+
+	void Negotiate(LocalUser* user, ProtocolTrigger::ParseOutput& parseoutput)
+	{
+		std::string command(parseoutput.cmd);
+		std::transform(command.begin(), command.end(), command.begin(), ::toupper);
 
-	static const std::string::size_type MAX_CLIENT_MESSAGE_TAG_LENGTH = INPUT_LIMIT;
+		if (command != "PROTOCOL")
+		{
+			return;
+		}
+
+		/* Not a command to queue. */
+
+		parseoutput.cmd.clear();
+
+		if (parseoutput.params.size() != 1)
+		{
+			user->SendProtocol(ERR_INPUT, INVALID_PARAM);
+			return;
+		}
+
+		if (user->Busy())
+		{
+			user->SendProtocol(ERR_INPUT, COMMANDS_PENDING);
+			return;
+		}
+
+		std::string name(parseoutput.params[0]);
+		std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+
+		ProtocolTrigger::Serializer* const serializer = Kernel->Modules->DataModule<ProtocolTrigger::Serializer>("serializer/" + name);
+
+		if (!serializer)
+		{
+			user->SendProtocol(ERR_INPUT, NOT_FOUND);
+			return;
+		}
+
+		/* Framed commands are kept in memory until complete, so only logged users may send them. */
+
+		if (serializer->IsFramed() && user->registered != REG_OK)
+		{
+			user->SendProtocol(ERR_INPUT, NO_AUTH);
+			return;
+		}
+
+		user->serializer = serializer;
+		user->SendProtocol(BRLD_OK, PROCESS_OK);
+	}
+
+	/* Parses message tags (tag=value;tag), as sent after '@'. */
+
+	void ParseTags(const ProtocolTrigger::Serializer* serializer, LocalUser* user, const std::string& line, ProtocolTrigger::TagMap& tags)
+	{
+		std::string token;
+		std::string tagval;
+		engine::node_stream ss(line, ';');
+		
+		while (ss.items_extract(token))
+		{
+			const std::string::size_type p = token.find('=');
+		
+			if (p != std::string::npos)
+			{
+				tagval.assign(token, p+1, std::string::npos);
+				token.erase(p);
+			}
+			else
+			{
+				tagval.clear();
+			}
+
+			serializer->HandleTag(user, token, tagval, tags);
+		}
+	}
 
-	static const std::string::size_type MAX_SERVER_MESSAGE_TAG_LENGTH = INPUT_LIMIT;
+	void CheckTagLength(std::string& line, size_t prevsize, size_t& length, size_t maxlength)
+	{
+		const std::string::size_type diffsize = line.size() - prevsize;
+	
+		if (length + diffsize > maxlength)
+		{
+			line.erase(prevsize);
+		}
+		else
+		{
+			length += diffsize;
+		}
+	}
 
-	static void SerializeTags(const ProtocolTrigger::TagMap& tags, const ProtocolTrigger::TagSelection& tagwl, std::string& line);
+	/* Appends selected tags of a message (@tag=value;tag). */
+
+	void SerializeTags(const ProtocolTrigger::TagMap& tags, const ProtocolTrigger::TagSelection& tagwl, std::string& line)
+	{
+		size_t client_tag_length = 0;
+		size_t server_tag_length = 0;
+		
+		for (ProtocolTrigger::TagMap::const_iterator i = tags.begin(); i != tags.end(); ++i)
+		{
+			if (!tagwl.IsSelected(tags, i))
+			{
+				continue;
+			}
+
+			const std::string::size_type prevsize = line.size();
+			line.push_back(prevsize ? ';' : '@');
+			line.append(i->first);
+			const std::string& val = i->second.value;
+			
+			if (!val.empty())
+			{
+				line.push_back('=');
+				line.append(val);
+			}
+			
+			if (i->first[0] == '+')
+			{
+				CheckTagLength(line, prevsize, client_tag_length, INPUT_LIMIT);
+			}
+			else
+			{
+				CheckTagLength(line, prevsize, server_tag_length, INPUT_LIMIT);
+			}
+		}
+	}
+}
+
+class Serializer : public ProtocolTrigger::Serializer
+{
+
+	static const std::string::size_type MAX_CLIENT_MESSAGE_TAG_LENGTH = INPUT_LIMIT;
 
  public:
 
@@ -33,6 +164,67 @@ class Serializer : public ProtocolTrigger::Serializer
 	ProtocolTrigger::SerializedMessage Serialize(const ProtocolTrigger::Message& msg, const ProtocolTrigger::TagSelection& tagwl) const ;
 };
 
+/* 
+ * Binary safe serializer, negotiated with 'PROTOCOL bulk'. Commands are
+ * sent as a count of arguments, followed by every argument prefixed
+ * with its length:
+ *
+ *         · *<arguments>\r\n
+ *         · $<length>\r\n<bytes>\r\n	: Once per argument, command first.
+ *
+ * Arguments may hold any byte and are not tokenized, so large values are
+ * copied from input as they are, without scanning them. Values are not
+ * quoted, neither in commands nor in replies (see User::IsDelimited). First argument
+ * may hold tags, prefixed with '@'. Replies use the same format, with 
+ * tags and source (prefixed with ':') first, when present.
+ */
+
+class BulkSerializer : public ProtocolTrigger::Serializer
+{
+ private:
+
+	/* 
+	 * Reads a header (*<arguments> or $<length>).
+	 *
+	 * @parameters:
+	 *
+	 *         · string	: Input received.
+	 *         · size_t	: Offset of header, moved past it when read.
+	 *         · char	: Header type.
+	 *         · uint64_t	: Value read.
+	 *
+	 * @return:
+	 *
+	 *         · int	: 1 if read, 0 if more input is needed, or -1 if malformed.
+	 */
+
+	static int ReadHeader(const std::string& input, std::string::size_type& pos, char type, uint64_t& value);
+
+	static void AppendBulk(std::string& line, const std::string& data);
+
+ public:
+
+	BulkSerializer(Module* mod) : ProtocolTrigger::Serializer(mod, "bulk")
+	{
+		
+	}
+
+	bool IsFramed() const
+	{
+		return true;
+	}
+
+	/* Not used, as input is not split in lines. */
+
+	bool Parse(LocalUser* user, const std::string& line, ProtocolTrigger::ParseOutput& parseoutput)
+	{
+		return false;
+	}
+
+	long Extract(LocalUser* user, const std::string& input, std::string::size_type pos, ProtocolTrigger::FrameState& frame, ProtocolTrigger::ParseOutput& parseoutput);
+	ProtocolTrigger::SerializedMessage Serialize(const ProtocolTrigger::Message& msg, const ProtocolTrigger::TagSelection& tagwl) const ;
+};
+
 bool Serializer::Parse(LocalUser* user, const std::string& line, ProtocolTrigger::ParseOutput& parseoutput)
 {
 	size_t start = line.find_first_not_of(" ");
@@ -69,25 +261,7 @@ bool Serializer::Parse(LocalUser* user, const std::string& line, ProtocolTrigger
 			tokens.get_message().erase(maxbrldline);
 		}
 		
-		std::string tagval;
-		engine::node_stream ss(token.substr(1), ';');
-		
-		while (ss.items_extract(token))
-		{
-			const std::string::size_type p = token.find('=');
-		
-			if (p != std::string::npos)
-			{
-				tagval.assign(token, p+1, std::string::npos);
-				token.erase(p);
-			}
-			else
-			{
-				tagval.clear();
-			}
-
-			HandleTag(user, token, tagval, parseoutput.tags);
-		}
+		ParseTags(this, user, token.substr(1), parseoutput.tags);
 		
 		if (!tokens.get_middle(token))
 		{
@@ -110,101 +284,242 @@ bool Serializer::Parse(LocalUser* user, const std::string& line, ProtocolTrigger
 		parseoutput.params.push_back(token);
 	}
 
+	Negotiate(user, parseoutput);
 	return true;
 }
 
-namespace
+ProtocolTrigger::SerializedMessage Serializer::Serialize(const ProtocolTrigger::Message& msg, const ProtocolTrigger::TagSelection& tagwl) const
 {
-	void CheckTagLength(std::string& line, size_t prevsize, size_t& length, size_t maxlength)
+	std::string line;
+	SerializeTags(msg.GetTags(), tagwl, line);
+
+	if (!line.empty())
 	{
-		const std::string::size_type diffsize = line.size() - prevsize;
+		line.push_back(' ');
+	}
+
+	const std::string::size_type brldmsg_begin = line.size();
+
+	if (msg.GetSource())
+	{
+		line.push_back(':');
+		line.append(*msg.GetSource());
+		line.push_back(' ');
+	}
 	
-		if (length + diffsize > maxlength)
+	line.append(msg.GetCommand());
+
+	const ProtocolTrigger::Message::ParamList& params = msg.GetParams();
+
+	if (!params.empty())
+	{
+		for (ProtocolTrigger::Message::ParamList::const_iterator i = params.begin(); i != params.end()-1; ++i)
 		{
-			line.erase(prevsize);
+			const std::string& param = *i;
+			line.push_back(' ');
+			line.append(param);
 		}
-		else
+
+		line.append(" :", 2).append(params.back());
+	}
+
+	if (line.length() - brldmsg_begin > INPUT_LIMIT)
+	{
+		line.erase(brldmsg_begin + INPUT_LIMIT);
+	}
+
+	line.append("\r\n", 2);
+	return line;
+}
+
+int BulkSerializer::ReadHeader(const std::string& input, std::string::size_type& pos, char type, uint64_t& value)
+{
+	if (pos >= input.size())
+	{
+		return 0;
+	}
+
+	if (input[pos] != type)
+	{
+		return -1;
+	}
+
+	value = 0;
+
+	for (std::string::size_type i = pos + 1; i < input.size(); ++i)
+	{
+		const char c = input[i];
+
+		if (c == '\r')
 		{
-			length += diffsize;
+			if (i == pos + 1)
+			{
+				return -1;
+			}
+
+			if (i + 1 == input.size())
+			{
+				return 0;
+			}
+
+			if (input[i + 1] != '\n')
+			{
+				return -1;
+			}
+
+			pos = i + 2;
+			return 1;
+		}
+
+		/* Values are limited to 18 digits, so they cannot overflow. */
+
+		if (c < '0' || c > '9' || i - pos > 18)
+		{
+			return -1;
 		}
+
+		value = value * 10 + (c - '0');
 	}
+
+	return 0;
 }
 
-void Serializer::SerializeTags(const ProtocolTrigger::TagMap& tags, const ProtocolTrigger::TagSelection& tagwl, std::string& line)
+long BulkSerializer::Extract(LocalUser* user, const std::string& input, std::string::size_type pos, ProtocolTrigger::FrameState& frame, ProtocolTrigger::ParseOutput& parseoutput)
 {
-	size_t client_tag_length = 0;
-	size_t server_tag_length = 0;
-	
-	for (ProtocolTrigger::TagMap::const_iterator i = tags.begin(); i != tags.end(); ++i)
+	/* Parsing resumes where previous reads left it, so each byte is parsed once. */
+
+	std::string::size_type cur = pos + frame.parsed;
+	int found;
+
+	if (!frame.count)
 	{
-		if (!tagwl.IsSelected(tags, i))
+		uint64_t count;
+		found = ReadHeader(input, cur, '*', count);
+
+		if (found <= 0)
 		{
-			continue;
+			return found;
 		}
 
-		const std::string::size_type prevsize = line.size();
-		line.push_back(prevsize ? ';' : '@');
-		line.append(i->first);
-		const std::string& val = i->second.value;
-		
-		if (!val.empty())
+		if (!count || count > BULK_ARGS)
 		{
-			line.push_back('=');
-			line.append(val);
+			return -1;
 		}
-		
-		if (i->first[0] == '+')
+
+		frame.count = count;
+		frame.parsed = cur - pos;
+	}
+
+	/* Whole command must be received before any argument is copied. */
+
+	while (frame.args.size() < frame.count)
+	{
+		uint64_t length;
+		found = ReadHeader(input, cur, '$', length);
+
+		if (found <= 0)
 		{
-			CheckTagLength(line, prevsize, client_tag_length, MAX_CLIENT_MESSAGE_TAG_LENGTH);
+			return found;
 		}
-		else
+
+		if (length > BULK_LIMIT || cur - pos + length > BULK_LIMIT)
 		{
-			CheckTagLength(line, prevsize, server_tag_length, MAX_SERVER_MESSAGE_TAG_LENGTH);
+			return -1;
 		}
+
+		if (input.size() - cur < length + 2)
+		{
+			return 0;
+		}
+
+		if (input[cur + length] != '\r' || input[cur + length + 1] != '\n')
+		{
+			return -1;
+		}
+
+		frame.args.push_back(std::make_pair(cur - pos, length));
+		cur += length + 2;
+		frame.parsed = cur - pos;
 	}
 
-	if (!line.empty())
+	std::vector<std::pair<size_t, size_t> >::const_iterator arg = frame.args.begin();
+
+	if (arg->second && input[pos + arg->first] == '@')
 	{
-		line.push_back(' ');
+		ParseTags(this, user, input.substr(pos + arg->first + 1, arg->second - 1), parseoutput.tags);
+		++arg;
 	}
-	
+
+	if (arg == frame.args.end())
+	{
+		return -1;
+	}
+
+	parseoutput.cmd.assign(input, pos + arg->first, arg->second);
+	parseoutput.params.reserve(frame.args.end() - arg - 1);
+
+	for (++arg; arg != frame.args.end(); ++arg)
+	{
+		parseoutput.params.push_back(input.substr(pos + arg->first, arg->second));
+	}
+
+	const long used = frame.parsed;
+	frame.Reset();
+
+	Negotiate(user, parseoutput);
+	return used;
 }
 
-ProtocolTrigger::SerializedMessage Serializer::Serialize(const ProtocolTrigger::Message& msg, const ProtocolTrigger::TagSelection& tagwl) const
+void BulkSerializer::AppendBulk(std::string& line, const std::string& data)
 {
-	std::string line;
-	SerializeTags(msg.GetTags(), tagwl, line);
-	const std::string::size_type brldmsg_begin = line.size();
+	line.push_back('$');
+	line.append(convto_string(data.length()));
+	line.append("\r\n", 2);
+	line.append(data);
+	line.append("\r\n", 2);
+}
 
-	if (msg.GetSource())
+ProtocolTrigger::SerializedMessage BulkSerializer::Serialize(const ProtocolTrigger::Message& msg, const ProtocolTrigger::TagSelection& tagwl) const
+{
+	std::string tags;
+	SerializeTags(msg.GetTags(), tagwl, tags);
+
+	const ProtocolTrigger::Message::ParamList& params = msg.GetParams();
+	const size_t count = params.size() + 1 + !tags.empty() + (msg.GetSource() != NULL);
+	size_t length = tags.length() + strlen(msg.GetCommand());
+
+	for (ProtocolTrigger::Message::ParamList::const_iterator i = params.begin(); i != params.end(); ++i)
 	{
-		line.push_back(':');
-		line.append(*msg.GetSource());
-		line.push_back(' ');
+		const std::string& param = *i;
+		length += param.length();
 	}
-	
-	line.append(msg.GetCommand());
 
-	const ProtocolTrigger::Message::ParamList& params = msg.GetParams();
+	/* Line is reserved up front, so large values are copied only once. */
 
-	if (!params.empty())
+	std::string line;
+	line.reserve(length + (count + 1) * 24);
+
+	line.push_back('*');
+	line.append(convto_string(count));
+	line.append("\r\n", 2);
+
+	if (!tags.empty())
 	{
-		for (ProtocolTrigger::Message::ParamList::const_iterator i = params.begin(); i != params.end()-1; ++i)
-		{
-			const std::string& param = *i;
-			line.push_back(' ');
-			line.append(param);
-		}
+		AppendBulk(line, tags);
+	}
 
-		line.append(" :", 2).append(params.back());
+	if (msg.GetSource())
+	{
+		AppendBulk(line, ":" + *msg.GetSource());
 	}
 
-	if (line.length() - brldmsg_begin > INPUT_LIMIT)
+	AppendBulk(line, msg.GetCommand());
+
+	for (ProtocolTrigger::Message::ParamList::const_iterator i = params.begin(); i != params.end(); ++i)
 	{
-		line.erase(brldmsg_begin + INPUT_LIMIT);
+		AppendBulk(line, *i);
 	}
 
-	line.append("\r\n", 2);
 	return line;
 }
 
@@ -214,9 +529,11 @@ class ModuleCoreSerializer : public Module
   
 	Serializer serializer;
 
+	BulkSerializer bulk;
+
  public:
  
-	ModuleCoreSerializer() : serializer(this)
+	ModuleCoreSerializer() : serializer(this), bulk(this)
 	{
 	
 	}
@@ -230,7 +547,7 @@ class ModuleCoreSerializer : public Module
 
 		LocalUser* const user = IS_LOCAL(static_cast<User*>(item));
 	
-		if ((user) && (user->serializer == &serializer))
+		if ((user) && (user->serializer == &serializer || user->serializer == &bulk))
 		{
 			Kernel->Clients->Disconnect(user, "Protocol serializer module unloading");
 		}
@@ -246,7 +563,7 @@ class ModuleCoreSerializer : public Module
 
 	Version GetDescription() 
 	{
-		return Version("Provides a Serializer to the client.", VF_CORE|VF_BERYLDB);
+		return Version("Provides brld and bulk serializers to the client.", VF_CORE|VF_BERYLDB);
 	}
 };
 
@@ -16,6 +16,7 @@
 #include "channelmanager.h"
 #include "engine.h"
 #include "stats.h"
+#include "monitor.h"
 
 class CommandStatus : public Command
 {
@@ -106,10 +107,36 @@ void CommandStatus::PreloadData(Status::Context& status)
 		{
                         status.AppendLine(BRLD_ITEM_LIST, Daemon::Format("Cores: %u", CORE_COUNT));
                         status.AppendLine(BRLD_ITEM_LIST, Daemon::Format("Threads: %u", Kernel->Store->Flusher->CountThreads()));
+                        status.AppendLine(BRLD_ITEM_LIST, Daemon::Format("Pooled queries: %lu", (unsigned long)QueryPool::Pooled()));
+                        status.AppendLine(BRLD_ITEM_LIST, Daemon::Format("Monitor drops: %lu", (unsigned long)Kernel->Monitor->GetDropped()));
 		}                        
                         
 		break;
 		
+		case 'e':
+		{
+			status.AppendLine(BRLD_ITEM_LIST, Daemon::Format("Expires: %u", Kernel->Store->Expires->CountAll()));
+			status.AppendLine(BRLD_ITEM_LIST, Daemon::Format("Expired: %lu", (unsigned long)Kernel->Store->Expires->GetExpired()));
+			status.AppendLine(BRLD_ITEM_LIST, Daemon::Format("Expire lag: %lus", (unsigned long)Kernel->Store->Expires->GetLag()));
+		}
+
+		break;
+
+		case 'h':
+		{
+			const uint64_t hits = Kernel->Store->Hot->GetHits();
+			const uint64_t misses = Kernel->Store->Hot->GetMisses();
+			const uint64_t total = hits + misses;
+
+			status.AppendLine(BRLD_ITEM_LIST, Daemon::Format("Hot keys: %lu/%lu", (unsigned long)Kernel->Store->Hot->Count(), (unsigned long)Kernel->Store->Hot->GetCapacity()));
+			status.AppendLine(BRLD_ITEM_LIST, Daemon::Format("Hits: %lu", (unsigned long)hits));
+			status.AppendLine(BRLD_ITEM_LIST, Daemon::Format("Misses: %lu", (unsigned long)misses));
+			status.AppendLine(BRLD_ITEM_LIST, Daemon::Format("Rejected: %lu", (unsigned long)Kernel->Store->Hot->GetRejected()));
+			status.AppendLine(BRLD_ITEM_LIST, Daemon::Format("Hit ratio: %.2f%%", total ? (hits * 100.0) / total : 0.0));
+		}
+
+		break;
+
 		case 'u':
 		{
 			status.AppendLine(BRLD_ITEM_LIST, Daemon::Uptime("", Kernel->GetUptime()));
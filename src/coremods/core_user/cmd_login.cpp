@@ -34,6 +34,36 @@ COMMAND_RESULT CommandLogin::HandleLocal(LocalUser* user, const Params& paramete
 		return FAILED;
 	}
 
+	if (user->GetLogged())
+	{
+		user->SendProtocol(ERR_INPUT, ALREADY_LOGGED);
+		return FAILED;
+	}
+
+	/* Verified recently, so bcrypt is not needed. */
+
+	if (Kernel->Logins->InCache(newlogin, user->auth))
+	{
+		return CommandLogin::Finish(user, newlogin);
+	}
+
+	CommandLogin::Verify(user, newlogin, user->auth);
+	return SUCCESS;
+}
+
+void CommandLogin::Verify(LocalUser* user, const std::string& newlogin, const std::string& pass)
+{
+	std::shared_ptr<login_query> query = QueryPool::Make<login_query>();
+	query->login = newlogin;
+	query->pass = pass;
+	query->provider = Kernel->Modules->DataModule<HashProvider>("hash/bcrypt");
+	query->generation = Kernel->Logins->GetGeneration();
+
+	Kernel->Logins->Workers.Submit(user, query);
+}
+
+COMMAND_RESULT CommandLogin::Finish(LocalUser* user, const std::string& newlogin)
+{
 	if (!user->SetLogin(newlogin))
 	{
 		return FAILED;
@@ -70,6 +100,40 @@ COMMAND_RESULT CommandLogin::HandleLocal(LocalUser* user, const Params& paramete
 	return SUCCESS;
 }
 
+void login_query::Run()
+{
+        this->verified = UserHelper::CheckPass(this->provider, this->login, this->pass);
+        this->SetOK();
+}
+
+void login_query::Process()
+{
+        LocalUser* localuser = IS_LOCAL(this->user);
+
+        if (!localuser)
+        {
+                return;
+        }
+
+        /* Credentials were removed meanwhile (ie, user disabled), so these are verified again. */
+
+        if (this->generation != Kernel->Logins->GetGeneration())
+        {
+                CommandLogin::Verify(localuser, this->login, this->pass);
+                return;
+        }
+
+        if (!this->verified)
+        {
+                localuser->SendProtocol(ERR_WRONG_PASS);
+                Kernel->Clients->Disconnect(localuser, "Wrong password.");
+                return;
+        }
+
+        Kernel->Logins->Add(this->login, this->pass);
+        CommandLogin::Finish(localuser, this->login);
+}
+
 CommandAuth::CommandAuth(Module* parent) : MultiCommand(parent, "AUTH", 1, 1)
 {
 	pre_reg_ok 	= true;
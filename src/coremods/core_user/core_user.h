@@ -15,7 +15,9 @@
 
 #include "beryl.h"
 #include "modules/message.h"
+#include "modules/encrypt.h"
 #include "managers/settings.h"
+#include "managers/user.h"
 #include "brldb/dbmanager.h"
 
 /* 
@@ -34,6 +36,56 @@ class CommandLogin : public MultiCommand
 	CommandLogin(Module* parent);
 	
 	COMMAND_RESULT HandleLocal(LocalUser* user, const Params& parameters);
+
+        /* 
+         * Logins an user whose password has been verified.
+         * 
+         * @parameters:
+	 *
+	 *         · user: User to login.
+	 *         · login: Login verified.
+         */    
+
+	static COMMAND_RESULT Finish(LocalUser* user, const std::string& login);
+
+        /* Verifies a password from an AuthPool thread (see login_query). */
+
+	static void Verify(LocalUser* user, const std::string& login, const std::string& pass);
+};
+
+/* 
+ * Verifies a password from an AuthPool thread. Users remain in
+ * REG_LOGINUSER until this query is delivered.
+ */
+
+class login_query : public QueryBase
+{
+   public:
+
+        /* Login and password to verify. */
+
+        std::string login;
+
+        std::string pass;
+
+        /* Found from the mainloop, as modules may not be looked up from threads. */
+
+        HashProvider* provider;
+
+        /* LoginCache generation when this request was submitted. */
+
+        uint64_t generation;
+
+        bool verified;
+
+        login_query() : provider(NULL), generation(0), verified(false)
+        {
+
+        }
+
+        void Run();
+
+        void Process();
 };
 
 /* 
@@ -24,7 +24,7 @@ CommandVExist::CommandVExist(Module* Creator) : Command(Creator, "VEXISTS", 2, 2
 
 COMMAND_RESULT CommandVExist::Handle(User* user, const Params& parameters)
 {  
-       KeyHelper::Simple(user, std::make_shared<vexist_query>(), parameters[0], parameters.back());
+       KeyHelper::Simple(user, QueryPool::Make<vexist_query>(), parameters[0], parameters.back());
        return SUCCESS;  
 }
 
@@ -44,7 +44,7 @@ COMMAND_RESULT CommandVPos::Handle(User* user, const Params& parameters)
               return FAILED;
        }
        
-       KeyHelper::SimpleRetro(user, std::make_shared<vpos_query>(), parameters[0], value);
+       KeyHelper::SimpleRetro(user, QueryPool::Make<vpos_query>(), parameters[0], value);
        return SUCCESS;  
 }
 
@@ -58,7 +58,7 @@ CommandVGet::CommandVGet(Module* Creator) : Command(Creator, "VGET", 1, 3)
 
 COMMAND_RESULT CommandVGet::Handle(User* user, const Params& parameters)
 {  
-       KeyHelper::RetroLimits(user, std::make_shared<vget_query>(), parameters[0], this->offset, this->limit);
+       KeyHelper::RetroLimits(user, QueryPool::Make<vget_query>(), parameters[0], this->offset, this->limit);
        return SUCCESS;  
 }
 
@@ -71,7 +71,7 @@ CommandVCount::CommandVCount(Module* Creator) : Command(Creator, "VCOUNT", 1, 1)
 
 COMMAND_RESULT CommandVCount::Handle(User* user, const Params& parameters)
 {  
-       KeyHelper::Retro(user, std::make_shared<vcount_query>(), parameters[0]);
+       KeyHelper::Retro(user, QueryPool::Make<vcount_query>(), parameters[0]);
        return SUCCESS;  
 }
 
@@ -91,7 +91,7 @@ COMMAND_RESULT CommandVResize::Handle(User* user, const Params& parameters)
               return FAILED;
        }
 
-       KeyHelper::Simple(user, std::make_shared<vresize_query>(), parameters[0], value);
+       KeyHelper::Simple(user, QueryPool::Make<vresize_query>(), parameters[0], value);
        return SUCCESS;  
 }
 
@@ -104,7 +104,7 @@ CommandVKeys::CommandVKeys(Module* Creator) : Command(Creator, "VKEYS", 1, 3)
 
 COMMAND_RESULT CommandVKeys::Handle(User* user, const Params& parameters)
 {  
-       KeyHelper::RetroLimits(user, std::make_shared<vkeys_query>(), parameters[0], this->offset, this->limit, true);
+       KeyHelper::RetroLimits(user, QueryPool::Make<vkeys_query>(), parameters[0], this->offset, this->limit, true);
        return SUCCESS;  
 }
 
@@ -118,7 +118,7 @@ CommandVDel::CommandVDel(Module* Creator) : Command(Creator, "VDEL", 2, 2)
 
 COMMAND_RESULT CommandVDel::Handle(User* user, const Params& parameters)
 {  
-        KeyHelper::Simple(user, std::make_shared<vdel_query>(), parameters[0], parameters.back());
+        KeyHelper::Simple(user, QueryPool::Make<vdel_query>(), parameters[0], parameters.back());
         return SUCCESS;  
 }
 
@@ -131,7 +131,7 @@ CommandVReverse::CommandVReverse(Module* Creator) : Command(Creator, "VREVERSE",
 
 COMMAND_RESULT CommandVReverse::Handle(User* user, const Params& parameters)
 {  
-        KeyHelper::Retro(user, std::make_shared<vreverse_query>(), parameters[0]);
+        KeyHelper::Retro(user, QueryPool::Make<vreverse_query>(), parameters[0]);
         return SUCCESS;  
 }
 
@@ -145,7 +145,7 @@ CommandVRepeats::CommandVRepeats(Module* Creator) : Command(Creator, "VREPEATS",
 
 COMMAND_RESULT CommandVRepeats::Handle(User* user, const Params& parameters)
 {  
-        KeyHelper::Simple(user, std::make_shared<vrepeats_query>(), parameters[0], parameters.back());
+        KeyHelper::Simple(user, QueryPool::Make<vrepeats_query>(), parameters[0], parameters.back());
         return SUCCESS;  
 }
 
@@ -158,7 +158,7 @@ CommandVSort::CommandVSort(Module* Creator) : Command(Creator, "VSORT", 1, 1)
 
 COMMAND_RESULT CommandVSort::Handle(User* user, const Params& parameters)
 {  
-        KeyHelper::Retro(user, std::make_shared<vsort_query>(), parameters[0]);
+        KeyHelper::Retro(user, QueryPool::Make<vsort_query>(), parameters[0]);
         return SUCCESS;  
 }
 
@@ -172,7 +172,7 @@ CommandVPush::CommandVPush(Module* Creator) : Command(Creator, "VPUSH", 2, 2)
 
 COMMAND_RESULT CommandVPush::Handle(User* user, const Params& parameters)
 {  
-        KeyHelper::Simple(user, std::make_shared<vpush_query>(), parameters[0], parameters.back());
+        KeyHelper::Simple(user, QueryPool::Make<vpush_query>(), parameters[0], parameters.back());
         return SUCCESS;  
 }
 
@@ -185,7 +185,7 @@ CommandVPopFront::CommandVPopFront(Module* Creator) : Command(Creator, "VPOPFRON
 
 COMMAND_RESULT CommandVPopFront::Handle(User* user, const Params& parameters)
 {  
-        KeyHelper::Retro(user, std::make_shared<vpop_front_query>(), parameters[0]);
+        KeyHelper::Retro(user, QueryPool::Make<vpop_front_query>(), parameters[0]);
         return SUCCESS;  
 }
 
@@ -199,7 +199,7 @@ CommandVPopBack::CommandVPopBack(Module* Creator) : Command(Creator, "VPOPBACK",
 
 COMMAND_RESULT CommandVPopBack::Handle(User* user, const Params& parameters)
 {  
-        KeyHelper::Retro(user, std::make_shared<vpop_back_query>(), parameters[0]);
+        KeyHelper::Retro(user, QueryPool::Make<vpop_back_query>(), parameters[0]);
         return SUCCESS;  
 }
 
@@ -212,7 +212,7 @@ CommandVAvg::CommandVAvg(Module* Creator) : Command(Creator, "VAVG", 1, 1)
 
 COMMAND_RESULT CommandVAvg::Handle(User* user, const Params& parameters)
 {  
-       KeyHelper::Retro(user, std::make_shared<vavg_query>(), parameters[0]);
+       KeyHelper::Retro(user, QueryPool::Make<vavg_query>(), parameters[0]);
        return SUCCESS;  
 }
 
@@ -225,7 +225,7 @@ CommandVHigh::CommandVHigh(Module* Creator) : Command(Creator, "VHIGH", 1, 1)
 
 COMMAND_RESULT CommandVHigh::Handle(User* user, const Params& parameters)
 {  
-       KeyHelper::Retro(user, std::make_shared<vhigh_query>(), parameters[0]);
+       KeyHelper::Retro(user, QueryPool::Make<vhigh_query>(), parameters[0]);
        return SUCCESS;  
 }
 
@@ -238,7 +238,7 @@ CommandVLow::CommandVLow(Module* Creator) : Command(Creator, "VLOW", 1, 1)
 
 COMMAND_RESULT CommandVLow::Handle(User* user, const Params& parameters)
 {  
-       KeyHelper::Retro(user, std::make_shared<vlow_query>(), parameters[0]);
+       KeyHelper::Retro(user, QueryPool::Make<vlow_query>(), parameters[0]);
        return SUCCESS;  
 }
 
@@ -251,7 +251,44 @@ CommandVSum::CommandVSum(Module* Creator) : Command(Creator, "VSUM", 1, 1)
 
 COMMAND_RESULT CommandVSum::Handle(User* user, const Params& parameters)
 {  
-       KeyHelper::Retro(user, std::make_shared<vsum_query>(), parameters[0]);
+       KeyHelper::Retro(user, QueryPool::Make<vsum_query>(), parameters[0]);
+       return SUCCESS;  
+}
+
+CommandVType::CommandVType(Module* Creator) : Command(Creator, "VTYPE", 2, 2)
+{
+        check_key       =       0;
+        group 		= 	'v';
+        syntax 		= 	"<key> <string|int|double>";
+}
+
+COMMAND_RESULT CommandVType::Handle(User* user, const Params& parameters)
+{  
+       const std::string& type = parameters[1];
+       VECTOR_TYPE numeric;
+
+       if (stdhelpers::string::equalsci(type, "string"))
+       {
+              numeric = VECTOR_TYPE_STRING;
+       }
+       else if (stdhelpers::string::equalsci(type, "int"))
+       {
+              numeric = VECTOR_TYPE_INT;
+       }
+       else if (stdhelpers::string::equalsci(type, "double"))
+       {
+              numeric = VECTOR_TYPE_DOUBLE;
+       }
+       else
+       {
+              user->SendProtocol(ERR_INPUT, INVALID_TYPE);
+              return FAILED;
+       }
+
+       std::shared_ptr<vtype_query> query = QueryPool::Make<vtype_query>();
+       query->data = numeric;
+
+       KeyHelper::Retro(user, query, parameters[0]);
        return SUCCESS;  
 }
 
@@ -265,7 +302,7 @@ CommandVPushNX::CommandVPushNX(Module* Creator) : Command(Creator, "VPUSHNX", 2,
 
 COMMAND_RESULT CommandVPushNX::Handle(User* user, const Params& parameters)
 {  
-        KeyHelper::Simple(user, std::make_shared<vpushnx_query>(), parameters[0], parameters.back());
+        KeyHelper::Simple(user, QueryPool::Make<vpushnx_query>(), parameters[0], parameters.back());
         return SUCCESS;  
 }
 
@@ -280,8 +317,8 @@ CommandVFind::CommandVFind(Module* Creator) : Command(Creator, "VFIND", 2, 4)
 
 COMMAND_RESULT CommandVFind::Handle(User* user, const Params& parameters)
 {  
-       std::shared_ptr<vdel_query> query = std::make_shared<vdel_query>();
-       query->value 			 = stripe(parameters.back());
+       std::shared_ptr<vdel_query> query = QueryPool::Make<vdel_query>();
+       query->value 			 = stripe(user, parameters.back());
        
        KeyHelper::RetroLimits(user, query, parameters[0], this->offset, this->limit);
        return SUCCESS;  
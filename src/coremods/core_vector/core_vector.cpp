@@ -39,6 +39,7 @@ class CoreModuleVector : public Module
         CommandVFind 		cmdvfind;
         CommandVFront 		cmdvfront;
         CommandVBack 		cmdvback;
+        CommandVType 		cmdvtype;
         
     public:	
         
@@ -62,7 +63,8 @@ class CoreModuleVector : public Module
                              cmdvpushnx(this),
                              cmdvfind(this),
                              cmdvfront(this),
-                             cmdvback(this)
+                             cmdvback(this),
+                             cmdvtype(this)
                              
 
         {
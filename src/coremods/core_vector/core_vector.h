@@ -17,6 +17,7 @@
 #include "extras.h"
 
 #include "managers/keys.h"
+#include "brldb/packed_vector.h"
 
 /* 
  * VLow returns lowest number in a vector.
@@ -362,6 +363,29 @@ class CommandVAvg : public Command
         COMMAND_RESULT Handle(User* user, const Params& parameters);
 };
 
+/* 
+ * VType changes the way items in a vector are stored. Numeric vectors
+ * (int or double) only accept numbers, and are aggregated faster.
+ * 
+ * @parameters:
+ *
+ *         · string	: Destination vector.
+ *         · string	: string, int or double.
+ * 
+ * @protocol:
+ *
+ *         · enum	: OK or ERROR.
+ */
+ 
+class CommandVType : public Command 
+{
+    public: 
+
+        CommandVType(Module* parent);
+
+        COMMAND_RESULT Handle(User* user, const Params& parameters);
+};
+
 /* 
  * VSum sums all items in a vector.
  * 
@@ -0,0 +1,162 @@
+/*
+ * BerylDB - A lightweight database.
+ * http://www.beryldb.com
+ *
+ * Copyright (C) 2021 - Carlos F. Ferry <cferry@beryldb.com>
+ * 
+ * This file is part of BerylDB. BerylDB is free software: you can
+ * redistribute it and/or modify it under the terms of the BSD License
+ * version 3.
+ *
+ * More information about our licensing can be found at https://docs.beryl.dev
+ */
+
+#include "beryl.h"
+#include "core_zsets.h"
+
+namespace
+{
+        bool CheckScore(User* user, const std::string& score)
+        {
+                double parsed;
+
+                if (!ZSetStore::ParseScore(score, parsed))
+                {
+                        user->SendProtocol(ERR_INPUT, MUST_BE_NUMERIC);
+                        return false;
+                }
+
+                return true;
+        }
+}
+
+CommandZAdd::CommandZAdd(Module* Creator) : Command(Creator, "ZADD", 3, 3)
+{
+       check_value      =       true;
+       check_key        =       0;
+       group 		= 	'z';
+       syntax 		= 	"<key> <score> \"member\"";
+}
+
+COMMAND_RESULT CommandZAdd::Handle(User* user, const Params& parameters)
+{  
+       const std::string& score 	= 	parameters[1];
+
+       if (!CheckScore(user, score))
+       {
+              return FAILED;
+       }
+
+       KeyHelper::HeshVal(user, QueryPool::Make<zadd_query>(), parameters[0], score, stripe(user, parameters.back()));
+       return SUCCESS;  
+}
+
+CommandZRem::CommandZRem(Module* Creator) : Command(Creator, "ZREM", 2, 2)
+{
+       check_value      =       true;
+       check_key        =       0;
+       group 		= 	'z';
+       syntax 		= 	"<key> \"member\"";
+}
+
+COMMAND_RESULT CommandZRem::Handle(User* user, const Params& parameters)
+{  
+       KeyHelper::Simple(user, QueryPool::Make<zrem_query>(), parameters[0], parameters.back());
+       return SUCCESS;  
+}
+
+CommandZScore::CommandZScore(Module* Creator) : Command(Creator, "ZSCORE", 2, 2)
+{
+       check_value      =       true;
+       check_key        =       0;
+       group 		= 	'z';
+       syntax 		= 	"<key> \"member\"";
+}
+
+COMMAND_RESULT CommandZScore::Handle(User* user, const Params& parameters)
+{  
+       KeyHelper::Simple(user, QueryPool::Make<zscore_query>(), parameters[0], parameters.back());
+       return SUCCESS;  
+}
+
+CommandZCount::CommandZCount(Module* Creator) : Command(Creator, "ZCOUNT", 1, 1)
+{
+       check_key        =       0;
+       group 		= 	'z';
+       syntax 		= 	"<key>";
+}
+
+COMMAND_RESULT CommandZCount::Handle(User* user, const Params& parameters)
+{  
+       KeyHelper::Retro(user, QueryPool::Make<zcount_query>(), parameters[0]);
+       return SUCCESS;  
+}
+
+CommandZRank::CommandZRank(Module* Creator) : Command(Creator, "ZRANK", 2, 2)
+{
+       check_value      =       true;
+       check_key        =       0;
+       group 		= 	'z';
+       syntax 		= 	"<key> \"member\"";
+}
+
+COMMAND_RESULT CommandZRank::Handle(User* user, const Params& parameters)
+{  
+       KeyHelper::Simple(user, QueryPool::Make<zrank_query>(), parameters[0], parameters.back());
+       return SUCCESS;  
+}
+
+CommandZRange::CommandZRange(Module* Creator) : Command(Creator, "ZRANGE", 3, 3)
+{
+       check_key        =       0;
+       group 		= 	'z';
+       syntax 		= 	"<key> <start> <stop>";
+}
+
+COMMAND_RESULT CommandZRange::Handle(User* user, const Params& parameters)
+{  
+       const std::string& start 	= 	parameters[1];
+       const std::string& stop 		= 	parameters[2];
+
+       if (!CheckValid(user, start) || !CheckValid(user, stop))
+       {
+              return FAILED;
+       }
+
+       KeyHelper::RetroLimits(user, QueryPool::Make<zrange_query>(), parameters[0], convto_num<signed int>(start), convto_num<signed int>(stop));
+       return SUCCESS;  
+}
+
+CommandZRangeByScore::CommandZRangeByScore(Module* Creator) : Command(Creator, "ZRANGEBYSCORE", 3, 3)
+{
+       check_key        =       0;
+       group 		= 	'z';
+       syntax 		= 	"<key> <min> <max>";
+}
+
+COMMAND_RESULT CommandZRangeByScore::Handle(User* user, const Params& parameters)
+{  
+       const std::string& min 	= 	parameters[1];
+       const std::string& max 	= 	parameters[2];
+
+       if (!CheckScore(user, min) || !CheckScore(user, max))
+       {
+              return FAILED;
+       }
+
+       KeyHelper::HeshVal(user, QueryPool::Make<zrangebyscore_query>(), parameters[0], min, max);
+       return SUCCESS;  
+}
+
+CommandZPopMin::CommandZPopMin(Module* Creator) : Command(Creator, "ZPOPMIN", 1, 1)
+{
+       check_key        =       0;
+       group 		= 	'z';
+       syntax 		= 	"<key>";
+}
+
+COMMAND_RESULT CommandZPopMin::Handle(User* user, const Params& parameters)
+{  
+       KeyHelper::Retro(user, QueryPool::Make<zpopmin_query>(), parameters[0]);
+       return SUCCESS;  
+}
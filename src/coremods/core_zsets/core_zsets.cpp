@@ -0,0 +1,50 @@
+/*
+ * BerylDB - A lightweight database.
+ * http://www.beryldb.com
+ *
+ * Copyright (C) 2021 - Carlos F. Ferry <cferry@beryldb.com>
+ * 
+ * This file is part of BerylDB. BerylDB is free software: you can
+ * redistribute it and/or modify it under the terms of the BSD License
+ * version 3.
+ *
+ * More information about our licensing can be found at https://docs.beryl.dev
+ */
+
+#include "beryl.h"
+#include "core_zsets.h"
+
+class CoreModuleZSets : public Module
+{
+    private:
+    
+        CommandZAdd 		cmdzadd;
+        CommandZRem 		cmdzrem;
+        CommandZScore 		cmdzscore;
+        CommandZCount 		cmdzcount;
+        CommandZRank 		cmdzrank;
+        CommandZRange 		cmdzrange;
+        CommandZRangeByScore 	cmdzrangebyscore;
+        CommandZPopMin 		cmdzpopmin;
+         
+    public:	
+        
+        CoreModuleZSets() : cmdzadd(this),
+                            cmdzrem(this),
+                            cmdzscore(this),
+                            cmdzcount(this),
+                            cmdzrank(this),
+                            cmdzrange(this),
+                            cmdzrangebyscore(this),
+                            cmdzpopmin(this)
+        {
+        
+        }
+        
+        Version GetDescription() 
+        {
+                return Version("Provides commands to handle sorted sets.", VF_BERYLDB|VF_CORE);
+        }
+};
+
+MODULE_LOAD(CoreModuleZSets)
@@ -0,0 +1,198 @@
+/*
+ * BerylDB - A lightweight database.
+ * http://www.beryldb.com
+ *
+ * Copyright (C) 2021 - Carlos F. Ferry <cferry@beryldb.com>
+ * 
+ * This file is part of BerylDB. BerylDB is free software: you can
+ * redistribute it and/or modify it under the terms of the BSD License
+ * version 3.
+ *
+ * More information about our licensing can be found at https://docs.beryl.dev
+ */
+
+#include "beryl.h"
+#include "engine.h"
+#include "maker.h"
+#include "extras.h"
+#include "managers/keys.h"
+#include "brldb/zset_store.h"
+
+/* 
+ * ZAdd adds a member to a sorted set, or updates its score
+ * if member is already in the set.
+ * 
+ * @parameters:
+ *
+ *         · string	: Sorted set key.
+ *         · double	: Score (-inf and +inf are valid scores).
+ *         · string	: Member.
+ * 
+ * @protocol:
+ *
+ *         · enum	: OK.
+ */ 
+
+class CommandZAdd : public Command 
+{
+    public: 
+
+        CommandZAdd(Module* parent);
+
+        COMMAND_RESULT Handle(User* user, const Params& parameters);
+};
+
+/* 
+ * ZRem removes a member from a sorted set.
+ * 
+ * @parameters:
+ *
+ *         · string	: Sorted set key.
+ *         · string	: Member to remove.
+ * 
+ * @protocol:
+ *
+ *         · enum	: OK, or NOT_FOUND.
+ */ 
+
+class CommandZRem : public Command 
+{
+    public: 
+
+        CommandZRem(Module* parent);
+
+        COMMAND_RESULT Handle(User* user, const Params& parameters);
+};
+
+/* 
+ * ZScore returns the score of a member.
+ * 
+ * @parameters:
+ *
+ *         · string	: Sorted set key.
+ *         · string	: Member to look for.
+ * 
+ * @protocol:
+ *
+ *         · double	: Score, or NOT_FOUND.
+ */ 
+
+class CommandZScore : public Command 
+{
+    public: 
+
+        CommandZScore(Module* parent);
+
+        COMMAND_RESULT Handle(User* user, const Params& parameters);
+};
+
+/* 
+ * ZCount counts members in a sorted set.
+ * 
+ * @parameters:
+ *
+ *         · string	: Sorted set key.
+ * 
+ * @protocol:
+ *
+ *         · int	: Members in set.
+ */ 
+
+class CommandZCount : public Command 
+{
+    public: 
+
+        CommandZCount(Module* parent);
+
+        COMMAND_RESULT Handle(User* user, const Params& parameters);
+};
+
+/* 
+ * ZRank returns the position of a member, lowest scores first.
+ * 
+ * @parameters:
+ *
+ *         · string	: Sorted set key.
+ *         · string	: Member to look for.
+ * 
+ * @protocol:
+ *
+ *         · int	: Zero based rank, or NOT_FOUND.
+ */ 
+
+class CommandZRank : public Command 
+{
+    public: 
+
+        CommandZRank(Module* parent);
+
+        COMMAND_RESULT Handle(User* user, const Params& parameters);
+};
+
+/* 
+ * ZRange returns members between two ranks, lowest scores first.
+ * Negative ranks count from the end of the set.
+ * 
+ * @parameters:
+ *
+ *         · string	: Sorted set key.
+ *         · int	: First rank.
+ *         · int	: Last rank, included.
+ * 
+ * @protocol:
+ *
+ *         · vector	: Members found.
+ */ 
+
+class CommandZRange : public Command 
+{
+    public: 
+
+        CommandZRange(Module* parent);
+
+        COMMAND_RESULT Handle(User* user, const Params& parameters);
+};
+
+/* 
+ * ZRangeByScore returns members with scores between min and max.
+ * 
+ * @parameters:
+ *
+ *         · string	: Sorted set key.
+ *         · double	: Lowest score.
+ *         · double	: Highest score, included.
+ * 
+ * @protocol:
+ *
+ *         · vector	: Members found.
+ */ 
+
+class CommandZRangeByScore : public Command 
+{
+    public: 
+
+        CommandZRangeByScore(Module* parent);
+
+        COMMAND_RESULT Handle(User* user, const Params& parameters);
+};
+
+/* 
+ * ZPopMin removes the member with lowest score.
+ * 
+ * @parameters:
+ *
+ *         · string	: Sorted set key.
+ * 
+ * @protocol:
+ *
+ *         · vector	: Member removed, followed by its score.
+ */ 
+
+class CommandZPopMin : public Command 
+{
+    public: 
+
+        CommandZPopMin(Module* parent);
+
+        COMMAND_RESULT Handle(User* user, const Params& parameters);
+};
@@ -746,7 +746,7 @@ void Dispatcher::VectorFlush(bool comillas, const std::string& title, QueryBase*
 	
 }
 
-void Dispatcher::MMapFlush(bool comillas, const std::string& title, const std::string& subtitle, QueryBase* query)
+void Dispatcher::MMapFlush(bool comillas, const std::string& title, const std::string& subtitle, QueryBase* query, const DualMMap& items)
 {
         if (query->subresult == 1)
         {
@@ -754,7 +754,7 @@ void Dispatcher::MMapFlush(bool comillas, const std::string& title, const std::s
                 Dispatcher::JustEmerald(query->user, BRLD_START_LIST, Daemon::Format("%-30s | %-10s", title.c_str(), subtitle.c_str()));
                 Dispatcher::JustEmerald(query->user, BRLD_START_LIST, Daemon::Format("%-30s | %-10s", Dispatcher::Repeat("―", 30).c_str(), Dispatcher::Repeat("―", 10).c_str()));
 
-               if (query->mmap.empty())
+               if (items.empty())
                {
                        Dispatcher::JustAPI(query->user, BRLD_END_LIST);
                        return;
@@ -762,7 +762,7 @@ void Dispatcher::MMapFlush(bool comillas, const std::string& title, const std::s
                 
         }
 
-        for (DualMMap::iterator i = query->mmap.begin(); i != query->mmap.end(); ++i)
+        for (DualMMap::const_iterator i = items.begin(); i != items.end(); ++i)
         {
                  std::string ikey = i->first;
                  std::string item;
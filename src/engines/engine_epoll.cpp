@@ -139,9 +139,9 @@ void SocketPool::DeleteDescriptor(EventHandler* ehandler)
 	SocketPool::DeleteFileDescRef(ehandler);
 }
 
-int SocketPool::Events()
+int SocketPool::Events(int timeout)
 {
-	int i = epoll_wait(SocketHandler, &events[0], events.size(), 5);
+	int i = epoll_wait(SocketHandler, &events[0], events.size(), timeout);
 
         Kernel->Now();
 	
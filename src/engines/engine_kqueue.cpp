@@ -133,11 +133,11 @@ void SocketPool::OnMaskReq(EventHandler* ehandler, int old_mask, int new_mask)
 	}
 }
 
-int SocketPool::Events()
+int SocketPool::Events(int timeout)
 {
 	struct timespec ts;
-	ts.tv_nsec = 30000000;
-	ts.tv_sec = 0;
+	ts.tv_nsec = (timeout % 1000) * 1000000;
+	ts.tv_sec = timeout / 1000;
 
 	int i = kevent(SocketHandler, &pendinglist.front(), ChangePos, &ke_list.front(), ke_list.size(), &ts);
 	ChangePos = 0;
@@ -23,9 +23,13 @@ User::User(const std::string& uid, Server* srv, UserType type) :
                                         	  age(Kernel->Now())
                                         	, connected(0)
                                         	, logged(0)
-                                        	, Locked(false)	 
+                                        	, inflight(0)
+                                        	, issued(1)
+                                        	, delivered(1)
+                                        	, barrier(0)
+                                        	, delivering(false)
                                         	, Multi(false)
-                                        	, MultiRunning(false)
+                                        	, WatchEpoch(0)
                                         	, Paused(false)
                                         	, uuid(uid)
                                         	, server(srv)
@@ -51,10 +55,6 @@ User::User(const std::string& uid, Server* srv, UserType type) :
 	/* By default, usersr are not quitting. */
 	
         this->SetQuit(false);
-	
-	/* Any user should be allowed to process queries by default. */
-		
-	this->SetLock(false);
 }
 
 LocalUser::LocalUser(int myfd, engine::sockets::sockaddrs* client, engine::sockets::sockaddrs* servaddr)
@@ -83,9 +83,21 @@ LocalUser::LocalUser(int myfd, const std::string& uid, Serializable::Data& data)
 	Deserialize(data);
 }
 
+void User::Unwatch()
+{
+        if (this->Watching.empty())
+        {
+              return;
+        }
+
+        Kernel->Store->Watches->Unwatch(this->Watching);
+        this->Watching.clear();
+}
+
 User::~User()
 {
-        this->SetLock(false);
+        DataFlush::Forget(this);
+        this->Unwatch();
         
         /* We remove this user from monitoring list, if applicable. */
         
@@ -139,14 +151,15 @@ bool User::IsQuitting()
         return this->quitting;
 }
 
-void User::SetLock(bool flag)
+bool User::IsLocked()
 {
-        this->Locked = flag;
+        return (this->inflight > 0);
 }
 
-bool User::IsLocked()
+bool User::IsDelimited()
 {
-        return this->Locked;
+        LocalUser* const local = IS_LOCAL(this);
+        return (local && local->serializer->IsFramed());
 }
 
 const std::string& User::GetHostFormat()
@@ -305,63 +318,113 @@ int User::GetFirstFlag()
 
 void InstanceStream::StreamData()
 {
-	if (user->IsQuitting())
+	/* 
+	 * Serializer may be changed by any command (see core_serialize), in which
+	 * case remaining input is read by the new one.
+	 */
+
+	while (!user->IsQuitting() && (user->serializer->IsFramed() ? StreamFrames() : StreamLines()))
 	{
-		return;
+		checked_until = 0;
+		frame.Reset();
 	}
+}
+
+bool InstanceStream::StreamLines()
+{
+	ProtocolTrigger::Serializer* const serializer = user->serializer;
 
 	std::string line;
 
 	std::string::size_type ipos;
 
-	std::string::size_type queueindex;
-
 	while (GetQueueSize() < ULONG_MAX)
 	{
-		ipos = recvq.find('\n', checked_until);
+		/* Lines are read in place: bytes consumed are only removed before next read. */
+
+		ipos = recvq.find('\n', recvpos + checked_until);
 
 		if (ipos == std::string::npos)
 		{
-			checked_until = recvq.length();
-			return;
+			checked_until = recvq.length() - recvpos;
+			return false;
 		}
 
-		line.reserve(ipos);
+		line.assign(recvq, recvpos, ipos - recvpos);
 
-		for (queueindex = 0; queueindex < ipos; ++queueindex)
-		{
-			char c = recvq[queueindex];
-
-			switch (c)
-			{
-				case '\0':
-					c = ' ';
-					break;
-				case '\r':
-					continue;
-			}
+		/* Carriage returns are dropped, and NULs replaced with spaces. */
 
-			line.push_back(c);
+		if (line.find_first_of(std::string("\r\0", 2)) != std::string::npos)
+		{
+			line.erase(std::remove(line.begin(), line.end(), '\r'), line.end());
+			std::replace(line.begin(), line.end(), '\0', ' ');
 		}
 
-		recvq.erase(0, ipos + 1);
+		Consume(ipos - recvpos + 1);
 		checked_until = 0;
 
 		Kernel->Commander.ProcessBuffer(user, line);
 
 		if (user->IsQuitting())
 		{
-			return;
+			return false;
+		}
+
+		if (user->serializer != serializer)
+		{
+			return true;
 		}
 
 		line.clear();
 	}
+
+	return false;
+}
+
+bool InstanceStream::StreamFrames()
+{
+	ProtocolTrigger::Serializer* const serializer = user->serializer;
+
+	while (GetQueueSize() < ULONG_MAX)
+	{
+		/* Arguments are copied once, straight from recvq, as their length is known. */
+
+		ProtocolTrigger::ParseOutput parseoutput;
+		const long used = serializer->Extract(user, recvq, recvpos, frame, parseoutput);
+
+		if (!used)
+		{
+			return false;
+		}
+
+		if (used < 0)
+		{
+			Kernel->Clients->Disconnect(user, "Malformed input");
+			return false;
+		}
+
+		Consume(used);
+		Kernel->Commander.ProcessOutput(user, parseoutput);
+
+		if (user->IsQuitting())
+		{
+			return false;
+		}
+
+		if (user->serializer != serializer)
+		{
+			return true;
+		}
+	}
+
+	return false;
 }
 
 void InstanceStream::swap_internal(InstanceStream& other)
 {
 	StreamSocket::swap_internal(other);
 	std::swap(checked_until, other.checked_until);
+	std::swap(frame, other.frame);
 }
 
 bool InstanceStream::OnSetEndPoint(const engine::sockets::sockaddrs& server, const engine::sockets::sockaddrs& client)
@@ -470,13 +533,6 @@ bool User::SetLogin(const std::string& userlogin, time_t newts)
 	this->logged = Kernel->Now();
 	this->login = userlogin;
 	
-	if (!UserHelper::CheckPass(userlogin, this->auth))
-	{
-		this->SendProtocol(ERR_WRONG_PASS);
-		Kernel->Clients->Disconnect(this, "Wrong password.");
-		return false;  	
-	}
-	
 	std::string newlogin = "I-" + this->login + "-" + this->uuid;
 	User* const InUse = Kernel->Clients->FindInstanceOnly(userlogin);
 	
@@ -618,9 +674,62 @@ void LocalUser::Write(const ProtocolTrigger::SerializedMessage& text)
 		return;
 	}
 
+	/* Replies of commands replayed by MRUN are sent along with its results. */
+
+	if (this->Transaction)
+	{
+		this->Transaction->replies.push_back(std::make_pair(this->Transaction->queries.size(), text));
+		return;
+	}
+
+	/* Replies to pipelined commands are held until results of earlier queries are sent. */
+
+	if (this->Outstanding() && !this->delivering && !this->IsQuitting())
+	{
+		const uint64_t last = this->issued - 1;
+
+		if (!this->held.empty() && this->held.back().first == last)
+		{
+			this->held.back().second.append(text);
+		}
+		else
+		{
+			this->held.push_back(std::make_pair(last, text));
+		}
+
+		return;
+	}
+
+	usercon.AppendBuffer(text);
+}
+
+void LocalUser::Write(const ProtocolTrigger::SharedMessage& text)
+{
+	if (!SocketPool::BoundsCheckFd(&usercon))
+	{
+		return;
+	}
+
+	/* Held output is copied, as it is merged with other replies. */
+
+	if (this->Transaction || (this->Outstanding() && !this->delivering && !this->IsQuitting()))
+	{
+		this->Write(*text);
+		return;
+	}
+
 	usercon.AppendBuffer(text);
 }
 
+void LocalUser::Release()
+{
+	while (!this->held.empty() && this->held.front().first < this->delivered)
+	{
+		usercon.AppendBuffer(std::move(this->held.front().second));
+		this->held.pop_front();
+	}
+}
+
 void LocalUser::Send(ProtocolTrigger::Event& protoev)
 {
 	if (!serializer)
@@ -11,6 +11,8 @@
  * More information about our licensing can be found at https://docs.beryl.dev
  */
 
+#include <random>
+
 #include "beryl.h"
 #include "engine.h"
 #include "login.h"
@@ -159,88 +161,270 @@ void SessionManager::NotifyFlags(const std::string& login, const std::string& fl
        }
 }
 
-LoginCache::LoginCache()
+AuthPool::AuthPool() : exiting(false)
 {
 
 }
 
-void LoginCache::Reset()
+AuthPool::~AuthPool()
 {
-       this->logins.clear();
+       this->Stop();
 }
 
-bool LoginCache::RemoveLastCache()
+void AuthPool::Start(unsigned int count)
 {
-       /* Remove last element. */
-    
-       if (this->logins.empty())
+       this->exiting = false;
+
+       for (unsigned int i = 0; i < count; i++)
        {
-            return false;
-       } 
-    
-       LoginMap::iterator it = logins.begin();
-       std::advance(it, static_cast<int>(logins.size())-1); 
-       logins.erase(it);
-       return true;
+              this->threads.push_back(std::thread(&AuthPool::Process, this));
+       }
 }
 
-void LoginCache::Add(const std::string& user, const std::string& pass)
+void AuthPool::Stop()
 {
-       Kernel->Stats->Cached++;
-       this->logins.insert(std::make_pair(user, pass));
-  
-       /* This cache should not have more than 1024 entries. */
-        
-       if (logins.size() >= 1024)
        {
-           this->RemoveLastCache();
+              std::lock_guard<std::mutex> lg(this->lock);
+              this->exiting = true;
+              this->requests.clear();
+       }
+
+       this->wake.notify_all();
+
+       for (std::vector<std::thread>::iterator i = this->threads.begin(); i != this->threads.end(); ++i)
+       {
+              if (i->joinable())
+              {
+                     i->join();
+              }
+       }
+
+       this->threads.clear();
+}
+
+void AuthPool::Submit(User* user, std::shared_ptr<QueryBase> query)
+{
+       query->user = user;
+
+       /* Result is delivered in order, and keeps this user alive until then. */
+
+       query->sequence = user->issued++;
+       user->inflight++;
+
+       {
+              std::lock_guard<std::mutex> lg(this->lock);
+              this->requests.push_back(query);
        }
+
+       this->wake.notify_one();
 }
 
-void LoginCache::Remove(const std::string& user)
+size_t AuthPool::Pending()
 {
-       logins.erase(user);
+       std::lock_guard<std::mutex> lg(this->lock);
+       return this->requests.size();
 }
 
-signed int LoginCache::InCache(const std::string& user, const std::string& pass)
+void AuthPool::Process()
 {
-        for (LoginMap::iterator i = logins.begin(); i != logins.end(); ++i)
-        {
-              if (i->first == user)
+       while (true)
+       {
+              std::shared_ptr<QueryBase> request;
+
+              {
+                     std::unique_lock<std::mutex> lk(this->lock);
+                     this->wake.wait(lk, [this] { return this->exiting || !this->requests.empty(); });
+
+                     if (this->exiting)
+                     {
+                            return;
+                     }
+
+                     request = std::move(this->requests.front());
+                     this->requests.pop_front();
+              }
+
+              if (request->user->IsQuitting())
+              {
+                     request->access_set(DBL_INTERRUPT);
+              }
+              else
               {
-                   HashProvider* provider = Kernel->Modules->DataModule<HashProvider>("hash/bcrypt");
-
-                   if (!provider)
-                   {
-                          return -1;
-                   }
-
-                   if (provider->Compare(pass, i->second))
-                   {
-                         return 1;
-                   }
-                   else
-                   {
-                         /* Login found, but wrong password. */
-                      
-                         return -1;
-                   }
+                     request->Run();
               }
+
+              DataFlush::AttachResult(request);
        }
-    
-       /* Login not found. */
-    
-       return 0;
 }
 
-bool LoginCache::InCache(const std::string& user)
+namespace
+{
+       inline uint64_t Rotate(uint64_t x, int b)
+       {
+              return (x << b) | (x >> (64 - b));
+       }
+
+       inline void SipRound(uint64_t& v0, uint64_t& v1, uint64_t& v2, uint64_t& v3)
+       {
+              v0 += v1; v1 = Rotate(v1, 13); v1 ^= v0; v0 = Rotate(v0, 32);
+              v2 += v3; v3 = Rotate(v3, 16); v3 ^= v2;
+              v0 += v3; v3 = Rotate(v3, 21); v3 ^= v0;
+              v2 += v1; v1 = Rotate(v1, 17); v1 ^= v2; v2 = Rotate(v2, 32);
+       }
+
+       /* SipHash-2-4: a keyed hash, so digests can not be forged without its key. */
+
+       uint64_t SipHash(const uint64_t key[2], const std::string& data)
+       {
+              uint64_t v0 = 0x736f6d6570736575ULL ^ key[0];
+              uint64_t v1 = 0x646f72616e646f6dULL ^ key[1];
+              uint64_t v2 = 0x6c7967656e657261ULL ^ key[0];
+              uint64_t v3 = 0x7465646279746573ULL ^ key[1];
+
+              const unsigned char* input = reinterpret_cast<const unsigned char*>(data.data());
+              const size_t length = data.size();
+              const size_t end = length - (length % 8);
+
+              for (size_t i = 0; i < end; i += 8)
+              {
+                     uint64_t m = 0;
+
+                     for (unsigned int j = 0; j < 8; j++)
+                     {
+                            m |= ((uint64_t)input[i + j]) << (8 * j);
+                     }
+
+                     v3 ^= m;
+                     SipRound(v0, v1, v2, v3);
+                     SipRound(v0, v1, v2, v3);
+                     v0 ^= m;
+              }
+
+              uint64_t last = ((uint64_t)length) << 56;
+
+              for (size_t i = end; i < length; i++)
+              {
+                     last |= ((uint64_t)input[i]) << (8 * (i - end));
+              }
+
+              v3 ^= last;
+              SipRound(v0, v1, v2, v3);
+              SipRound(v0, v1, v2, v3);
+              v0 ^= last;
+
+              v2 ^= 0xff;
+
+              for (unsigned int i = 0; i < 4; i++)
+              {
+                     SipRound(v0, v1, v2, v3);
+              }
+
+              return v0 ^ v1 ^ v2 ^ v3;
+       }
+}
+
+LoginCache::LoginCache() : generation(0)
+{
+       std::random_device device;
+
+       for (unsigned int i = 0; i < 2; i++)
+       {
+              this->key[i] = ((uint64_t)device() << 32) | device();
+       }
+}
+
+uint64_t LoginCache::Digest(const std::string& user, const std::string& pass)
+{
+       std::string data(user);
+       data.push_back('\0');
+       data.append(pass);
+
+       return SipHash(this->key, data);
+}
+
+void LoginCache::Reset()
+{
+       this->entries.clear();
+       this->logins.clear();
+       this->generation++;
+}
+
+void LoginCache::Add(const std::string& user, const std::string& pass)
+{
+       Kernel->Stats->Cached++;
+
+       LoginMap::iterator it = this->logins.find(user);
+
+       if (it != this->logins.end())
+       {
+              it->second->digest = this->Digest(user, pass);
+              it->second->added = Kernel->Now();
+              this->entries.splice(this->entries.begin(), this->entries, it->second);
+              return;
+       }
+
+       Entry entry;
+       entry.login = user;
+       entry.digest = this->Digest(user, pass);
+       entry.added = Kernel->Now();
+
+       this->entries.push_front(entry);
+       this->logins[user] = this->entries.begin();
+
+       /* Least recently used logins are removed first. */
+
+       while (this->logins.size() > LOGIN_CACHE_SIZE)
+       {
+              this->logins.erase(this->entries.back().login);
+              this->entries.pop_back();
+       }
+}
+
+void LoginCache::Remove(const std::string& user)
+{
+       LoginMap::iterator it = this->logins.find(user);
+
+       /* Verifications already running may have used removed credentials. */
+
+       this->generation++;
+
+       if (it == this->logins.end())
+       {
+              return;
+       }
+
+       this->entries.erase(it->second);
+       this->logins.erase(it);
+}
+
+bool LoginCache::InCache(const std::string& user, const std::string& pass)
 {
        LoginMap::iterator it = this->logins.find(user);
 
        if (it == this->logins.end())
        {
-                return false;
+              return false;
+       }
+
+       if (it->second->added + LOGIN_CACHE_TTL <= Kernel->Now())
+       {
+              this->entries.erase(it->second);
+              this->logins.erase(it);
+              return false;
        }
 
+       /* A different pass is verified again, as it may have changed. */
+
+       if (it->second->digest != this->Digest(user, pass))
+       {
+              return false;
+       }
+
+       this->entries.splice(this->entries.begin(), this->entries, it->second);
        return true;
-}
\ No newline at end of file
+}
+
+bool LoginCache::InCache(const std::string& user)
+{
+       return (this->logins.find(user) != this->logins.end());
+}
@@ -19,7 +19,7 @@
 
 MapData CMapsHelper::Set(const std::string& entry, const std::string& hesh, const std::string& value)
 {
-       std::shared_ptr<hset_query> query = std::make_shared<hset_query>();
+       std::shared_ptr<hset_query> query = QueryPool::Make<hset_query>();
        Helpers::make_cmap(query, entry, hesh);
        
        query->value = value;
@@ -31,7 +31,7 @@ MapData CMapsHelper::Set(const std::string& entry, const std::string& hesh, cons
 
 MapData CMapsHelper::Get(const std::string& key, const std::string& hesh)
 {
-       std::shared_ptr<hget_query> query = std::make_shared<hget_query>();
+       std::shared_ptr<hget_query> query = QueryPool::Make<hget_query>();
        Helpers::make_cmap(query, key, hesh);
 
        query->Prepare();
@@ -41,7 +41,7 @@ MapData CMapsHelper::Get(const std::string& key, const std::string& hesh)
 
 MapData CMapsHelper::Del(const std::string& key, const std::string& hesh)
 {
-       std::shared_ptr<hdel_query> query = std::make_shared<hdel_query>();
+       std::shared_ptr<hdel_query> query = QueryPool::Make<hdel_query>();
        Helpers::make_cmap(query, key, hesh);
 
        query->Prepare();
@@ -51,7 +51,7 @@ MapData CMapsHelper::Del(const std::string& key, const std::string& hesh)
 
 MapData CMapsHelper::HList(const std::string& entry)
 {
-       std::shared_ptr<hlist_query> query = std::make_shared<hlist_query>();
+       std::shared_ptr<hlist_query> query = QueryPool::Make<hlist_query>();
        Helpers::make_cmap(query, entry);
        
        query->key = entry;
@@ -62,7 +62,7 @@ MapData CMapsHelper::HList(const std::string& entry)
 
 MapData CMapsHelper::Erase(const std::string& entry)
 {
-       std::shared_ptr<del_query> query = std::make_shared<del_query>();
+       std::shared_ptr<del_query> query = QueryPool::Make<del_query>();
        Helpers::make_cmap(query, entry);
        
        query->key = entry;
@@ -32,7 +32,7 @@ bool DBHelper::FlushDB(std::shared_ptr<Database> database, bool notify)
 
 MapData DBHelper::CType(const std::string& key)
 {
-       std::shared_ptr<type_query> query = std::make_shared<type_query>();
+       std::shared_ptr<type_query> query = QueryPool::Make<type_query>();
        Helpers::make_cquery(query, key);
        query->Prepare();
        query->Run();
@@ -41,7 +41,7 @@ MapData DBHelper::CType(const std::string& key)
 
 void DBHelper::DBSize(User* user, std::shared_ptr<Database> db)
 {
-       std::shared_ptr<dbsize_query> query = std::make_shared<dbsize_query>();
+       std::shared_ptr<dbsize_query> query = QueryPool::Make<dbsize_query>();
        query->user = user;
        query->database = db;
        
@@ -50,28 +50,28 @@ void DBHelper::DBSize(User* user, std::shared_ptr<Database> db)
 
 void DBHelper::SFlush(User* user, const std::string& key)
 {
-       std::shared_ptr<sflush_query> query = std::make_shared<sflush_query>();
+       std::shared_ptr<sflush_query> query = QueryPool::Make<sflush_query>();
        Helpers::make_query(user, query, key);
        Kernel->Store->Push(query);
 }
 
 void DBHelper::List(User* user)
 {
-       std::shared_ptr<list_query> query = std::make_shared<list_query>();
+       std::shared_ptr<list_query> query = QueryPool::Make<list_query>();
        Helpers::make_query(user, query);
        Kernel->Store->Push(query);
 }
 
 void DBHelper::GList(User* user)
 {
-       std::shared_ptr<glist_query> query = std::make_shared<glist_query>();
+       std::shared_ptr<glist_query> query = QueryPool::Make<glist_query>();
        Helpers::make_query(user, query);
        Kernel->Store->Push(query);
 }
 
 void DBHelper::Total(User* user)
 {
-       std::shared_ptr<total_query> query = std::make_shared<total_query>();
+       std::shared_ptr<total_query> query = QueryPool::Make<total_query>();
        Helpers::make_query(user, query);
        
        Kernel->Store->Push(query);
@@ -79,7 +79,7 @@ void DBHelper::Total(User* user)
 
 void DBHelper::DatabaseReset(User* user, const std::string& dbname)
 {
-       std::shared_ptr<dbreset_query> query = std::make_shared<dbreset_query>();
+       std::shared_ptr<dbreset_query> query = QueryPool::Make<dbreset_query>();
        
        query->user 		= user;
        query->database 		= Kernel->Store->DBM->Find(dbname);
@@ -19,10 +19,11 @@
 #include "managers/expires.h"
 #include "helpers.h"
 #include "extras.h"
+#include "maker.h"
 
 void ExpireHelper::ListFutures(std::shared_ptr<Database> db, bool last)
 {
-       std::shared_ptr<future_list_query> query = std::make_shared<future_list_query>();
+       std::shared_ptr<future_list_query> query = QueryPool::Make<future_list_query>();
        
        query->database 	=  db;
        query->user 	=  Kernel->Clients->Global;
@@ -39,7 +40,7 @@ void ExpireHelper::ListFutures(std::shared_ptr<Database> db, bool last)
 
 void ExpireHelper::List(std::shared_ptr<Database> db)
 {
-       std::shared_ptr<expire_list_query> query = std::make_shared<expire_list_query>();
+       std::shared_ptr<expire_list_query> query = QueryPool::Make<expire_list_query>();
        
        query->database = db;
        query->user = Kernel->Clients->Global;
@@ -48,27 +49,27 @@ void ExpireHelper::List(std::shared_ptr<Database> db)
 
 void ExpireHelper::Future(User* user, const std::string& entry, unsigned int ttl, const std::string& value)
 {
-       std::shared_ptr<future_query> query = std::make_shared<future_query>();
+       std::shared_ptr<future_query> query = QueryPool::Make<future_query>();
        Helpers::make_query(user, query, entry);
 
-       query->value = stripe(value);
+       query->value = stripe(user, value);
        query->id = Kernel->Now() + ttl;
        Kernel->Store->Push(query);
 }
 
 void ExpireHelper::FutureAT(User* user, const std::string& entry, unsigned int ttl, const std::string& value)
 {
-       std::shared_ptr<future_query> query = std::make_shared<future_query>();
+       std::shared_ptr<future_query> query = QueryPool::Make<future_query>();
        Helpers::make_query(user, query, entry);
 
-       query->value = stripe(value);
+       query->value = stripe(user, value);
        query->id = ttl;
        Kernel->Store->Push(query);
 }
 
 void ExpireHelper::Expire(User* user, const std::string& entry, unsigned int ttl)
 {
-       std::shared_ptr<expire_query> query = std::make_shared<expire_query>();
+       std::shared_ptr<expire_query> query = QueryPool::Make<expire_query>();
        Helpers::make_query(user, query, entry);
 
        query->id = Kernel->Now() + ttl;
@@ -77,17 +78,17 @@ void ExpireHelper::Expire(User* user, const std::string& entry, unsigned int ttl
 
 void ExpireHelper::Setex(User* user, unsigned int exp_usig, const std::string& key, const std::string& value)
 {
-       std::shared_ptr<setex_query> query = std::make_shared<setex_query>();
+       std::shared_ptr<setex_query> query = QueryPool::Make<setex_query>();
        Helpers::make_query(user, query, key);
 
-       query->value = stripe(value);
+       query->value = stripe(user, value);
        query->id = Kernel->Now() + exp_usig;
        Kernel->Store->Push(query);
 }
 
 void ExpireHelper::ExpireAT(User* user, const std::string& entry, unsigned int ttl)
 {
-       std::shared_ptr<expireat_query> query = std::make_shared<expireat_query>();
+       std::shared_ptr<expireat_query> query = QueryPool::Make<expireat_query>();
        Helpers::make_query(user, query, entry);
 
        query->id = ttl;
@@ -96,7 +97,7 @@ void ExpireHelper::ExpireAT(User* user, const std::string& entry, unsigned int t
 
 void ExpireHelper::Persist(User* user, const std::string& entry, unsigned int select, std::shared_ptr<Database> db)
 {
-       std::shared_ptr<expire_del_query> query = std::make_shared<expire_del_query>();
+       std::shared_ptr<expire_del_query> query = QueryPool::Make<expire_del_query>();
        
        query->database = db;
        query->flags = QUERY_FLAGS_QUIET;
@@ -109,7 +110,7 @@ void ExpireHelper::Persist(User* user, const std::string& entry, unsigned int se
 
 void ExpireHelper::QuickPersist(User* user, const std::string& key)
 {
-       std::shared_ptr<expire_del_query> query = std::make_shared<expire_del_query>();
+       std::shared_ptr<expire_del_query> query = QueryPool::Make<expire_del_query>();
        Helpers::make_query(user, query, key);
 
        Kernel->Store->Push(query);
@@ -25,7 +25,7 @@
 
 void GlobalHelper::Transfer(User* user, const std::string& entry, std::shared_ptr<Database> db)
 {
-       std::shared_ptr<transfer_query> query = std::make_shared<transfer_query>();
+       std::shared_ptr<transfer_query> query = QueryPool::Make<transfer_query>();
        Helpers::make_query(user, query, entry);
        query->transf_db = db;
        query->value = entry;
@@ -34,7 +34,7 @@ void GlobalHelper::Transfer(User* user, const std::string& entry, std::shared_pt
 
 void GlobalHelper::Touch(User* user, const std::string& entry)
 {
-       std::shared_ptr<touch_query> query = std::make_shared<touch_query>();
+       std::shared_ptr<touch_query> query = QueryPool::Make<touch_query>();
        Helpers::make_query(user, query, entry);
        query->value = entry;      
        Kernel->Store->Push(query);
@@ -42,7 +42,7 @@ void GlobalHelper::Touch(User* user, const std::string& entry)
 
 void GlobalHelper::NTouch(User* user, const std::string& entry)
 {
-       std::shared_ptr<ntouch_query> query = std::make_shared<ntouch_query>();
+       std::shared_ptr<ntouch_query> query = QueryPool::Make<ntouch_query>();
        Helpers::make_query(user, query, entry);
        query->value = entry;      
        Kernel->Store->Push(query);
@@ -50,7 +50,7 @@ void GlobalHelper::NTouch(User* user, const std::string& entry)
 
 void GlobalHelper::Clone(User* user, const std::string& entry, const std::string& dest)
 {
-       std::shared_ptr<clone_query> query = std::make_shared<clone_query>();
+       std::shared_ptr<clone_query> query = QueryPool::Make<clone_query>();
        Helpers::make_query(user, query, entry);
        query->value = dest;
        Kernel->Store->Push(query);
@@ -58,7 +58,7 @@ void GlobalHelper::Clone(User* user, const std::string& entry, const std::string
 
 void GlobalHelper::Copy(User* user, const std::string& entry, const std::string& dest)
 {
-       std::shared_ptr<copy_query> query = std::make_shared<copy_query>();
+       std::shared_ptr<copy_query> query = QueryPool::Make<copy_query>();
        Helpers::make_query(user, query, entry);
        query->value = dest;
        Kernel->Store->Push(query);
@@ -66,7 +66,7 @@ void GlobalHelper::Copy(User* user, const std::string& entry, const std::string&
 
 void GlobalHelper::Delete(User* user, const std::string& entry)
 {
-       std::shared_ptr<del_query> query = std::make_shared<del_query>();
+       std::shared_ptr<del_query> query = QueryPool::Make<del_query>();
        Helpers::make_query(user, query, entry);
        
        Kernel->Store->Push(query);
@@ -74,7 +74,7 @@ void GlobalHelper::Delete(User* user, const std::string& entry)
 
 void GlobalHelper::Rename(User* user, const std::string& entry, const std::string& dest)
 {
-       std::shared_ptr<rename_query> query = std::make_shared<rename_query>();
+       std::shared_ptr<rename_query> query = QueryPool::Make<rename_query>();
        Helpers::make_query(user, query, entry);
        query->value = dest;
        Kernel->Store->Push(query);
@@ -82,7 +82,7 @@ void GlobalHelper::Rename(User* user, const std::string& entry, const std::strin
 
 void GlobalHelper::RenameNX(User* user, const std::string& entry, const std::string& dest)
 {
-       std::shared_ptr<renamenx_query> query = std::make_shared<renamenx_query>();
+       std::shared_ptr<renamenx_query> query = QueryPool::Make<renamenx_query>();
        Helpers::make_query(user, query, entry);
        query->value = dest;
        Kernel->Store->Push(query);
@@ -91,7 +91,7 @@ void GlobalHelper::RenameNX(User* user, const std::string& entry, const std::str
 
 void GlobalHelper::Move(User* user, const std::string& entry, const std::string& dest)
 {
-       std::shared_ptr<move_query> query = std::make_shared<move_query>();
+       std::shared_ptr<move_query> query = QueryPool::Make<move_query>();
        Helpers::make_query(user, query, entry);
        query->value = dest;
        Kernel->Store->Push(query);
@@ -99,14 +99,14 @@ void GlobalHelper::Move(User* user, const std::string& entry, const std::string&
 
 void GlobalHelper::Exists(User* user, const std::string& entry)
 {
-       std::shared_ptr<exists_query> query = std::make_shared<exists_query>();
+       std::shared_ptr<exists_query> query = QueryPool::Make<exists_query>();
        Helpers::make_query(user, query, entry);
        Kernel->Store->Push(query);
 }
 
 void GlobalHelper::ExpireDelete(std::shared_ptr<Database> database, unsigned int  where, const std::string& key)
 {
-       std::shared_ptr<del_query> query = std::make_shared<del_query>();
+       std::shared_ptr<del_query> query = QueryPool::Make<del_query>();
 
        query->user = Kernel->Clients->Global;
        query->database = database;
@@ -119,7 +119,7 @@ void GlobalHelper::ExpireDelete(std::shared_ptr<Database> database, unsigned int
 
 void GlobalHelper::FutureExecute(std::shared_ptr<Database> database, unsigned int where, const std::string& key)
 {
-       std::shared_ptr<future_exec_query> query = std::make_shared<future_exec_query>();
+       std::shared_ptr<future_exec_query> query = QueryPool::Make<future_exec_query>();
 
        query->user = Kernel->Clients->Global;
        query->database = database;
@@ -131,21 +131,21 @@ void GlobalHelper::FutureExecute(std::shared_ptr<Database> database, unsigned in
 
 void GlobalHelper::UserFutureExecute(User* user, const std::string& key)
 {
-       std::shared_ptr<future_exec_query> query = std::make_shared<future_exec_query>();
+       std::shared_ptr<future_exec_query> query = QueryPool::Make<future_exec_query>();
        Helpers::make_query(user, query, key);
        Kernel->Store->Push(query);
 }
 
 void GlobalHelper::FutureCancel(User* user, const std::string& key)
 {
-       std::shared_ptr<future_del_query> query = std::make_shared<future_del_query>();
+       std::shared_ptr<future_del_query> query = QueryPool::Make<future_del_query>();
        Helpers::make_query(user, query, key);
        Kernel->Store->Push(query);
 }
 
 void GlobalHelper::FutureGlobalCancel(std::shared_ptr<Database> database, unsigned int where, const std::string& key)
 {
-       std::shared_ptr<future_del_query> query = std::make_shared<future_del_query>();
+       std::shared_ptr<future_del_query> query = QueryPool::Make<future_del_query>();
 
        query->user = Kernel->Clients->Global;
        query->database = database;
@@ -157,7 +157,7 @@ void GlobalHelper::FutureGlobalCancel(std::shared_ptr<Database> database, unsign
 
 void GlobalHelper::Diff(User* user, const std::string& key, const std::string& value, signed int offset, signed int limit)
 {
-       std::shared_ptr<diff_query> query = std::make_shared<diff_query>();
+       std::shared_ptr<diff_query> query = QueryPool::Make<diff_query>();
        Helpers::make_query(user, query, key);
        query->value = value;
        query->limit = limit;
@@ -168,7 +168,7 @@ void GlobalHelper::Diff(User* user, const std::string& key, const std::string& v
 
 void GlobalHelper::DatabaseReset(User* user, const std::string& dbname)
 {
-       std::shared_ptr<dbreset_query> query = std::make_shared<dbreset_query>();
+       std::shared_ptr<dbreset_query> query = QueryPool::Make<dbreset_query>();
        query->user = user;
        query->database = Kernel->Store->DBM->Find(dbname);
        query->key = dbname;
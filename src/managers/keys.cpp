@@ -14,6 +14,7 @@
 #include "beryl.h"
 #include "helpers.h"
 #include "extras.h"
+#include "maker.h"
 #include "managers/keys.h"
 
 void KeyHelper::HeshVal(User* user, std::shared_ptr<QueryBase> query, const std::string& key, const std::string& val1, const std::string& val2)
@@ -42,7 +43,7 @@ void KeyHelper::Simple(User* user, std::shared_ptr<QueryBase> query, const std::
        
        if (do_stripe)
        {
-              query->value = stripe(value);
+              query->value = stripe(user, value);
        }
        else
        {
@@ -83,7 +84,7 @@ void KeyHelper::Retro(User* user, std::shared_ptr<QueryBase> query, const std::s
 void KeyHelper::HeshLimits(User* user, std::shared_ptr<QueryBase> query, const std::string& entry, const std::string& value, signed int offset, signed int limit, bool allow)
 {
        Helpers::make_query(user, query, entry, allow);
-       query->value  = stripe(value);
+       query->value  = stripe(user, value);
        query->offset = offset;
        query->limit = limit;
        Kernel->Store->Push(query);
@@ -107,7 +108,7 @@ void KeyHelper::SimpleRetro(User* user, std::shared_ptr<QueryBase> query, const
 void KeyHelper::SimpleHesh(User* user, std::shared_ptr<QueryBase> query, const std::string& kmap, const std::string& entry, const std::string& value)
 {
        Helpers::make_map(user, query, kmap, entry);
-       query->value = stripe(value);
+       query->value = stripe(user, value);
        
        Kernel->Store->Push(query);
 }
@@ -127,7 +128,7 @@ void KeyHelper::IDRetro(User* user, std::shared_ptr<QueryBase> query, const std:
 
 void KeyHelper::Operation(User* user, const std::string& key, OP_TYPE type, const std::string& oper)
 {
-       std::shared_ptr<op_query> query = std::make_shared<op_query>();
+       std::shared_ptr<op_query> query = QueryPool::Make<op_query>();
        Helpers::make_query(user, query, key);
        query->value = oper;
        query->operation = type;
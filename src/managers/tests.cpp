@@ -24,7 +24,7 @@
 
 void TestHelper::Dump(User* user)
 {
-       std::shared_ptr<test_dump_query> query = std::make_shared<test_dump_query>();
+       std::shared_ptr<test_dump_query> query = QueryPool::Make<test_dump_query>();
        Helpers::make_query(user, query);
        Kernel->Store->Push(query);
 }
@@ -22,19 +22,11 @@
 #include "managers/maps.h"
 #include "modules/encrypt.h"
 
-bool UserHelper::CheckPass(const std::string& user, const std::string& key)
+bool UserHelper::CheckPass(HashProvider* provider, const std::string& user, const std::string& key)
 {
-   	/* Wrong password. */
-   	
-        signed int cached = Kernel->Logins->InCache(user, key);
-        
-        if (cached == -1)
-        {
-                return false;
-        }
-        else if (cached == 1)
+        if (!provider)
         {
-                return true;
+               return false;
         }
 
         const std::string& status = CMapsHelper::Get(user, "status").response;
@@ -46,23 +38,7 @@ bool UserHelper::CheckPass(const std::string& user, const std::string& key)
         }
         
         const std::string& passwd = CMapsHelper::Get(user, "pass").response;
-        
-        HashProvider* provider = Kernel->Modules->DataModule<HashProvider>("hash/bcrypt");
-
-        if (!provider)
-        {
-               return false;
-        }
-
-        if (!provider->Compare(key, passwd))
-        {
-             return false;
-        }
-
-        /* We may add this login to the cache. */
-
-        Kernel->Logins->Add(user, passwd);
-        return true;
+        return provider->Compare(key, passwd);
 }
 
 std::string UserHelper::Find(const std::string& key, const std::string& value)
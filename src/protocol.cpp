@@ -62,7 +62,7 @@ ProtocolTrigger::TagSelection ProtocolTrigger::Serializer::MakeTagWhitelist(Loca
 	return tagwl;
 }
 
-const ProtocolTrigger::SerializedMessage& ProtocolTrigger::Serializer::SerializeForUser(LocalUser* user, Message& msg)
+const ProtocolTrigger::SharedMessage& ProtocolTrigger::Serializer::SerializeForUser(LocalUser* user, Message& msg)
 {
 	if (!msg.msginit_done)
 	{
@@ -73,7 +73,7 @@ const ProtocolTrigger::SerializedMessage& ProtocolTrigger::Serializer::Serialize
 	return msg.GetSerialized(Message::SerializedData(this, MakeTagWhitelist(user, msg.GetTags())));
 }
 
-const ProtocolTrigger::SerializedMessage& ProtocolTrigger::Message::GetSerialized(const SerializedData& serializeinfo) const
+const ProtocolTrigger::SharedMessage& ProtocolTrigger::Message::GetSerialized(const SerializedData& serializeinfo) const
 {
 	for (SerializedList::const_iterator i = serlist.begin(); i != serlist.end(); ++i)
 	{
@@ -85,7 +85,9 @@ const ProtocolTrigger::SerializedMessage& ProtocolTrigger::Message::GetSerialize
 		}
 	}
 
-	serlist.push_back(std::make_pair(serializeinfo, serializeinfo.serializer->Serialize(*this, serializeinfo.tagwl)));
+	/* Serialized once per serializer and tags, then shared by all users receiving it. */
+
+	serlist.push_back(std::make_pair(serializeinfo, std::make_shared<const SerializedMessage>(serializeinfo.serializer->Serialize(*this, serializeinfo.tagwl))));
 	return serlist.back().second;
 }
 
@@ -155,18 +155,38 @@ DiscardResult StreamSocket::discard()
 
 bool StreamSocket::find_next_line(std::string& line, char delim)
 {
-	std::string::size_type i = recvq.find(delim);
+	std::string::size_type i = recvq.find(delim, recvpos);
 
 	if (i == std::string::npos)
 	{
 		return false;
 	}
 	
-	line.assign(recvq, 0, i);
-	recvq.erase(0, i + 1);
+	line.assign(recvq, recvpos, i - recvpos);
+	Consume(i - recvpos + 1);
 	return true;
 }
 
+void StreamSocket::Consume(std::string::size_type count)
+{
+	recvpos += count;
+
+	if (recvpos >= recvq.size())
+	{
+		recvq.clear();
+		recvpos = 0;
+	}
+}
+
+void StreamSocket::Compact()
+{
+	if (recvpos)
+	{
+		recvq.erase(0, recvpos);
+		recvpos = 0;
+	}
+}
+
 int StreamSocket::QueueChainRead(IOQueue* attach, std::string& rq)
 {
 	if (!attach)
@@ -191,6 +211,8 @@ int StreamSocket::QueueChainRead(IOQueue* attach, std::string& rq)
 
 void StreamSocket::StreamRead()
 {
+	Compact();
+
 	const std::string::size_type prevrecvqsize = recvq.size();
 
 	const int result = QueueChainRead(GetIOQueue(), recvq);
@@ -413,6 +435,28 @@ void StreamSocket::AppendBuffer(const std::string &data)
 	SocketPool::EventSwitch(this, Q_ADD_WRITE_TRIAL);
 }
 
+void StreamSocket::AppendBuffer(std::string&& data)
+{
+	if (!HasFileDesc())
+	{
+		return;
+	}
+
+	sendq.push_back(std::move(data));
+	SocketPool::EventSwitch(this, Q_ADD_WRITE_TRIAL);
+}
+
+void StreamSocket::AppendBuffer(const std::shared_ptr<const std::string>& data)
+{
+	if (!HasFileDesc())
+	{
+		return;
+	}
+
+	sendq.push_back(send_queue::Element(data));
+	SocketPool::EventSwitch(this, Q_ADD_WRITE_TRIAL);
+}
+
 bool SocketTimer::Run(time_t)
 {
 	if (SocketPool::GetReference(this->sfd) != this->sock.get())
@@ -628,5 +672,6 @@ void StreamSocket::swap_internal(StreamSocket& other)
 	std::swap(error, other.error);
 	std::swap(ioattach, other.ioattach);
 	std::swap(recvq, other.recvq);
+	std::swap(recvpos, other.recvpos);
 	std::swap(sendq, other.sendq);
 }
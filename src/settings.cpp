@@ -118,7 +118,12 @@ bool Helpers::as_bool(const std::string &key, bool def)
 
 std::string Helpers::Format(const std::string& fmt)
 {
-    return Daemon::Format("\"%s\"", fmt.c_str());
+    /* Not using Daemon::Format, as large values would be formatted several times. */
+
+    std::string quoted;
+    quoted.reserve(fmt.size() + 2);
+    quoted.append(1, '"').append(fmt).append(1, '"');
+    return quoted;
 }
 
 void Helpers::make_query(User* user, std::shared_ptr<QueryBase> base, const std::string& key, bool allow)     
@@ -287,6 +292,11 @@ std::string Helpers::TypeString(const std::string& type, bool plural)
            return Daemon::Format("MULTIMAP%s", plural == true ? "S" : "");
      }
      
+     if (type == INT_ZSET)
+     {
+           return Daemon::Format("ZSET%s", plural == true ? "S" : "");
+     }
+     
      if (type == INT_FUTURE)
      {
            return Daemon::Format("FUTURE%s", plural == true ? "S" : "");